@@ -0,0 +1,12 @@
+set(CONTACTBENCHMARK_ROOT_DIR "${SIMROBOT_PREFIX}/Src/Benchmarks")
+set(CONTACTBENCHMARK_OUTPUT_DIR "${OUTPUT_PREFIX}/Build/${OS}/ContactBenchmark/$<CONFIG>")
+
+set(CONTACTBENCHMARK_SOURCES "${CONTACTBENCHMARK_ROOT_DIR}/ContactBenchmark.cpp")
+
+add_executable(ContactBenchmark EXCLUDE_FROM_ALL ${CONTACTBENCHMARK_SOURCES})
+set_property(TARGET ContactBenchmark PROPERTY FOLDER Tools)
+set_property(TARGET ContactBenchmark PROPERTY RUNTIME_OUTPUT_DIRECTORY "${CONTACTBENCHMARK_OUTPUT_DIR}")
+target_link_libraries(ContactBenchmark PRIVATE Box2D::Box2D)
+target_link_libraries(ContactBenchmark PRIVATE Flags::Default)
+
+source_group(TREE "${CONTACTBENCHMARK_ROOT_DIR}" FILES ${CONTACTBENCHMARK_SOURCES})
@@ -0,0 +1,12 @@
+set(READERBENCHMARK_ROOT_DIR "${SIMROBOT_PREFIX}/Src/Benchmarks")
+set(READERBENCHMARK_OUTPUT_DIR "${OUTPUT_PREFIX}/Build/${OS}/ReaderBenchmark/$<CONFIG>")
+
+set(READERBENCHMARK_SOURCES "${READERBENCHMARK_ROOT_DIR}/ReaderBenchmark.cpp")
+
+add_executable(ReaderBenchmark EXCLUDE_FROM_ALL ${READERBENCHMARK_SOURCES})
+set_property(TARGET ReaderBenchmark PROPERTY FOLDER Tools)
+set_property(TARGET ReaderBenchmark PROPERTY RUNTIME_OUTPUT_DIRECTORY "${READERBENCHMARK_OUTPUT_DIR}")
+target_link_libraries(ReaderBenchmark PRIVATE SimRobotCommon)
+target_link_libraries(ReaderBenchmark PRIVATE Flags::Default)
+
+source_group(TREE "${READERBENCHMARK_ROOT_DIR}" FILES ${READERBENCHMARK_SOURCES})
@@ -0,0 +1,289 @@
+/**
+ * @file ContactBenchmark.cpp
+ * A benchmark that measures how fast persistent contacts are reported in a Box2D world in which many discs collide.
+ * It compares keeping all touching contacts in a hash map (as the 2D simulation does), keeping them in a dense vector
+ * from which ended contacts are swap-removed, and walking the contact list of the world while only remembering the
+ * contacts that began during a step. Both the contact callbacks and the loop after each step are timed.
+ * Usage: ContactBenchmark [discs [steps]]
+ */
+
+#include <box2d/b2_body.h>
+#include <box2d/b2_circle_shape.h>
+#include <box2d/b2_contact.h>
+#include <box2d/b2_edge_shape.h>
+#include <box2d/b2_fixture.h>
+#include <box2d/b2_world.h>
+#include <box2d/b2_world_callbacks.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * @class ContactReporter
+ * The base class of the ways to report collisions after each step
+ */
+class ContactReporter : public b2ContactListener
+{
+public:
+  std::size_t reports = 0; /**< The number of collisions reported */
+  std::chrono::steady_clock::duration reportTime{}; /**< The time spent reporting collisions after the steps */
+  std::chrono::steady_clock::duration callbackTime{}; /**< The time spent in \c BeginContact and \c EndContact */
+
+  /**
+   * Steps the world and reports the collisions that persisted over the step
+   * @param world The world
+   */
+  virtual void step(b2World& world) = 0;
+
+protected:
+  /**
+   * Stands in for calling the collision callbacks of both fixtures of a contact
+   * @param contact The contact
+   */
+  void report(b2Contact*)
+  {
+    reports += 2;
+  }
+
+  /**
+   * Called when two fixtures begin to touch
+   * @param contact The contact
+   */
+  virtual void begin(b2Contact* contact) = 0;
+
+  /**
+   * Called when two fixtures cease to touch
+   * @param contact The contact
+   */
+  virtual void end(b2Contact*) {}
+
+private:
+  void BeginContact(b2Contact* contact) override
+  {
+    const auto start = std::chrono::steady_clock::now();
+    begin(contact);
+    callbackTime += std::chrono::steady_clock::now() - start;
+  }
+
+  void EndContact(b2Contact* contact) override
+  {
+    const auto start = std::chrono::steady_clock::now();
+    end(contact);
+    callbackTime += std::chrono::steady_clock::now() - start;
+  }
+};
+
+/**
+ * @class MapReporter
+ * Keeps all touching contacts in a hash map and reports the ones that existed before the step
+ */
+class MapReporter : public ContactReporter
+{
+public:
+  void step(b2World& world) override
+  {
+    world.Step(0.01f, 8, 3);
+    const auto start = std::chrono::steady_clock::now();
+    for(auto& contact : contacts)
+    {
+      if(contact.second)
+        report(contact.first);
+      else
+        contact.second = true;
+    }
+    reportTime += std::chrono::steady_clock::now() - start;
+  }
+
+private:
+  std::unordered_map<b2Contact*, bool> contacts; /**< The touching contacts and whether they existed before the current step */
+
+  void begin(b2Contact* contact) override
+  {
+    contacts[contact] = false;
+    report(contact);
+  }
+
+  void end(b2Contact* contact) override
+  {
+    contacts.erase(contact);
+  }
+};
+
+/**
+ * @class DenseReporter
+ * Keeps all touching contacts in a vector and reports the ones that existed before the step. An ended contact is
+ * replaced by the last one. Box2D contacts have no user data, so the index of each contact is kept in a hash map,
+ * which is only used when a contact ends.
+ */
+class DenseReporter : public ContactReporter
+{
+public:
+  void step(b2World& world) override
+  {
+    world.Step(0.01f, 8, 3);
+    const auto start = std::chrono::steady_clock::now();
+    for(auto& contact : contacts)
+    {
+      if(contact.second)
+        report(contact.first);
+      else
+        contact.second = true;
+    }
+    reportTime += std::chrono::steady_clock::now() - start;
+  }
+
+private:
+  std::vector<std::pair<b2Contact*, bool>> contacts; /**< The touching contacts and whether they existed before the current step */
+  std::unordered_map<b2Contact*, std::size_t> indices; /**< The index of each touching contact in \c contacts */
+
+  void begin(b2Contact* contact) override
+  {
+    indices[contact] = contacts.size();
+    contacts.emplace_back(contact, false);
+    report(contact);
+  }
+
+  void end(b2Contact* contact) override
+  {
+    const auto i = indices.find(contact);
+    if(i == indices.end())
+      return;
+    const std::size_t index = i->second;
+    indices.erase(i);
+    if(index != contacts.size() - 1)
+    {
+      contacts[index] = contacts.back();
+      indices[contacts[index].first] = index;
+    }
+    contacts.pop_back();
+  }
+};
+
+/**
+ * @class ListReporter
+ * Walks the contact list of the world and skips the contacts that began during the step
+ */
+class ListReporter : public ContactReporter
+{
+public:
+  void step(b2World& world) override
+  {
+    newContacts.clear();
+    world.Step(0.01f, 8, 3);
+    const auto start = std::chrono::steady_clock::now();
+    std::sort(newContacts.begin(), newContacts.end());
+    for(b2Contact* contact = world.GetContactList(); contact; contact = contact->GetNext())
+      if(contact->IsTouching() && !std::binary_search(newContacts.begin(), newContacts.end(), contact))
+        report(contact);
+    reportTime += std::chrono::steady_clock::now() - start;
+  }
+
+private:
+  std::vector<b2Contact*> newContacts; /**< The contacts that began during the current step */
+
+  void begin(b2Contact* contact) override
+  {
+    newContacts.push_back(contact);
+    report(contact);
+  }
+};
+
+/**
+ * Fills a world with discs that move in random directions inside a square arena
+ * @param world The world
+ * @param discs The number of discs
+ */
+static void createDiscs(b2World& world, int discs)
+{
+  // The arena is sized so that the discs cover about half of it and collide constantly.
+  constexpr float radius = 0.1f;
+  const float halfSize = std::sqrt(static_cast<float>(discs) * 3.1416f * radius * radius * 2.f) * 0.5f;
+
+  b2BodyDef wallsDef;
+  b2Body* walls = world.CreateBody(&wallsDef);
+  const b2Vec2 corners[] = {{-halfSize, -halfSize}, {halfSize, -halfSize}, {halfSize, halfSize}, {-halfSize, halfSize}};
+  for(int i = 0; i < 4; ++i)
+  {
+    b2EdgeShape edge;
+    edge.SetTwoSided(corners[i], corners[(i + 1) % 4]);
+    walls->CreateFixture(&edge, 0.f);
+  }
+
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> position(-halfSize + radius, halfSize - radius);
+  std::uniform_real_distribution<float> velocity(-2.f, 2.f);
+  b2CircleShape circle;
+  circle.m_radius = radius;
+  b2FixtureDef fixtureDef;
+  fixtureDef.shape = &circle;
+  fixtureDef.density = 1.f;
+  fixtureDef.restitution = 1.f;
+  fixtureDef.friction = 0.f;
+  for(int i = 0; i < discs; ++i)
+  {
+    b2BodyDef bodyDef;
+    bodyDef.type = b2_dynamicBody;
+    bodyDef.position.Set(position(random), position(random));
+    bodyDef.linearVelocity.Set(velocity(random), velocity(random));
+    world.CreateBody(&bodyDef)->CreateFixture(&fixtureDef);
+  }
+}
+
+/**
+ * Simulates the discs and measures the time per step
+ * @param reporter The way collisions are reported
+ * @param discs The number of discs
+ * @param steps The number of steps
+ * @return The milliseconds per step (the time spent after the steps and in the callbacks is in \c reporter.reportTime
+ *         and \c reporter.callbackTime)
+ */
+static double run(ContactReporter& reporter, int discs, int steps)
+{
+  b2World world(b2Vec2_zero);
+  world.SetContactListener(&reporter);
+  createDiscs(world, discs);
+
+  const auto start = std::chrono::steady_clock::now();
+  for(int i = 0; i < steps; ++i)
+    reporter.step(world);
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / steps;
+}
+
+int main(int argc, char* argv[])
+{
+  const int discs = argc > 1 ? std::atoi(argv[1]) : 2000;
+  const int steps = argc > 2 ? std::atoi(argv[2]) : 1000;
+  if(discs <= 0 || steps <= 0)
+  {
+    std::cerr << "Usage: ContactBenchmark [discs [steps]]" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  MapReporter mapReporter;
+  const double mapMilliseconds = run(mapReporter, discs, steps);
+  DenseReporter denseReporter;
+  const double denseMilliseconds = run(denseReporter, discs, steps);
+  ListReporter listReporter;
+  const double listMilliseconds = run(listReporter, discs, steps);
+
+  const auto print = [steps](const char* name, double milliseconds, const ContactReporter& reporter)
+  {
+    std::cout << name << milliseconds << " ms per step, "
+              << std::chrono::duration<double, std::milli>(reporter.callbackTime).count() / steps << " ms of it in callbacks, "
+              << std::chrono::duration<double, std::milli>(reporter.reportTime).count() / steps << " ms after the step\n";
+  };
+  std::cout << discs << " discs, " << steps << " steps, " << listReporter.reports / steps << " reports per step\n";
+  print("hash map:     ", mapMilliseconds, mapReporter);
+  print("dense vector: ", denseMilliseconds, denseReporter);
+  print("contact list: ", listMilliseconds, listReporter);
+  std::cout.flush();
+
+  // All must report the same collisions, since the simulation is deterministic.
+  return mapReporter.reports == listReporter.reports && denseReporter.reports == listReporter.reports ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file ReaderBenchmark.cpp
+ * A benchmark that measures how fast the scene file reader tokenizes a large generated scene with inline meshes.
+ * Usage: ReaderBenchmark [megabytes [file]]
+ */
+
+#include "Parser/Reader.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+/**
+ * @class CountingReader
+ * A reader that only counts what it reads
+ */
+class CountingReader : public Reader
+{
+public:
+  std::size_t elements = 0; /**< The number of elements read */
+  std::size_t textBytes = 0; /**< The number of bytes of text read */
+  std::size_t errors = 0; /**< The number of errors reported */
+
+  bool read(const std::string& fileName)
+  {
+    return readFile(fileName);
+  }
+
+private:
+  void handleError(const std::string& msg, const Location& location) override
+  {
+    std::cerr << fileName << ":" << location.line << ":" << location.column << ": " << msg << std::endl;
+    ++errors;
+  }
+
+  bool handleElement(const std::string&, Attributes& attributes, const Location&) override
+  {
+    elements += 1 + attributes.size();
+    return readElements(true);
+  }
+
+  void handleText(std::string& text, const Location&) override
+  {
+    textBytes += text.size();
+  }
+};
+
+/**
+ * Writes a scene that consists of bodies with inline meshes
+ * @param fileName The name of the file
+ * @param size The approximate size of the file in bytes
+ */
+static void generateScene(const std::string& fileName, std::size_t size)
+{
+  std::ofstream stream(fileName, std::ios::binary);
+  std::mt19937 random(42);
+  std::uniform_real_distribution<float> coordinate(-1.f, 1.f);
+  char buffer[64];
+  stream << "<Simulation>\n  <!-- generated by ReaderBenchmark -->\n  <Scene name=\"Benchmark\" stepLength=\"0.01\">\n";
+  for(int body = 0; static_cast<std::size_t>(stream.tellp()) < size; ++body)
+  {
+    stream << "    <Body name=\"body" << body << "\">\n      <Translation z=\"" << body << "cm\"/>\n";
+    stream << "      <ComplexAppearance name=\"mesh" << body << "\">\n        <Vertices unit=\"mm\">\n";
+    for(int i = 0; i < 1000; ++i)
+    {
+      std::snprintf(buffer, sizeof(buffer), "          %.5f %.5f %.5f\n", coordinate(random), coordinate(random), coordinate(random));
+      stream << buffer;
+    }
+    stream << "        </Vertices>\n        <Triangles>\n";
+    for(int i = 0; i < 998; ++i)
+      stream << "          " << i << " " << i + 1 << " " << i + 2 << "\n";
+    stream << "        </Triangles>\n      </ComplexAppearance>\n    </Body>\n";
+  }
+  stream << "  </Scene>\n</Simulation>\n";
+}
+
+int main(int argc, char* argv[])
+{
+  const std::size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50;
+  const bool generated = argc <= 2;
+  const std::string fileName = generated ? (std::filesystem::temp_directory_path() / "ReaderBenchmark.ros2").string() : argv[2];
+  if(generated)
+    generateScene(fileName, megabytes << 20);
+  const std::size_t fileSize = static_cast<std::size_t>(std::filesystem::file_size(fileName));
+
+  double best = 0.;
+  CountingReader reader;
+  for(int run = 0; run < 5; ++run)
+  {
+    reader = CountingReader();
+    const auto start = std::chrono::steady_clock::now();
+    if(!reader.read(fileName))
+    {
+      std::cerr << "Could not read " << fileName << std::endl;
+      return EXIT_FAILURE;
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if(run == 0 || seconds < best)
+      best = seconds;
+  }
+
+  std::cout << fileSize / 1048576.0 << " MB, " << reader.elements << " elements and attributes, " << reader.textBytes << " bytes of text, " << reader.errors << " errors\n"
+            << "best of 5: " << best * 1000. << " ms (" << fileSize / 1048576.0 / best << " MB/s)" << std::endl;
+
+  if(generated)
+    std::filesystem::remove(fileName);
+  return reader.errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
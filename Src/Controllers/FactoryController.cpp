@@ -68,7 +68,29 @@ public:
   /** Initialization of sensor and actuator ports, states, and positions*/
   bool compile() override
   {
-    // Get all necessary actuator and sensor objects
+    resolveObjects();
+
+    currentState = MEASURING;
+    nextState = MEASURING;
+    startOfWaitingTime = 0.0;
+
+    // Slider target positions:
+    sliderPositions[MEASURING] = 0.02f;
+    sliderPositions[PUSHING_BLOCK1] = 0.35f;
+    sliderPositions[PUSHING_BLOCK2] = 0.60f;
+    sliderPositions[PUSHING_BLOCK3] = 0.90f;
+    return true;
+  }
+
+  /** The objects are resolved again, since bodies might have been instantiated again */
+  bool reload() override {return resolveObjects();}
+
+  /**
+   * Gets all necessary actuator and sensor objects
+   * @return Whether all objects were found
+   */
+  bool resolveObjects()
+  {
     SimRobotCore2::Object* rootObj = static_cast<SimRobotCore2::Object*>(simRobot.resolveObject("Factory", SimRobotCore2::scene));
     QVector<QString> parts;
     parts.resize(1);
@@ -94,16 +116,8 @@ public:
     parts[0] = "trapDoor3Hinge.position";
     trapDoor3Hinge = static_cast<SimRobotCore2::ActuatorPort*>(simRobot.resolveObject(parts, rootObj, SimRobotCore2::actuatorPort));
     simPort = static_cast<SimRobotCore2::Scene*>(simRobot.resolveObject("Factory", SimRobotCore2::scene));
-    currentState = MEASURING;
-    nextState = MEASURING;
-    startOfWaitingTime = 0.0;
-
-    // Slider target positions:
-    sliderPositions[MEASURING] = 0.02f;
-    sliderPositions[PUSHING_BLOCK1] = 0.35f;
-    sliderPositions[PUSHING_BLOCK2] = 0.60f;
-    sliderPositions[PUSHING_BLOCK3] = 0.90f;
-    return true;
+    return distanceSensor1 && distanceSensor2 && distanceSensor3 && sliderActuator && sliderSensor && trapDoor1Bumper &&
+           trapDoor2Bumper && trapDoor3Bumper && trapDoor1Hinge && trapDoor2Hinge && trapDoor3Hinge && simPort;
   }
 
   /** This function becomes called in every execution cycle of the simulation*/
@@ -50,7 +50,24 @@ public:
   /** Initializes objects for interfacing with actuators and sensor */
   bool compile() override
   {
-    // Get all necessary actuator and sensor objects
+    resolveObjects();
+
+    // Init behavior member
+    vehicleState = SEARCH_FOR_BALL;
+    ballFound = false;
+    simRobot.setStatusMessage("Initial search for ball.");
+    return true;
+  }
+
+  /** The objects are resolved again, since bodies might have been instantiated again */
+  bool reload() override {return resolveObjects();}
+
+  /**
+   * Gets all necessary actuator and sensor objects
+   * @return Whether all objects were found
+   */
+  bool resolveObjects()
+  {
     SimRobotCore2::Object* vehicleObj = static_cast<SimRobotCore2::Object*>(simRobot.resolveObject("SimpleVehicle.car", SimRobotCore2::body));
     QVector<QString> parts;
     parts.resize(1);
@@ -64,12 +81,7 @@ public:
     backRightWheel = static_cast<SimRobotCore2::ActuatorPort*>(simRobot.resolveObject(parts, vehicleObj, SimRobotCore2::actuatorPort));
     parts[0] = "image";
     distanceSensor = static_cast<SimRobotCore2::SensorPort*>(simRobot.resolveObject(parts, vehicleObj, SimRobotCore2::sensorPort));
-
-    // Init behavior member
-    vehicleState = SEARCH_FOR_BALL;
-    ballFound = false;
-    simRobot.setStatusMessage("Initial search for ball.");
-    return true;
+    return frontLeftWheel && frontRightWheel && backLeftWheel && backRightWheel && distanceSensor;
   }
 
   /** This function is called in every execution cycle of the simulation*/
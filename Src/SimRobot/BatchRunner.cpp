@@ -0,0 +1,253 @@
+/**
+ * @file SimRobot/BatchRunner.cpp
+ * Implementation of a class that runs several scenes without GUI
+ */
+
+#include "BatchRunner.h"
+#include "MainWindow.h"
+#include "SceneGraphDockWidget.h"
+#include <QFileInfo>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+BatchRunner::BatchRunner(MainWindow& mainWindow) : mainWindow(mainWindow) {}
+
+BatchRunner::~BatchRunner()
+{
+  // Scenes are unloaded in reverse order, like the modules of a scene.
+  while(!scenes.empty())
+    scenes.pop_back();
+}
+
+bool BatchRunner::add(const QString& filePath)
+{
+  if(QFileInfo(filePath).suffix() != "ros2")
+  {
+    std::cerr << "Only .ros2 scenes can be run in a batch: " << filePath.toUtf8().constData() << std::endl;
+    return false;
+  }
+  scenes.emplace_back(std::make_unique<Scene>(mainWindow, filePath));
+  if(scenes.back()->load())
+    return true;
+  scenes.pop_back();
+  return false;
+}
+
+void BatchRunner::run(unsigned int steps, int threads)
+{
+  if(scenes.empty())
+    return;
+
+  if(threads <= 0)
+    threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+  threads = std::min(threads, static_cast<int>(scenes.size()));
+
+  // The calling thread takes part, so only threads - 1 helpers are needed.
+  std::atomic<std::size_t> nextScene = 0;
+  const auto work = [this, steps, &nextScene]
+  {
+    for(std::size_t scene = nextScene++; scene < scenes.size(); scene = nextScene++)
+      scenes[scene]->step(steps);
+  };
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> helpers;
+  for(int i = 1; i < threads; ++i)
+    helpers.emplace_back(work);
+  work();
+  for(std::thread& helper : helpers)
+    helper.join();
+  const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+  for(const std::unique_ptr<Scene>& scene : scenes)
+    std::cout << QString::asprintf("%-50s %10.1f ms %10.1f steps/s\n", scene->getFilePath().toUtf8().constData(), scene->milliseconds,
+                                   scene->milliseconds > 0. ? steps * 1000. / scene->milliseconds : 0.).toUtf8().constData();
+  std::cout << QString::asprintf("%u scenes with %d threads: %.1f ms\n", static_cast<unsigned int>(scenes.size()), threads, milliseconds).toUtf8().constData() << std::flush;
+}
+
+BatchRunner::Scene::Scene(MainWindow& mainWindow, const QString& filePath) : mainWindow(mainWindow), filePath(filePath) {}
+
+BatchRunner::Scene::~Scene()
+{
+  // The modules of this scene must be the current ones of the calling thread while they are deleted.
+  prepareThread();
+  while(!modules.empty())
+  {
+    Module& module = modules.back();
+    delete module.module;
+    module.library->unload();
+    modules.pop_back();
+  }
+}
+
+bool BatchRunner::Scene::load()
+{
+  if(!loadModule("SimRobotCore2"))
+    return false;
+
+  for(std::size_t i = 0; i < modules.size(); ++i) // note: list of modules may grow while compiling modules
+  {
+    modules[i].compiled = modules[i].module->compile();
+    if(!modules[i].compiled)
+      return false;
+  }
+  for(Module& module : modules)
+    module.module->link();
+  return true;
+}
+
+void BatchRunner::Scene::step(unsigned int steps)
+{
+  prepareThread();
+  const auto start = std::chrono::steady_clock::now();
+  for(unsigned int i = 0; i < steps; ++i)
+    for(Module& module : modules)
+    {
+      module.module->update();
+      for(int item = 0, count = module.module->getWorkItemCount(); item < count; ++item)
+        module.module->updateWorkItem(item);
+    }
+  milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void BatchRunner::Scene::prepareThread()
+{
+  for(Module& module : modules)
+    module.module->prepareWorkerThread();
+}
+
+BatchRunner::Scene::Object* BatchRunner::Scene::findObject(const SimRobot::Object* object) const
+{
+  const auto entry = objects.find(object);
+  return entry != objects.end() ? entry->second.get() : nullptr;
+}
+
+bool BatchRunner::Scene::registerObject(const SimRobot::Module&, SimRobot::Object& object, const SimRobot::Object* parent, int)
+{
+  Object* parentObject = findObject(parent);
+  if(parent && !parentObject)
+    return false;
+  Object& newObject = *(objects[&object] = std::make_unique<Object>(Object{&object, parentObject, {}}));
+  if(parentObject)
+    parentObject->children.append(&newObject);
+  objectsByName.insert(object.getFullName(), &newObject);
+  return true;
+}
+
+bool BatchRunner::Scene::unregisterObject(const SimRobot::Object& object)
+{
+  Object* entry = findObject(&object);
+  if(!entry)
+    return false;
+
+  // Children are unregistered with their parent.
+  while(!entry->children.isEmpty())
+    unregisterObject(*entry->children.back()->object);
+  if(entry->parent)
+    entry->parent->children.removeOne(entry);
+  objectsByName.remove(object.getFullName(), entry);
+  objects.erase(&object);
+  return true;
+}
+
+SimRobot::Object* BatchRunner::Scene::resolveObject(const QString& fullName, int kind)
+{
+  for(auto [i, end] = objectsByName.equal_range(fullName); i != end; ++i)
+    if(!kind || (*i)->object->getKind() == kind)
+      return (*i)->object;
+  return nullptr;
+}
+
+SimRobot::Object* BatchRunner::Scene::resolveObject(const QVector<QString>& parts, const SimRobot::Object* parent, int kind)
+{
+  if(parts.isEmpty())
+    return nullptr;
+
+  // Like in the scene graph, every part must match whole components of the name of an ancestor.
+  for(const auto& [key, object] : objects)
+  {
+    if((kind && object->object->getKind() != kind) || !SceneGraphDockWidget::endsWithComponents(object->object->getFullName(), parts.back()))
+      continue;
+    const Object* currentObject = object.get();
+    for(auto i = parts.count() - 2; i >= 0 && currentObject; --i)
+      for(currentObject = currentObject->parent;
+          currentObject && !SceneGraphDockWidget::endsWithComponents(currentObject->object->getFullName(), parts.at(i));
+          currentObject = currentObject->parent);
+    if(!currentObject)
+      continue;
+    if(parent)
+    {
+      for(currentObject = currentObject->parent; currentObject && currentObject->object != parent; currentObject = currentObject->parent);
+      if(!currentObject)
+        continue;
+    }
+    return object->object;
+  }
+  return nullptr;
+}
+
+int BatchRunner::Scene::getObjectChildCount(const SimRobot::Object& object)
+{
+  const Object* entry = findObject(&object);
+  return entry ? static_cast<int>(entry->children.count()) : 0;
+}
+
+SimRobot::Object* BatchRunner::Scene::getObjectChild(const SimRobot::Object& object, int index)
+{
+  const Object* entry = findObject(&object);
+  return entry && index >= 0 && index < entry->children.count() ? entry->children.at(index)->object : nullptr;
+}
+
+bool BatchRunner::Scene::addStatusLabel(const SimRobot::Module&, SimRobot::StatusLabel* statusLabel)
+{
+  // There is no status bar that would take the ownership.
+  delete statusLabel;
+  return true;
+}
+
+bool BatchRunner::Scene::registerModule(const SimRobot::Module&, const QString&, const QString&, int)
+{
+  return true;
+}
+
+bool BatchRunner::Scene::loadModule(const QString& name)
+{
+  for(const Module& module : modules)
+    if(module.name == name)
+      return true; // already loaded
+
+  Module module{name, std::make_unique<QLibrary>(mainWindow.getModuleFileName(name))};
+  using CreateModuleProc = SimRobot::Module* (*)(SimRobot::Application&);
+  const auto createModule = reinterpret_cast<CreateModuleProc>(module.library->resolve("createModule"));
+  if(!createModule)
+  {
+    showWarning("SimRobot", module.library->errorString());
+    module.library->unload();
+    return false;
+  }
+  module.module = createModule(*this);
+  modules.emplace_back(std::move(module));
+  return true;
+}
+
+void BatchRunner::Scene::showWarning(const QString& title, const QString& message)
+{
+  std::cerr << title.toUtf8().constData() << " (" << filePath.toUtf8().constData() << "): " << message.toUtf8().constData() << std::endl;
+}
+
+const QString& BatchRunner::Scene::getAppPath() const
+{
+  return static_cast<SimRobot::Application&>(mainWindow).getAppPath();
+}
+
+QSettings& BatchRunner::Scene::getSettings()
+{
+  return static_cast<SimRobot::Application&>(mainWindow).getSettings();
+}
+
+QSettings& BatchRunner::Scene::getLayoutSettings()
+{
+  return static_cast<SimRobot::Application&>(mainWindow).getLayoutSettings();
+}
@@ -0,0 +1,152 @@
+/**
+ * @file SimRobot/BatchRunner.h
+ * Declaration of a class that runs several scenes without GUI
+ */
+
+#pragma once
+
+#include <QLibrary>
+#include <QList>
+#include <QMultiHash>
+#include <QString>
+#include <QStringList>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "SimRobot.h"
+
+class MainWindow;
+
+/**
+ * @class BatchRunner
+ * Runs several scenes (e.g. variants of a scene for a parameter sweep) in one process without GUI.
+ * Every scene gets its own instances of the core module and of its controller, which see the scene through their own
+ * \c SimRobot::Application. The scenes are loaded on the GUI thread, since the cores create their offscreen renderers
+ * there, and then each scene is stepped by one of several threads.
+ */
+class BatchRunner
+{
+public:
+  /**
+   * Constructor
+   * @param mainWindow The (hidden) main window, which provides the settings and locates the modules
+   */
+  explicit BatchRunner(MainWindow& mainWindow);
+
+  /** Destructor. Unloads all scenes. */
+  ~BatchRunner();
+
+  /**
+   * Loads a scene with its controller. Must be called on the GUI thread.
+   * @param filePath The path of the scene file
+   * @return Whether the scene was loaded
+   */
+  bool add(const QString& filePath);
+
+  /**
+   * Steps all scenes a number of times and prints how long each scene took. Returns when all scenes are done.
+   * Controllers that read sensors that render images must be run with a single thread, because only the GUI thread
+   * can use the offscreen renderers.
+   * @param steps The number of simulation steps per scene
+   * @param threads The number of threads that step scenes (including the calling thread, 0 means one per hardware thread)
+   */
+  void run(unsigned int steps, int threads = 0);
+
+private:
+  /** A scene that is run, together with the modules that simulate and control it */
+  class Scene : public SimRobot::Application
+  {
+  public:
+    double milliseconds = 0.; /**< The (real) time it took to step the scene */
+
+    /**
+     * Constructor
+     * @param mainWindow The main window, which provides the settings and locates the modules
+     * @param filePath The path of the scene file
+     */
+    Scene(MainWindow& mainWindow, const QString& filePath);
+
+    /** Destructor. Unloads all modules in reverse order. */
+    ~Scene();
+
+    /**
+     * Loads and compiles the modules of the scene
+     * @return Whether all modules were compiled
+     */
+    bool load();
+
+    /**
+     * Steps the scene a number of times
+     * @param steps The number of simulation steps
+     */
+    void step(unsigned int steps);
+
+    const QString& getFilePath() const override {return filePath;}
+
+  private:
+    /** A loaded module */
+    struct Module
+    {
+      QString name; /**< The name of the module */
+      std::unique_ptr<QLibrary> library; /**< The library that contains the module */
+      SimRobot::Module* module = nullptr; /**< The instance of the module */
+      bool compiled = false; /**< Whether the module was compiled */
+    };
+
+    /** A registered object */
+    struct Object
+    {
+      SimRobot::Object* object; /**< The object */
+      Object* parent; /**< The registered parent (\c nullptr for top-level objects) */
+      QList<Object*> children; /**< The registered children */
+    };
+
+    MainWindow& mainWindow; /**< The main window, which provides the settings and locates the modules */
+    QString filePath; /**< The path of the scene file */
+    std::vector<Module> modules; /**< The loaded modules in the order they were loaded */
+    std::unordered_map<const SimRobot::Object*, std::unique_ptr<Object>> objects; /**< All registered objects */
+    QMultiHash<QString, Object*> objectsByName; /**< All registered objects by their full names */
+
+    /**
+     * Calls \c prepareWorkerThread of all modules, which makes this scene the one the calling thread works on
+     */
+    void prepareThread();
+
+    /**
+     * Looks up a registered object
+     * @param object The object
+     * @return The entry of the object or \c nullptr if it is not registered
+     */
+    Object* findObject(const SimRobot::Object* object) const;
+
+    // SimRobot::Application
+    bool registerObject(const SimRobot::Module& module, SimRobot::Object& object, const SimRobot::Object* parent, int flags) override;
+    bool unregisterObject(const SimRobot::Object& object) override;
+    SimRobot::Object* resolveObject(const QString& fullName, int kind) override;
+    SimRobot::Object* resolveObject(const QVector<QString>& parts, const SimRobot::Object* parent, int kind) override;
+    int getObjectChildCount(const SimRobot::Object& object) override;
+    SimRobot::Object* getObjectChild(const SimRobot::Object& object, int index) override;
+    bool addStatusLabel(const SimRobot::Module& module, SimRobot::StatusLabel* statusLabel) override;
+    bool registerModule(const SimRobot::Module& module, const QString& displayName, const QString& name, int flags) override;
+    bool loadModule(const QString& name) override;
+    bool openObject(const SimRobot::Object&) override {return false;}
+    bool closeObject(const SimRobot::Object&) override {return false;}
+    bool selectObject(const SimRobot::Object&) override {return false;}
+    void showWarning(const QString& title, const QString& message) override;
+    void setStatusMessage(const QString&) override {}
+    void addLoadPhase(const QString&, double) override {}
+    const QString& getAppPath() const override;
+    QSettings& getSettings() override;
+    QSettings& getLayoutSettings() override;
+    bool isSimRunning() override {return true;}
+    void simReset() override {}
+    void simReload() override {}
+    void simStart() override {}
+    void simStep() override {}
+    void simStop() override {}
+  };
+
+  MainWindow& mainWindow; /**< The main window, which provides the settings and locates the modules */
+  std::vector<std::unique_ptr<Scene>> scenes; /**< The loaded scenes */
+};
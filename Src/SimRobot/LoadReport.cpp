@@ -0,0 +1,56 @@
+/**
+ * @file SimRobot/LoadReport.cpp
+ * Implementation of a class that records how long the phases of opening or resetting a scene take
+ */
+
+#include "LoadReport.h"
+
+void LoadReport::start(const QString& title)
+{
+  this->title = title;
+  phases.clear();
+  runningPhases.clear();
+  total = 0.;
+  running = true;
+  timer.start();
+}
+
+void LoadReport::begin(const QString& name)
+{
+  if(!running)
+    return;
+  runningPhases.append(QPair<int, qint64>(static_cast<int>(phases.size()), timer.nsecsElapsed()));
+  phases.append({name, static_cast<int>(runningPhases.size()) - 1});
+}
+
+void LoadReport::end()
+{
+  if(!running || runningPhases.isEmpty())
+    return;
+  const QPair<int, qint64> phase = runningPhases.takeLast();
+  phases[phase.first].milliseconds = static_cast<double>(timer.nsecsElapsed() - phase.second) / 1e6;
+}
+
+void LoadReport::add(const QString& name, double milliseconds)
+{
+  if(running)
+    phases.append({name, static_cast<int>(runningPhases.size()), milliseconds});
+}
+
+void LoadReport::finish()
+{
+  if(!running)
+    return;
+  while(!runningPhases.isEmpty())
+    end();
+  total = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+  running = false;
+}
+
+QString LoadReport::toString() const
+{
+  QString text = QString::asprintf("%s: %.1f ms\n", title.toUtf8().constData(), total);
+  for(const Phase& phase : phases)
+    text += QString::asprintf("%*s%-*s %9.1f ms\n", 2 + phase.depth * 2, "", 40 - phase.depth * 2, phase.name.toUtf8().constData(), phase.milliseconds);
+  return text;
+}
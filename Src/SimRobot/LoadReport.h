@@ -0,0 +1,77 @@
+/**
+ * @file SimRobot/LoadReport.h
+ * Declaration of a class that records how long the phases of opening or resetting a scene take
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+
+/**
+ * @class LoadReport
+ * The durations of the (nested) phases of opening or resetting a scene
+ */
+class LoadReport
+{
+public:
+  /** A phase of loading */
+  struct Phase
+  {
+    QString name; /**< The name of the phase */
+    int depth; /**< The nesting depth of the phase (0 for top-level phases) */
+    double milliseconds = 0.; /**< The duration of the phase */
+  };
+
+  /**
+   * Starts a new report
+   * @param title The title of the report (e.g. what is loaded)
+   */
+  void start(const QString& title);
+
+  /**
+   * Begins a phase nested in the phase that is currently running (if any).
+   * Does nothing if no report was started.
+   * @param name The name of the phase
+   */
+  void begin(const QString& name);
+
+  /** Ends the phase that was begun last */
+  void end();
+
+  /**
+   * Adds a phase that was measured by someone else, nested in the phase that is currently running (if any).
+   * Does nothing if no report was started.
+   * @param name The name of the phase
+   * @param milliseconds The duration of the phase
+   */
+  void add(const QString& name, double milliseconds);
+
+  /** Ends all phases and the report */
+  void finish();
+
+  /**
+   * Whether a report was started and not finished yet
+   * @return Whether it is running
+   */
+  bool isRunning() const {return running;}
+
+  const QString& getTitle() const {return title;}
+  const QList<Phase>& getPhases() const {return phases;}
+  double getTotal() const {return total;}
+
+  /**
+   * Formats the report as text (one line per phase, nested phases are indented)
+   * @return The text
+   */
+  QString toString() const;
+
+private:
+  QString title; /**< The title of the report */
+  QList<Phase> phases; /**< The phases in the order in which they began */
+  QList<QPair<int, qint64>> runningPhases; /**< The indices of the phases that are currently running and the times when they began (in ns) */
+  QElapsedTimer timer; /**< The timer measuring since the report was started */
+  double total = 0.; /**< The duration of the whole report in ms */
+  bool running = false; /**< Whether a report was started and not finished yet */
+};
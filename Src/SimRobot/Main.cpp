@@ -6,6 +6,10 @@
 
 #include <QApplication>
 #include <QSurfaceFormat>
+#include <QTimer>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 extern void qt_registerDefaultPlatformBackingStoreOpenGLSupport();
 
@@ -117,16 +121,49 @@ int main(int argc, char* argv[])
 #endif
 
   // open file from commandline
+  // "-benchmark <iterations> <file>" opens, resets and closes the file repeatedly and quits
+  // "-batch <steps> [-threads <n>] <file>..." steps all files without showing them and quits
+  // "-nocache" does not use or create scene caches (e.g. to benchmark loading scenes from scratch)
+  int benchmarkIterations = 0;
+  int batchSteps = 0;
+  int batchThreads = 0;
+  const char* file = nullptr;
+  QStringList batchFiles;
   for(int i = 1; i < argc; i++)
-    if(*argv[i] != '-' && strcmp(argv[i], "YES"))
+    if(!strcmp(argv[i], "-benchmark") && i + 1 < argc)
+      benchmarkIterations = std::max(std::atoi(argv[++i]), 1);
+    else if(!strcmp(argv[i], "-batch") && i + 1 < argc)
+      batchSteps = std::max(std::atoi(argv[++i]), 1);
+    else if(!strcmp(argv[i], "-threads") && i + 1 < argc)
+      batchThreads = std::max(std::atoi(argv[++i]), 0);
+    else if(!strcmp(argv[i], "-nocache"))
+      qputenv("SIMROBOT_NO_SCENE_CACHE", "1");
+    else if(*argv[i] != '-' && strcmp(argv[i], "YES"))
     {
-      mainWindow.openFile(argv[i]);
-      break;
+      batchFiles.append(argv[i]);
+      if(!file)
+        file = argv[i];
     }
+  if(batchSteps)
+  {
+    if(batchFiles.isEmpty())
+      return 1;
+    QTimer::singleShot(0, &mainWindow, [&]{app.exit(mainWindow.runBatch(batchFiles, batchSteps, batchThreads));});
+    return app.exec();
+  }
+  if(file && !benchmarkIterations)
+    mainWindow.openFile(file);
 
 #ifndef MACOS
   mainWindow.show();
 #endif
 
+  if(benchmarkIterations)
+  {
+    if(!file)
+      return 1;
+    QTimer::singleShot(0, &mainWindow, [&]{app.exit(mainWindow.runLoadBenchmark(file, benchmarkIterations));});
+  }
+
   return app.exec();
 }
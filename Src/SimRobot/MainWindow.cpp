@@ -5,6 +5,7 @@
  */
 
 #include "MainWindow.h"
+#include "BatchRunner.h"
 #include "SceneGraphDockWidget.h"
 #include "RegisteredDockWidget.h"
 #include "StatusBar.h"
@@ -23,6 +24,7 @@
 #include <QCloseEvent>
 #include <QUrl>
 #include <QTimer>
+#include <QElapsedTimer>
 #ifdef WINDOWS
 #include <Windows.h>
 #elif defined MACOS
@@ -30,7 +32,12 @@
 #else
 #include <ctime>
 #endif
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iostream>
+#include <latch>
+#include <vector>
 
 #define QDOCKWIDGET_STYLE ""
 #define QDOCKWIDGET_STYLE_FOCUS "QDockWidget {font-weight: bold;}"
@@ -90,6 +97,12 @@ MainWindow::MainWindow(int, char* argv[]) :
   simResetAct->setEnabled(false);
   connect(simResetAct, &QAction::triggered, this, &MainWindow::simReset);
 
+  simReloadAct = new QAction(tr("Re&load"), this);
+  simReloadAct->setStatusTip(tr("Apply changes of the scene file without resetting the simulation (if possible)"));
+  simReloadAct->setShortcut(QKeySequence(static_cast<int>(Qt::CTRL) + static_cast<int>(Qt::Key_F5)));
+  simReloadAct->setEnabled(false);
+  connect(simReloadAct, &QAction::triggered, this, &MainWindow::simReload);
+
   simStartAct = new QAction(QIcon(":/Icons/control_play_blue.png"), tr("&Start"), this);
   simStartAct->setStatusTip(tr("Start or stop the simulation"));
   simStartAct->setShortcut(QKeySequence(Qt::Key_F5));
@@ -208,8 +221,8 @@ unsigned int MainWindow::getSystemTime()
 
 bool MainWindow::registerObject(const SimRobot::Module& module, SimRobot::Object& object, const SimRobot::Object* parent, int flags)
 {
-  if(sceneGraphDockWidget)
-    sceneGraphDockWidget->registerObject(&module, &object, parent, flags);
+  if(sceneGraphDockWidget && !sceneGraphDockWidget->registerObject(&module, &object, parent, flags))
+    return false;
 
   RegisteredDockWidget* dockWidget = openedObjectsByName.value(object.getFullName());
   if(dockWidget && !dockWidget->hasWidget())
@@ -237,6 +250,20 @@ bool MainWindow::registerObject(const SimRobot::Module& module, SimRobot::Object
 
 bool MainWindow::unregisterObject(const SimRobot::Object& object)
 {
+  // The widgets of the object and its children are deleted, but their dock widgets stay open, so they show the new
+  // objects if objects with the same names are registered again (e.g. when parts of the scene are reloaded).
+  const QString& fullName = object.getFullName();
+  const QString prefix = fullName + ".";
+  bool activeDockWidgetChanged = false;
+  for(auto i = openedObjectsByName.begin(), end = openedObjectsByName.end(); i != end; ++i)
+    if((*i)->hasWidget() && (i.key() == fullName || i.key().startsWith(prefix)))
+    {
+      (*i)->setWidget(0, 0, 0, 0);
+      activeDockWidgetChanged |= *i == activeDockWidget;
+    }
+  if(activeDockWidgetChanged)
+    updateMenuAndToolBar();
+
   return sceneGraphDockWidget ? sceneGraphDockWidget->unregisterObject(&object) : false;
 }
 
@@ -314,6 +341,18 @@ void MainWindow::setStatusMessage(const QString& message)
   statusBar->setUserMessage(message);
 }
 
+void MainWindow::addLoadPhase(const QString& name, double milliseconds)
+{
+  loadReport.add(name, milliseconds);
+}
+
+void MainWindow::finishLoadReport()
+{
+  loadReport.finish();
+  if(!benchmarking)
+    std::cout << loadReport.toString().toUtf8().constData() << std::flush;
+}
+
 void MainWindow::closeEvent(QCloseEvent* event)
 {
   if(!closeFile())
@@ -328,7 +367,10 @@ void MainWindow::closeEvent(QCloseEvent* event)
 void MainWindow::timerEvent(QTimerEvent* event)
 {
   for(LoadedModule* loadedModule : loadedModules)
+  {
     loadedModule->module->update();
+    updateWorkItems(*loadedModule->module);
+  }
 
   // update gui
   const unsigned int now = getSystemTime();
@@ -349,6 +391,39 @@ void MainWindow::timerEvent(QTimerEvent* event)
   }
 }
 
+void MainWindow::updateWorkItems(SimRobot::Module& module)
+{
+  const int count = module.getWorkItemCount();
+  if(count <= 0)
+    return;
+
+  // the calling thread takes part, so only count - 1 helpers are needed at most
+  std::atomic<int> nextItem = 0;
+  const auto work = [&module, &nextItem, count]
+  {
+    for(int item = nextItem++; item < count; item = nextItem++)
+      module.updateWorkItem(item);
+  };
+  const int helpers = std::min(count, workItemPool.maxThreadCount()) - 1;
+  std::latch done(std::max(helpers, 0));
+  for(int i = 0; i < helpers; ++i)
+    workItemPool.start([this, &work, &done]
+    {
+      // The pool keeps its threads, so they are only prepared once for the current set of modules.
+      thread_local unsigned int preparedModulesGeneration = 0;
+      if(preparedModulesGeneration != modulesGeneration)
+      {
+        for(LoadedModule* loadedModule : loadedModules)
+          loadedModule->module->prepareWorkerThread();
+        preparedModulesGeneration = modulesGeneration;
+      }
+      work();
+      done.count_down();
+    });
+  work();
+  done.wait();
+}
+
 void MainWindow::dragEnterEvent(QDragEnterEvent* event)
 {
   if(event->mimeData()->hasUrls())
@@ -432,15 +507,8 @@ bool MainWindow::loadModule(const QString& name, bool manually)
       flags = i->flags;
   }
 
-#ifdef WINDOWS
-  const QString& moduleName = name;
-#elif defined MACOS
-  QString moduleName = QFileInfo(application->getAppPath()).dir().path() + "/../lib/" + name;
-#else
-  QString moduleName = QFileInfo(appPath).path() + "/lib" + name + ".so";
-#endif
   {
-    LoadedModule* loadedModule = new LoadedModule(moduleName, flags);
+    LoadedModule* loadedModule = new LoadedModule(name, getModuleFileName(name), flags);
     loadedModule->createModule = reinterpret_cast<LoadedModule::CreateModuleProc>(loadedModule->resolve("createModule"));
     if(!loadedModule->createModule)
     {
@@ -466,6 +534,7 @@ bool MainWindow::loadModule(const QString& name, bool manually)
       manuallyLoadedModules.append(name);
     }
     loadedModules.append(loadedModule);
+    ++modulesGeneration;
   }
 
   // relink modules
@@ -478,6 +547,17 @@ bool MainWindow::loadModule(const QString& name, bool manually)
   return true;
 }
 
+QString MainWindow::getModuleFileName(const QString& name) const
+{
+#ifdef WINDOWS
+  return name;
+#elif defined MACOS
+  return QFileInfo(appPath).dir().path() + "/../lib/" + name;
+#else
+  return QFileInfo(appPath).path() + "/lib" + name + ".so";
+#endif
+}
+
 void MainWindow::unloadModule(const QString& name)
 {
   LoadedModule* loadedModule = loadedModulesByName.value(name);
@@ -513,6 +593,7 @@ void MainWindow::unloadModule(const QString& name)
   loadedModule->unload();
   delete loadedModule;
   loadedModules.removeOne(loadedModule);
+  ++modulesGeneration;
   loadedModulesByName.remove(name);
   manuallyLoadedModules.removeOne(name);
 
@@ -532,7 +613,9 @@ bool MainWindow::compileModules()
     LoadedModule* loadedModule = loadedModules[i];
     if(!loadedModule->compiled)
     {
+      loadReport.begin("compile " + loadedModule->name);
       loadedModule->compiled = loadedModule->module->compile();
+      loadReport.end();
       if(!loadedModule->compiled)
         success = false;
     }
@@ -543,8 +626,10 @@ bool MainWindow::compileModules()
   compiled = true;
 
   // link modules
+  loadReport.begin("link modules");
   for(LoadedModule* loadedModule : loadedModules)
     loadedModule->module->link();
+  loadReport.end();
   return true;
 }
 
@@ -706,6 +791,7 @@ QMenu* MainWindow::createSimMenu()
   QMenu* simMenu = new QMenu(tr("&Simulation"), this);
   simMenu->addAction(simStartAct);
   simMenu->addAction(simResetAct);
+  simMenu->addAction(simReloadAct);
   simMenu->addAction(simStepAct);
   return simMenu;
 }
@@ -806,19 +892,25 @@ void MainWindow::open()
 
 void MainWindow::openFile(const QString& fileName)
 {
+  loadReport.start(tr("Open %1").arg(fileName));
+  loadReport.begin("close previous file");
   closeFile();
+  loadReport.end();
 
   // get full file path
   QFileInfo fileInfo(fileName);
   filePath = fileInfo.absoluteDir().canonicalPath() + '/' + fileInfo.fileName();
 
-  // remove file path from recent file list
-  recentFiles.removeAll(filePath);
+  // remove file path from recent file list (unless benchmarking, which must not change the settings)
+  if(!benchmarking)
+    recentFiles.removeAll(filePath);
 
   // check if file exists
   if(!fileInfo.exists())
   {
-    settings.setValue("RecentFiles", recentFiles);
+    if(!benchmarking)
+      settings.setValue("RecentFiles", recentFiles);
+    loadReport.finish();
     QMessageBox::warning(this, tr("SimRobot"), tr("Cannot open file %1.").arg(fileName));
     return;
   }
@@ -826,16 +918,20 @@ void MainWindow::openFile(const QString& fileName)
 
   // add file path to recent file list
   const QString& baseName = fileInfo.baseName();
-  recentFiles.prepend(filePath);
-  while(recentFiles.count() > 8)
-    recentFiles.removeLast();
-  settings.setValue("RecentFiles", recentFiles);
+  if(!benchmarking)
+  {
+    recentFiles.prepend(filePath);
+    while(recentFiles.count() > 8)
+      recentFiles.removeLast();
+    settings.setValue("RecentFiles", recentFiles);
+  }
   setWindowTitle(baseName + " - " + tr("SimRobot"));
 
   // open layout settings
   layoutSettings.beginGroup(baseName);
 
   // create scene graph window
+  loadReport.begin("restore layout");
   sceneGraphDockWidget = new SceneGraphDockWidget(createSimMenu(), this);
   sceneGraphDockWidget->setStyleSheet(QDOCKWIDGET_STYLE);
   connect(sceneGraphDockWidget, &SceneGraphDockWidget::visibilityChanged, this, &MainWindow::visibilityChanged);
@@ -857,9 +953,11 @@ void MainWindow::openFile(const QString& fileName)
   guiUpdateRate = layoutSettings.value("GuiUpdateRate", -1).toInt();
   if(guiUpdateRate < 0)
     guiUpdateRate = 100;
+  loadReport.end();
 
   // load core module
   Q_ASSERT(!compiled);
+  loadReport.begin("load modules");
   loadModule(fileInfo.suffix() == "ros2d" ? "SimRobotCore2D" : "SimRobotCore2");
 
   for(int i = 0; i < manuallyLoadedModules.size();)
@@ -867,6 +965,7 @@ void MainWindow::openFile(const QString& fileName)
       ++i;
     else
       manuallyLoadedModules.removeAt(i);
+  loadReport.end();
 
   compileModules();
 
@@ -889,14 +988,140 @@ void MainWindow::openFile(const QString& fileName)
   // gui update
   fileCloseAct->setEnabled(true);
   simResetAct->setEnabled(true);
+  simReloadAct->setEnabled(true);
   simStartAct->setEnabled(true);
   simStepAct->setEnabled(true);
 
+  finishLoadReport();
+
   // start simulation
   if(compiled && layoutSettings.value("Run", true).toBool())
     simStart();
 }
 
+int MainWindow::runLoadBenchmark(const QString& fileName, int iterations)
+{
+  /** The durations of a phase in all iterations */
+  struct Samples
+  {
+    QString name;
+    int depth;
+    std::vector<double> milliseconds;
+  };
+
+  const auto addReport = [](QList<Samples>& samples, const LoadReport& report)
+  {
+    if(samples.isEmpty())
+      for(const LoadReport::Phase& phase : report.getPhases())
+        samples.append({phase.name, phase.depth + 1, {}});
+    // Phases that did not occur in the first iteration are ignored.
+    for(int i = 0, j = 0; i < static_cast<int>(report.getPhases().size()) && j < static_cast<int>(samples.size()); ++i)
+      if(report.getPhases()[i].name == samples[j].name && report.getPhases()[i].depth + 1 == samples[j].depth)
+        samples[j++].milliseconds.push_back(report.getPhases()[i].milliseconds);
+  };
+
+  const auto percentile = [](std::vector<double> values, double p)
+  {
+    if(values.empty())
+      return 0.;
+    std::sort(values.begin(), values.end());
+    const std::size_t rank = static_cast<std::size_t>(std::ceil(p / 100. * static_cast<double>(values.size())));
+    return values[std::min(std::max(rank, std::size_t(1)), values.size()) - 1];
+  };
+
+  // Settings that views and modules store while the scene is opened and closed are restored afterwards.
+  const auto saveSettings = [](const QSettings& settings)
+  {
+    QList<std::pair<QString, QVariant>> values;
+    for(const QString& key : settings.allKeys())
+      values.append({key, settings.value(key)});
+    return values;
+  };
+  const auto restoreSettings = [](QSettings& settings, const QList<std::pair<QString, QVariant>>& values)
+  {
+    settings.clear();
+    for(const auto& [key, value] : values)
+      settings.setValue(key, value);
+    settings.sync();
+  };
+  const QList<std::pair<QString, QVariant>> savedSettings = saveSettings(settings);
+  const QList<std::pair<QString, QVariant>> savedLayoutSettings = saveSettings(layoutSettings);
+  const auto finishBenchmark = [&]
+  {
+    benchmarking = false;
+    restoreSettings(settings, savedSettings);
+    restoreSettings(layoutSettings, savedLayoutSettings);
+  };
+
+  benchmarking = true;
+  Samples openSamples = {tr("open"), 0, {}};
+  Samples resetSamples = {tr("reset"), 0, {}};
+  Samples closeSamples = {tr("close"), 0, {}};
+  QList<Samples> openPhaseSamples;
+  QList<Samples> resetPhaseSamples;
+  QElapsedTimer timer;
+  for(int i = 0; i < iterations; ++i)
+  {
+    // The events are processed so that the views are created and drawn as well.
+    timer.start();
+    openFile(fileName);
+    QApplication::processEvents();
+    openSamples.milliseconds.push_back(static_cast<double>(timer.nsecsElapsed()) / 1e6);
+    if(!compiled)
+    {
+      finishBenchmark();
+      std::cerr << "Cannot load " << fileName.toUtf8().constData() << std::endl;
+      return 1;
+    }
+    addReport(openPhaseSamples, loadReport);
+
+    timer.start();
+    simReset();
+    QApplication::processEvents();
+    resetSamples.milliseconds.push_back(static_cast<double>(timer.nsecsElapsed()) / 1e6);
+    addReport(resetPhaseSamples, loadReport);
+
+    timer.start();
+    closeFile();
+    QApplication::processEvents();
+    closeSamples.milliseconds.push_back(static_cast<double>(timer.nsecsElapsed()) / 1e6);
+  }
+  finishBenchmark();
+
+  // The first iteration is reported separately, because it creates the scene cache (unless it already exists) and
+  // warms up the file system caches. The percentiles only cover the other iterations.
+  std::cout << QString::asprintf("%-42s %9s %9s %9s %9s %9s\n", "Phase (ms)", "first", "min", "median", "p90", "max").toUtf8().constData();
+  const auto print = [&percentile](const Samples& samples)
+  {
+    const std::vector<double> later = samples.milliseconds.size() > 1 ? std::vector<double>(samples.milliseconds.begin() + 1, samples.milliseconds.end()) : samples.milliseconds;
+    std::cout << QString::asprintf("%*s%-*s %9.1f %9.1f %9.1f %9.1f %9.1f\n", samples.depth * 2, "", 42 - samples.depth * 2, samples.name.toUtf8().constData(),
+                                   samples.milliseconds.empty() ? 0. : samples.milliseconds.front(),
+                                   percentile(later, 0.), percentile(later, 50.), percentile(later, 90.), percentile(later, 100.)).toUtf8().constData();
+  };
+  print(openSamples);
+  for(const Samples& samples : openPhaseSamples)
+    print(samples);
+  print(resetSamples);
+  for(const Samples& samples : resetPhaseSamples)
+    print(samples);
+  print(closeSamples);
+  std::cout << std::flush;
+  return 0;
+}
+
+int MainWindow::runBatch(const QStringList& fileNames, unsigned int steps, int threads)
+{
+  BatchRunner batchRunner(*this);
+  for(const QString& fileName : fileNames)
+    if(!batchRunner.add(fileName))
+    {
+      std::cerr << "Cannot load " << fileName.toUtf8().constData() << std::endl;
+      return 1;
+    }
+  batchRunner.run(steps, threads);
+  return 0;
+}
+
 void MainWindow::unlockLayout()
 {
   for(QMap<QString, RegisteredDockWidget*>::iterator it = openedObjectsByName.begin(), end = openedObjectsByName.end(); it != end; ++it)
@@ -920,8 +1145,8 @@ bool MainWindow::closeFile()
   filePath.clear();
   layoutRestored = false;
 
-  // save layout
-  if(wasOpened)
+  // save layout (unless benchmarking, so that every iteration starts with the same layout)
+  if(wasOpened && !benchmarking)
   {
     layoutSettings.setValue("Geometry", saveGeometry());
     layoutSettings.setValue("WindowState", saveState());
@@ -941,6 +1166,7 @@ bool MainWindow::closeFile()
   setFocus();
 
   // close opened windows
+  loadReport.begin("close views");
   if(sceneGraphDockWidget)
   {
     delete sceneGraphDockWidget;
@@ -950,12 +1176,14 @@ bool MainWindow::closeFile()
     delete dockWidget;
   openedObjects.clear();
   openedObjectsByName.clear();
+  loadReport.end();
 
   // remove registered status labels and modules
   statusBar->removeAllLabels();
   registeredModules.clear();
 
   // unload all modules in reverse order
+  loadReport.begin("unload modules");
   for(auto loadedModule = loadedModules.rbegin(); loadedModule != loadedModules.rend(); ++loadedModule)
   {
     delete (*loadedModule)->module;
@@ -963,9 +1191,11 @@ bool MainWindow::closeFile()
     delete *loadedModule;
   }
   loadedModules.clear();
+  ++modulesGeneration;
   loadedModulesByName.clear();
   manuallyLoadedModules.clear();
   registeredModules.clear();
+  loadReport.end();
 
   //
   if(wasOpened)
@@ -976,6 +1206,7 @@ bool MainWindow::closeFile()
   {
     fileCloseAct->setEnabled(false);
     simResetAct->setEnabled(false);
+    simReloadAct->setEnabled(false);
     simStartAct->setEnabled(false);
     simStepAct->setEnabled(false);
     viewUpdateRateMenu->setEnabled(false);
@@ -996,6 +1227,7 @@ void MainWindow::simReset()
       return;
 
   // start resetting
+  loadReport.start(tr("Reset %1").arg(filePath));
   QString openedFilePath = filePath;
   const bool wasRunning = running || !compiled;
   QString activeObject;
@@ -1014,6 +1246,7 @@ void MainWindow::simReset()
   setFocus();
 
   // remove all registered status labels and modules and most registered objects
+  loadReport.begin("close views");
   QSet<const SimRobot::Module*> ignoredModules;
   if(sceneGraphDockWidget)
     for(LoadedModule* loadedModule : loadedModules)
@@ -1034,8 +1267,10 @@ void MainWindow::simReset()
       continue;
     dockWidget->setWidget(0, 0, 0, 0);
   }
+  loadReport.end();
 
   // unload all modules
+  loadReport.begin("unload modules");
   for(LoadedModule* loadedModule : loadedModules)
   {
     if(loadedModule->flags & SimRobot::Flag::ignoreReset)
@@ -1046,8 +1281,10 @@ void MainWindow::simReset()
   }
   compiled = false;
   filePath = openedFilePath;
+  loadReport.end();
 
   // reload all modules
+  loadReport.begin("create modules");
   for(LoadedModule* loadedModule : loadedModules)
   {
     if(loadedModule->module)
@@ -1055,6 +1292,7 @@ void MainWindow::simReset()
     loadedModule->module = loadedModule->createModule(*this);
     Q_ASSERT(loadedModule->module);
   }
+  loadReport.end();
 
   // recompile modules
   compileModules();
@@ -1074,11 +1312,35 @@ void MainWindow::simReset()
   if(!activeDockWidget)
     updateMenuAndToolBar();
 
+  finishLoadReport();
+
   // start!?
   if(compiled && wasRunning)
     simStart();
 }
 
+void MainWindow::simReload()
+{
+  if(!compiled)
+  {
+    simReset();
+    return;
+  }
+
+  // Modules that are kept on resets are not affected by changes of the scene.
+  for(LoadedModule* loadedModule : loadedModules)
+    if(!(loadedModule->flags & SimRobot::Flag::ignoreReset) && !loadedModule->module->reload())
+    {
+      simReset();
+      return;
+    }
+
+  for(RegisteredDockWidget* dockWidget : openedObjectsByName)
+    if(dockWidget->isReallyVisible())
+      dockWidget->update();
+  statusBar->setUserMessage(tr("Applied changes of the scene file"));
+}
+
 void MainWindow::simStart()
 {
   simStartAct->setChecked(false);
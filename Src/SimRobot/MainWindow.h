@@ -12,7 +12,9 @@
 #include <QSet>
 #include <QHash>
 #include <QLibrary>
+#include <QThreadPool>
 
+#include "LoadReport.h"
 #include "SimRobot.h"
 
 class SceneGraphDockWidget;
@@ -30,6 +32,31 @@ public:
 
   QMenu* createSimMenu();
 
+  /**
+   * Opens, resets and closes a scene repeatedly and prints the durations of the first iteration and percentiles of the
+   * durations of the others to the console. The settings are not changed.
+   * @param fileName The scene file
+   * @param iterations The number of times the scene is opened
+   * @return The exit code (0 if the scene could be loaded every time)
+   */
+  int runLoadBenchmark(const QString& fileName, int iterations);
+
+  /**
+   * Runs several scenes without showing them and prints how long stepping each of them took
+   * @param fileNames The scene files
+   * @param steps The number of simulation steps per scene
+   * @param threads The number of threads that step scenes (0 means one per hardware thread)
+   * @return The exit code (0 if all scenes could be loaded)
+   */
+  int runBatch(const QStringList& fileNames, unsigned int steps, int threads);
+
+  /**
+   * Determines the file of the library of a module
+   * @param name The name of the module
+   * @return The file name that is passed to \c QLibrary
+   */
+  QString getModuleFileName(const QString& name) const;
+
 private:
 
   static QString getAppPath(const char* argv0);
@@ -45,10 +72,13 @@ private:
     using CreateModuleProc = SimRobot::Module* (*)(SimRobot::Application&);
     CreateModuleProc createModule = nullptr;
 
-    LoadedModule(const QString& name, int flags) : QLibrary(name), flags(flags) {}
+    QString name;
+
+    LoadedModule(const QString& name, const QString& fileName, int flags) : QLibrary(fileName), flags(flags), name(name) {}
   };
 
   int timerId = 0; /**< The id of the timer used to get something like an OnIdle callback function to update the simulation. */
+  QThreadPool workItemPool; /**< The worker threads that update the work items of modules. */
 
   QAction* fileOpenAct;
   QAction* fileCloseAct;
@@ -57,6 +87,7 @@ private:
 #endif
   QAction* toolbarOpenAct;
   QAction* simResetAct;
+  QAction* simReloadAct;
   QAction* simStartAct;
   QAction* simStepAct;
 
@@ -89,6 +120,8 @@ private:
   int guiUpdateRate = 100;
   unsigned int lastGuiUpdate = 0;
   QString filePath; /**< the path to the currently opened file */
+  LoadReport loadReport; /**< the durations of the phases of the last time the scene was opened or reset */
+  bool benchmarking = false; /**< whether \c runLoadBenchmark is running (which suppresses printing load reports) */
 
   class RegisteredModule
   {
@@ -104,6 +137,7 @@ private:
   QStringList manuallyLoadedModules; /**< modules (a.k.a. addons) that were loaded manually */
   QList<LoadedModule*> loadedModules;
   QHash<QString, LoadedModule*> loadedModulesByName; /**< all loaded modules associated to the currently opened file */
+  unsigned int modulesGeneration = 1; /**< incremented whenever \c loadedModules changes, so that worker threads know when to prepare again */
 
   QDockWidget* activeDockWidget = nullptr;
   QMenu* dockWidgetFileMenu = nullptr;
@@ -129,6 +163,7 @@ private:
   bool selectObject(const SimRobot::Object& object) override;
   void showWarning(const QString& title, const QString& message) override;
   void setStatusMessage(const QString& message) override;
+  void addLoadPhase(const QString& name, double milliseconds) override;
   const QString& getFilePath() const override {return filePath;}
   const QString& getAppPath() const override {return appPath;}
   QSettings& getSettings() override {return settings;}
@@ -145,6 +180,8 @@ private:
   bool loadModule(const QString& name, bool manually);
   void unloadModule(const QString& name);
   bool compileModules();
+  void finishLoadReport();
+  void updateWorkItems(SimRobot::Module& module);
   void updateViewMenu(QMenu* menu);
   void addToolBarButtonsFromMenu(QMenu* menu, QToolBar* toolBar, bool addSeparator);
 
@@ -184,6 +221,7 @@ public:
 
 public slots:
   void simReset() override;
+  void simReload() override;
   void simStart() override;
   void simStep() override;
   void simStop() override;
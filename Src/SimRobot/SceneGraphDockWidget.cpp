@@ -1,38 +1,65 @@
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QHeaderView>
 #include <QSettings>
 #include <QAction>
 #include <QContextMenuEvent>
 #include <QMenu>
 #include <QApplication>
+#include <utility>
 
 #include "SceneGraphDockWidget.h"
 #include "MainWindow.h"
 
-SceneGraphDockWidget::SceneGraphDockWidget(QMenu* contextMenu, QWidget* parent) : QDockWidget(parent), contextMenu(contextMenu)
+template<typename F> void SceneGraphDockWidget::forEachSuffix(const QString& fullName, F f)
+{
+  const QStringView name(fullName);
+  f(name);
+  for(qsizetype i = name.indexOf(QLatin1Char('.')); i >= 0; i = name.indexOf(QLatin1Char('.'), i + 1))
+    f(name.mid(i + 1));
+}
+
+bool SceneGraphDockWidget::endsWithComponents(const QString& fullName, const QString& suffix)
+{
+  return fullName.endsWith(suffix) && (fullName.size() == suffix.size() || fullName.at(fullName.size() - suffix.size() - 1) == QLatin1Char('.'));
+}
+
+SceneGraphDockWidget::SceneGraphDockWidget(QMenu* contextMenu, QWidget* parent) : QDockWidget(parent), contextMenu(contextMenu), model(*this)
 {
   setAllowedAreas(Qt::TopDockWidgetArea);
   setFocusPolicy(Qt::ClickFocus);
   setObjectName(".SceneGraph");
   setWindowTitle(tr("Scene Graph"));
-  treeWidget = new QTreeWidget(this);
-  italicFont = treeWidget->font();
+  treeView = new QTreeView(this);
+  italicFont = treeView->font();
   italicFont.setItalic(true);
-  boldFont = treeWidget->font();
+  boldFont = treeView->font();
   boldFont.setBold(true);
-  treeWidget->setFrameStyle(QFrame::NoFrame);
-  setWidget(treeWidget);
-  setFocusProxy(treeWidget);
-  treeWidget->setExpandsOnDoubleClick(false);
-  treeWidget->setHeaderHidden(true);
-  treeWidget->setSelectionMode(QAbstractItemView::NoSelection);
-
-  connect(treeWidget, &QTreeWidget::activated, this, &SceneGraphDockWidget::itemActivated);
-  connect(treeWidget, &QTreeWidget::collapsed, this, &SceneGraphDockWidget::itemCollapsed);
-  connect(treeWidget, &QTreeWidget::expanded, this, &SceneGraphDockWidget::itemExpanded);
+  treeView->setFrameStyle(QFrame::NoFrame);
+  treeView->setModel(&model);
+  setWidget(treeView);
+  setFocusProxy(treeView);
+  treeView->setExpandsOnDoubleClick(false);
+  treeView->setHeaderHidden(true);
+  treeView->setUniformRowHeights(true);
+  treeView->setSelectionMode(QAbstractItemView::NoSelection);
+
+  connect(treeView, &QTreeView::activated, this, &SceneGraphDockWidget::itemActivated);
+  connect(treeView, &QTreeView::collapsed, this, &SceneGraphDockWidget::itemCollapsed);
+  connect(treeView, &QTreeView::expanded, this, &SceneGraphDockWidget::itemExpanded);
   // suppress decoration of the current item which doesn't mix well with our own styling
   // (maybe the whole thing that is done by setting the font etc. can be achieved better using stylesheets)
-  connect(treeWidget, &QTreeWidget::currentItemChanged, this, [this](auto*, auto*){ treeWidget->setCurrentItem(nullptr); });
+  connect(treeView->selectionModel(), &QItemSelectionModel::currentChanged, this, [this](const QModelIndex& current)
+  {
+    if(current.isValid())
+      treeView->setCurrentIndex(QModelIndex());
+  });
+  // rows are only created when their parent is expanded, so the expansion state is restored when they appear
+  connect(&model, &Model::rowsInserted, this, [this](const QModelIndex& parent, int first, int last)
+  {
+    for(int i = first; i <= last; ++i)
+      if(expandedItems.contains(model.getObject(model.index(i, 0, parent))->fullName))
+        treeView->expand(model.index(i, 0, parent));
+  });
 
   // load layout settings
   QSettings& settings = MainWindow::application->getLayoutSettings();
@@ -55,28 +82,26 @@ SceneGraphDockWidget::~SceneGraphDockWidget()
   Q_ASSERT(registeredObjectsByKindAndName.isEmpty());
 }
 
-void SceneGraphDockWidget::registerObject(const SimRobot::Module* module, SimRobot::Object* object, const SimRobot::Object* parent, int flags)
+bool SceneGraphDockWidget::registerObject(const SimRobot::Module* module, SimRobot::Object* object, const SimRobot::Object* parent, int flags)
 {
-  QTreeWidgetItem* parentItem = parent ? registeredObjectsByObject.value(parent) : treeWidget->invisibleRootItem();
-  RegisteredObject* newItem = new RegisteredObject(module, object, parentItem, flags);
-  const auto parentFullNameLength = parent ? static_cast<RegisteredObject*>(parentItem)->fullName.length() : 0;
-  newItem->setText(0, parent ? newItem->fullName.mid(parentFullNameLength + 1) : newItem->fullName);
-  const QIcon* icon = object->getIcon();
-  if(icon)
-    newItem->setIcon(0, *icon);
-  if(flags & SimRobot::Flag::hidden)
-    newItem->setHidden(true);
-  if(flags & SimRobot::Flag::windowless)
-    newItem->setFont(0, italicFont);
-  else
-    newItem->setDisabled(true);
-  parentItem->addChild(newItem);
+  RegisteredObject* parentObject = parent ? registeredObjectsByObject.value(parent) : &rootObject;
+  if(!parentObject)
+    return false;
+  RegisteredObject* newObject = new RegisteredObject(module, object, parentObject, flags);
   if(!parent)
-    parentItem->sortChildren(0, Qt::AscendingOrder);
-  if(expandedItems.contains(newItem->fullName))
-    treeWidget->expandItem(newItem);
+  {
+    // top-level objects are sorted by name
+    auto position = parentObject->children.begin();
+    while(position != parentObject->children.end() && !(newObject->fullName < (*position)->fullName))
+      ++position;
+    parentObject->children.insert(position, newObject);
+  }
+  else
+    parentObject->children.append(newObject);
+  if(!newObject->hidden)
+    model.addRow(newObject);
 
-  registeredObjectsByObject.insert(object, newItem);
+  registeredObjectsByObject.insert(object, newObject);
 
   int kind = object->getKind();
   QHash<QString, RegisteredObject*>* registeredObjectsByName = registeredObjectsByKindAndName.value(kind);
@@ -86,28 +111,39 @@ void SceneGraphDockWidget::registerObject(const SimRobot::Module* module, SimRob
     registeredObjectsByKindAndName.insert(kind, registeredObjectsByName);
   }
 
-  registeredObjectsByName->insert(newItem->fullName, newItem);
+  registeredObjectsByName->insert(newObject->fullName, newObject);
+  if(registeredObjectsBySuffixBuilt)
+    forEachSuffix(newObject->fullName, [this, newObject](QStringView suffix) {registeredObjectsBySuffix.insert(suffix, newObject);});
 
   if(flags & SimRobot::Flag::showParent)
-    while(parentItem)
+    for(RegisteredObject* ancestor = parentObject; ancestor != &rootObject && ancestor->hidden; ancestor = ancestor->parent)
     {
-      parentItem->setHidden(false);
-      parentItem = parentItem->parent();
+      ancestor->hidden = false;
+      model.addRow(ancestor);
     }
+  return true;
 }
 
 void SceneGraphDockWidget::unregisterAllObjects()
 {
+  model.reset(true);
+  for(RegisteredObject* registeredObject : std::as_const(rootObject.children))
+    destroyRegisteredObject(registeredObject);
+  rootObject.children.clear();
+  rootObject.rows.clear();
+  rootObject.visibleChildCount = 0;
+  model.reset(false);
   registeredObjectsByObject.clear();
+  registeredObjectsBySuffix.clear();
+  registeredObjectsBySuffixBuilt = false;
   qDeleteAll(registeredObjectsByKindAndName);
   registeredObjectsByKindAndName.clear();
-  treeWidget->clear();
 }
 
 void SceneGraphDockWidget::unregisterObjectsFromModule(const SimRobot::Module* module)
 {
-  for(int i = treeWidget->topLevelItemCount() - 1; i >= 0; --i)
-    deleteRegisteredObjectsFromModule(static_cast<RegisteredObject*>(treeWidget->topLevelItem(i)), module);
+  for(auto i = rootObject.children.count() - 1; i >= 0; --i)
+    deleteRegisteredObjectsFromModule(rootObject.children.at(i), module);
 }
 
 bool SceneGraphDockWidget::unregisterObject(const SimRobot::Object* object)
@@ -141,50 +177,48 @@ SimRobot::Object* SceneGraphDockWidget::resolveObject(const SimRobot::Object* pa
   const auto partsCount = parts.count();
   if(partsCount <= 0)
     return nullptr;
-  for(QHash<int, QHash<QString, RegisteredObject*>*>::iterator i = kind ? registeredObjectsByKindAndName.find(kind) : registeredObjectsByKindAndName.begin(); i != registeredObjectsByKindAndName.end(); ++i)
+  const QString& lastPart = parts.at(partsCount - 1);
+  if(!registeredObjectsBySuffixBuilt)
   {
-    QHash<QString, RegisteredObject*>* registeredObjectsByName = *i;
-    if(!registeredObjectsByName)
+    for(RegisteredObject* object : std::as_const(registeredObjectsByObject))
+      forEachSuffix(object->fullName, [this, object](QStringView suffix) {registeredObjectsBySuffix.insert(suffix, object);});
+    registeredObjectsBySuffixBuilt = true;
+  }
+  const auto [begin, end] = std::as_const(registeredObjectsBySuffix).equal_range(QStringView(lastPart));
+  for(auto entry = begin; entry != end; ++entry)
+  {
+    RegisteredObject* object = *entry;
+    if(kind && object->object->getKind() != kind)
       continue;
-    const QString& lastPart = parts.at(partsCount - 1);
-    for(RegisteredObject* object : *registeredObjectsByName)
+    RegisteredObject* currentObject = object;
+    for(auto i = partsCount - 2; i >= 0; --i)
     {
-      if(object->fullName.endsWith(lastPart))
+      currentObject = currentObject->parent;
+      const QString& currentPart = parts.at(i);
+      for(;;)
       {
-        RegisteredObject* currentObject = object;
-        for(auto i = partsCount - 2; i >= 0; --i)
-        {
-          currentObject = static_cast<RegisteredObject*>(currentObject->parent());
-          const QString& currentPart = parts.at(i);
-          for(;;)
-          {
-            if(!currentObject)
-              goto continueSearch;
-            if(currentObject->fullName.endsWith(currentPart))
-              break;
-            currentObject = static_cast<RegisteredObject*>(currentObject->parent());
-          }
-        }
-        if(parent)
-        {
-          currentObject = static_cast<RegisteredObject*>(currentObject->parent());
-          for(;;)
-          {
-            if(!currentObject)
-              goto continueSearch;
-            if(currentObject->object == parent)
-              break;
-            currentObject = static_cast<RegisteredObject*>(currentObject->parent());
-          }
-        }
-        return object->object;
+        if(currentObject == &rootObject)
+          goto continueSearch;
+        if(endsWithComponents(currentObject->fullName, currentPart))
+          break;
+        currentObject = currentObject->parent;
       }
-    continueSearch:
-      ;
     }
-
-    if(kind)
-      break;
+    if(parent)
+    {
+      currentObject = currentObject->parent;
+      for(;;)
+      {
+        if(currentObject == &rootObject)
+          goto continueSearch;
+        if(currentObject->object == parent)
+          break;
+        currentObject = currentObject->parent;
+      }
+    }
+    return object->object;
+  continueSearch:
+    ;
   }
   return nullptr;
 }
@@ -192,20 +226,20 @@ SimRobot::Object* SceneGraphDockWidget::resolveObject(const SimRobot::Object* pa
 int SceneGraphDockWidget::getObjectChildCount(const SimRobot::Object* object)
 {
   const RegisteredObject* item = registeredObjectsByObject.value(object);
-  return item ? item->childCount() : 0;
+  return item ? static_cast<int>(item->children.count()) : 0;
 }
 
 SimRobot::Object* SceneGraphDockWidget::getObjectChild(const SimRobot::Object* object, int index)
 {
   const RegisteredObject* item = registeredObjectsByObject.value(object);
-  return item && index >= 0 && index < item->childCount() ? static_cast<RegisteredObject*>(item->child(index))->object : 0;
+  return item && index >= 0 && index < item->children.count() ? item->children.at(index)->object : 0;
 }
 
 bool SceneGraphDockWidget::activateFirstObject()
 {
-  RegisteredObject* item = static_cast<RegisteredObject*>(treeWidget->invisibleRootItem()->child(0));
-  if(!item)
+  if(rootObject.children.isEmpty())
     return false;
+  RegisteredObject* item = rootObject.children.first();
   emit activatedObject(item->fullName, item->module, item->object, item->flags);
   return true;
 }
@@ -225,9 +259,9 @@ bool SceneGraphDockWidget::setOpened(const SimRobot::Object* object, bool opened
   if(!item)
     return false;
   item->opened = opened;
-  item->setDisabled(!opened);
   if(!opened)
-    item->setFont(0, QFont());
+    item->active = false;
+  model.objectChanged(item);
   return true;
 }
 
@@ -236,7 +270,8 @@ bool SceneGraphDockWidget::setActive(const SimRobot::Object* object, bool active
   RegisteredObject* item = registeredObjectsByObject.value(object);
   if(!item)
     return false;
-  item->setFont(0, active ? boldFont : QFont());
+  item->active = active;
+  model.objectChanged(item);
   return true;
 }
 
@@ -253,15 +288,25 @@ void SceneGraphDockWidget::deleteRegisteredObjectsFromModule(RegisteredObject* r
   if(registeredObject->module == module)
     deleteRegisteredObject(registeredObject);
   else
-    for(int i = registeredObject->childCount() - 1; i >= 0; --i)
-      deleteRegisteredObjectsFromModule(static_cast<RegisteredObject*>(registeredObject->child(i)), module);
+    for(auto i = registeredObject->children.count() - 1; i >= 0; --i)
+      deleteRegisteredObjectsFromModule(registeredObject->children.at(i), module);
 }
 
 void SceneGraphDockWidget::deleteRegisteredObject(RegisteredObject* registeredObject)
 {
-  for(int i = registeredObject->childCount() - 1; i >= 0; --i)
-    deleteRegisteredObject(static_cast<RegisteredObject*>(registeredObject->child(i)));
+  // the whole subtree disappears from the view at once
+  model.removeObject(registeredObject);
+  registeredObject->parent->children.removeOne(registeredObject);
+  destroyRegisteredObject(registeredObject);
+}
+
+void SceneGraphDockWidget::destroyRegisteredObject(RegisteredObject* registeredObject)
+{
+  for(RegisteredObject* child : std::as_const(registeredObject->children))
+    destroyRegisteredObject(child);
   registeredObjectsByObject.remove(registeredObject->object);
+  if(registeredObjectsBySuffixBuilt)
+    forEachSuffix(registeredObject->fullName, [this, registeredObject](QStringView suffix) {registeredObjectsBySuffix.remove(suffix, registeredObject);});
   int kind = registeredObject->object->getKind();
   QHash<QString, RegisteredObject*>* registeredObjectsByName = registeredObjectsByKindAndName.value(kind);
   if(registeredObjectsByName)
@@ -276,9 +321,18 @@ void SceneGraphDockWidget::deleteRegisteredObject(RegisteredObject* registeredOb
   delete registeredObject;
 }
 
+bool SceneGraphDockWidget::isEnabled(const RegisteredObject* registeredObject) const
+{
+  // like in a QTreeWidget, disabled objects also disable their children
+  for(; registeredObject != &rootObject; registeredObject = registeredObject->parent)
+    if(!(registeredObject->flags & SimRobot::Flag::windowless) && !registeredObject->opened)
+      return false;
+  return true;
+}
+
 void SceneGraphDockWidget::contextMenuEvent(QContextMenuEvent* event)
 {
-  const QRect content(treeWidget->geometry());
+  const QRect content(treeView->geometry());
   if(!content.contains(event->x(), event->y()))
   {
     // click on window frame
@@ -286,7 +340,8 @@ void SceneGraphDockWidget::contextMenuEvent(QContextMenuEvent* event)
     return;
   }
 
-  clickedItem = static_cast<RegisteredObject*>(treeWidget->itemAt(treeWidget->mapFromParent(event->pos())));
+  const QModelIndex clickedIndex = treeView->indexAt(treeView->viewport()->mapFrom(this, event->pos()));
+  clickedItem = clickedIndex.isValid() ? model.getObject(clickedIndex) : nullptr;
 
   QMenu menu;
   if(clickedItem)
@@ -297,9 +352,9 @@ void SceneGraphDockWidget::contextMenuEvent(QContextMenuEvent* event)
       connect(action, &QAction::triggered, this, &SceneGraphDockWidget::openOrCloseObject);
       menu.addSeparator();
     }
-    if(clickedItem->childCount() > 0)
+    if(!clickedItem->children.isEmpty())
     {
-      QAction* action = menu.addAction(tr(clickedItem->isExpanded() ? "Collaps&e" : "&Expand"));
+      QAction* action = menu.addAction(tr(treeView->isExpanded(clickedIndex) ? "Collaps&e" : "&Expand"));
       connect(action, &QAction::triggered, this, &SceneGraphDockWidget::expandOrCollapseObject);
       menu.addSeparator();
     }
@@ -312,13 +367,13 @@ void SceneGraphDockWidget::contextMenuEvent(QContextMenuEvent* event)
 
 void SceneGraphDockWidget::itemActivated(const QModelIndex& index)
 {
-  RegisteredObject* item = static_cast<RegisteredObject*>(index.internalPointer());
+  RegisteredObject* item = model.getObject(index);
   if(item->flags & SimRobot::Flag::windowless)
   {
-    if(item->isExpanded())
-      treeWidget->collapseItem(item);
+    if(treeView->isExpanded(index))
+      treeView->collapse(index);
     else
-      treeWidget->expandItem(item);
+      treeView->expand(index);
     // the object does not have a widget, but it might have a simple
     // widget-less callback - call it (by default an empty callback
     // stub is provided)
@@ -330,13 +385,13 @@ void SceneGraphDockWidget::itemActivated(const QModelIndex& index)
 
 void SceneGraphDockWidget::itemCollapsed(const QModelIndex& index)
 {
-  RegisteredObject* item = static_cast<RegisteredObject*>(index.internalPointer());
+  RegisteredObject* item = model.getObject(index);
   expandedItems.remove(item->fullName);
 }
 
 void SceneGraphDockWidget::itemExpanded(const QModelIndex& index)
 {
-  RegisteredObject* item = static_cast<RegisteredObject*>(index.internalPointer());
+  RegisteredObject* item = model.getObject(index);
   expandedItems.insert(item->fullName);
 }
 
@@ -350,10 +405,11 @@ void SceneGraphDockWidget::openOrCloseObject()
 
 void SceneGraphDockWidget::expandOrCollapseObject()
 {
-  if(clickedItem->isExpanded())
-    treeWidget->collapseItem(clickedItem);
+  const QModelIndex index = model.getIndex(clickedItem);
+  if(treeView->isExpanded(index))
+    treeView->collapse(index);
   else
-    treeWidget->expandItem(clickedItem);
+    treeView->expand(index);
 }
 
 void SceneGraphDockWidget::topLevelChanged(bool topLevel)
@@ -363,3 +419,178 @@ void SceneGraphDockWidget::topLevelChanged(bool topLevel)
   else
     setFeatures(features() & ~DockWidgetMovable);
 }
+
+QModelIndex SceneGraphDockWidget::Model::index(int row, int column, const QModelIndex& parent) const
+{
+  const RegisteredObject* parentObject = getObject(parent);
+  if(column != 0 || row < 0 || row >= parentObject->rows.count())
+    return QModelIndex();
+  return createIndex(row, 0, parentObject->rows.at(row));
+}
+
+QModelIndex SceneGraphDockWidget::Model::parent(const QModelIndex& index) const
+{
+  return index.isValid() ? getIndex(getObject(index)->parent) : QModelIndex();
+}
+
+int SceneGraphDockWidget::Model::rowCount(const QModelIndex& parent) const
+{
+  return static_cast<int>(getObject(parent)->rows.count());
+}
+
+int SceneGraphDockWidget::Model::columnCount(const QModelIndex&) const
+{
+  return 1;
+}
+
+bool SceneGraphDockWidget::Model::hasChildren(const QModelIndex& parent) const
+{
+  return getObject(parent)->visibleChildCount > 0;
+}
+
+bool SceneGraphDockWidget::Model::canFetchMore(const QModelIndex& parent) const
+{
+  const RegisteredObject* parentObject = getObject(parent);
+  return !parentObject->populated && parentObject->visibleChildCount > 0;
+}
+
+void SceneGraphDockWidget::Model::fetchMore(const QModelIndex& parent)
+{
+  RegisteredObject* parentObject = getObject(parent);
+  if(parentObject->populated)
+    return;
+  beginInsertRows(parent, 0, parentObject->visibleChildCount - 1);
+  parentObject->populated = true;
+  parentObject->rows.reserve(parentObject->visibleChildCount);
+  for(RegisteredObject* child : std::as_const(parentObject->children))
+    if(!child->hidden)
+    {
+      child->row = static_cast<int>(parentObject->rows.count());
+      parentObject->rows.append(child);
+    }
+  endInsertRows();
+}
+
+QVariant SceneGraphDockWidget::Model::data(const QModelIndex& index, int role) const
+{
+  const RegisteredObject* object = getObject(index);
+  if(object == &dockWidget.rootObject)
+    return QVariant();
+  switch(role)
+  {
+    case Qt::DisplayRole:
+      return object->parent != &dockWidget.rootObject ? object->fullName.mid(object->parent->fullName.length() + 1) : object->fullName;
+    case Qt::DecorationRole:
+    {
+      const QIcon* icon = object->object->getIcon();
+      return icon ? QVariant(*icon) : QVariant();
+    }
+    case Qt::FontRole:
+      if(object->active)
+        return dockWidget.boldFont;
+      if(object->flags & SimRobot::Flag::windowless)
+        return dockWidget.italicFont;
+      return QVariant();
+    default:
+      return QVariant();
+  }
+}
+
+Qt::ItemFlags SceneGraphDockWidget::Model::flags(const QModelIndex& index) const
+{
+  const RegisteredObject* object = getObject(index);
+  return object != &dockWidget.rootObject && dockWidget.isEnabled(object) ? Qt::ItemIsEnabled | Qt::ItemIsSelectable : Qt::NoItemFlags;
+}
+
+SceneGraphDockWidget::RegisteredObject* SceneGraphDockWidget::Model::getObject(const QModelIndex& index) const
+{
+  return index.isValid() ? static_cast<RegisteredObject*>(index.internalPointer()) : &dockWidget.rootObject;
+}
+
+QModelIndex SceneGraphDockWidget::Model::getIndex(const RegisteredObject* object) const
+{
+  if(object == &dockWidget.rootObject)
+    return QModelIndex();
+  return object->row >= 0 ? createIndex(object->row, 0, const_cast<RegisteredObject*>(object)) : QModelIndex();
+}
+
+void SceneGraphDockWidget::Model::addRow(RegisteredObject* object)
+{
+  RegisteredObject* parentObject = object->parent;
+  ++parentObject->visibleChildCount;
+  if(parentObject->populated || parentObject == &dockWidget.rootObject)
+  {
+    // the row is inserted behind the rows of the visible objects that precede it
+    int row = 0;
+    if(parentObject->children.last() == object)
+      row = static_cast<int>(parentObject->rows.count());
+    else
+      for(const RegisteredObject* child : std::as_const(parentObject->children))
+      {
+        if(child == object)
+          break;
+        if(!child->hidden)
+          ++row;
+      }
+    const QModelIndex parentIndex = getIndex(parentObject);
+    beginInsertRows(parentIndex, row, row);
+    parentObject->populated = true;
+    parentObject->rows.insert(row, object);
+    updateRowIndices(parentObject, row);
+    endInsertRows();
+  }
+  else if(parentObject->visibleChildCount == 1)
+  {
+    // the parent gets an expansion indicator
+    const QModelIndex parentIndex = getIndex(parentObject);
+    if(parentIndex.isValid())
+      emit dataChanged(parentIndex, parentIndex);
+  }
+}
+
+void SceneGraphDockWidget::Model::removeObject(RegisteredObject* object)
+{
+  RegisteredObject* parentObject = object->parent;
+  if(object->hidden)
+    return;
+  --parentObject->visibleChildCount;
+  const int row = object->row;
+  if(row >= 0)
+  {
+    beginRemoveRows(getIndex(parentObject), row, row);
+    parentObject->rows.removeAt(row);
+    object->row = -1;
+    updateRowIndices(parentObject, row);
+    endRemoveRows();
+  }
+}
+
+void SceneGraphDockWidget::Model::updateRowIndices(RegisteredObject* object, int first)
+{
+  // rows are mostly appended, so usually only the new row is touched
+  for(int row = first; row < object->rows.count(); ++row)
+    object->rows.at(row)->row = row;
+}
+
+void SceneGraphDockWidget::Model::objectChanged(const RegisteredObject* object)
+{
+  // the enabled state is inherited, so the populated rows below the object change as well
+  const QModelIndex index = getIndex(object);
+  if(index.isValid())
+    emit dataChanged(index, index);
+  if(!object->rows.isEmpty())
+  {
+    emit dataChanged(createIndex(0, 0, object->rows.first()), createIndex(static_cast<int>(object->rows.count() - 1), 0, object->rows.last()));
+    for(const RegisteredObject* child : object->rows)
+      if(!child->rows.isEmpty())
+        objectChanged(child);
+  }
+}
+
+void SceneGraphDockWidget::Model::reset(bool begin)
+{
+  if(begin)
+    beginResetModel();
+  else
+    endResetModel();
+}
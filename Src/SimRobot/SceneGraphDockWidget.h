@@ -1,12 +1,17 @@
 #pragma once
 
+#include <QAbstractItemModel>
 #include <QDockWidget>
 #include <QSet>
 #include <QHash>
-#include <QTreeWidgetItem>
+#include <QList>
+#include <QMultiHash>
+#include <QStringView>
 
 #include "SimRobot.h"
 
+class QTreeView;
+
 class SceneGraphDockWidget : public QDockWidget
 {
   Q_OBJECT
@@ -15,7 +20,7 @@ public:
   SceneGraphDockWidget(QMenu* contextMenu, QWidget* parent);
   ~SceneGraphDockWidget();
 
-  void registerObject(const SimRobot::Module* module, SimRobot::Object* object, const SimRobot::Object* parent, int flags);
+  bool registerObject(const SimRobot::Module* module, SimRobot::Object* object, const SimRobot::Object* parent, int flags);
   void unregisterAllObjects();
   void unregisterObjectsFromModule(const SimRobot::Module* module);
   bool unregisterObject(const SimRobot::Object* object);
@@ -31,37 +36,146 @@ public:
 
   QAction* toggleViewAction() const;
 
+  /**
+   * Checks whether a full name ends with a sequence of whole dot-separated components.
+   * @param fullName The full name.
+   * @param suffix The components (e.g. "b.c" matches "a.b.c", but not "a.xb.c").
+   * @return Whether the full name ends with the components.
+   */
+  static bool endsWithComponents(const QString& fullName, const QString& suffix);
+
 signals:
   void activatedObject(const QString& fullName, const SimRobot::Module* module, SimRobot::Object* object, int flags);
   void deactivatedObject(const QString& fullName);
 
 private:
-  class RegisteredObject : public QTreeWidgetItem
+  class RegisteredObject
   {
   public:
-    RegisteredObject(const SimRobot::Module* module, SimRobot::Object* object, QTreeWidgetItem* parentItem, int flags) :
-      QTreeWidgetItem(parentItem), module(module), object(object), fullName(object->getFullName()), flags(flags), opened(false) {}
+    RegisteredObject() = default;
+    RegisteredObject(const SimRobot::Module* module, SimRobot::Object* object, RegisteredObject* parent, int flags) :
+      module(module), object(object), fullName(object->getFullName()), flags(flags), hidden(flags & SimRobot::Flag::hidden), parent(parent) {}
 
-    const SimRobot::Module* module;
-    SimRobot::Object* object;
+    const SimRobot::Module* module = nullptr;
+    SimRobot::Object* object = nullptr;
     const QString fullName;
-    int flags;
-    bool opened;
+    int flags = 0;
+    bool opened = false;
+    bool active = false;
+    bool hidden = false;
+    RegisteredObject* parent = nullptr; /**< The parent object (\c rootObject for top-level objects). */
+    QList<RegisteredObject*> children; /**< All child objects (including hidden ones). */
+    QList<RegisteredObject*> rows; /**< The child objects that are not hidden in the order of \c children (only filled once the object has been populated). */
+    int row = -1; /**< The index of this object in the \c rows of its parent (-1 if it does not have a row). */
+    int visibleChildCount = 0; /**< The number of child objects that are not hidden. */
+    bool populated = false; /**< Whether the model provides the rows of the child objects (i.e. the object has been expanded once). */
+  };
+
+  /**
+   * A tree model of the registered objects that only provides the rows of objects that have been expanded.
+   * Registering an object with a parent that has never been expanded does not touch the view at all.
+   */
+  class Model : public QAbstractItemModel
+  {
+  public:
+    Model(SceneGraphDockWidget& dockWidget) : dockWidget(dockWidget) {}
+
+    QModelIndex index(int row, int column, const QModelIndex& parent) const override;
+    QModelIndex parent(const QModelIndex& index) const override;
+    int rowCount(const QModelIndex& parent) const override;
+    int columnCount(const QModelIndex& parent) const override;
+    bool hasChildren(const QModelIndex& parent) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
+    QVariant data(const QModelIndex& index, int role) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    /**
+     * Returns the registered object of an index.
+     * @param index The index.
+     * @return The object (\c rootObject for an invalid index).
+     */
+    RegisteredObject* getObject(const QModelIndex& index) const;
+
+    /**
+     * Returns the index of a registered object.
+     * @param object The object.
+     * @return The index (invalid if the object is not provided by the model).
+     */
+    QModelIndex getIndex(const RegisteredObject* object) const;
+
+    /**
+     * Provides a registered object that is not hidden as a row if its parent has been populated.
+     * @param object The object that has already been added to the children of its parent.
+     */
+    void addRow(RegisteredObject* object);
+
+    /**
+     * Removes the row of a registered object (if it has one).
+     * @param object The object that is still a child of its parent.
+     */
+    void removeObject(RegisteredObject* object);
+
+    /**
+     * Notifies the view that a registered object and the rows below it have changed.
+     * @param object The object.
+     */
+    void objectChanged(const RegisteredObject* object);
+
+    /**
+     * Notifies the view that all registered objects are about to be replaced.
+     * @param begin Whether this is called before (\c true) or after (\c false) they have been replaced.
+     */
+    void reset(bool begin);
+
+  private:
+    SceneGraphDockWidget& dockWidget; /**< The dock widget that owns the registered objects. */
+
+    /**
+     * Updates the indices that the rows of an object store.
+     * @param object The object.
+     * @param first The index of the first row whose index changed.
+     */
+    static void updateRowIndices(RegisteredObject* object, int first);
   };
 
   QMenu* contextMenu;
-  QTreeWidget* treeWidget;
+  Model model;
+  QTreeView* treeView;
   QFont italicFont;
   QFont boldFont;
   QSet<QString> expandedItems;
+  RegisteredObject rootObject; /**< The invisible parent of the top-level objects. */
   QHash<const void*, RegisteredObject*> registeredObjectsByObject;
   QHash<int, QHash<QString, RegisteredObject*>*> registeredObjectsByKindAndName;
+  QMultiHash<QStringView, RegisteredObject*> registeredObjectsBySuffix; /**< All objects by each dot-separated suffix of their full name (the keys refer to \c RegisteredObject::fullName). Only built when it is needed for the first time. */
+  bool registeredObjectsBySuffixBuilt = false; /**< Whether \c registeredObjectsBySuffix contains all registered objects. */
 
   RegisteredObject* clickedItem = nullptr;
 
   void deleteRegisteredObjectsFromModule(RegisteredObject* registeredObject, const SimRobot::Module* module);
   void deleteRegisteredObject(RegisteredObject* registeredObject);
 
+  /**
+   * Deletes a registered object and its children without notifying the model.
+   * @param registeredObject The object.
+   */
+  void destroyRegisteredObject(RegisteredObject* registeredObject);
+
+  /**
+   * Returns whether a registered object is shown as enabled (i.e. it and all of its ancestors are windowless or opened).
+   * @param registeredObject The object.
+   * @return Whether it is enabled.
+   */
+  bool isEnabled(const RegisteredObject* registeredObject) const;
+
+  /**
+   * Calls a function for each suffix of a full name that starts at the beginning of a dot-separated component (including the full name itself).
+   * @param fullName The full name.
+   * @param f The function.
+   */
+  template<typename F> static void forEachSuffix(const QString& fullName, F f);
+
   void contextMenuEvent(QContextMenuEvent* event) override;
 
 private slots:
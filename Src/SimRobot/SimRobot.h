@@ -116,6 +116,36 @@ namespace SimRobot
      */
     virtual void update() {}
 
+    /**
+     * Called when the scene file was modified while the simulation is loaded. The module can apply the modifications
+     * without being recreated. It might unregister some of its objects and register new ones instead, so modules that
+     * resolved objects of modules that were loaded before them have to resolve them again.
+     * @return Whether the modifications were applied. If any module returns \c false, the simulation is reset instead.
+     */
+    virtual bool reload() {return false;}
+
+    /**
+     * Returns the number of work items (e.g. one per robot) that can be updated independently of each other.
+     * If this is greater than 0, \c updateWorkItem is called for each of them after \c update in every simulation step.
+     * @return The number of work items
+     */
+    virtual int getWorkItemCount() {return 0;}
+
+    /**
+     * Called to perform the part of a simulation step that belongs to a single work item.
+     * Calls for different work items may run concurrently on worker threads. Therefore, they must only access
+     * the objects of their own work item (e.g. the sensor and actuator ports of one robot) and not the GUI.
+     * Sensors that render images (cameras etc.) must be read in \c update instead.
+     * @param index The index of the work item (0 .. \c getWorkItemCount() - 1)
+     */
+    virtual void updateWorkItem(int /* index */) {}
+
+    /**
+     * Called on a worker thread before it updates any work items, so that the module can set up its thread-local state.
+     * This is called only once per worker thread and module (worker threads are kept across simulation steps).
+     */
+    virtual void prepareWorkerThread() {}
+
     /**
      * A handler that will be called when any modules uses \c Application::selectObject
      */
@@ -153,12 +183,14 @@ namespace SimRobot
     virtual bool selectObject(const Object& object) = 0;
     virtual void showWarning(const QString& title, const QString& message) = 0;
     virtual void setStatusMessage(const QString& message) = 0;
+    virtual void addLoadPhase(const QString& name, double milliseconds) = 0; /**< Adds the duration of a phase of compiling a module to the load report */
     virtual const QString& getFilePath() const = 0;
     virtual const QString& getAppPath() const = 0;
     virtual QSettings& getSettings() = 0;
     virtual QSettings& getLayoutSettings() = 0;
     virtual bool isSimRunning() = 0;
     virtual void simReset() = 0;
+    virtual void simReload() = 0;
     virtual void simStart() = 0;
     virtual void simStep() = 0;
     virtual void simStop() = 0;
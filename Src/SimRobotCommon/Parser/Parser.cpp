@@ -9,12 +9,17 @@
 
 #include "Parser.h"
 #include "Parser/Element.h"
+#include "Parser/SceneCache.h"
 #include "Platform/Assert.h"
 #include "Tools/Math/Constants.h"
+#include <algorithm>
 #include <cctype>
+#include <charconv>
+#include <cmath>
 #include <cstring>
 #include <limits>
 #include <sstream>
+#include <type_traits>
 
 Parser::~Parser()
 {
@@ -22,7 +27,7 @@ Parser::~Parser()
     delete pair.second;
 }
 
-bool Parser::parse(const std::string& fileName, std::list<std::string>& errors)
+bool Parser::parse(const std::string& fileName, std::list<std::string>& errors, CompiledScene* compiledScene, bool useSceneCache)
 {
   this->errors = &errors;
 
@@ -31,6 +36,55 @@ bool Parser::parse(const std::string& fileName, std::list<std::string>& errors)
   parseRootDir = i != std::string::npos ? fileName.substr(0, i + 1) : std::string();
 
   const std::size_t preErrorCount = errors.size();
+  const std::string sceneCacheFileName = SceneCache::getFileName(fileName);
+  if(compiledScene)
+  {
+    compiledScene->cache.reset();
+    compiledScene->cacheFileName.clear();
+    compiledScene->dataFiles.clear();
+  }
+  dataFiles = compiledScene ? &compiledScene->dataFiles : nullptr;
+
+  // Instantiate the compiled scene if it is up to date.
+  if(useSceneCache)
+  {
+    auto sceneCache = std::make_unique<SceneCache>();
+    if(!sceneCacheFileName.empty() && sceneCache->load(sceneCacheFileName) && checkSceneCache(*sceneCache))
+    {
+      this->fileName = fileName;
+      const auto iter = elementInfos.find("Simulation");
+      ASSERT(iter != elementInfos.end());
+      ElementData elementData(nullptr, Location(), iter->second);
+      this->elementData = &elementData;
+      ASSERT(!element);
+      std::vector<Element*> instantiatedElements;
+      std::uint32_t index = 0;
+      sceneCache->rewind();
+      SceneCache::Event event;
+      while(sceneCache->read(event))
+      {
+        ASSERT(event == SceneCache::beginElement);
+        replaySceneCache(*sceneCache, instantiatedElements, index);
+      }
+      if(compiledScene)
+      {
+        compiledScene->events = sceneCache->getEvents();
+        compiledScene->elements.swap(instantiatedElements);
+        compiledScene->cache = std::move(sceneCache);
+        compiledScene->cacheFileName = sceneCacheFileName;
+      }
+      return preErrorCount == errors.size();
+    }
+  }
+
+  auto sceneCache = std::make_unique<SceneCache>();
+  recordingSceneCache = sceneCache.get();
+  sceneCache->addInputFile(fileName);
+  if(compiledScene)
+  {
+    compiledScene->elements.clear();
+    instantiatedElements = &compiledScene->elements;
+  }
   do
   {
     // Parse the XML file and create macros.
@@ -42,9 +96,25 @@ bool Parser::parse(const std::string& fileName, std::list<std::string>& errors)
     if(preErrorCount != errors.size())
       break;
 
+    recordingSceneCache = nullptr;
+    instantiatedElements = nullptr;
+    if(compiledScene)
+    {
+      compiledScene->events = sceneCache->getEvents();
+      if(!sceneCacheFileName.empty())
+      {
+        compiledScene->cache = std::move(sceneCache);
+        compiledScene->cacheFileName = sceneCacheFileName;
+      }
+    }
+    // Failing to write the cache (e.g. in a read-only directory) is not an error.
+    else if(!sceneCacheFileName.empty())
+      sceneCache->save(sceneCacheFileName);
     return true;
   }
   while(true);
+  recordingSceneCache = nullptr;
+  instantiatedElements = nullptr;
 
   // Apparently the error is that the file could not be opened at all or is completely invalid XML.
   if(preErrorCount == errors.size())
@@ -57,6 +127,34 @@ bool Parser::parse(const std::string& fileName, std::list<std::string>& errors)
   return false;
 }
 
+bool Parser::instantiate(const std::string& fileName, std::string_view events, const SceneCache::Structure& structure, std::uint32_t index,
+                         Element& parent, std::vector<Element*>& elements, std::list<std::string>& errors)
+{
+  this->errors = &errors;
+  const std::size_t i = fileName.find_last_of("/\\");
+  parseRootDir = i != std::string::npos ? fileName.substr(0, i + 1) : std::string();
+  this->fileName = fileName;
+  const std::size_t preErrorCount = errors.size();
+
+  // The handlers of the new elements only know the type of their parent.
+  const std::uint32_t parentIndex = structure.elements[index].parent;
+  ASSERT(parentIndex != SceneCache::noParent);
+  const auto iter = elementInfos.find(std::string(structure.elements[parentIndex].name));
+  ASSERT(iter != elementInfos.end());
+  ElementData parentElementData(nullptr, Location(), iter->second);
+  elementData = &parentElementData;
+  ASSERT(!element);
+  element = &parent;
+
+  SceneCache sceneCache;
+  sceneCache.setEvents(events, structure.elements[index].offset);
+  replaySceneCache(sceneCache, elements, index);
+
+  elementData = nullptr;
+  element = nullptr;
+  return preErrorCount == errors.size();
+}
+
 void Parser::handleError(const std::string& msg, const Location& location)
 {
   const std::string fileName = this->fileName.find(parseRootDir) == 0 ? this->fileName.substr(parseRootDir.length()) : this->fileName;
@@ -99,7 +197,9 @@ bool Parser::handleElement(const std::string& name, Attributes& attributes, cons
   {
     ElementData elementData(nullptr, location, elementInfo);
     this->elementData = &elementData;
-    this->attributes = &attributes;
+    std::vector<CompiledAttribute> compiledAttributes;
+    compileAttributes(attributes, compiledAttributes);
+    setAttributes(compiledAttributes);
 
     elementInfo->startElementProc();
 
@@ -131,6 +231,8 @@ bool Parser::handleElement(const std::string& name, Attributes& attributes, cons
           fileName = savedRootDir + savedIncludeFile;
         const std::size_t i = fileName.find_last_of("/\\");
         parseRootDir = i != std::string::npos ? fileName.substr(0, i + 1) : std::string();
+        if(recordingSceneCache)
+          recordingSceneCache->addInputFile(fileName);
         // Parse the included file.
         if(!readFile(fileName))
         {
@@ -164,11 +266,15 @@ bool Parser::handleElement(const std::string& name, Attributes& attributes, cons
       iter->second.value = parseRootDir + iter->second.value;
   }
 
+  // Split the attribute values into literal text and placeholders once, so that instantiating macros does not have to search them.
+  std::vector<CompiledAttribute> compiledAttributes;
+  compileAttributes(attributes, compiledAttributes);
+
   // All children of the Simulation element are macros.
   if(recordingMacroElement)
   {
     // If there is already a macro being recorded, this element is added as child to it.
-    auto* const newMacroElement = new MacroElement(recordingMacroElement, elementInfo, attributes, location);
+    auto* const newMacroElement = new MacroElement(recordingMacroElement, elementInfo, compiledAttributes, location);
     recordingMacroElement->children.push_back(newMacroElement);
     recordingMacroElement = newMacroElement;
     // The child elements are added to this macro element.
@@ -189,20 +295,20 @@ bool Parser::handleElement(const std::string& name, Attributes& attributes, cons
 
     ElementData elementData(nullptr, location, elementInfo);
     this->elementData = &elementData;
-    this->attributes = &attributes;
+    setAttributes(compiledAttributes);
     const std::string& macroName = getString("name", true);
 
     // The full macro name is combined from its name attribute and its element name. This combination must be unique.
     const std::string combinedMacroName = macroName + " " + name;
     if(macros.find(combinedMacroName) != macros.end())
     {
-      handleError("Duplicated name \"" + macroName + "\"", attributes.find("name")->second.valueLocation);
+      handleError("Duplicated name \"" + macroName + "\"", findAttribute("name")->valueLocation);
       handleError("Note: Defined here", macros.find(combinedMacroName)->second->location);
       return readElements(false);
     }
 
     // A new macro is created from this element. Its children will be added in the call to \c readElements.
-    auto* const macro = new Macro(elementInfo, fileName, attributes, location);
+    auto* const macro = new Macro(elementInfo, fileName, compiledAttributes, location);
     macros[combinedMacroName] = macro;
     if(isScene)
       sceneMacro = macro;
@@ -232,22 +338,19 @@ void Parser::handleText(std::string& text, const Location& location)
 void Parser::checkAttributes()
 {
   // It is not an error if the name attribute has not been parsed. In that case, it is marked as parsed here.
-  const auto iter = attributes->find("name");
-  if(iter != attributes->end())
-  {
-    const Attribute& ai = iter->second;
-    elementData->parsedAttributes |= 1u << ai.index;
-  }
+  for(std::size_t i = 0; i < attributes.size(); ++i)
+    if(*attributes[i]->name == "name")
+      elementData->parsedAttributes |= 1u << i;
 
   // Construct the bit mask of the attributes that were not parsed.
-  const unsigned int allAttributes = attributes->empty() ? 0u : (0xffffffffu >> static_cast<unsigned int>(32 - attributes->size()));
+  const unsigned int allAttributes = attributes.empty() ? 0u : (0xffffffffu >> static_cast<unsigned int>(32 - attributes.size()));
   const unsigned int unexpectedAttributes = allAttributes & ~elementData->parsedAttributes;
   // If there are any, errors are thrown.
   if(unexpectedAttributes)
   {
-    for(const auto& attribute : *attributes)
-      if(unexpectedAttributes & (1u << attribute.second.index))
-        handleError("Unexpected attribute \"" + attribute.first + "\"", attribute.second.nameLocation);
+    for(std::size_t i = 0; i < attributes.size(); ++i)
+      if(unexpectedAttributes & (1u << i))
+        handleError("Unexpected attribute \"" + *attributes[i]->name + "\"", attributes[i]->attribute.nameLocation);
   }
 }
 
@@ -282,7 +385,78 @@ void Parser::checkElements()
   }
 }
 
-const std::string* Parser::resolvePlaceholder(const std::string& name)
+void Parser::compileAttributes(const Attributes& attributes, std::vector<CompiledAttribute>& compiledAttributes)
+{
+  compiledAttributes.clear();
+  compiledAttributes.reserve(attributes.size());
+  for(const auto& [name, attribute] : attributes)
+    compiledAttributes.push_back({&intern(name), attribute, {}, true});
+  std::sort(compiledAttributes.begin(), compiledAttributes.end(), [](const CompiledAttribute& a, const CompiledAttribute& b) {return a.attribute.index < b.attribute.index;});
+
+  for(CompiledAttribute& compiledAttribute : compiledAttributes)
+  {
+    const std::string& str = compiledAttribute.attribute.value;
+    std::vector<CompiledAttribute::Segment>& segments = compiledAttribute.segments;
+    std::size_t varStart = str.find_first_of('$');
+    // No placeholders -> no segments.
+    if(varStart == std::string::npos)
+      continue;
+
+    std::size_t literalStart = 0;
+    while(varStart != std::string::npos)
+    {
+      // Add the literal text up to the placeholder.
+      if(varStart > literalStart)
+        segments.push_back({static_cast<std::uint32_t>(literalStart), static_cast<std::uint32_t>(varStart - literalStart), nullptr});
+
+      std::size_t nameStart = varStart + 1;
+      std::size_t nameEnd;
+      std::size_t varEnd;
+      if(const char c = str[nameStart]; c == '(' || c == '{')
+      {
+        // The name of the placeholder is the string between the parentheses.
+        ++nameStart;
+        nameEnd = str.find_first_of(c == '(' ? ')' : '}', nameStart);
+        if(nameEnd == std::string::npos)
+        {
+          // This is reported when the attribute is read.
+          compiledAttribute.valid = false;
+          segments.clear();
+          break;
+        }
+        varEnd = nameEnd + 1;
+      }
+      else
+      {
+        // The placeholder consists of all contiguous alphanumeric characters.
+        nameEnd = nameStart;
+        while(std::isalnum(static_cast<unsigned char>(str[nameEnd])))
+          ++nameEnd;
+        varEnd = nameEnd;
+      }
+      // The placeholder segment covers the whole reference so that it can be inserted verbatim if the variable is not defined.
+      segments.push_back({static_cast<std::uint32_t>(varStart), static_cast<std::uint32_t>(varEnd - varStart),
+                          &intern(std::string_view(str).substr(nameStart, nameEnd - nameStart))});
+
+      // Proceed up to the next $.
+      literalStart = varEnd;
+      varStart = str.find_first_of('$', varEnd);
+    }
+
+    // Add the remaining literal text.
+    if(compiledAttribute.valid && literalStart < str.size())
+      segments.push_back({static_cast<std::uint32_t>(literalStart), static_cast<std::uint32_t>(str.size() - literalStart), nullptr});
+  }
+}
+
+void Parser::setAttributes(const std::vector<CompiledAttribute>& compiledAttributes)
+{
+  attributes.clear();
+  for(const CompiledAttribute& attribute : compiledAttributes)
+    attributes.push_back(&attribute);
+}
+
+const std::string* Parser::resolvePlaceholder(const std::string* name)
 {
   ASSERT(element);
   ElementData* elementData = this->elementData;
@@ -299,72 +473,31 @@ const std::string* Parser::resolvePlaceholder(const std::string& name)
   return nullptr;
 }
 
-const std::string& Parser::replacePlaceholders(const std::string& str, const Location& location)
+const std::string& Parser::replacePlaceholders(const CompiledAttribute& attribute)
 {
-  std::size_t varStart = str.find_first_of('$');
+  const std::string& str = attribute.attribute.value;
+  if(!attribute.valid)
+  {
+    handleError("Invalid attribute format", attribute.attribute.valueLocation);
+    return str;
+  }
+
   // No placeholders -> return input.
-  if(varStart == std::string::npos)
+  if(attribute.segments.empty())
     return str;
 
-  // Add the part up to the first placeholder.
   std::string& result = placeholderBuffer;
   result.resize(0);
-  result += str.substr(0, varStart);
-
-  std::size_t varEnd;
-  for(;;)
+  for(const CompiledAttribute::Segment& segment : attribute.segments)
   {
-    // Skip $.
-    ++varStart;
-    if(char c = str[varStart]; c == '(' || c == '{')
-    {
-      // Skip opening parenthesis.
-      ++varStart;
-      // Find closing parenthesis.
-      const char cEnd = c == '(' ? ')' : '}';
-      varEnd = str.find_first_of(cEnd, varStart);
-      if(varEnd == std::string::npos)
-      {
-        handleError("Invalid attribute format", location);
-        return str;
-      }
-      else
-      {
-        // The name of the placeholder is the string between the parentheses.
-        const std::string name = str.substr(varStart, varEnd - varStart);
-        const std::string* const value = resolvePlaceholder(name);
-        // Either insert the variable (if it was defined) or the reference verbatim because the variable has not been defined.
-        if(value)
-          result += *value;
-        else
-          result += std::string("$") + c + name + cEnd;
-        // Skip closing parenthesis.
-        ++varEnd;
-      }
-    }
+    // Either insert the variable (if it was defined) or the literal text / the reference verbatim because the variable has not been defined.
+    const std::string* const value = segment.placeholder ? resolvePlaceholder(segment.placeholder) : nullptr;
+    if(value)
+      result += *value;
     else
-    {
-      varEnd = varStart;
-      // The placeholder consists of all contiguous alphanumeric characters.
-      while(std::isalnum(str[varEnd]))
-        ++varEnd;
-      const std::string name = str.substr(varStart, varEnd - varStart);
-      const std::string* const value = resolvePlaceholder(name);
-      // Either insert the variable (if it was defined) or the reference verbatim because the variable has not been defined.
-      if(value)
-        result += *value;
-      else
-        result += std::string("$") + name;
-    }
-
-    // Proceed up to the next $ or add the remaining string if there is none.
-    varStart = str.find_first_of('$', varEnd);
-    if(varStart == std::string::npos)
-    {
-      result += str.substr(varEnd);
-      return result;
-    }
+      result.append(str, segment.offset, segment.length);
   }
+  return result;
 }
 
 void Parser::parseSimulation()
@@ -397,7 +530,20 @@ void Parser::parseMacroElements()
 
   // Handle text / data of the parent.
   if(!replayingMacroElement->text.empty())
+  {
+    recordedNumbers.clear();
+    recordedNumbersCount = 0;
     elementData->info->textProc(replayingMacroElement->text, replayingMacroElement->textLocation);
+    if(recordingSceneCache)
+    {
+      // A text that was parsed into numbers is stored as these numbers, so replaying it does not parse it again.
+      const bool asNumbers = recordedNumbersCount == 1;
+      recordingSceneCache->write(asNumbers ? SceneCache::numbers : SceneCache::text);
+      recordingSceneCache->write(asNumbers ? std::string_view(recordedNumbers) : std::string_view(replayingMacroElement->text));
+      recordingSceneCache->write(static_cast<std::uint32_t>(replayingMacroElement->textLocation.line));
+      recordingSceneCache->write(static_cast<std::uint32_t>(replayingMacroElement->textLocation.column));
+    }
+  }
 
   const unsigned int parsedChildren = elementData->parsedChildren;
   elementData->parsedChildren = 0;
@@ -433,7 +579,7 @@ void Parser::parseMacroElements()
 void Parser::parseMacroElement(ElementData& elementData)
 {
   this->elementData = &elementData;
-  this->attributes = &replayingMacroElement->attributes;
+  setAttributes(replayingMacroElement->attributes);
 
   // Check if this element is allowed to be a child of its parent and throw an error otherwise.
   {
@@ -453,7 +599,7 @@ void Parser::parseMacroElement(ElementData& elementData)
   // If there is already an instance of this macro element, use that.
   if(replayingMacroElement->element)
   {
-    replayingMacroElement->element->addParent(*element);
+    reuseElement(*replayingMacroElement->element);
     return;
   }
 
@@ -465,7 +611,7 @@ void Parser::parseMacroElement(ElementData& elementData)
   {
     // Create the new element and set it as current.
     Element* const parentElement = element;
-    Element* const childElement = elementData.info->startElementProc();
+    Element* const childElement = startElement(elementData);
     element = childElement;
     // Check that all attributes have been used during creation of the element.
     checkAttributes();
@@ -475,6 +621,8 @@ void Parser::parseMacroElement(ElementData& elementData)
     ASSERT(element == childElement);
     // Check that there were no required children missing.
     checkElements();
+    if(recordingSceneCache)
+      recordingSceneCache->write(SceneCache::endElement);
     if(element)
     {
       // Link element to its parent.
@@ -493,18 +641,18 @@ void Parser::parseMacroElement(ElementData& elementData)
   if(!macro || macro->replaying)
   {
     if(macro)
-      handleError("Looping reference \"" + *ref + "\"", attributes->find("ref")->second.valueLocation);
+      handleError("Looping reference \"" + *ref + "\"", findAttribute("ref")->valueLocation);
     else
-      handleError("Unresolvable reference \"" + *ref + "\"", attributes->find("ref")->second.valueLocation);
+      handleError("Unresolvable reference \"" + *ref + "\"", findAttribute("ref")->valueLocation);
     return;
   }
 
   // Handle "reference-only" elements (e.g. <Mass ref="anyMass"/>).
-  const bool isReferenceOnlyElement = attributes->size() == 1 && !replayingMacroElement->hasTextOrChildren();
+  const bool isReferenceOnlyElement = attributes.size() == 1 && !replayingMacroElement->hasTextOrChildren();
   if(isReferenceOnlyElement && macro->element)
   {
     // Use the already created "reference-only" instance.
-    macro->element->addParent(*element);
+    reuseElement(*macro->element);
     replayingMacroElement->element = macro->element;
     return;
   }
@@ -512,7 +660,6 @@ void Parser::parseMacroElement(ElementData& elementData)
   // Handle normal macro references.
   {
     std::list<Macro*> referencedMacros;
-    Attributes* copiedAttributes = nullptr; // We might need this, since this->attributes is read-only.
 
     macro->replaying = true;
 
@@ -523,26 +670,29 @@ void Parser::parseMacroElement(ElementData& elementData)
       referencedMacros.push_back(nextMacro);
 
       // Combine current attributes with the attributes of the referenced macro.
-      for(const auto& pair : nextMacro->attributes)
-        if(attributes->find(pair.first) == attributes->end())
+      // The combined set only refers to the attributes of the macros, i.e. nothing is copied.
+      const CompiledAttribute* refAttribute = nullptr;
+      for(const CompiledAttribute& attribute : nextMacro->attributes)
+      {
+        if(*attribute.name == "ref")
+          refAttribute = &attribute;
+        if(std::none_of(attributes.begin(), attributes.end(), [&attribute](const CompiledAttribute* other) {return other->name == attribute.name;}))
         {
-          if(!copiedAttributes)
-            attributes = copiedAttributes = new Attributes(*attributes);
-          if(attributes->size() >= 32)
+          if(attributes.size() >= 32)
           {
             handleError("Macro attribute combination results in more than 32 attributes", replayingMacroElement->location);
             for(Macro* m : referencedMacros)
               m->replaying = false;
             return;
           }
-          copiedAttributes->emplace(pair.first, Attribute(pair.second, static_cast<unsigned int>(copiedAttributes->size())));
+          attributes.push_back(&attribute);
         }
+      }
 
       // Check if the macro references another one. If not, we are done.
-      const auto refIter = nextMacro->attributes.find("ref");
-      if(refIter == nextMacro->attributes.end())
+      if(!refAttribute)
         break;
-      ref = &replacePlaceholders(refIter->second.value, refIter->second.valueLocation);
+      ref = &replacePlaceholders(*refAttribute);
 
       // Resolve the referenced macro.
       iter = macros.find(*ref + " " + elementData.info->name);
@@ -550,9 +700,9 @@ void Parser::parseMacroElement(ElementData& elementData)
       if(!nextMacro || nextMacro->replaying)
       {
         if(nextMacro)
-          handleError("Looping reference \"" + *ref + "\"", refIter->second.valueLocation);
+          handleError("Looping reference \"" + *ref + "\"", refAttribute->attribute.valueLocation);
         else
-          handleError("Unresolvable reference \"" + *ref + "\"", refIter->second.valueLocation);
+          handleError("Unresolvable reference \"" + *ref + "\"", refAttribute->attribute.valueLocation);
         for(Macro* m : referencedMacros)
           m->replaying = false;
         return;
@@ -562,12 +712,10 @@ void Parser::parseMacroElement(ElementData& elementData)
 
     // Create the new element and set it as current.
     Element* const parentElement = element;
-    Element* const childElement = elementData.info->startElementProc();
+    Element* const childElement = startElement(elementData);
     element = childElement;
     // Check that all attributes have been used during creation of the element.
     checkAttributes();
-    delete copiedAttributes;
-    // this->attributes is dangling now, but that's okay.
 
     // Parse direct subordinate elements.
     parseMacroElements();
@@ -593,6 +741,8 @@ void Parser::parseMacroElement(ElementData& elementData)
 
     // Check that there were no required children missing.
     checkElements();
+    if(recordingSceneCache)
+      recordingSceneCache->write(SceneCache::endElement);
     if(element)
     {
       // Link element to its parent.
@@ -611,19 +761,199 @@ void Parser::parseMacroElement(ElementData& elementData)
   }
 }
 
-bool Parser::getStringRaw(const char* key, bool required, const std::string*& value)
+Element* Parser::startElement(ElementData& elementData)
 {
-  const auto iter = attributes->find(key);
-  if(iter == attributes->end())
+  recordedAttributes.clear();
+  Element* const newElement = elementData.info->startElementProc();
+  if(recordingSceneCache)
   {
-    if(required)
-      handleError("Expected attribute \"" + std::string(key) + "\"", elementData->location);
-    return false;
+    // Only the resolved values of the attributes that have been read are needed to instantiate the element again.
+    recordingSceneCache->write(SceneCache::beginElement);
+    recordingSceneCache->write(elementData.info->name);
+    recordingSceneCache->write(static_cast<std::uint32_t>(elementData.location.line));
+    recordingSceneCache->write(static_cast<std::uint32_t>(elementData.location.column));
+    recordingSceneCache->write(static_cast<std::uint32_t>(recordedAttributes.size()));
+    for(const auto& [name, value] : recordedAttributes)
+    {
+      recordingSceneCache->write(name);
+      recordingSceneCache->write(value);
+    }
+    if(newElement)
+      recordedElements[newElement] = recordedElementCount;
+    ++recordedElementCount;
+    if(instantiatedElements)
+      instantiatedElements->push_back(newElement);
   }
-  const Attribute& ai = iter->second;
-  elementData->parsedAttributes |= 1u << ai.index;
-  value = &replacePlaceholders(ai.value, ai.valueLocation);
-  return true;
+  return newElement;
+}
+
+void Parser::reuseElement(Element& existingElement)
+{
+  if(recordingSceneCache)
+  {
+    const auto iter = recordedElements.find(&existingElement);
+    ASSERT(iter != recordedElements.end());
+    recordingSceneCache->write(SceneCache::reuseElement);
+    recordingSceneCache->write(iter->second);
+  }
+  existingElement.addParent(*element);
+}
+
+bool Parser::checkSceneCache(SceneCache& sceneCache)
+{
+  // Walk through all events without instantiating anything so that an invalid cache can still be rejected.
+  std::uint32_t depth = 0;
+  std::uint32_t instantiatedElements = 0;
+  std::vector<bool> textAllowed;
+  while(!sceneCache.atEnd())
+  {
+    SceneCache::Event event;
+    std::string_view name, value;
+    std::uint32_t number, line, column;
+    if(!sceneCache.read(event))
+      return false;
+    switch(event)
+    {
+      case SceneCache::beginElement:
+      {
+        if(!sceneCache.read(name) || !sceneCache.read(line) || !sceneCache.read(column) || !sceneCache.read(number) || number > 32)
+          return false;
+        const auto iter = elementInfos.find(std::string(name));
+        if(iter == elementInfos.end() || iter->second->elementClass == infrastructureClass)
+          return false;
+        for(std::uint32_t i = 0; i < number; ++i)
+          if(!sceneCache.read(name) || !sceneCache.read(value))
+            return false;
+        textAllowed.push_back(iter->second->flags & textFlag);
+        ++depth;
+        ++instantiatedElements;
+        break;
+      }
+      case SceneCache::text:
+      case SceneCache::numbers:
+        if(!depth || !textAllowed.back() || !sceneCache.read(value) || !sceneCache.read(line) || !sceneCache.read(column) ||
+           (event == SceneCache::numbers && value.size() % 4))
+          return false;
+        break;
+      case SceneCache::reuseElement:
+        if(!depth || !sceneCache.read(number) || number >= instantiatedElements)
+          return false;
+        break;
+      case SceneCache::endElement:
+        if(!depth)
+          return false;
+        textAllowed.pop_back();
+        --depth;
+        break;
+    }
+  }
+  return !depth && instantiatedElements;
+}
+
+void Parser::replaySceneCache(SceneCache& sceneCache, std::vector<Element*>& instantiatedElements, std::uint32_t& index)
+{
+  // The cache has been checked, so reading cannot fail.
+  std::string_view name, value;
+  std::uint32_t count, line, column;
+  VERIFY(sceneCache.read(name));
+  VERIFY(sceneCache.read(line));
+  VERIFY(sceneCache.read(column));
+  const Location location(static_cast<int>(line), static_cast<int>(column));
+  ElementData elementData(this->elementData, location, elementInfos.find(std::string(name))->second);
+  // The values are already resolved, so they do not have placeholders.
+  std::vector<CompiledAttribute> elementAttributes;
+  VERIFY(sceneCache.read(count));
+  elementAttributes.reserve(count);
+  for(std::uint32_t i = 0; i < count; ++i)
+  {
+    VERIFY(sceneCache.read(name));
+    VERIFY(sceneCache.read(value));
+    elementAttributes.push_back({&intern(name), Attribute(std::string(value), i, location, location), {}, true});
+  }
+
+  // Create the new element and set it as current.
+  ElementData* const parentElementData = this->elementData;
+  Element* const parentElement = element;
+  this->elementData = &elementData;
+  setAttributes(elementAttributes);
+  Element* const childElement = elementData.info->startElementProc();
+  if(instantiatedElements.size() <= index)
+    instantiatedElements.resize(index + 1);
+  instantiatedElements[index++] = childElement;
+  element = childElement;
+
+  // Handle text / data and subordinate elements.
+  for(;;)
+  {
+    SceneCache::Event event;
+    VERIFY(sceneCache.read(event));
+    if(event == SceneCache::endElement)
+      break;
+    else if(event == SceneCache::beginElement)
+      replaySceneCache(sceneCache, instantiatedElements, index);
+    else if(event == SceneCache::text || event == SceneCache::numbers)
+    {
+      VERIFY(sceneCache.read(value));
+      VERIFY(sceneCache.read(line));
+      VERIFY(sceneCache.read(column));
+      std::string text;
+      if(event == SceneCache::numbers)
+      {
+        // The text handler gets the numbers through getNumbers.
+        replayedNumbers = value;
+        replayingNumbers = true;
+      }
+      else
+        text = value;
+      elementData.info->textProc(text, Location(static_cast<int>(line), static_cast<int>(column)));
+      replayingNumbers = false;
+    }
+    else
+    {
+      ASSERT(event == SceneCache::reuseElement);
+      VERIFY(sceneCache.read(count));
+      if(instantiatedElements[count] && element)
+        instantiatedElements[count]->addParent(*element);
+    }
+  }
+
+  // Link element to its parent.
+  if(element && parentElement)
+    element->addParent(*parentElement);
+  this->elementData = parentElementData;
+  element = parentElement;
+}
+
+const Reader::Attribute* Parser::findAttribute(const char* key) const
+{
+  for(const CompiledAttribute* attribute : attributes)
+    if(*attribute->name == key)
+      return &attribute->attribute;
+  return nullptr;
+}
+
+const std::string& Parser::intern(std::string_view str)
+{
+  auto iter = internedStrings.find(str);
+  if(iter == internedStrings.end())
+    iter = internedStrings.emplace(str).first;
+  return *iter;
+}
+
+bool Parser::getStringRaw(const char* key, bool required, const std::string*& value)
+{
+  for(std::size_t i = 0; i < attributes.size(); ++i)
+    if(*attributes[i]->name == key)
+    {
+      elementData->parsedAttributes |= 1u << i;
+      value = &replacePlaceholders(*attributes[i]);
+      if(recordingSceneCache && std::none_of(recordedAttributes.begin(), recordedAttributes.end(), [key](const auto& pair) {return pair.first == key;}))
+        recordedAttributes.emplace_back(key, *value);
+      return true;
+    }
+  if(required)
+    handleError("Expected attribute \"" + std::string(key) + "\"", elementData->location);
+  return false;
 }
 
 bool Parser::getFloatRaw(const char* key, bool required, float& value)
@@ -635,7 +965,7 @@ bool Parser::getFloatRaw(const char* key, bool required, float& value)
   value = std::strtof(strvalue->c_str(), &end);
   if(*end)
   {
-    handleError("Expected float", attributes->find(key)->second.valueLocation);
+    handleError("Expected float", findAttribute(key)->valueLocation);
     return false;
   }
   return true;
@@ -650,7 +980,7 @@ bool Parser::getIntegerRaw(const char* key, bool required, int& value)
   value = static_cast<int>(std::strtol(strvalue->c_str(), &end, 10));
   if(*end)
   {
-    handleError("Expected integer", attributes->find(key)->second.valueLocation);
+    handleError("Expected integer", findAttribute(key)->valueLocation);
     return false;
   }
   return true;
@@ -676,7 +1006,7 @@ bool Parser::getBool(const char* key, bool required, bool defaultValue)
     return true;
   if(*value == "false" || *value == "0" || *value == "off")
     return false;
-  handleError("Expected boolean value (true or false)", attributes->find(key)->second.valueLocation);
+  handleError("Expected boolean value (true or false)", findAttribute(key)->valueLocation);
   return defaultValue;
 }
 
@@ -693,7 +1023,7 @@ float Parser::getFloatPositive(const char* key, bool required, float defaultValu
     return defaultValue;
   if(value < 0.f)
   {
-    handleError("Expected a positive value", attributes->find(key)->second.valueLocation);
+    handleError("Expected a positive value", findAttribute(key)->valueLocation);
     return defaultValue;
   }
   return value;
@@ -708,7 +1038,7 @@ float Parser::getFloatMinMax(const char* key, bool required, float defaultValue,
   {
     char msg[256];
     sprintf(msg, "Expected a value between %g and %g instead of %g", min, max, value);
-    handleError(msg, attributes->find(key)->second.valueLocation);
+    handleError(msg, findAttribute(key)->valueLocation);
     return defaultValue;
   }
   return value;
@@ -719,7 +1049,7 @@ bool Parser::getFloatAndUnit(const char* key, bool required, float& value, char*
   const std::string* strValue;
   if(!getStringRaw(key, required, strValue))
     return false;
-  unitLocation = attributes->find(key)->second.valueLocation;
+  unitLocation = findAttribute(key)->valueLocation;
   value = std::strtof(strValue->c_str(), unit);
   if(*unit == strValue->c_str())
   {
@@ -739,7 +1069,7 @@ int Parser::getInteger(const char* key, bool required, int defaultValue, bool no
     return defaultValue;
   if(nonZeroPositive && value <= 0)
   {
-    handleError("Expected a positive non-zero value", attributes->find(key)->second.valueLocation);
+    handleError("Expected a positive non-zero value", findAttribute(key)->valueLocation);
     return defaultValue;
   }
   return value;
@@ -752,7 +1082,7 @@ std::uint16_t Parser::getUInt16(const char* key, bool required, std::uint16_t de
     return defaultValue;
   if(value < 0 || value >= std::numeric_limits<std::uint16_t>::max())
   {
-    handleError("Expected an unsigned 16 bit value", attributes->find(key)->second.valueLocation);
+    handleError("Expected an unsigned 16 bit value", findAttribute(key)->valueLocation);
     return defaultValue;
   }
   return static_cast<std::uint16_t>(value);
@@ -767,7 +1097,7 @@ float Parser::getLength(const char* key, bool required, float defaultValue, bool
     return defaultValue;
   if(nonZeroPositive && result <= 0.f)
   {
-    handleError("Expected a positive non-zero value", attributes->find(key)->second.valueLocation);
+    handleError("Expected a positive non-zero value", findAttribute(key)->valueLocation);
     return defaultValue;
   }
   if(*endPtr)
@@ -846,7 +1176,7 @@ float Parser::getAngle(const char* key, bool required, float defaultValue, bool
     return defaultValue;
   if(nonZeroPositive && result <= 0.f)
   {
-    handleError("Expected a positive non-zero value", attributes->find(key)->second.valueLocation);
+    handleError("Expected a positive non-zero value", findAttribute(key)->valueLocation);
     return defaultValue;
   }
   if(*endPtr)
@@ -918,7 +1248,7 @@ float Parser::getMass(const char* key, bool required, float defaultValue)
     }
   }
   if(result <= 0.f)
-    handleError("A mass should be greater than zero", attributes->find(key)->second.valueLocation);
+    handleError("A mass should be greater than zero", findAttribute(key)->valueLocation);
   return result;
 }
 
@@ -951,7 +1281,7 @@ float Parser::getTimeNonZeroPositive(const char* key, bool required, float defau
     return defaultValue;
   if(result <= 0.f)
   {
-    handleError("Expected a positive non-zero value", attributes->find(key)->second.valueLocation);
+    handleError("Expected a positive non-zero value", findAttribute(key)->valueLocation);
     return defaultValue;
   }
   if(*endPtr)
@@ -981,7 +1311,7 @@ float Parser::getUnit(const char* key, bool required, float defaultValue)
     result = 1000.f;
   else if(strcmp(s->c_str(), "m") != 0)
   {
-    handleError("Unexpected unit \"" + *s + "\" (expected one of \"mm, cm, dm, m, km\")", attributes->find(key)->second.valueLocation);
+    handleError("Unexpected unit \"" + *s + "\" (expected one of \"mm, cm, dm, m, km\")", findAttribute(key)->valueLocation);
     return defaultValue;
   }
   return result;
@@ -992,7 +1322,7 @@ bool Parser::getColor(const char* key, bool required, unsigned char* color)
   const std::string* strValue;
   if(!getStringRaw(key, required, strValue))
     return false;
-  Location location = attributes->find(key)->second.valueLocation;
+  Location location = findAttribute(key)->valueLocation;
   const char* strColor = strValue->c_str();
   if(*strColor == '#')
   {
@@ -1134,6 +1464,107 @@ bool Parser::getColor(const char* key, bool required, unsigned char* color)
   }
 }
 
+void Parser::addInputFile(const std::string& fileName)
+{
+  if(recordingSceneCache)
+    recordingSceneCache->addInputFile(fileName);
+  if(dataFiles && std::none_of(dataFiles->begin(), dataFiles->end(), [&fileName](const SceneCache::InputFile& dataFile) {return dataFile.fileName == fileName;}))
+  {
+    // A file that cannot be read is registered anyway, so it is noticed when it becomes readable.
+    SceneCache::InputFile& dataFile = dataFiles->emplace_back(SceneCache::InputFile{fileName, 0, 0});
+    SceneCache::hashFile(fileName, dataFile.size, dataFile.hash);
+  }
+}
+
+bool Parser::getNumbers(const std::string& text, Location location, std::vector<float>& numbers, std::size_t groupSize, const char* error)
+{
+  return getNumbersImpl(text, location, numbers, groupSize, error);
+}
+
+bool Parser::getNumbers(const std::string& text, Location location, std::vector<unsigned int>& numbers, std::size_t groupSize, const char* error)
+{
+  return getNumbersImpl(text, location, numbers, groupSize, error);
+}
+
+template<typename T>
+bool Parser::getNumbersImpl(const std::string& text, Location location, std::vector<T>& numbers, std::size_t groupSize, const char* error)
+{
+  static_assert(sizeof(T) == 4, "The scene cache stores numbers with 4 bytes");
+  if(replayingNumbers)
+  {
+    // The numbers were checked when they were recorded.
+    replayingNumbers = false;
+    if(replayedNumbers.size() % (sizeof(T) * groupSize))
+    {
+      handleError(error, location);
+      return false;
+    }
+    const std::size_t start = numbers.size();
+    numbers.resize(start + replayedNumbers.size() / sizeof(T));
+    std::memcpy(numbers.data() + start, replayedNumbers.data(), replayedNumbers.size());
+    return true;
+  }
+
+  const char* str = text.c_str();
+  const char* const end = str + text.size();
+
+  // Count the words in advance so that the numbers are appended without reallocations.
+  std::size_t words = 0;
+  bool previousIsSpace = true;
+  for(const char* c = str; c != end; ++c)
+  {
+    const bool isSpace = *c == ' ' || *c == '\n' || *c == '\r' || *c == '\t';
+    words += previousIsSpace && !isSpace;
+    previousIsSpace = isSpace;
+  }
+  const std::size_t start = numbers.size();
+  numbers.reserve(start + words);
+
+  skipWhitespace(str, location);
+  while(str != end)
+  {
+    if(*str == '#')
+    {
+      while(str != end && *str != '\n' && *str != '\r')
+      {
+        ++str;
+        ++location.column;
+      }
+      skipWhitespace(str, location);
+      continue;
+    }
+    // std::from_chars is locale-independent, but unlike strtof/strtol it does not accept a leading '+'.
+    const char* const first = *str == '+' ? str + 1 : str;
+    T value;
+    const auto [next, ec] = std::from_chars(first, end, value);
+    bool valid = ec == std::errc();
+    if constexpr(std::is_floating_point_v<T>)
+      valid &= std::isfinite(value); // std::from_chars accepts "inf" and "nan".
+    if(!valid)
+    {
+      numbers.resize(start);
+      handleError(error, location);
+      return false;
+    }
+    numbers.push_back(value);
+    location.column += static_cast<int>(next - str);
+    str = next;
+    skipWhitespace(str, location);
+  }
+  if((numbers.size() - start) % groupSize)
+  {
+    numbers.resize(start);
+    handleError(error, location);
+    return false;
+  }
+  if(recordingSceneCache)
+  {
+    recordedNumbers.append(reinterpret_cast<const char*>(numbers.data() + start), (numbers.size() - start) * sizeof(T));
+    ++recordedNumbersCount;
+  }
+  return true;
+}
+
 Element* Parser::simulationElement()
 {
   passedSimulationTag = true;
@@ -1145,6 +1576,6 @@ Element* Parser::includeElement()
 {
   includeFile = getString("href", true);
   if(!includeFile.empty())
-    includeFileLocation = attributes->find("href")->second.valueLocation;
+    includeFileLocation = findAttribute("href")->valueLocation;
   return nullptr;
 }
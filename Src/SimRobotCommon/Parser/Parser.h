@@ -10,10 +10,15 @@
 #pragma once
 
 #include "Parser/Reader.h"
+#include "Parser/SceneCache.h"
+#include <cstdint>
 #include <functional>
 #include <list>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class Element;
@@ -25,16 +30,50 @@ class Element;
 class Parser : protected Reader
 {
 public:
+  /**
+   * The compiled scene (see \c SceneCache) together with the elements it instantiated.
+   * Two compiled scenes can be compared to find out which elements differ between two versions of a scene.
+   */
+  struct CompiledScene
+  {
+    std::string events; /**< The events of the compiled scene. */
+    std::vector<Element*> elements; /**< The instantiated elements in the order of their instantiation (\c nullptr for elements that only modify their parent). */
+    std::unique_ptr<SceneCache> cache; /**< The loaded or recorded scene cache. The caller can add sections and save it (\c nullptr if scenes are not cached). */
+    std::string cacheFileName; /**< The name of the file of the scene cache. */
+    std::vector<SceneCache::InputFile> dataFiles; /**< The files (other than scene descriptions) that were loaded by elements, with their contents' hashes at that time. */
+  };
+
   /** Destructor. */
   ~Parser();
 
   /**
    * Parses a .ros2(d) file into the scene graph.
+   * The scene graph is compiled into a file in the cache directory (see \c SceneCache::getFileName), which is used
+   * instead of parsing the scene description again as long as neither the file nor any file that it includes has changed.
    * @param fileName The name of the file to parse.
    * @param errors A list which is filled with messages about errors during parsing.
+   * @param compiledScene If not \c nullptr, this is filled with the compiled scene. Its cache is not saved then, so
+   *                      the caller can add data that it derives from the scene before saving it.
+   * @param useSceneCache Whether an up-to-date compiled scene may be used. Otherwise, the file is parsed (and compiled again).
    * @return Whether the file was parsed successfully.
    */
-  bool parse(const std::string& fileName, std::list<std::string>& errors);
+  bool parse(const std::string& fileName, std::list<std::string>& errors, CompiledScene* compiledScene = nullptr, bool useSceneCache = true);
+
+  /**
+   * Instantiates an element of a compiled scene (including its subordinate elements) as a child of an existing element,
+   * e.g. to add an element of a modified version of a scene to the scene graph of a running simulation.
+   * @param fileName The name of the scene file.
+   * @param events The events of the compiled scene (as recorded or checked by \c parse).
+   * @param structure The structure of the compiled scene.
+   * @param index The index of the element to instantiate.
+   * @param parent The existing element that becomes the parent of the new element.
+   * @param elements The elements of the compiled scene (indexed like \c structure). It must contain all elements that the
+   *                 new elements reuse and the new elements are stored in it.
+   * @param errors A list which is filled with messages about errors.
+   * @return Whether there were no errors.
+   */
+  bool instantiate(const std::string& fileName, std::string_view events, const SceneCache::Structure& structure, std::uint32_t index,
+                   Element& parent, std::vector<Element*>& elements, std::list<std::string>& errors);
 
 protected:
   using StartElementProc = std::function<Element*()>;
@@ -67,7 +106,7 @@ protected:
     const ElementInfo* info; /**< The info about the type of this element. */
     unsigned int parsedChildren = 0; /**< Bit mask of the already parsed child element classes. */
     unsigned int parsedAttributes = 0; /**< Bit mask of the already parsed attributes. */
-    std::unordered_map<std::string, std::string> vars; /**< User defined variables for placeholders in attributes. */
+    std::unordered_map<const std::string*, std::string> vars; /**< User defined variables for placeholders in attributes (indexed by their interned names). */
     bool usedPlaceholdersInAttributes = false; /**< Whether this element used placeholders in its attributes. */
     Location location; /**< The location of the instantiated element. */
 
@@ -76,6 +115,23 @@ protected:
     {}
   };
 
+  /** An attribute whose value has been split into literal text and placeholders when it was read. */
+  struct CompiledAttribute final
+  {
+    /** A part of the value of an attribute. */
+    struct Segment final
+    {
+      std::uint32_t offset; /**< The offset of the part in the value. */
+      std::uint32_t length; /**< The length of the part. */
+      const std::string* placeholder; /**< The interned name of the placeholder if the part is one (otherwise \c nullptr). */
+    };
+
+    const std::string* name; /**< The interned name of the attribute. */
+    Attribute attribute; /**< The value and the locations of the attribute. */
+    std::vector<Segment> segments; /**< The parts of the value (empty if it does not contain placeholders). */
+    bool valid; /**< Whether all placeholders in the value are closed. */
+  };
+
   /**
    * Handler for errors during parsing.
    * @param msg An error message.
@@ -84,6 +140,9 @@ protected:
   void handleError(const std::string& msg, const Location& location) override;
 
 private:
+  template<typename T>
+  bool getNumbersImpl(const std::string& text, Location location, std::vector<T>& numbers, std::size_t groupSize, const char* error);
+
   bool getStringRaw(const char* key, bool required, const std::string*& value);
   bool getFloatRaw(const char* key, bool required, float& value);
   bool getIntegerRaw(const char* key, bool required, int& value);
@@ -109,6 +168,42 @@ protected:
   float getUnit(const char* key, bool required, float defaultValue);
   bool getColor(const char* key, bool required, unsigned char* color);
 
+  /**
+   * Parses a text block of whitespace separated numbers (\c # starts a comment until the end of the line).
+   * @param text The text.
+   * @param location The location of the text.
+   * While a compiled scene is recorded, the numbers are stored instead of the text, and while it is replayed, they are
+   * appended directly (the text is empty then). Therefore, a text handler must parse its text with one call of this method.
+   * @param numbers The numbers are appended to this vector (nothing is appended if the text is invalid).
+   * @param groupSize The number of numbers read must be a multiple of this.
+   * @param error The error message for invalid text (which includes infinite and NaN values).
+   * @return Whether the text was valid.
+   */
+  bool getNumbers(const std::string& text, Location location, std::vector<float>& numbers, std::size_t groupSize, const char* error);
+  bool getNumbers(const std::string& text, Location location, std::vector<unsigned int>& numbers, std::size_t groupSize, const char* error);
+
+  /**
+   * Returns an attribute of the current element.
+   * @param key The name of the attribute.
+   * @return The attribute or \c nullptr if the current element does not have it.
+   */
+  const Attribute* findAttribute(const char* key) const;
+
+  /**
+   * Returns the only instance of a string that is stored by this parser.
+   * Interned strings can be compared and hashed by their addresses.
+   * @param str The string.
+   * @return The instance (valid as long as the parser exists).
+   */
+  const std::string& intern(std::string_view str);
+
+  /**
+   * Registers a file that an element handler loaded (e.g. a mesh), so that the compiled scene is not used anymore
+   * and reloading the scene recreates it if the file changes.
+   * @param fileName The name of the file.
+   */
+  void addInputFile(const std::string& fileName);
+
   Element* simulationElement();
   Element* includeElement();
 
@@ -116,21 +211,21 @@ protected:
 
   Element* element = nullptr; /**< The last inserted XML element. */
   ElementData* elementData = nullptr; /**< Element context data required for parsing an XML element. */
-  const Attributes* attributes = nullptr; /**< The current set of attributes. */
+  std::vector<const CompiledAttribute*> attributes; /**< The current set of attributes (in the order of their indices). */
 
 private:
   struct MacroElement
   {
     MacroElement* parent; /**< The parent macro element. */
     const ElementInfo* elementInfo; /**< The info about the type of this macro element */
-    Attributes attributes; /**< The attributes of this macro element. */
+    std::vector<CompiledAttribute> attributes; /**< The attributes of this macro element (in the order of their indices). */
     std::string text; /**< The text / data belonging to this macro element (can be empty if there is none). */
     Location textLocation; /**< The location of the text / data (if there is some). */
     std::list<MacroElement*> children; /**< The child macro elements of this macro element. */
     Element* element = nullptr; /**< An actual element that was created from the macro element. */
     Location location; /**< The location of the macro element. */
 
-    MacroElement(MacroElement* parent, const ElementInfo* elementInfo, Attributes& attributes, const Location& location) :
+    MacroElement(MacroElement* parent, const ElementInfo* elementInfo, std::vector<CompiledAttribute>& attributes, const Location& location) :
       parent(parent), elementInfo(elementInfo), location(location)
     {
       this->attributes.swap(attributes);
@@ -157,7 +252,7 @@ private:
     std::string fileName; /**< The file in which the macro was declared. */
     bool replaying = false; /**< A flag for detecting macro reference loops. */
 
-    Macro(const ElementInfo* elementInfo, const std::string& fileName, Attributes& attributes, const Location& location) :
+    Macro(const ElementInfo* elementInfo, const std::string& fileName, std::vector<CompiledAttribute>& attributes, const Location& location) :
       MacroElement(nullptr, elementInfo, attributes, location), fileName(fileName)
     {}
   };
@@ -184,24 +279,65 @@ private:
   /** Checks if some required subordinate elements have not been parsed. */
   void checkElements();
 
+  /**
+   * Splits the values of attributes into literal text and placeholders ($String, $(String) or ${String}).
+   * @param attributes The attributes.
+   * @param compiledAttributes Is filled with the compiled attributes (in the order of their indices).
+   */
+  void compileAttributes(const Attributes& attributes, std::vector<CompiledAttribute>& compiledAttributes);
+
+  /**
+   * Makes a list of compiled attributes the current set of attributes.
+   * @param compiledAttributes The attributes (in the order of their indices).
+   */
+  void setAttributes(const std::vector<CompiledAttribute>& compiledAttributes);
+
   /**
    * Resolves a placeholder in the context of the current element.
-   * @param name The name of the placeholder
+   * @param name The interned name of the placeholder
    * @return A pointer to the value of the placeholder (or null if it is not defined).
    */
-  const std::string* resolvePlaceholder(const std::string& name);
+  const std::string* resolvePlaceholder(const std::string* name);
 
   /**
-   * Replaces placeholders ($String) in a string with their values.
-   * @param str The string in which to replace placeholders with their values.
-   * @param location The location of the string.
-   * @return The resulting string (which is overwritten by further calls to this method).
+   * Replaces the placeholders in the value of an attribute with their values.
+   * @param attribute The attribute.
+   * @return The resulting string (which is overwritten by further calls to this method unless the value does not contain placeholders).
    */
-  const std::string& replacePlaceholders(const std::string& str, const Location& location);
+  const std::string& replacePlaceholders(const CompiledAttribute& attribute);
 
   /** Instantiates the elements below <Simulation>. */
   void parseSimulation();
 
+  /**
+   * Calls the start element handler of an element and records the instantiation in the compiled scene (if one is recorded).
+   * @param elementData The parsing context of the element.
+   * @return The element created by the handler.
+   */
+  Element* startElement(ElementData& elementData);
+
+  /**
+   * Adds an already instantiated element to the current element and records this in the compiled scene (if one is recorded).
+   * @param existingElement The element that is reused.
+   */
+  void reuseElement(Element& existingElement);
+
+  /**
+   * Checks whether the events of a compiled scene form a scene graph that can be instantiated by this parser.
+   * @param sceneCache The compiled scene.
+   * @return Whether it is valid.
+   */
+  bool checkSceneCache(SceneCache& sceneCache);
+
+  /**
+   * Instantiates an element of a (checked) compiled scene including its subordinate elements.
+   * The \c beginElement event must already have been read.
+   * @param sceneCache The compiled scene.
+   * @param instantiatedElements The elements of the compiled scene (in the order of their instantiation).
+   * @param index The index of the element in the compiled scene. Is set to the index behind its last subordinate element.
+   */
+  void replaySceneCache(SceneCache& sceneCache, std::vector<Element*>& instantiatedElements, std::uint32_t& index);
+
   /** Instantiates all children of the currently replaying macro element. */
   void parseMacroElements();
 
@@ -226,4 +362,23 @@ private:
   MacroElement* replayingMacroElement = nullptr; /**< A macro element set to insert subordinate nodes of a macro. */
 
   std::string placeholderBuffer; /**< A buffer which contains the most recently resolved placeholder. */
+
+  /** A hash function for strings that also accepts string views. */
+  struct StringHash
+  {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view str) const {return std::hash<std::string_view>()(str);}
+  };
+  std::unordered_set<std::string, StringHash, std::equal_to<>> internedStrings; /**< The strings returned by \c intern. */
+
+  SceneCache* recordingSceneCache = nullptr; /**< The compiled scene that is recorded while parsing (if any). */
+  std::string recordedNumbers; /**< The bytes of the numbers the current text was parsed into (while recording). */
+  unsigned int recordedNumbersCount = 0; /**< The number of times the current text was parsed into numbers (while recording). */
+  std::string_view replayedNumbers; /**< The bytes of the numbers the current text is replaced by (while replaying). */
+  bool replayingNumbers = false; /**< Whether the current text is replaced by \c replayedNumbers. */
+  std::vector<std::pair<std::string, std::string>> recordedAttributes; /**< The resolved values of the attributes that the current element handler has read. */
+  std::unordered_map<const Element*, std::uint32_t> recordedElements; /**< The indices of the instantiated elements in the recorded compiled scene. */
+  std::uint32_t recordedElementCount = 0; /**< The number of element instantiations in the recorded compiled scene. */
+  std::vector<Element*>* instantiatedElements = nullptr; /**< The list of instantiated elements that is filled while recording (if requested). */
+  std::vector<SceneCache::InputFile>* dataFiles = nullptr; /**< The list of files loaded by element handlers that is filled while parsing (if requested). */
 };
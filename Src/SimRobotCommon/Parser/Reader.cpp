@@ -25,199 +25,216 @@
  */
 
 #include <cctype>
-#include <fstream>
-#include <iostream>
+#include <cstring>
 
 #include "Reader.h"
 #include "Platform/Assert.h"
+#include "Platform/MappedFile.h"
+
+namespace
+{
+  /** Character classes of the language */
+  enum CharClass : unsigned char
+  {
+    spaceChar = 1,
+    nameStartChar = 2,
+    nameChar = 4
+  };
+
+  /** A lookup table that maps each byte to its character classes */
+  struct CharClasses
+  {
+    unsigned char classes[256] = {};
+
+    CharClasses()
+    {
+      for(const char c : {' ', '\n', '\r', '\t'})
+        classes[static_cast<unsigned char>(c)] = spaceChar;
+      for(int c = 'A'; c <= 'Z'; ++c)
+        classes[c] = classes[c + 'a' - 'A'] = nameStartChar | nameChar;
+      for(int c = '0'; c <= '9'; ++c)
+        classes[c] = nameChar;
+      classes[static_cast<unsigned char>('_')] = classes[static_cast<unsigned char>(':')] = nameStartChar | nameChar;
+      classes[static_cast<unsigned char>('.')] = classes[static_cast<unsigned char>('-')] = nameChar;
+    }
+
+    bool is(char c, CharClass charClass) const {return classes[static_cast<unsigned char>(c)] & charClass;}
+  };
+
+  const CharClasses charClasses;
+}
 
 bool Reader::readFile(const std::string& fileName)
 {
   // open file
-  std::ifstream reader(fileName);
-  if(!reader.is_open())
+  MappedFile file;
+  if(!file.open(fileName))
     return false;
 
   // backup reader state
   std::string oldFileName = fileName;
-  const Location oldLocation = location;
-  const Location oldNextLocation = nextLocation;
+  const std::string_view oldInput = input;
+  const std::size_t oldPosition = position;
+  const bool oldEmptyElement = emptyElement;
+  const std::size_t oldLocationOffset = lastLocationOffset;
+  const Location oldLastLocation = lastLocation;
 
   // set new reader state
-  this->reader.swap(reader);
   this->fileName.swap(oldFileName);
-  nextLocation = location = Location(1, 1);
-  ASSERT(nextToken == invalidToken);
+  input = file.getData();
+  position = 0;
+  emptyElement = false;
+  lastLocationOffset = 0;
+  lastLocation = Location(1, 1);
 
   // read root elements
   bool result = readElements(true, true);
 
-  // close reader
-  this->reader.close();
-
   // restore old reader state
   if(!oldFileName.empty())
-  {
     this->fileName.swap(oldFileName);
-    location = oldLocation;
-    nextLocation = oldNextLocation;
-  }
-  nextToken = invalidToken;
-  this->reader.swap(reader);
+  input = oldInput;
+  position = oldPosition;
+  emptyElement = oldEmptyElement;
+  lastLocationOffset = oldLocationOffset;
+  lastLocation = oldLastLocation;
 
   return result;
 }
 
 bool Reader::readElements(bool callHandler, bool isRoot)
 {
-  if(!reader.is_open()) // the last element was "empty"
+  if(emptyElement) // the last element was "empty"
     return true;
 
-  Token token;
-  while(tokenIsSpace(token = readToken()));
-
+  skipSpace();
   for(;;)
   {
-    if(token == tagStart || token == commentStart)
+    if(position >= input.size())
     {
-      undoReadToken(token);
-      if(!readElement(callHandler))
-        return false;
-      while(tokenIsSpace(token = readToken()));
+      if(!isRoot)
+        handleError("Unexpected end of file", getLocation(position));
+      return isRoot;
     }
-    else if(token == endTagStart)
+    else if(lookingAt("</"))
     {
       if(isRoot)
       {
-        handleError("Unexpected end tag without matching opening tag", location);
+        handleError("Unexpected end tag without matching opening tag", getLocation(position));
         return false;
       }
-      undoReadToken(endTagStart);
       return true;
     }
-    else if(token == endOfInput)
-    {
-      if(!isRoot)
-        handleError("Unexpected end of file", location);
-      return isRoot;
-    }
-    else
+    else if(input[position] == '<')
     {
-      undoReadToken(token);
-      if(!readData(callHandler))
+      if(!readElement(callHandler))
         return false;
-      token = readToken();
+      skipSpace();
     }
+    else if(!readData(callHandler))
+      return false;
   }
 }
 
 bool Reader::readElement(bool callHandler)
 {
-  Token token = readToken();
-  if(token == tagStart)
+  if(lookingAt("<!--"))
   {
-    Location nameLocation;
-    if(!readName(nameLocation))
-      return false;
-    const std::string name = tmpString;
-    attributes.clear();
-    if(!readAttributes())
+    const std::size_t startCommentOffset = position;
+    const std::size_t commentEnd = input.find("-->", position + 4);
+    if(commentEnd == std::string_view::npos)
+    {
+      handleError("Unterminated comment", getLocation(startCommentOffset));
       return false;
-    token = readToken();
-    if(token == emptyTagEnd)
+    }
+    position = commentEnd + 3;
+    return true;
+  }
+
+  // This function is only called if the next character starts a tag.
+  ASSERT(input[position] == '<');
+  ++position;
+  Location nameLocation;
+  if(!readName(nameLocation))
+    return false;
+  const std::string name = tmpString;
+  attributes.clear();
+  if(!readAttributes())
+    return false;
+  if(lookingAt("/>"))
+  {
+    position += 2;
+    if(callHandler)
     {
-      if(callHandler)
-      {
-        // This signals further calls to readElements that there is nothing to read
-        std::ifstream f;
-        reader.swap(f);
-        handleElement(name, attributes, nameLocation);
-        reader.swap(f);
-      }
-      return true;
+      // This signals further calls to readElements that there is nothing to read
+      emptyElement = true;
+      handleElement(name, attributes, nameLocation);
+      emptyElement = false;
+    }
+    return true;
+  }
+  else if(input[position] == '>')
+  {
+    ++position;
+    bool result;
+    if(callHandler)
+    {
+      // handleElement is responsible for calling readElements.
+      result = handleElement(name, attributes, nameLocation);
     }
-    else if(token == tagEnd)
+    else
+      result = readElements(false);
+    if(!result)
+      return false;
+    // readElements would not have returned true if the next characters were not "</".
+    ASSERT(lookingAt("</"));
+    position += 2;
+    Location endNameLocation;
+    if(!readName(endNameLocation))
+      return false;
+    const std::string& endName = tmpString;
+    skipSpace();
+    if(position < input.size() && input[position] == '>')
     {
-      bool result;
-      if(callHandler)
+      ++position;
+      if(name != endName)
       {
-        // handleElement is responsible for calling readElements.
-        result = handleElement(name, attributes, nameLocation);
-      }
-      else
-        result = readElements(false);
-      if(!result)
+        handleError("End tag does not match", endNameLocation);
+        handleError("Note: Matching tag is here", nameLocation);
         return false;
-      token = readToken();
-      if(token == endTagStart)
-      {
-        Location endNameLocation;
-        if(!readName(endNameLocation))
-          return false;
-        const std::string& endName = tmpString;
-        while(tokenIsSpace(token = readToken()));
-        if(token == tagEnd)
-        {
-          if(name != endName)
-          {
-            handleError("End tag does not match", endNameLocation);
-            handleError("Note: Matching tag is here", nameLocation);
-            return false;
-          }
-          return true;
-        }
-        else
-        {
-          handleError("Expected tag end", location);
-          return false;
-        }
       }
-      // readElements would not have returned true if the next token was not endTagStart.
-      ASSERT(false);
-      return false;
+      return true;
     }
     else
     {
-      handleError("Expected tag end", location);
+      handleError("Expected tag end", getLocation(position));
       return false;
     }
   }
-  else if(token == commentStart)
+  else
   {
-    const Location startCommentLocation = location;
-    while((token = readToken()) != commentEnd)
-    {
-      if(token == endOfInput)
-      {
-        handleError("Unterminated comment", startCommentLocation);
-        return false;
-      }
-    }
-    return true;
+    handleError("Expected tag end", getLocation(position));
+    return false;
   }
-  // This function is only called if one of the above conditions is true.
-  ASSERT(false);
-  return false;
 }
 
 bool Reader::readAttributes()
 {
   for(;;)
   {
-    bool readWhitespace = false;
-    Token token;
-    while(tokenIsSpace(token = readToken()) && (readWhitespace = true));
-    undoReadToken(token);
-    if(token == tagEnd || token == emptyTagEnd)
-      return true;
-    else if(token == endOfInput)
+    const std::size_t start = position;
+    skipSpace();
+    const bool readWhitespace = position != start;
+    if(position >= input.size())
     {
-      handleError("Unexpected end of file", location);
+      handleError("Unexpected end of file", getLocation(position));
       return false;
     }
+    else if(input[position] == '>' || lookingAt("/>"))
+      return true;
     else if(!readWhitespace)
     {
-      handleError("Attributes must be separated by whitespace characters", location);
+      handleError("Attributes must be separated by whitespace characters", getLocation(position));
       return false;
     }
     else if(!readAttribute())
@@ -231,12 +248,11 @@ bool Reader::readAttribute()
   if(!readName(nameLocation))
     return false;
   const std::string name = tmpString;
-  Token token;
-  while(tokenIsSpace(token = readToken()));
-  if(token == equals)
+  skipSpace();
+  if(position < input.size() && input[position] == '=')
   {
-    while(tokenIsSpace(token = readToken()));
-    undoReadToken(token);
+    ++position;
+    skipSpace();
     Location valueLocation;
     if(!readString(valueLocation))
       return false;
@@ -246,217 +262,130 @@ bool Reader::readAttribute()
   }
   else
   {
-    if(token == endOfInput)
-      handleError("Unexpected end of file", location);
+    if(position >= input.size())
+      handleError("Unexpected end of file", getLocation(position));
     else
-      handleError("Expected '=' after attribute name", location);
+      handleError("Expected '=' after attribute name", getLocation(position));
     return false;
   }
 }
 
 bool Reader::readName(Location& location)
 {
-  Token token = readToken();
-  if(token >= firstNonCharToken || (!std::isalpha(static_cast<unsigned char>(token)) && token != underscore && token != colon))
+  if(position >= input.size() || !charClasses.is(input[position], nameStartChar))
   {
-    if(token == endOfInput)
-      handleError("Unexpected end of file", this->location);
-    else if(tokenIsSpace(token))
-      handleError("Unexpected whitespace", this->location);
+    if(position >= input.size())
+      handleError("Unexpected end of file", getLocation(position));
+    else if(charClasses.is(input[position], spaceChar))
+      handleError("Unexpected whitespace", getLocation(position));
     else
-      handleError("A name must begin with an alphabetic letter, underscore or colon", this->location);
+      handleError("A name must begin with an alphabetic letter, underscore or colon", getLocation(position));
     return false;
   }
-  location = this->location;
-  tmpString.clear();
-  tmpString += static_cast<char>(token);
-  for(;;)
-  {
-    token = readToken();
-    if(token >= firstNonCharToken || (!std::isalnum(static_cast<unsigned char>(token)) && token != dot && token != dash && token != underscore && token != colon))
-    {
-      undoReadToken(token);
-      return true;
-    }
-    tmpString += static_cast<char>(token);
-  }
+  location = getLocation(position);
+  const std::size_t start = position++;
+  while(position < input.size() && charClasses.is(input[position], nameChar) &&
+        !(input[position] == '-' && input.compare(position + 1, 2, "->") == 0)) // "-->" ends a comment
+    ++position;
+  tmpString.assign(input, start, position - start);
+  return true;
 }
 
 bool Reader::readString(Location& location)
 {
-  Token token = readToken();
-  if(token != doubleQuote)
+  if(position >= input.size() || input[position] != '"')
   {
-    if(token == endOfInput)
-      handleError("Unexpected end of file", this->location);
-    else if(tokenIsSpace(token))
-      handleError("Unexpected whitespace", this->location);
+    if(position >= input.size())
+      handleError("Unexpected end of file", getLocation(position));
+    else if(charClasses.is(input[position], spaceChar))
+      handleError("Unexpected whitespace", getLocation(position));
     else
-      handleError("A string must begin with a double quote character", this->location);
+      handleError("A string must begin with a double quote character", getLocation(position));
     return false;
   }
-  const Location startQuoteLocation = this->location;
-  bool wroteLocation = false;
+  const std::size_t startQuoteOffset = position++;
+  location = getLocation(position);
   tmpString.clear();
-  bool escaped = false;
-  while((token = readToken()) != doubleQuote && !escaped)
+  for(;;)
   {
-    if(token == endOfInput)
+    // find the closing quote and copy everything up to it in one go if there is no escape sequence in between
+    const char* const begin = input.data() + position;
+    const char* const quote = static_cast<const char*>(std::memchr(begin, '"', input.size() - position));
+    const char* const backslash = quote ? static_cast<const char*>(std::memchr(begin, '\\', quote - begin)) : nullptr;
+    if(!quote || (backslash && backslash + 1 == input.data() + input.size()))
     {
-      handleError("Unterminated string (there must be a closing double quote somewhere)", startQuoteLocation);
+      handleError("Unterminated string (there must be a closing double quote somewhere)", getLocation(startQuoteOffset));
       return false;
     }
-    if(!wroteLocation)
-    {
-      location = this->location;
-      wroteLocation = true;
-    }
-    if(!escaped && token == backslash)
+    if(!backslash)
     {
-      escaped = true;
-      continue;
+      tmpString.append(begin, quote);
+      position = quote - input.data() + 1;
+      return true;
     }
-    if(static_cast<int>(token) < firstNonCharToken)
-      tmpString += static_cast<char>(token);
-    else
-      tmpString += nonCharTokenToString(token);
+    tmpString.append(begin, backslash);
+    tmpString += backslash[1];
+    position = backslash - input.data() + 2;
   }
-  if(!wroteLocation)
-    location = this->location;
-  return true;
 }
 
 bool Reader::readData(bool callHandler)
 {
-  tmpString.clear();
-  Token token = readToken();
-  // This function is only called if the next token is not one of the ones below.
-  ASSERT(token != endOfInput && token != tagStart && token != endTagStart);
-  const Location dataLocation = location;
-  if(static_cast<int>(token) < firstNonCharToken)
-    tmpString += static_cast<char>(token);
-  else
-    tmpString += nonCharTokenToString(token);
-  while((token = readToken()) != endTagStart && token != tagStart)
+  // This function is only called if the next character does not start a tag.
+  ASSERT(position < input.size() && input[position] != '<');
+  const std::size_t start = position;
+  for(;;)
   {
-    if(token == endOfInput)
+    const char* const tagStart = static_cast<const char*>(std::memchr(input.data() + position, '<', input.size() - position));
+    if(!tagStart)
     {
-      handleError("Unterminated data block (there must be a tag somewhere)", dataLocation);
+      handleError("Unterminated data block (there must be a tag somewhere)", getLocation(start));
       return false;
     }
-    if(static_cast<int>(token) < firstNonCharToken)
-      tmpString += static_cast<char>(token);
-    else
-      tmpString += nonCharTokenToString(token);
+    position = tagStart - input.data();
+    if(!lookingAt("<!--")) // comments do not end data blocks
+      break;
+    position += 4;
   }
-  undoReadToken(token);
 
   if(callHandler)
-    handleText(tmpString, dataLocation);
-  return true;
-}
-
-Reader::Token Reader::readToken()
-{
-  prevLocation = location;
-  location = nextLocation;
-  if(nextToken != invalidToken)
   {
-    const Token token = nextToken;
-    nextToken = invalidToken;
-    nextLocation = nextNextLocation;
-    return token;
+    tmpString.assign(input, start, position - start);
+    handleText(tmpString, getLocation(start));
   }
-  const char c = static_cast<char>(reader.get());
-  if(!reader.good())
-    return endOfInput;
-  ASSERT(c != EOF);
-  if(c == '\n')
-  {
-    ++nextLocation.line;
-    nextLocation.column = 1;
-  }
-  else if((c & 0xc0) != 0x80) // This handles UTF-8 continuation characters.
-    ++nextLocation.column;
-  if(c == '<')
-  {
-    char nextC = static_cast<char>(reader.peek());
-    if(nextC == '/')
-    {
-      reader.get();
-      ++nextLocation.column;
-      return endTagStart;
-    }
-    else if(nextC == '!')
-    {
-      reader.get();
-      if(reader.peek() == '-')
-      {
-        reader.get();
-        if(reader.peek() == '-')
-        {
-          reader.get();
-          nextLocation.column += 3;
-          return commentStart;
-        }
-        reader.putback('-');
-      }
-      reader.putback('!');
-    }
-  }
-  else if(c == '/')
-  {
-    if(reader.peek() == '>')
-    {
-      reader.get();
-      ++nextLocation.column;
-      return emptyTagEnd;
-    }
-  }
-  else if(c == '-')
-  {
-    if(reader.peek() == '-')
-    {
-      reader.get();
-      if(reader.peek() == '>')
-      {
-        reader.get();
-        nextLocation.column += 2;
-        return commentEnd;
-      }
-      reader.putback('-');
-    }
-  }
-  return static_cast<Token>(c);
-}
-
-void Reader::undoReadToken(Token token)
-{
-  ASSERT(nextToken == invalidToken);
-  nextToken = token;
-  nextNextLocation = nextLocation;
-  nextLocation = location;
-  location = prevLocation;
+  return true;
 }
 
-std::string Reader::nonCharTokenToString(Token token)
+void Reader::skipSpace()
 {
-  ASSERT(token >= firstNonCharToken);
-  if(token == emptyTagEnd)
-    return "/>";
-  else if(token == endTagStart)
-    return "</";
-  else if(token == commentStart)
-    return "<!--";
-  else if(token == commentEnd)
-    return "-->";
-  ASSERT(false);
-  return std::string();
+  while(position < input.size() && charClasses.is(input[position], spaceChar))
+    ++position;
 }
 
-bool Reader::tokenIsSpace(Token token)
+Reader::Location Reader::getLocation(std::size_t offset)
 {
-  return token == ' ' || token == '\n' || token == '\r' || token == '\t';
+  ASSERT(offset <= input.size());
+  if(offset < lastLocationOffset)
+  {
+    lastLocationOffset = 0;
+    lastLocation = Location(1, 1);
+  }
+  const char* current = input.data() + lastLocationOffset;
+  const char* const end = input.data() + offset;
+  while(current < end)
+  {
+    const char* const lineEnd = static_cast<const char*>(std::memchr(current, '\n', end - current));
+    if(!lineEnd)
+      break;
+    ++lastLocation.line;
+    lastLocation.column = 1;
+    current = lineEnd + 1;
+  }
+  for(; current < end; ++current)
+    if((*current & 0xc0) != 0x80) // This handles UTF-8 continuation characters.
+      ++lastLocation.column;
+  lastLocationOffset = offset;
+  return lastLocation;
 }
 
 void Reader::skipWhitespace(const char*& str, Location& loc)
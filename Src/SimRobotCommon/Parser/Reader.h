@@ -26,8 +26,9 @@
 
 #pragma once
 
-#include <fstream>
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 /**
@@ -49,14 +50,6 @@ protected:
     Attribute(const std::string& value, int index, const Location& nameLocation, const Location& valueLocation) :
       value(value), index(index), nameLocation(nameLocation), valueLocation(valueLocation) {}
 
-    /**
-     * Copies an attribute with a new index
-     * @param other The other attribute
-     * @param index The new index
-     */
-    Attribute(const Attribute& other, unsigned int index) :
-      value(other.value), index(index), nameLocation(other.nameLocation), valueLocation(other.valueLocation) {}
-
     std::string value; /**< The value of the attribute (i.e. what is in between the quotes) */
     unsigned int index; /**< The index in the list of attributes of its containing tag */
     Location nameLocation; /**< The location of the attribute name */
@@ -116,58 +109,33 @@ protected:
 
 private:
   /**
-   * Represents a (very low level) token of the language
-   * The values from 0 to 255 have their normal UTF-8 character meaning.
-   * Values above 255 represent tokens that do not correspond to a single character.
-   */
-  enum Token : int
-  {
-    invalidToken = -1,
-    endOfInput = 0,
-    doubleQuote = '"',
-    dash = '-',
-    dot = '.',
-    colon = ':',
-    tagStart = '<',
-    equals = '=',
-    tagEnd = '>',
-    backslash = '\\',
-    underscore = '_',
-    firstNonCharToken = 256,
-    emptyTagEnd = firstNonCharToken, // />
-    endTagStart, // </
-    commentStart, // <!--
-    commentEnd // -->
-  };
-
-  /**
-   * Reads an element from the stream
+   * Reads an element from the input
    * @param callHandler Whether handlers for subordinate elements should be called
    * @return Whether an element could be read
    */
   bool readElement(bool callHandler);
 
   /**
-   * Reads all attributes within a tag from the stream and stores them in \c attributes
+   * Reads all attributes within a tag from the input and stores them in \c attributes
    * @return Whether the attributes could be read
    */
   bool readAttributes();
 
   /**
-   * Reads an attribute from the stream and stores it in \c attributes
+   * Reads an attribute from the input and stores it in \c attributes
    * @return Whether an attribute could be read
    */
   bool readAttribute();
 
   /**
-   * Reads a name from the stream and writes it to \c tmpString
+   * Reads a name from the input and writes it to \c tmpString
    * @param location Is filled with the location of the name
    * @return Whether a name could be read
    */
   bool readName(Location& location);
 
   /**
-   * Reads a string from the stream and writes it to \c tmpString
+   * Reads a string from the input and writes it to \c tmpString
    * @param location Is filled with the location of the first character after the quote
    * @return Whether a string could be read
    */
@@ -180,39 +148,30 @@ private:
    */
   bool readData(bool callHandler);
 
-  /**
-   * Reads a token from the input stream and sets the current location accordingly
-   * @return The token that has been read
-   */
-  Token readToken();
+  /** Advances \c position to the next non-whitespace character */
+  void skipSpace();
 
   /**
-   * Puts an already read token back
-   * readToken must be called in between calls to this method and before this method is called after readFile has been entered.
-   * @param token The read token
+   * Checks whether the input continues with a character sequence at the current position
+   * @param str The character sequence
+   * @return Whether it does
    */
-  void undoReadToken(Token token);
+  bool lookingAt(std::string_view str) const {return input.compare(position, str.size(), str) == 0;}
 
   /**
-   * Returns the character sequence that corresponds to a token
-   * @param token The token to convert
-   * @return The converted string
+   * Computes the location of an offset in the current file
+   * Locations are only needed for error messages and handlers, so they are not tracked while scanning.
+   * This is fast if the offset is not before the offset of the previous call.
+   * @param offset The offset in \c input
+   * @return The location
    */
-  static std::string nonCharTokenToString(Token token);
+  Location getLocation(std::size_t offset);
 
-  /**
-   * Custom version of isspace that is independent of the C locale and supports values that do not fit into an unsigned char.
-   * @param token The token to test
-   * @return Whether the token represents a whitespace character
-   */
-  static bool tokenIsSpace(Token token);
-
-  std::ifstream reader; /**< The stream from which to read */
-  Location location; /**< The location of the last token returned by readToken */
-  Location nextLocation; /**< The location where the next token starts */
-  Token nextToken = invalidToken; /**< The token that was put back (not saved over reentrant \c readFile calls) */
-  Location prevLocation; /**< The location before the last call to readToken (needed by \c undoReadToken) */
-  Location nextNextLocation; /**< The next location after the next call to readToken (filled by \c undoReadToken) */
+  std::string_view input; /**< The contents of the current file */
+  std::size_t position = 0; /**< The offset of the next character to read in \c input */
+  bool emptyElement = false; /**< Whether the handler of an empty element (e.g. <x/>) is running, i.e. there is nothing to read */
+  std::size_t lastLocationOffset = 0; /**< The offset of the last location computed by \c getLocation */
+  Location lastLocation; /**< The last location computed by \c getLocation */
   std::string tmpString; /**< A string used by readName, readString and readData (not saved over reentrant \c readFile calls) */
   Attributes attributes; /**< A storage for the attributes of an element (not saved over reentrant \c readFile calls) */
 };
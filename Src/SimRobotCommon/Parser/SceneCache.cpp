@@ -0,0 +1,330 @@
+/**
+ * @file SceneCache.cpp
+ *
+ * This file implements a class that stores a compiled scene description in a binary file.
+ */
+
+#include "SceneCache.h"
+#include "Platform/System.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+void SceneCache::addInputFile(const std::string& fileName)
+{
+  for(const InputFile& inputFile : inputFiles)
+    if(inputFile.fileName == fileName)
+      return;
+  inputFiles.push_back({fileName, 0, 0});
+}
+
+void SceneCache::write(std::string_view value)
+{
+  write(static_cast<std::uint32_t>(value.size()));
+  body.append(value);
+}
+
+std::string_view SceneCache::getSection(const std::string& name) const
+{
+  if(const auto section = sections.find(name); section != sections.end())
+    return section->second;
+  const auto section = loadedSections.find(name);
+  return section != loadedSections.end() ? section->second : std::string_view();
+}
+
+std::string SceneCache::getFileName(const std::string& fileName)
+{
+  if(const char* disabled = std::getenv("SIMROBOT_NO_SCENE_CACHE"); disabled && *disabled)
+    return std::string();
+
+  const std::string directory = System::getCacheDirectory();
+  if(directory.empty())
+    return std::string();
+
+  // Scenes with the same name in different directories get different cache files.
+  std::error_code error;
+  const std::filesystem::path path = std::filesystem::absolute(fileName, error).lexically_normal();
+  const std::string pathString = path.generic_string();
+  std::uint64_t hash = 0xcbf29ce484222325;
+  for(const char c : pathString)
+    hash = (hash ^ static_cast<std::uint8_t>(c)) * 0x100000001b3;
+  char hashString[17];
+  std::snprintf(hashString, sizeof(hashString), "%016llx", static_cast<unsigned long long>(hash));
+  return directory + path.stem().string() + "-" + hashString + ".cache";
+}
+
+bool SceneCache::save(const std::string& fileName) const
+{
+  const auto append = [](std::string& target, const auto& value) {target.append(reinterpret_cast<const char*>(&value), sizeof(value));};
+  const auto appendString = [&append](std::string& target, std::string_view value)
+  {
+    append(target, static_cast<std::uint32_t>(value.size()));
+    target.append(value);
+  };
+
+  std::string header;
+  append(header, magic);
+  append(header, version);
+  append(header, static_cast<std::uint32_t>(inputFiles.size()));
+  for(const InputFile& inputFile : inputFiles)
+  {
+    std::uint64_t size, hash;
+    if(!hashFile(inputFile.fileName, size, hash))
+      return false;
+    appendString(header, inputFile.fileName);
+    append(header, size);
+    append(header, hash);
+  }
+  const std::string_view events = getEvents();
+  append(header, static_cast<std::uint64_t>(events.size()));
+
+  // Sections that were set replace loaded ones with the same name.
+  std::map<std::string_view, std::string_view> allSections(loadedSections.begin(), loadedSections.end());
+  for(const auto& [name, value] : sections)
+    allSections[name] = value;
+  std::string trailer;
+  append(trailer, static_cast<std::uint32_t>(allSections.size()));
+  for(const auto& [name, value] : allSections)
+  {
+    appendString(trailer, name);
+    appendString(trailer, value);
+  }
+
+  // Write to a temporary file first so that a concurrent load never sees a partial cache.
+  const std::string tempFileName = fileName + ".tmp";
+  {
+    std::ofstream stream(tempFileName, std::ios::binary | std::ios::trunc);
+    if(!stream.is_open())
+      return false;
+    stream.write(header.data(), static_cast<std::streamsize>(header.size()));
+    stream.write(events.data(), static_cast<std::streamsize>(events.size()));
+    stream.write(trailer.data(), static_cast<std::streamsize>(trailer.size()));
+    if(!stream.good())
+    {
+      stream.close();
+      std::remove(tempFileName.c_str());
+      return false;
+    }
+  }
+  std::remove(fileName.c_str());
+  if(std::rename(tempFileName.c_str(), fileName.c_str()) != 0)
+  {
+    std::remove(tempFileName.c_str());
+    return false;
+  }
+  return true;
+}
+
+bool SceneCache::load(const std::string& fileName)
+{
+  inputFiles.clear();
+  body.clear();
+  sections.clear();
+  loadedSections.clear();
+  if(open(fileName))
+    return true;
+
+  // An invalid file is not kept, so this object does not appear to be loaded.
+  file.close();
+  data = std::string_view();
+  inputFiles.clear();
+  loadedSections.clear();
+  bodyStart = bodyEnd = position = 0;
+  return false;
+}
+
+bool SceneCache::open(const std::string& fileName)
+{
+  if(!file.open(fileName))
+    return false;
+  data = file.getData();
+  position = 0;
+  bodyEnd = data.size();
+
+  std::uint32_t fileMagic, fileVersion, inputFileCount;
+  if(!read(fileMagic) || fileMagic != magic || !read(fileVersion) || fileVersion != version || !read(inputFileCount))
+    return false;
+  for(std::uint32_t i = 0; i < inputFileCount; ++i)
+  {
+    std::string_view inputFileName;
+    std::uint64_t expectedSize, expectedHash, size, hash;
+    if(!read(inputFileName) || data.size() - position < 2 * sizeof(std::uint64_t))
+      return false;
+    std::memcpy(&expectedSize, data.data() + position, sizeof(expectedSize));
+    std::memcpy(&expectedHash, data.data() + position + sizeof(expectedSize), sizeof(expectedHash));
+    position += 2 * sizeof(std::uint64_t);
+    if(!hashFile(std::string(inputFileName), size, hash) || size != expectedSize || hash != expectedHash)
+      return false;
+    inputFiles.push_back({std::string(inputFileName), 0, 0});
+  }
+  std::uint64_t eventsSize;
+  if(data.size() - position < sizeof(eventsSize))
+    return false;
+  std::memcpy(&eventsSize, data.data() + position, sizeof(eventsSize));
+  position += sizeof(eventsSize);
+  if(data.size() - position < eventsSize)
+    return false;
+  bodyStart = position;
+
+  // The sections behind the events are read before reading is limited to the events.
+  position = bodyStart + static_cast<std::size_t>(eventsSize);
+  std::uint32_t sectionCount;
+  if(!read(sectionCount))
+    return false;
+  for(std::uint32_t i = 0; i < sectionCount; ++i)
+  {
+    std::string_view name, value;
+    if(!read(name) || !read(value))
+      return false;
+    loadedSections.emplace(std::string(name), value);
+  }
+  if(position != data.size())
+    return false;
+  bodyEnd = bodyStart + static_cast<std::size_t>(eventsSize);
+  position = bodyStart;
+  return true;
+}
+
+bool SceneCache::read(Event& event)
+{
+  if(position >= bodyEnd || static_cast<std::uint8_t>(data[position]) > endElement)
+    return false;
+  event = static_cast<Event>(data[position++]);
+  return true;
+}
+
+bool SceneCache::read(std::uint32_t& value)
+{
+  if(bodyEnd - position < sizeof(value))
+    return false;
+  std::memcpy(&value, data.data() + position, sizeof(value));
+  position += sizeof(value);
+  return true;
+}
+
+bool SceneCache::read(std::string_view& value)
+{
+  std::uint32_t length;
+  if(!read(length) || bodyEnd - position < length)
+    return false;
+  value = data.substr(position, length);
+  position += length;
+  return true;
+}
+
+void SceneCache::setEvents(std::string_view events, std::size_t offset)
+{
+  file.close();
+  data = events;
+  bodyStart = 0;
+  bodyEnd = events.size();
+  position = offset;
+}
+
+bool SceneCache::analyze(std::string_view events, Structure& structure)
+{
+  // FNV-1a over the lengths and bytes of the values, so that different splits of the same bytes differ.
+  constexpr std::uint64_t prime = 0x100000001b3;
+  const auto hashValue = [](std::uint64_t hash, std::string_view value)
+  {
+    hash = (hash ^ value.size()) * prime;
+    for(const char c : value)
+      hash = (hash ^ static_cast<std::uint8_t>(c)) * prime;
+    return hash;
+  };
+
+  SceneCache cache;
+  cache.setEvents(events);
+  structure.elements.clear();
+  structure.roots.clear();
+  std::vector<std::uint32_t> openElements;
+  while(!cache.atEnd())
+  {
+    Event event;
+    std::string_view name, value;
+    std::uint32_t number, line, column;
+    if(!cache.read(event))
+      return false;
+    switch(event)
+    {
+      case beginElement:
+      {
+        const std::uint32_t index = static_cast<std::uint32_t>(structure.elements.size());
+        Structure::Element& element = structure.elements.emplace_back();
+        element.offset = cache.position;
+        element.parent = openElements.empty() ? noParent : openElements.back();
+        element.end = 0;
+
+        // The locations are skipped, since they change whenever lines are inserted above the element.
+        if(!cache.read(element.name) || !cache.read(line) || !cache.read(column) || !cache.read(number))
+          return false;
+        element.ownHash = hashValue(0xcbf29ce484222325, element.name);
+        for(std::uint32_t i = 0; i < number; ++i)
+        {
+          if(!cache.read(name) || !cache.read(value))
+            return false;
+          element.ownHash = hashValue(hashValue(element.ownHash, name), value);
+          if(name == "name")
+            element.nameAttribute = value;
+        }
+        if(openElements.empty())
+          structure.roots.push_back(index);
+        else
+          structure.elements[openElements.back()].children.push_back({index, false});
+        openElements.push_back(index);
+        break;
+      }
+      case text:
+      case numbers:
+        if(openElements.empty() || !cache.read(value) || !cache.read(line) || !cache.read(column))
+          return false;
+        structure.elements[openElements.back()].ownHash = hashValue(structure.elements[openElements.back()].ownHash, value);
+        break;
+      case reuseElement:
+        // Only complete elements can be reused.
+        if(openElements.empty() || !cache.read(number) || number >= structure.elements.size() || !structure.elements[number].end)
+          return false;
+        structure.elements[openElements.back()].children.push_back({number, true});
+        break;
+      case endElement:
+      {
+        if(openElements.empty())
+          return false;
+        Structure::Element& element = structure.elements[openElements.back()];
+        openElements.pop_back();
+        element.end = static_cast<std::uint32_t>(structure.elements.size());
+        element.hash = element.ownHash;
+        for(const Structure::Child& child : element.children)
+          element.hash = ((element.hash ^ structure.elements[child.index].hash) * prime ^ child.reused) * prime;
+        break;
+      }
+    }
+  }
+  return openElements.empty();
+}
+
+bool SceneCache::hashFile(const std::string& fileName, std::uint64_t& size, std::uint64_t& hash)
+{
+  MappedFile inputFile;
+  if(!inputFile.open(fileName))
+    return false;
+  const std::string_view contents = inputFile.getData();
+  size = contents.size();
+
+  // FNV-1a over 64 bit words (and the remaining bytes)
+  constexpr std::uint64_t prime = 0x100000001b3;
+  hash = 0xcbf29ce484222325;
+  std::size_t i = 0;
+  for(; i + sizeof(std::uint64_t) <= contents.size(); i += sizeof(std::uint64_t))
+  {
+    std::uint64_t word;
+    std::memcpy(&word, contents.data() + i, sizeof(word));
+    hash = (hash ^ word) * prime;
+  }
+  for(; i < contents.size(); ++i)
+    hash = (hash ^ static_cast<std::uint8_t>(contents[i])) * prime;
+  return true;
+}
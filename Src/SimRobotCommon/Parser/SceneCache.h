@@ -0,0 +1,234 @@
+/**
+ * @file SceneCache.h
+ *
+ * This file declares a class that stores a compiled scene description in a binary file.
+ * The compiled scene is the sequence of element instantiations that the parser performed after including files,
+ * expanding macros and replacing placeholders. Texts that were parsed into numbers are stored as these numbers.
+ * The file can also contain sections with data that the simulation derived from the scene (e.g. mesh buffers), so
+ * that loading the scene again skips computing them. It is only valid as long as none of the input files have changed.
+ *
+ * File format (all numbers in native byte order):
+ * file := magic version inputFileCount { inputFile } eventsSize { event } sectionCount { section }
+ * inputFile := string size hash
+ * event := beginElement string line column attributeCount { string string } | text string line column |
+ *          numbers string line column | reuseElement index | endElement
+ * section := string string
+ * string := length { char }
+ */
+
+#pragma once
+
+#include "Platform/MappedFile.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class SceneCache
+ * A compiled scene description that can be recorded and saved, or loaded and read back.
+ */
+class SceneCache
+{
+public:
+  /** The events of a compiled scene */
+  enum Event : std::uint8_t
+  {
+    beginElement, /**< An element is instantiated (followed by its name, location and the values of its attributes). */
+    text, /**< The text / data of the current element (followed by the text and its location). */
+    numbers, /**< The numbers that the text of the current element was parsed into (followed by their bytes and the location of the text). */
+    reuseElement, /**< A previously instantiated element is added to the current element (followed by its index). */
+    endElement /**< The current element is complete. */
+  };
+
+  /** A file on which a compiled scene depends. */
+  struct InputFile
+  {
+    std::string fileName; /**< The name of the file. */
+    std::uint64_t size; /**< The size of the file in bytes. */
+    std::uint64_t hash; /**< A hash of the contents of the file. */
+
+    bool operator==(const InputFile& other) const = default;
+  };
+
+  /**
+   * Adds a file to the set of files the compiled scene depends on.
+   * @param fileName The name of the file.
+   */
+  void addInputFile(const std::string& fileName);
+
+  /**
+   * Appends an event to the recorded compiled scene.
+   * @param event The event.
+   */
+  void write(Event event) {body.push_back(static_cast<char>(event));}
+
+  /**
+   * Appends a number to the recorded compiled scene.
+   * @param value The number.
+   */
+  void write(std::uint32_t value) {body.append(reinterpret_cast<const char*>(&value), sizeof(value));}
+
+  /**
+   * Appends a string to the recorded compiled scene.
+   * @param value The string.
+   */
+  void write(std::string_view value);
+
+  /**
+   * Sets a section with data that was derived from the compiled scene. Change the name of a section whenever the
+   * format of its data changes.
+   * @param name The name of the section.
+   * @param value The data.
+   */
+  void setSection(const std::string& name, std::string value) {sections[name] = std::move(value);}
+
+  /**
+   * Returns a section with data that was derived from the compiled scene.
+   * @param name The name of the section.
+   * @return The data (empty if there is no such section; valid as long as this object exists and nothing else is loaded).
+   */
+  std::string_view getSection(const std::string& name) const;
+
+  /**
+   * Writes the recorded or loaded compiled scene together with all sections to a file.
+   * @param fileName The name of the cache file.
+   * @return Whether the file could be written.
+   */
+  bool save(const std::string& fileName) const;
+
+  /**
+   * Maps a cache file into memory and checks whether it is still valid, i.e. whether it has the current format and
+   * whether all files it depends on are unchanged.
+   * @param fileName The name of the cache file.
+   * @return Whether the file can be used.
+   */
+  bool load(const std::string& fileName);
+
+  /**
+   * Whether the compiled scene was loaded from a file (rather than recorded).
+   * @return Whether a cache file is loaded.
+   */
+  bool isLoaded() const {return file.isOpen();}
+
+  /**
+   * Returns the events of the recorded or loaded compiled scene.
+   * @return The events (valid as long as this object exists and nothing else is recorded or loaded).
+   */
+  std::string_view getEvents() const {return file.isOpen() ? data.substr(bodyStart, bodyEnd - bodyStart) : std::string_view(body);}
+
+  /**
+   * Returns the name of the cache file of a scene. It is located in the cache directory of SimRobot, so scene
+   * directories do not need to be writable and are not cluttered.
+   * @param fileName The name of the scene file.
+   * @return The name of the cache file (empty if there is no cache directory or the environment variable
+   *         SIMROBOT_NO_SCENE_CACHE is set).
+   */
+  static std::string getFileName(const std::string& fileName);
+
+  /** The tree of the elements that a compiled scene instantiates, which is used to find out what differs between two versions of a scene. */
+  struct Structure
+  {
+    /** An element that is added to an instantiated element. */
+    struct Child
+    {
+      std::uint32_t index; /**< The index of the child element. */
+      bool reused; /**< Whether the child was instantiated before and is only reused here. */
+    };
+
+    /** An instantiated element. */
+    struct Element
+    {
+      std::size_t offset; /**< The offset of the name of the element in the events (i.e. behind its beginElement event). */
+      std::uint32_t parent; /**< The index of the parent (\c noParent for top-level elements). */
+      std::uint32_t end; /**< The index behind the last element instantiated inside this one. */
+      std::string_view name; /**< The name of the element (e.g. "Body"). */
+      std::string_view nameAttribute; /**< The value of the attribute "name" (empty if there is none). */
+      std::uint64_t ownHash; /**< A hash of the name, the attributes and the text of the element, ignoring its location. */
+      std::uint64_t hash; /**< A hash of the element together with all of its children (including reused ones). */
+      std::vector<Child> children; /**< The elements that were added to this one (in their order). */
+    };
+
+    std::vector<Element> elements; /**< All instantiated elements in the order of their instantiation. */
+    std::vector<std::uint32_t> roots; /**< The top-level elements. */
+  };
+
+  /**
+   * Determines the structure of a compiled scene.
+   * @param events The events of a compiled scene.
+   * @param structure Is filled with the structure.
+   * @return Whether the events were valid.
+   */
+  static bool analyze(std::string_view events, Structure& structure);
+
+  /**
+   * Reads events that were not loaded from a file, e.g. those of a compiled scene.
+   * @param events The events (must stay valid while reading).
+   * @param offset The offset of the next value to read.
+   */
+  void setEvents(std::string_view events, std::size_t offset = 0);
+
+  /**
+   * Calculates a hash of a file.
+   * @param fileName The name of the file.
+   * @param size Is filled with the size of the file.
+   * @param hash Is filled with the hash of its contents.
+   * @return Whether the file could be read.
+   */
+  static bool hashFile(const std::string& fileName, std::uint64_t& size, std::uint64_t& hash);
+
+  static constexpr std::uint32_t noParent = 0xffffffff; /**< The parent index of top-level elements. */
+
+  /** Restarts reading at the first event of a loaded compiled scene. */
+  void rewind() {position = bodyStart;}
+
+  /**
+   * Whether all events of a loaded compiled scene have been read.
+   * @return Whether the end has been reached.
+   */
+  bool atEnd() const {return position == bodyEnd;}
+
+  /**
+   * Reads an event from a loaded compiled scene.
+   * @param event Is filled with the event.
+   * @return Whether there was a valid event.
+   */
+  bool read(Event& event);
+
+  /**
+   * Reads a number from a loaded compiled scene.
+   * @param value Is filled with the number.
+   * @return Whether there was a number.
+   */
+  bool read(std::uint32_t& value);
+
+  /**
+   * Reads a string from a loaded compiled scene.
+   * @param value Is filled with the string (valid as long as the cache is loaded).
+   * @return Whether there was a string.
+   */
+  bool read(std::string_view& value);
+
+private:
+  static constexpr std::uint32_t magic = 0x43535253; /**< "SRSC" */
+  static constexpr std::uint32_t version = 2; /**< The version of the file format and of the semantics of the events. Increment it when either changes. */
+
+  /**
+   * Maps a cache file into memory and reads its header and sections.
+   * @param fileName The name of the cache file.
+   * @return Whether the file is valid.
+   */
+  bool open(const std::string& fileName);
+
+  std::vector<InputFile> inputFiles; /**< The files the recorded compiled scene depends on. */
+  std::string body; /**< The recorded events. */
+  std::map<std::string, std::string> sections; /**< The sections that were set since the cache was recorded or loaded. */
+
+  MappedFile file; /**< The loaded cache file. */
+  std::string_view data; /**< The contents of the loaded cache file. */
+  std::size_t bodyStart = 0; /**< The offset of the first event in \c data. */
+  std::size_t bodyEnd = 0; /**< The offset behind the last event in \c data. */
+  std::map<std::string, std::string_view, std::less<>> loadedSections; /**< The sections of the loaded cache file. */
+  std::size_t position = 0; /**< The offset of the next value to read in \c data. */
+};
@@ -0,0 +1,99 @@
+/**
+ * @file MappedFile.cpp
+ * Implementation of class MappedFile
+ */
+
+#ifdef WINDOWS
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.h"
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+bool MappedFile::open(const std::string& fileName)
+{
+  close();
+#ifdef WINDOWS
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if(file == INVALID_HANDLE_VALUE)
+    return false;
+  LARGE_INTEGER fileSize;
+  if(!GetFileSizeEx(file, &fileSize))
+  {
+    CloseHandle(file);
+    return false;
+  }
+  this->file = file;
+  size = static_cast<std::size_t>(fileSize.QuadPart);
+  if(size)
+  {
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(mapping)
+      data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if(!data)
+    {
+      if(mapping)
+        CloseHandle(mapping);
+      CloseHandle(file);
+      mapping = this->file = nullptr;
+      size = 0;
+      return false;
+    }
+  }
+#else
+  const int fd = ::open(fileName.c_str(), O_RDONLY);
+  if(fd < 0)
+    return false;
+  struct stat fileStat;
+  if(fstat(fd, &fileStat) != 0 || !S_ISREG(fileStat.st_mode))
+  {
+    ::close(fd);
+    return false;
+  }
+  size = static_cast<std::size_t>(fileStat.st_size);
+  if(size)
+  {
+    void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(address == MAP_FAILED)
+    {
+      ::close(fd);
+      size = 0;
+      return false;
+    }
+    madvise(address, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(address);
+  }
+  ::close(fd); // the mapping stays valid
+#endif
+  opened = true;
+  return true;
+}
+
+void MappedFile::close()
+{
+  if(!opened)
+    return;
+#ifdef WINDOWS
+  if(data)
+    UnmapViewOfFile(data);
+  if(mapping)
+    CloseHandle(mapping);
+  CloseHandle(file);
+  mapping = file = nullptr;
+#else
+  if(data)
+    munmap(const_cast<char*>(data), size);
+#endif
+  data = nullptr;
+  size = 0;
+  opened = false;
+}
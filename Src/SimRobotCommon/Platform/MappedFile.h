@@ -0,0 +1,56 @@
+/**
+ * @file MappedFile.h
+ * Declaration of class MappedFile
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * @class MappedFile
+ * A read-only view of a whole file that is mapped into memory
+ */
+class MappedFile
+{
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /** Destructor. Unmaps the file. */
+  ~MappedFile();
+
+  /**
+   * Maps a file into memory (and unmaps a previously mapped one)
+   * @param fileName The name of the file
+   * @return Whether the file could be opened
+   */
+  bool open(const std::string& fileName);
+
+  /** Unmaps the file */
+  void close();
+
+  /**
+   * Whether a file is mapped
+   * @return Whether it is mapped
+   */
+  bool isOpen() const {return opened;}
+
+  /**
+   * Returns the contents of the file
+   * @return The contents (valid until the file is closed)
+   */
+  std::string_view getData() const {return std::string_view(data, size);}
+
+private:
+  const char* data = nullptr; /**< The first byte of the file (\c nullptr for empty files) */
+  std::size_t size = 0; /**< The size of the file in bytes */
+  bool opened = false; /**< Whether a file is mapped */
+#ifdef WINDOWS
+  void* file = nullptr; /**< The handle of the file */
+  void* mapping = nullptr; /**< The handle of the file mapping */
+#endif
+};
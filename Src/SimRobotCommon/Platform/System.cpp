@@ -14,6 +14,9 @@
 #endif
 
 #include "System.h"
+#include <cstdlib>
+#include <filesystem>
+#include <system_error>
 
 unsigned int System::getTime()
 {
@@ -30,3 +33,27 @@ unsigned int System::getTime()
   return static_cast<unsigned int>(ts.tv_sec * 1000 + ts.tv_nsec / 1000000l);
 #endif
 }
+
+std::string System::getCacheDirectory()
+{
+  std::filesystem::path directory;
+#ifdef WINDOWS
+  if(const char* localAppData = std::getenv("LOCALAPPDATA"); localAppData && *localAppData)
+    directory = std::filesystem::path(localAppData) / "SimRobot" / "Cache";
+#elif defined MACOS
+  if(const char* home = std::getenv("HOME"); home && *home)
+    directory = std::filesystem::path(home) / "Library" / "Caches" / "SimRobot";
+#else
+  if(const char* cacheHome = std::getenv("XDG_CACHE_HOME"); cacheHome && *cacheHome == '/')
+    directory = std::filesystem::path(cacheHome) / "SimRobot";
+  else if(const char* home = std::getenv("HOME"); home && *home)
+    directory = std::filesystem::path(home) / ".cache" / "SimRobot";
+#endif
+  if(directory.empty())
+    return std::string();
+  std::error_code error;
+  std::filesystem::create_directories(directory, error);
+  if(error)
+    return std::string();
+  return (directory / "").string();
+}
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <string>
+
 /**
  * @class System
  * Collection of some basic platform-dependent system functions
@@ -18,4 +20,11 @@ public:
    * @return the time
    */
   static unsigned int getTime();
+
+  /**
+   * Returns the directory in which SimRobot stores files that can be recreated (e.g. scene caches).
+   * It is created if it does not exist.
+   * @return The directory (with a trailing separator) or an empty string if there is none
+   */
+  static std::string getCacheDirectory();
 };
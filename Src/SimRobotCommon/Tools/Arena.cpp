@@ -0,0 +1,46 @@
+/**
+ * @file Tools/Arena.cpp
+ * Implementation of class Arena
+ */
+
+#include "Arena.h"
+#include "Platform/Assert.h"
+#include <memory>
+
+void* Arena::allocate(std::size_t size, std::size_t alignment)
+{
+  ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+  void* memory = current;
+  if(std::align(alignment, size, memory, remaining))
+  {
+    current = static_cast<std::byte*>(memory) + size;
+    remaining -= size;
+    return memory;
+  }
+
+  // Large allocations get a block of their own, so that the rest of the current block is not wasted.
+  const std::size_t requiredSize = size + alignment - 1;
+  if(requiredSize > blockSize / 4)
+  {
+    blocks.emplace_back(new std::byte[requiredSize]);
+    memory = blocks.back().get();
+    std::size_t space = requiredSize;
+    VERIFY(std::align(alignment, size, memory, space));
+    return memory;
+  }
+
+  blocks.emplace_back(new std::byte[blockSize]);
+  memory = blocks.back().get();
+  remaining = blockSize;
+  VERIFY(std::align(alignment, size, memory, remaining));
+  current = static_cast<std::byte*>(memory) + size;
+  remaining -= size;
+  return memory;
+}
+
+void Arena::clear()
+{
+  blocks.clear();
+  current = nullptr;
+  remaining = 0;
+}
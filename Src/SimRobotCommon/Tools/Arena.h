@@ -0,0 +1,42 @@
+/**
+ * @file Tools/Arena.h
+ * Declaration of class Arena
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+/**
+ * @class Arena
+ * A memory pool that hands out memory from large blocks and releases all of it at once.
+ * Single allocations cannot be freed. The objects placed in the arena must be destructed
+ * by their owner before the arena is cleared.
+ */
+class Arena
+{
+public:
+  Arena() = default;
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  /**
+   * Allocates memory
+   * @param size The number of bytes
+   * @param alignment The alignment of the memory (a power of 2)
+   * @return The memory (valid until the arena is cleared)
+   */
+  void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+  /** Releases all memory allocated */
+  void clear();
+
+private:
+  static constexpr std::size_t blockSize = 64 * 1024; /**< The size of a regular block in bytes. */
+
+  std::vector<std::unique_ptr<std::byte[]>> blocks; /**< All blocks allocated. */
+  std::byte* current = nullptr; /**< The next free byte of the current block. */
+  std::size_t remaining = 0; /**< The number of free bytes in the current block. */
+};
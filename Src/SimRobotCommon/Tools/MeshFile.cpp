@@ -0,0 +1,555 @@
+/**
+ * @file Tools/MeshFile.cpp
+ * Implementation of class MeshFile
+ */
+
+#include "MeshFile.h"
+#include "Tools/Math/Eigen.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+namespace
+{
+  /** A simple tokenizer for the ASCII variants of STL and PLY */
+  class Tokenizer
+  {
+  public:
+    explicit Tokenizer(std::string_view data) : data(data) {}
+
+    /**
+     * Reads the next whitespace separated word.
+     * @return The word (empty at the end of the input).
+     */
+    std::string_view word()
+    {
+      while(position < data.size() && std::isspace(static_cast<unsigned char>(data[position])))
+        ++position;
+      const std::size_t start = position;
+      while(position < data.size() && !std::isspace(static_cast<unsigned char>(data[position])))
+        ++position;
+      return data.substr(start, position - start);
+    }
+
+    /**
+     * Reads the next word as number.
+     * @param value Is filled with the number.
+     * @return Whether the word was a number.
+     */
+    template<typename T>
+    bool number(T& value)
+    {
+      const std::string_view w = word();
+      const char* const first = !w.empty() && w[0] == '+' ? w.data() + 1 : w.data();
+      const auto [next, ec] = std::from_chars(first, w.data() + w.size(), value);
+      return ec == std::errc() && next == w.data() + w.size();
+    }
+
+    /**
+     * Reads the rest of the current line.
+     * @return The line without the line break.
+     */
+    std::string_view line()
+    {
+      const std::size_t start = position;
+      const std::size_t end = std::min(data.find('\n', position), data.size());
+      position = std::min(end + 1, data.size());
+      std::string_view result = data.substr(start, end - start);
+      if(!result.empty() && result.back() == '\r')
+        result.remove_suffix(1);
+      return result;
+    }
+
+    std::string_view data; /**< The text. */
+    std::size_t position = 0; /**< The offset of the next character to read. */
+  };
+
+  /** Hashes the bits of a vertex (position and normal) for merging identical vertices. */
+  struct VertexHasher
+  {
+    std::size_t operator()(const std::array<float, 6>& vertex) const
+    {
+      std::uint32_t bits[6];
+      std::memcpy(bits, vertex.data(), sizeof(bits));
+      std::size_t hash = 0;
+      for(const std::uint32_t b : bits)
+        hash = (hash ^ b) * 0x100000001b3;
+      return hash;
+    }
+  };
+
+  /** The scalar types of PLY properties */
+  enum PLYType
+  {
+    int8, uint8, int16, uint16, int32, uint32, float32, float64, invalid
+  };
+
+  /**
+   * Maps a PLY type name to the type.
+   * @param name The name of the type.
+   * @return The type (\c invalid if the name is unknown).
+   */
+  PLYType getPLYType(std::string_view name)
+  {
+    static const std::pair<std::string_view, PLYType> names[] =
+    {
+      {"char", int8}, {"int8", int8}, {"uchar", uint8}, {"uint8", uint8},
+      {"short", int16}, {"int16", int16}, {"ushort", uint16}, {"uint16", uint16},
+      {"int", int32}, {"int32", int32}, {"uint", uint32}, {"uint32", uint32},
+      {"float", float32}, {"float32", float32}, {"double", float64}, {"float64", float64}
+    };
+    for(const auto& [typeName, type] : names)
+      if(typeName == name)
+        return type;
+    return invalid;
+  }
+
+  /** A property of a PLY element (a scalar or a list of scalars) */
+  struct PLYProperty
+  {
+    std::string name; /**< The name of the property. */
+    PLYType type = invalid; /**< The type of the scalar(s). */
+    PLYType countType = invalid; /**< The type of the length of the list (\c invalid for scalars). */
+  };
+
+  /** An element declaration in a PLY header */
+  struct PLYElement
+  {
+    std::string name; /**< The name of the element. */
+    std::size_t count = 0; /**< The number of instances. */
+    std::vector<PLYProperty> properties; /**< The properties of each instance. */
+  };
+
+  /** Reads the values in the body of a PLY file */
+  class PLYReader
+  {
+  public:
+    PLYReader(std::string_view data, bool ascii) : tokenizer(data), ascii(ascii) {}
+
+    /**
+     * Reads a scalar.
+     * @param type The type of the scalar.
+     * @param value Is filled with its value.
+     * @return Whether there was a value.
+     */
+    bool read(PLYType type, double& value)
+    {
+      if(ascii)
+        return tokenizer.number(value);
+      static constexpr std::size_t sizes[] = {1, 1, 2, 2, 4, 4, 4, 8};
+      const std::size_t size = sizes[type];
+      if(tokenizer.data.size() - tokenizer.position < size)
+        return false;
+      const char* const p = tokenizer.data.data() + tokenizer.position;
+      tokenizer.position += size;
+      switch(type)
+      {
+        case int8: value = static_cast<std::int8_t>(*p); break;
+        case uint8: value = static_cast<std::uint8_t>(*p); break;
+        case int16: value = load<std::int16_t>(p); break;
+        case uint16: value = load<std::uint16_t>(p); break;
+        case int32: value = load<std::int32_t>(p); break;
+        case uint32: value = load<std::uint32_t>(p); break;
+        case float32: value = load<float>(p); break;
+        default: value = load<double>(p); break;
+      }
+      return true;
+    }
+
+  private:
+    template<typename T>
+    static T load(const char* p)
+    {
+      T value;
+      std::memcpy(&value, p, sizeof(T));
+      return value;
+    }
+
+    Tokenizer tokenizer; /**< The tokenizer (also used to track the position in binary files). */
+    bool ascii; /**< Whether the body is in ASCII format. */
+  };
+}
+
+bool MeshFile::load(const std::string& fileName, std::string& error, float scale)
+{
+  close();
+
+  std::string extension = fileName.substr(std::min(fileName.find_last_of('.'), fileName.size()));
+  std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) {return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));});
+  if(extension != ".stl" && extension != ".ply")
+    return map(fileName, error);
+
+  MappedFile source;
+  if(!source.open(fileName))
+  {
+    error = "Could not open file";
+    return false;
+  }
+  if(!(extension == ".stl" ? importSTL(source.getData(), error, scale) : importPLY(source.getData(), error, scale)))
+  {
+    close();
+    return false;
+  }
+  if(!vertexCount || !indexCount)
+  {
+    error = "The mesh is empty";
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool MeshFile::save(const std::string& fileName) const
+{
+  std::ofstream stream(fileName, std::ios::binary | std::ios::trunc);
+  if(!stream.is_open())
+    return false;
+  const std::uint32_t header[] = {version, flags, vertexCount, indexCount};
+  stream.write(magic, sizeof(magic));
+  stream.write(reinterpret_cast<const char*>(header), sizeof(header));
+  stream.write(reinterpret_cast<const char*>(vertices), static_cast<std::streamsize>(vertexCount * getVertexSize() * sizeof(float)));
+  stream.write(static_cast<const char*>(indices), static_cast<std::streamsize>(indexCount * (hasIndices32() ? 4 : 2)));
+  return stream.good();
+}
+
+void MeshFile::close()
+{
+  file.close();
+  importedVertices.clear();
+  importedIndices.clear();
+  importedIndices16.clear();
+  flags = vertexCount = indexCount = 0;
+  vertices = nullptr;
+  indices = nullptr;
+}
+
+bool MeshFile::map(const std::string& fileName, std::string& error)
+{
+  static_assert(headerSize == sizeof(magic) + 4 * sizeof(std::uint32_t));
+  if(!file.open(fileName))
+  {
+    error = "Could not open file";
+    return false;
+  }
+  const std::string_view data = file.getData();
+  std::uint32_t header[4];
+  if(data.size() < headerSize || std::memcmp(data.data(), magic, sizeof(magic)))
+  {
+    error = "Not a mesh file";
+    close();
+    return false;
+  }
+  std::memcpy(header, data.data() + sizeof(magic), sizeof(header));
+  if(header[0] != version || header[1] & ~static_cast<std::uint32_t>(texCoordsFlag | indices32Flag))
+  {
+    error = "Unsupported mesh file version";
+    close();
+    return false;
+  }
+  flags = header[1];
+  vertexCount = header[2];
+  indexCount = header[3];
+  const std::uint64_t vertexBytes = static_cast<std::uint64_t>(vertexCount) * getVertexSize() * sizeof(float);
+  const std::uint64_t indexBytes = static_cast<std::uint64_t>(indexCount) * (hasIndices32() ? 4 : 2);
+  if(!vertexCount || !indexCount || indexCount % 3 || data.size() != headerSize + vertexBytes + indexBytes)
+  {
+    error = "Invalid mesh file size";
+    close();
+    return false;
+  }
+
+  // The mapping is page-aligned and the header and vertices have sizes that are multiples of 4, so the arrays are aligned.
+  vertices = reinterpret_cast<const float*>(data.data() + headerSize);
+  indices = data.data() + headerSize + vertexBytes;
+
+  // Out-of-range indices would make the GPU read arbitrary memory.
+  const std::uint32_t maxIndex = hasIndices32() ?
+                                 *std::max_element(static_cast<const std::uint32_t*>(indices), static_cast<const std::uint32_t*>(indices) + indexCount) :
+                                 *std::max_element(static_cast<const std::uint16_t*>(indices), static_cast<const std::uint16_t*>(indices) + indexCount);
+  if(maxIndex >= vertexCount)
+  {
+    error = "Index out of range";
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool MeshFile::importSTL(std::string_view data, std::string& error, float scale)
+{
+  std::unordered_map<std::array<float, 6>, std::uint32_t, VertexHasher> vertexMap;
+  const auto addTriangle = [&](const Vector3f& givenNormal, const Vector3f (&corners)[3])
+  {
+    // The normals in STL files are often wrong, so they are only used for degenerated triangles.
+    Vector3f normal = (corners[1] - corners[0]).cross(corners[2] - corners[0]);
+    normal = normal.squaredNorm() > 0.f ? normal.normalized() : givenNormal;
+    normal += Vector3f::Zero(); // -0 -> 0, so that vertices are merged
+    for(const Vector3f& corner : corners)
+    {
+      const std::array<float, 6> vertex = {corner.x() * scale, corner.y() * scale, corner.z() * scale, normal.x(), normal.y(), normal.z()};
+      const auto [iter, inserted] = vertexMap.try_emplace(vertex, static_cast<std::uint32_t>(vertexMap.size()));
+      if(inserted)
+        importedVertices.insert(importedVertices.end(), vertex.begin(), vertex.end());
+      importedIndices.push_back(iter->second);
+    }
+  };
+
+  std::uint32_t triangles = 0;
+  if(data.size() >= 84)
+    std::memcpy(&triangles, data.data() + 80, sizeof(triangles));
+  if(data.size() >= 84 && data.size() == 84 + 50 * static_cast<std::uint64_t>(triangles))
+  {
+    importedIndices.reserve(triangles * 3);
+    for(std::uint32_t i = 0; i < triangles; ++i)
+    {
+      float values[12];
+      std::memcpy(values, data.data() + 84 + 50 * static_cast<std::size_t>(i), sizeof(values));
+      addTriangle(Vector3f(values[0], values[1], values[2]),
+                  {Vector3f(values[3], values[4], values[5]), Vector3f(values[6], values[7], values[8]), Vector3f(values[9], values[10], values[11])});
+    }
+  }
+  else
+  {
+    Tokenizer tokenizer(data);
+    if(tokenizer.word() != "solid")
+    {
+      error = "Invalid STL file";
+      return false;
+    }
+    tokenizer.line(); // the name of the solid
+    for(std::string_view word = tokenizer.word(); word == "facet"; word = tokenizer.word())
+    {
+      Vector3f normal;
+      Vector3f corners[3];
+      bool valid = tokenizer.word() == "normal" && tokenizer.number(normal.x()) && tokenizer.number(normal.y()) && tokenizer.number(normal.z()) &&
+                   tokenizer.word() == "outer" && tokenizer.word() == "loop";
+      for(Vector3f& corner : corners)
+        valid = valid && tokenizer.word() == "vertex" && tokenizer.number(corner.x()) && tokenizer.number(corner.y()) && tokenizer.number(corner.z());
+      if(!valid || tokenizer.word() != "endloop" || tokenizer.word() != "endfacet")
+      {
+        error = "Invalid facet in STL file";
+        return false;
+      }
+      addTriangle(normal, corners);
+    }
+  }
+  finishImport(false);
+  return true;
+}
+
+bool MeshFile::importPLY(std::string_view data, std::string& error, float scale)
+{
+  // Parse the header.
+  Tokenizer header(data);
+  if(header.line() != "ply")
+  {
+    error = "Invalid PLY file";
+    return false;
+  }
+  bool ascii = true;
+  std::vector<PLYElement> elements;
+  for(;;)
+  {
+    Tokenizer line(header.line());
+    const std::string_view keyword = line.word();
+    if(keyword == "end_header")
+      break;
+    else if(keyword == "format")
+    {
+      const std::string_view format = line.word();
+      if(format == "binary_little_endian")
+        ascii = false;
+      else if(format != "ascii")
+      {
+        error = "Unsupported PLY format \"" + std::string(format) + "\"";
+        return false;
+      }
+    }
+    else if(keyword == "element")
+    {
+      PLYElement& element = elements.emplace_back();
+      element.name = line.word();
+      if(!line.number(element.count))
+      {
+        error = "Invalid element in PLY header";
+        return false;
+      }
+    }
+    else if(keyword == "property")
+    {
+      if(elements.empty())
+      {
+        error = "Property without element in PLY header";
+        return false;
+      }
+      PLYProperty& property = elements.back().properties.emplace_back();
+      std::string_view type = line.word();
+      if(type == "list")
+      {
+        property.countType = getPLYType(line.word());
+        type = line.word();
+        if(property.countType == invalid || property.countType == float32 || property.countType == float64)
+        {
+          error = "Invalid list property in PLY header";
+          return false;
+        }
+      }
+      property.type = getPLYType(type);
+      property.name = line.word();
+      if(property.type == invalid)
+      {
+        error = "Unknown property type \"" + std::string(type) + "\" in PLY header";
+        return false;
+      }
+    }
+    else if(keyword != "comment" && keyword != "obj_info")
+    {
+      error = header.position >= data.size() ? "Incomplete PLY header" : "Unexpected \"" + std::string(keyword) + "\" in PLY header";
+      return false;
+    }
+  }
+
+  // Read the body.
+  PLYReader reader(data.substr(header.position), ascii);
+  std::vector<Vector3f> positions, normals;
+  std::vector<Vector2f> texCoords;
+  std::vector<std::uint32_t> polygon;
+  for(const PLYElement& element : elements)
+  {
+    const bool isVertex = element.name == "vertex";
+    const bool isFace = element.name == "face";
+
+    // Find the properties that are used.
+    int position[3] = {-1, -1, -1}, normal[3] = {-1, -1, -1}, texCoord[2] = {-1, -1}, vertexIndices = -1;
+    for(int i = 0; i < static_cast<int>(element.properties.size()); ++i)
+    {
+      const std::string& name = element.properties[i].name;
+      const bool isList = element.properties[i].countType != invalid;
+      if(isVertex && !isList)
+      {
+        for(int j = 0; j < 3; ++j)
+        {
+          if(name == std::string(1, static_cast<char>('x' + j)))
+            position[j] = i;
+          if(name == std::string("n") + static_cast<char>('x' + j))
+            normal[j] = i;
+        }
+        if(name == "u" || name == "s" || name == "texture_u" || name == "texture_s")
+          texCoord[0] = i;
+        if(name == "v" || name == "t" || name == "texture_v" || name == "texture_t")
+          texCoord[1] = i;
+      }
+      else if(isFace && isList && (name == "vertex_indices" || name == "vertex_index"))
+        vertexIndices = i;
+    }
+    if(isVertex && (position[0] < 0 || position[1] < 0 || position[2] < 0))
+    {
+      error = "PLY vertices have no position";
+      return false;
+    }
+    const bool withNormals = normal[0] >= 0 && normal[1] >= 0 && normal[2] >= 0;
+    const bool withTexCoords = texCoord[0] >= 0 && texCoord[1] >= 0;
+
+    std::vector<double> values(element.properties.size());
+    for(std::size_t i = 0; i < element.count; ++i)
+    {
+      for(std::size_t j = 0; j < element.properties.size(); ++j)
+      {
+        const PLYProperty& property = element.properties[j];
+        if(property.countType == invalid)
+        {
+          if(!reader.read(property.type, values[j]))
+          {
+            error = "Unexpected end of PLY file";
+            return false;
+          }
+          continue;
+        }
+        double count;
+        if(!reader.read(property.countType, count) || count < 0)
+        {
+          error = "Unexpected end of PLY file";
+          return false;
+        }
+        polygon.clear();
+        for(std::size_t k = 0; k < static_cast<std::size_t>(count); ++k)
+        {
+          double value;
+          if(!reader.read(property.type, value))
+          {
+            error = "Unexpected end of PLY file";
+            return false;
+          }
+          polygon.push_back(static_cast<std::uint32_t>(value));
+        }
+        if(static_cast<int>(j) == vertexIndices)
+          for(std::size_t k = 2; k < polygon.size(); ++k) // triangle fan
+            importedIndices.insert(importedIndices.end(), {polygon[0], polygon[k - 1], polygon[k]});
+      }
+      if(isVertex)
+      {
+        positions.emplace_back(static_cast<float>(values[position[0]]) * scale, static_cast<float>(values[position[1]]) * scale, static_cast<float>(values[position[2]]) * scale);
+        if(withNormals)
+          normals.emplace_back(Vector3f(static_cast<float>(values[normal[0]]), static_cast<float>(values[normal[1]]), static_cast<float>(values[normal[2]])).normalized());
+        if(withTexCoords)
+          texCoords.emplace_back(static_cast<float>(values[texCoord[0]]), static_cast<float>(values[texCoord[1]]));
+      }
+    }
+  }
+
+  if(std::any_of(importedIndices.begin(), importedIndices.end(), [&positions](std::uint32_t index) {return index >= positions.size();}))
+  {
+    error = "Index out of range in PLY file";
+    return false;
+  }
+
+  // Calculate smooth normals (weighted by the areas of the triangles) if there are none.
+  if(normals.empty())
+  {
+    normals.resize(positions.size(), Vector3f::Zero());
+    for(std::size_t i = 0; i < importedIndices.size(); i += 3)
+    {
+      const std::uint32_t* const triangle = importedIndices.data() + i;
+      const Vector3f normal = (positions[triangle[1]] - positions[triangle[0]]).cross(positions[triangle[2]] - positions[triangle[0]]);
+      for(int j = 0; j < 3; ++j)
+        normals[triangle[j]] += normal;
+    }
+    for(Vector3f& normal : normals)
+      normal = normal.squaredNorm() > 0.f ? normal.normalized() : Vector3f(0.f, 0.f, 1.f);
+  }
+
+  const bool withTexCoords = !texCoords.empty();
+  importedVertices.reserve(positions.size() * (withTexCoords ? 8 : 6));
+  for(std::size_t i = 0; i < positions.size(); ++i)
+  {
+    importedVertices.insert(importedVertices.end(), {positions[i].x(), positions[i].y(), positions[i].z(), normals[i].x(), normals[i].y(), normals[i].z()});
+    if(withTexCoords)
+      importedVertices.insert(importedVertices.end(), {texCoords[i].x(), texCoords[i].y()});
+  }
+  finishImport(withTexCoords);
+  return true;
+}
+
+void MeshFile::finishImport(bool withTexCoords)
+{
+  flags = withTexCoords ? static_cast<std::uint32_t>(texCoordsFlag) : 0;
+  vertexCount = static_cast<std::uint32_t>(importedVertices.size() / getVertexSize());
+  indexCount = static_cast<std::uint32_t>(importedIndices.size());
+  vertices = importedVertices.data();
+  if(vertexCount <= 0x10000)
+  {
+    importedIndices16.assign(importedIndices.begin(), importedIndices.end());
+    importedIndices.clear();
+    importedIndices.shrink_to_fit();
+    indices = importedIndices16.data();
+  }
+  else
+  {
+    flags |= indices32Flag;
+    indices = importedIndices.data();
+  }
+}
@@ -0,0 +1,152 @@
+/**
+ * @file Tools/MeshFile.h
+ * Declaration of class MeshFile
+ *
+ * A mesh file (.srmesh) stores a triangle list in the layout in which it is uploaded to the GPU, so that
+ * it can be memory-mapped and copied into a vertex and an index buffer without processing single vertices.
+ * All values are little-endian:
+ *
+ * Offset             Size                   Content
+ * 0                  4                      Magic "SRMS"
+ * 4                  4                      uint32: Version (1)
+ * 8                  4                      uint32: Flags (bit 0: vertices have texture coordinates, bit 1: indices have 32 instead of 16 bits)
+ * 12                 4                      uint32: Number of vertices
+ * 16                 4                      uint32: Number of indices (a multiple of 3)
+ * 20                 vertices * (24 | 32)   Vertices: position (3 floats in m), normal (3 floats), [texture coordinates (2 floats)]
+ * 20 + vertex bytes  indices * (2 | 4)      Indices (uint16 or uint32)
+ *
+ * STL (binary and ASCII) and PLY (ASCII and binary little-endian) files can be imported.
+ * Imported meshes are converted into the same representation, i.e. they can be saved as mesh file.
+ */
+
+#pragma once
+
+#include "Platform/MappedFile.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class MeshFile
+ * A triangle mesh that is either mapped from a mesh file or imported from another format
+ */
+class MeshFile
+{
+public:
+  /** The flags in the header of a mesh file */
+  enum Flags : std::uint32_t
+  {
+    texCoordsFlag = 1 << 0, /**< The vertices have texture coordinates. */
+    indices32Flag = 1 << 1 /**< The indices have 32 bits. */
+  };
+
+  /**
+   * Loads a mesh. The format is determined by the file name extension (.stl, .ply, anything else is a mesh file).
+   * @param fileName The name of the file.
+   * @param error Is filled with a description of the problem if the mesh could not be loaded.
+   * @param scale A factor that is applied to the positions of imported meshes.
+   * @return Whether the mesh could be loaded.
+   */
+  bool load(const std::string& fileName, std::string& error, float scale = 1.f);
+
+  /**
+   * Writes the mesh as mesh file.
+   * @param fileName The name of the file.
+   * @return Whether the file could be written.
+   */
+  bool save(const std::string& fileName) const;
+
+  /** Releases the mesh. */
+  void close();
+
+  /**
+   * Whether the vertices have texture coordinates.
+   * @return Whether they have.
+   */
+  bool hasTexCoords() const {return flags & texCoordsFlag;}
+
+  /**
+   * Whether the indices have 32 bits (instead of 16 bits).
+   * @return Whether they have.
+   */
+  bool hasIndices32() const {return flags & indices32Flag;}
+
+  /**
+   * Returns the number of floats per vertex.
+   * @return 6 (position, normal) or 8 (position, normal, texture coordinates).
+   */
+  std::size_t getVertexSize() const {return hasTexCoords() ? 8 : 6;}
+
+  /**
+   * Returns the number of vertices.
+   * @return The number of vertices.
+   */
+  std::uint32_t getVertexCount() const {return vertexCount;}
+
+  /**
+   * Returns the interleaved vertices.
+   * @return A pointer to \c getVertexCount() * \c getVertexSize() floats.
+   */
+  const float* getVertices() const {return vertices;}
+
+  /**
+   * Returns the number of indices.
+   * @return The number of indices (three per triangle).
+   */
+  std::uint32_t getIndexCount() const {return indexCount;}
+
+  /**
+   * Returns the indices.
+   * @return A pointer to \c getIndexCount() uint16 or uint32 values (see \c hasIndices32).
+   */
+  const void* getIndices() const {return indices;}
+
+private:
+  static constexpr char magic[4] = {'S', 'R', 'M', 'S'}; /**< The first bytes of a mesh file. */
+  static constexpr std::uint32_t version = 1; /**< The version of the mesh file format. */
+  static constexpr std::size_t headerSize = 20; /**< The size of the header of a mesh file in bytes. */
+
+  /**
+   * Maps a mesh file.
+   * @param fileName The name of the file.
+   * @param error Is filled with a description of the problem.
+   * @return Whether the file is a valid mesh file.
+   */
+  bool map(const std::string& fileName, std::string& error);
+
+  /**
+   * Imports an STL file.
+   * @param data The contents of the file.
+   * @param error Is filled with a description of the problem.
+   * @param scale A factor that is applied to the positions.
+   * @return Whether the file could be imported.
+   */
+  bool importSTL(std::string_view data, std::string& error, float scale);
+
+  /**
+   * Imports a PLY file.
+   * @param data The contents of the file.
+   * @param error Is filled with a description of the problem.
+   * @param scale A factor that is applied to the positions.
+   * @return Whether the file could be imported.
+   */
+  bool importPLY(std::string_view data, std::string& error, float scale);
+
+  /**
+   * Sets the views to the imported vertices and indices and chooses the smallest index type.
+   * @param withTexCoords Whether the imported vertices have texture coordinates.
+   */
+  void finishImport(bool withTexCoords);
+
+  MappedFile file; /**< The mapped mesh file (if the mesh was not imported). */
+  std::vector<float> importedVertices; /**< The vertices of an imported mesh. */
+  std::vector<std::uint32_t> importedIndices; /**< The 32 bit indices of an imported mesh. */
+  std::vector<std::uint16_t> importedIndices16; /**< The 16 bit indices of an imported mesh (if all indices fit). */
+
+  std::uint32_t flags = 0; /**< The flags of the mesh (see \c Flags). */
+  std::uint32_t vertexCount = 0; /**< The number of vertices. */
+  std::uint32_t indexCount = 0; /**< The number of indices. */
+  const float* vertices = nullptr; /**< The interleaved vertices. */
+  const void* indices = nullptr; /**< The indices. */
+};
@@ -199,7 +199,7 @@ ActuatorWidget::ActuatorWidget(SimRobotCore2::ActuatorPort* actuator, QWidget* p
   txbValue->setAlignment(Qt::AlignRight);
 
   // restore layout
-  QSettings* settings = &CoreModule::application->getLayoutSettings();
+  QSettings* settings = &CoreModule::current().application.getLayoutSettings();
   settings->beginGroup(actuatorName);
   valueChanged(settings->value("Value", 0.0).toDouble());
   cbxSet->setChecked(settings->value("Set", true).toBool());
@@ -212,7 +212,7 @@ ActuatorWidget::~ActuatorWidget()
   if(input)
     input->data.floatValue = input->defaultValue; // setValue would clip value
 
-  QSettings* settings = &CoreModule::application->getLayoutSettings();
+  QSettings* settings = &CoreModule::current().application.getLayoutSettings();
   settings->beginGroup(actuatorName);
   settings->setValue("Set", cbxSet->checkState() == Qt::Checked);
   settings->setValue("Value", value);
@@ -270,7 +270,7 @@ ActuatorsWidget::ActuatorsWidget()
   scrollArea->setWidgetResizable(true);
 
   // load layout
-  QSettings& settings = CoreModule::application->getLayoutSettings();
+  QSettings& settings = CoreModule::current().application.getLayoutSettings();
   settings.beginGroup("Actuators");
   QStringList openedActuators = settings.value("OpenedActuators").toStringList();
   settings.endGroup();
@@ -285,7 +285,7 @@ ActuatorsWidget::~ActuatorsWidget()
   actuatorsWidget = 0;
 
   // save layout
-  QSettings& settings = CoreModule::application->getLayoutSettings();
+  QSettings& settings = CoreModule::current().application.getLayoutSettings();
   settings.beginGroup("Actuators");
   settings.setValue("OpenedActuators", actuatorNames);
   settings.endGroup();
@@ -307,7 +307,7 @@ void ActuatorsWidget::openActuator(const QString& actuatorName)
     return;
   }
 
-  SimRobotCore2::ActuatorPort* actuator = static_cast<SimRobotCore2::ActuatorPort*>(CoreModule::application->resolveObject(actuatorName, SimRobotCore2::actuatorPort));
+  SimRobotCore2::ActuatorPort* actuator = static_cast<SimRobotCore2::ActuatorPort*>(CoreModule::current().application.resolveObject(actuatorName, SimRobotCore2::actuatorPort));
   if(!actuator)
     return;
   ActuatorWidget* widget = new ActuatorWidget(actuator, this);
@@ -323,6 +323,23 @@ void ActuatorsWidget::adoptActuators()
     widget->adoptActuator();
 }
 
+void ActuatorsWidget::relinkActuators()
+{
+  // The widgets save their values when they are deleted, so the new widgets continue with them.
+  const QStringList names = actuatorNames;
+  for(const QString& actuatorName : names)
+  {
+    ActuatorWidget* widget = actuators.value(actuatorName);
+    if(static_cast<SimRobotCore2::ActuatorPort*>(CoreModule::current().application.resolveObject(actuatorName, SimRobotCore2::actuatorPort)) == widget->getActuator())
+      continue;
+    layout->removeWidget(widget);
+    actuators.remove(actuatorName);
+    actuatorNames.removeOne(actuatorName);
+    delete widget;
+    openActuator(actuatorName);
+  }
+}
+
 void ActuatorsWidget::closeActuator()
 {
   ActuatorWidget* actuator = qobject_cast<ActuatorWidget*>(sender());
@@ -335,5 +352,5 @@ void ActuatorsWidget::closeActuator()
   delete actuator;
 
   if(actuators.count() == 0)
-    CoreModule::application->closeObject(CoreModule::module->actuatorsObject);
+    CoreModule::current().application.closeObject(CoreModule::current().actuatorsObject);
 }
@@ -63,6 +63,9 @@ public:
   /** Adopts user controlled actuator values */
   void adoptActuators();
 
+  /** Replaces the widgets of actuators that were removed from the scene by widgets of the actuators with the same names (if any) */
+  void relinkActuators();
+
 private:
   QHash<QString, ActuatorWidget*> actuators;
   QStringList actuatorNames;
@@ -100,6 +103,12 @@ public:
   /** Adopts a user controlled actuator value */
   void adoptActuator();
 
+  /**
+   * Returns the actuator controlled by the widget
+   * @return The actuator
+   */
+  SimRobotCore2::ActuatorPort* getActuator() const {return actuator;}
+
 signals:
   void releasedClose();
 
@@ -5,25 +5,26 @@
  */
 
 #include "CoreModule.h"
+#include "VideoRecorder.h"
 #include "Simulation/PhysicalObject.h"
 #include "Simulation/Scene.h"
+#include "Simulation/SimObject.h"
 #include <QDir>
 #include <QLabel>
+#include <ode/odeinit.h>
+#include <chrono>
+#include <unordered_set>
 
 extern "C" DLL_EXPORT SimRobot::Module* createModule(SimRobot::Application& simRobot)
 {
   return new CoreModule(simRobot);
 }
 
-SimRobot::Application* CoreModule::application;
-CoreModule* CoreModule::module;
-
 CoreModule::CoreModule(SimRobot::Application& application) :
-  sceneIcon(":/Icons/bricks.png"), objectIcon(":/Icons/brick.png"), sensorIcon(":/Icons/transmit_go.png"), actuatorIcon(":/Icons/arrow_rotate_clockwise.png"),
+  application(application), sceneIcon(":/Icons/bricks.png"), objectIcon(":/Icons/brick.png"), sensorIcon(":/Icons/transmit_go.png"), actuatorIcon(":/Icons/arrow_rotate_clockwise.png"),
   hingeIcon(":/Icons/link.png"), sliderIcon(":/Icons/slider.png"), appearanceIcon(":/Icons/note.png")
 {
-  CoreModule::application = &application;
-  CoreModule::module = this;
+  Simulation::simulation = this;
 }
 
 bool CoreModule::compile()
@@ -31,27 +32,25 @@ bool CoreModule::compile()
   Q_ASSERT(!scene);
 
   // change working directory
-  QString filePath = application->getFilePath();
+  QString filePath = application.getFilePath();
   QDir::setCurrent(QFileInfo(filePath).dir().path());
 
   // load simulation
   std::list<std::string> errors;
-  if(!loadFile(filePath.toUtf8().constData(), errors))
+  const bool loaded = loadFile(filePath.toUtf8().constData(), errors);
+  for(const auto& [name, milliseconds] : loadPhases)
+    application.addLoadPhase(name, milliseconds);
+  if(!loaded)
   {
-    QString errorMessage;
-    for(const std::string& error : errors)
-    {
-      if(!errorMessage.isEmpty())
-        errorMessage += "\n";
-      errorMessage += error.c_str();
-    }
-    application->showWarning(QObject::tr("SimRobotCore2"), errorMessage);
+    showErrors(errors);
     return false;
   }
 
   // register scene graph objects
+  auto start = std::chrono::steady_clock::now();
   registerObjects();
-  application->registerObject(*this, actuatorsObject, 0, SimRobot::Flag::hidden);
+  application.registerObject(*this, actuatorsObject, 0, SimRobot::Flag::hidden);
+  application.addLoadPhase("register objects", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
 
   // register status bar labels
   class StepsLabel : public QLabel, public SimRobot::StatusLabel
@@ -105,22 +104,91 @@ bool CoreModule::compile()
     }
   };
 
-  application->addStatusLabel(*this, new StepsLabel());
-  application->addStatusLabel(*this, new StepsPerSecondLabel());
-  application->addStatusLabel(*this, new CollisionsLabel());
+  application.addStatusLabel(*this, new StepsLabel());
+  application.addStatusLabel(*this, new StepsPerSecondLabel());
+  application.addStatusLabel(*this, new CollisionsLabel());
 
   // suggest further modules
-  application->registerModule(*this, "File Editor", "SimRobotEditor", SimRobot::Flag::ignoreReset);
+  application.registerModule(*this, "File Editor", "SimRobotEditor", SimRobot::Flag::ignoreReset);
 
   // load controller
   if(simulation->scene->controller != "")
-    application->loadModule(simulation->scene->controller.c_str());
+  {
+    start = std::chrono::steady_clock::now();
+    application.loadModule(simulation->scene->controller.c_str());
+    application.addLoadPhase("load controller", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  }
   return true;
 }
 
+void CoreModule::registerObjects()
+{
+  scene->fullName = scene->name.c_str();
+  application.registerObject(*this, *scene, 0);
+  scene->registerObjects(*this);
+}
+
+void CoreModule::prepareWorkerThread()
+{
+  Simulation::simulation = this;
+  dAllocateODEDataForThread(dAllocateMaskAll);
+}
+
 void CoreModule::update()
 {
   if(ActuatorsWidget::actuatorsWidget)
     ActuatorsWidget::actuatorsWidget->adoptActuators();
   doSimulationStep();
+  for(VideoRecorder* videoRecorder : videoRecorders)
+    videoRecorder->step();
+  viewServer.step();
+}
+
+bool CoreModule::reload()
+{
+  std::list<std::string> errors;
+  if(!reloadFile(application.getFilePath().toUtf8().constData(), errors))
+  {
+    if(errors.empty())
+      return false;
+
+    // Resetting would fail as well, so the simulation keeps running until the errors are fixed.
+    showErrors(errors);
+    return true;
+  }
+  if(ActuatorsWidget::actuatorsWidget)
+    ActuatorsWidget::actuatorsWidget->relinkActuators();
+  return true;
+}
+
+void CoreModule::removingObject(SimObject& object)
+{
+  std::unordered_set<const SimObject*> objects;
+  std::vector<const SimObject*> openObjects = {&object};
+  while(!openObjects.empty())
+  {
+    const SimObject* openObject = openObjects.back();
+    openObjects.pop_back();
+    objects.insert(openObject);
+    openObjects.insert(openObjects.end(), openObject->children.begin(), openObject->children.end());
+  }
+  viewServer.removeViews(objects);
+  application.unregisterObject(dynamic_cast<SimRobot::Object&>(object));
+}
+
+void CoreModule::addedObject(SimObject& parent, SimObject& object)
+{
+  parent.registerChild(*this, object);
+}
+
+void CoreModule::showErrors(const std::list<std::string>& errors)
+{
+  QString errorMessage;
+  for(const std::string& error : errors)
+  {
+    if(!errorMessage.isEmpty())
+      errorMessage += "\n";
+    errorMessage += error.c_str();
+  }
+  application.showWarning(QObject::tr("SimRobotCore2"), errorMessage);
 }
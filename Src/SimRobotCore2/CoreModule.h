@@ -7,11 +7,14 @@
 #pragma once
 
 #include "ActuatorsWidget.h"
+#include "ViewServer.h"
 #include "Simulation/Simulation.h"
 #include <SimRobot.h>
 #include <QIcon>
+#include <vector>
 
 class SimObject;
+class VideoRecorder;
 
 /**
  * @class CoreModule
@@ -20,8 +23,7 @@ class SimObject;
 class CoreModule : public SimRobot::Module, public Simulation
 {
 public:
-  static SimRobot::Application* application;
-  static CoreModule* module;
+  SimRobot::Application& application; /**< The interface to the SimRobot application that loaded this module */
 
   QIcon sceneIcon;
   QIcon objectIcon;
@@ -31,6 +33,8 @@ public:
   QIcon sliderIcon;
   QIcon appearanceIcon;
   ActuatorsObject actuatorsObject;
+  std::vector<VideoRecorder*> videoRecorders; /**< The video recorders that capture frames after each simulation step */
+  ViewServer viewServer; /**< Renders the views that are served to other processes after simulation steps */
 
   /**
    * Constructor
@@ -38,6 +42,13 @@ public:
    */
   CoreModule(SimRobot::Application& application);
 
+  /**
+   * Returns the module that owns the simulation that is the current one of the calling thread
+   * (see \c Simulation::simulation). Its objects and widgets use this to reach their module.
+   * @return The module
+   */
+  static CoreModule& current() {return *static_cast<CoreModule*>(Simulation::simulation);}
+
 private:
   /**
    * Called to initialize the module. In this phase the module can do the following tasks
@@ -48,6 +59,38 @@ private:
    */
   bool compile() override;
 
+  /** Registers all objects of the simulation (including children, actuators and sensors) at SimRobot's GUI */
+  void registerObjects();
+
   /** Called to perform another simulation step */
   void update() override;
+
+  /**
+   * Called when the scene file was modified. Applies the modifications to the running simulation if possible.
+   * If the modified file has errors, they are shown and the simulation is kept as it is.
+   * @return Whether the modifications were applied (or the modified file has errors)
+   */
+  bool reload() override;
+
+  /**
+   * Unregisters an object (including its children) and removes the views that show it before it is removed from the scene graph
+   * @param object The object
+   */
+  void removingObject(SimObject& object) override;
+
+  /**
+   * Registers an object (including its children) that was added to the scene graph
+   * @param parent The object the new object was added to
+   * @param object The new object
+   */
+  void addedObject(SimObject& parent, SimObject& object) override;
+
+  /**
+   * Shows the errors that occurred while parsing the scene file
+   * @param errors The errors
+   */
+  void showErrors(const std::list<std::string>& errors);
+
+  /** Makes this simulation the current one of a worker thread that updates controller work items */
+  void prepareWorkerThread() override;
 };
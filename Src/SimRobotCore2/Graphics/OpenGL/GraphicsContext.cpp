@@ -14,7 +14,11 @@
 #include <QOpenGLContext>
 #include <QOpenGLFramebufferObject>
 #include <QOpenGLFunctions_3_3_Core>
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <limits>
+#include <thread>
 
 // The following shader source code is based on https://learnopengl.com/Lighting/Multiple-lights.
 
@@ -189,6 +193,42 @@ void main()
 }
 )glsl";
 
+static const char* conversionVertexShaderSourceCode = R"glsl(
+void main()
+{
+  // A single triangle that covers the whole viewport.
+  vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+  gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
+)glsl";
+
+static const char* conversionFragmentShaderSourceCode = R"glsl(
+uniform sampler2D sourceImage;
+
+out vec4 FragColor;
+
+const vec3 yWeights = vec3(0.299, 0.587, 0.114);
+const vec3 uWeights = vec3(-0.168736, -0.331264, 0.5);
+const vec3 vWeights = vec3(0.5, -0.418688, -0.081312);
+
+void main()
+{
+  ivec2 pos = ivec2(gl_FragCoord.xy);
+#if defined(YUYV)
+  vec3 color0 = texelFetch(sourceImage, ivec2(pos.x * 2, pos.y), 0).rgb;
+  vec3 color1 = texelFetch(sourceImage, ivec2(pos.x * 2 + 1, pos.y), 0).rgb;
+  vec3 color = (color0 + color1) * 0.5;
+  FragColor = vec4(dot(color0, yWeights), dot(color, uWeights) + 0.5, dot(color1, yWeights), dot(color, vWeights) + 0.5);
+#elif defined(BAYER_RGGB)
+  vec3 color = texelFetch(sourceImage, pos, 0).rgb;
+  float value = (pos.y & 1) == 0 ? ((pos.x & 1) == 0 ? color.r : color.g) : ((pos.x & 1) == 0 ? color.g : color.b);
+  FragColor = vec4(value, 0.0, 0.0, 1.0);
+#else
+  FragColor = vec4(dot(texelFetch(sourceImage, pos, 0).rgb, yWeights), 0.0, 0.0, 1.0);
+#endif
+}
+)glsl";
+
 GraphicsContext::GraphicsContext()
 {
   vertexBuffers.resize(2);
@@ -212,6 +252,9 @@ GraphicsContext::~GraphicsContext()
     destroyGraphics();
   }
   ASSERT(perContextData.empty());
+  for(const auto& pair : conversionBuffers)
+    delete pair.second;
+  conversionBuffers.clear();
   for(const auto& pair : offscreenBuffers)
     delete pair.second;
   offscreenBuffers.clear();
@@ -239,6 +282,42 @@ GraphicsContext::~GraphicsContext()
 }
 
 void GraphicsContext::compile()
+{
+  ASSERT(bufferFills.empty());
+
+  // Simplify meshes now that their buffers are filled. The new index buffers must be part of the layout.
+  for(Mesh* mesh : levelOfDetailMeshes)
+    requestBufferFill([mesh]{createLevelsOfDetail(*mesh);});
+  levelOfDetailMeshes.clear();
+  fillBuffers();
+
+  if(!layoutRestored)
+    compileLayout();
+
+  // Determine texture indices.
+  std::size_t index = 0;
+  for(auto& texture : textures)
+    texture.second->index = index++;
+
+  // Determine surface indices.
+  index = 0;
+  for(auto* surface : surfaces)
+    surface->index = index++;
+}
+
+void GraphicsContext::recompile()
+{
+  fillBuffers();
+  layoutRestored = false;
+  compile();
+
+  // The model matrices of new objects have never been calculated.
+  for(ModelMatrixSet& modelMatrixSet : modelMatrixSets)
+    modelMatrixSet.lastUpdate = -1;
+  ++layoutRevision;
+}
+
+void GraphicsContext::compileLayout()
 {
   // Determine buffer memory layout of vertex buffer.
   GLint base = 0;
@@ -269,16 +348,6 @@ void GraphicsContext::compile()
     offset += buffer->size();
   }
   indexBufferTotalSize = offset;
-
-  // Determine texture indices.
-  std::size_t index = 0;
-  for(auto& texture : textures)
-    texture.second->index = index++;
-
-  // Determine surface indices.
-  index = 0;
-  for(auto* surface : surfaces)
-    surface->index = index++;
 }
 
 void GraphicsContext::createGraphics()
@@ -338,6 +407,7 @@ void GraphicsContext::createGraphics()
     data.vbo = shareData->vbo;
     data.ebo = shareData->ebo;
     data.ubo = shareData->ubo;
+    data.surfaceRevision = shareData->surfaceRevision;
   }
   else
   {
@@ -359,31 +429,11 @@ void GraphicsContext::createGraphics()
     f->glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, data.ebo);
     vertexBuffers[vaoIndex].setupVertexAttributes(*f);
   }
+  f->glGenVertexArrays(1, &data.conversionVAO);
 
   // Upload buffer data, now that also the EBO is bound.
   if(!shareData)
-  {
-    f->glBufferData(GL_ARRAY_BUFFER, vertexBufferTotalSize, nullptr, GL_STATIC_DRAW);
-    for(const auto& pair : vertexBuffers)
-      for(const auto* buffer : pair.buffers)
-        f->glBufferSubData(GL_ARRAY_BUFFER, buffer->offset, buffer->size(), buffer->data);
-
-    f->glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBufferTotalSize, nullptr, GL_STATIC_DRAW);
-    for(const auto* buffer : indexBuffers)
-      f->glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, buffer->offset, buffer->size(), buffer->indices.data());
-
-    f->glBindBuffer(GL_UNIFORM_BUFFER, data.ubo);
-    f->glBufferData(GL_UNIFORM_BUFFER, surfaces.size() * Surface::memorySize, nullptr, GL_STATIC_DRAW);
-    for(std::size_t i = 0; i < surfaces.size(); ++i)
-    {
-      static constexpr std::size_t verbatimPart = offsetof(Surface, shininess) - offsetof(Surface, diffuseColor) + sizeof(Surface::shininess);
-      unsigned char buf[Surface::memorySize];
-      std::memcpy(buf, &surfaces[i]->diffuseColor, verbatimPart);
-      *reinterpret_cast<unsigned int*>(buf + verbatimPart) = surfaces[i]->texture != nullptr;
-      f->glBufferSubData(GL_UNIFORM_BUFFER, i * Surface::memorySize, Surface::memorySize, buf);
-    }
-    f->glBindBuffer(GL_UNIFORM_BUFFER, 0);
-  }
+    uploadBuffers(data);
 
   f->glBindBuffer(GL_ARRAY_BUFFER, 0);
   f->glBindVertexArray(0);
@@ -393,26 +443,16 @@ void GraphicsContext::createGraphics()
   {
     data.textureIDs = shareData->textureIDs;
     data.shaders = shareData->shaders;
+    data.conversionPrograms = shareData->conversionPrograms;
+    data.layoutRevision = shareData->layoutRevision;
   }
   else
   {
-    // Upload textures.
-    data.textureIDs.resize(textures.size());
-    f->glGenTextures(static_cast<GLsizei>(textures.size()), data.textureIDs.data());
-    for(const auto& pair : textures)
-    {
-      const Texture* texture = pair.second;
-      f->glBindTexture(GL_TEXTURE_2D, data.textureIDs[texture->index]);
-      f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-      f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-      f->glTexImage2D(GL_TEXTURE_2D, 0, texture->hasAlpha ? GL_RGBA : GL_RGB, texture->width, texture->height, 0, texture->byteOrder, GL_UNSIGNED_BYTE, texture->data);
-      f->glGenerateMipmap(GL_TEXTURE_2D);
-    }
-
-    // Compile shaders.
-    for(unsigned int i = 0; i < 8; ++i)
-      data.shaders[i] = compileColorShader(i & 4, i & 2, i & 1);
-    data.shaders[8] = compileDepthOnlyShader();
+    uploadTexturesAndShaders(data);
+    data.layoutRevision = layoutRevision;
+    data.conversionPrograms[rgb] = 0;
+    for(unsigned int i = rgb + 1; i < numOfImageFormats; ++i)
+      data.conversionPrograms[i] = compileConversionProgram(static_cast<ImageFormat>(i));
   }
 
   f = nullptr;
@@ -430,6 +470,7 @@ void GraphicsContext::destroyGraphics()
     return;
 
   data.f->glDeleteVertexArrays(static_cast<GLsizei>(data.vao.size()), data.vao.data());
+  data.f->glDeleteVertexArrays(1, &data.conversionVAO);
   if(--referenceCounters[data.referenceCounterIndex] == 0)
   {
     data.f->glDeleteBuffers(1, &data.vbo);
@@ -438,6 +479,9 @@ void GraphicsContext::destroyGraphics()
     data.f->glDeleteTextures(static_cast<GLsizei>(data.textureIDs.size()), data.textureIDs.data());
     for(const auto& shader : data.shaders)
       data.f->glDeleteProgram(shader.program);
+    for(const GLuint program : data.conversionPrograms)
+      if(program)
+        data.f->glDeleteProgram(program);
     delete data.f;
   }
 
@@ -475,6 +519,283 @@ GraphicsContext::Mesh* GraphicsContext::requestMesh(const VertexBufferBase* vert
   return mesh;
 }
 
+void GraphicsContext::requestLevelsOfDetail(Mesh* mesh)
+{
+  ASSERT(mesh);
+  if(mesh->mode != GL_TRIANGLES || !mesh->indexBuffer || !mesh->levelsOfDetail.empty())
+    return;
+
+  // Each level halves the resolution of the clustering grid. Its cells must not become larger than about 2 pixels.
+  for(const float gridResolution : {32.f, 16.f, 8.f})
+    mesh->levelsOfDetail.push_back({requestIndexBuffer(), gridResolution});
+  levelOfDetailMeshes.push_back(mesh);
+}
+
+void GraphicsContext::requestBufferFill(std::function<void()> fill)
+{
+  bufferFills.emplace_back(std::move(fill));
+}
+
+void GraphicsContext::fillBuffers()
+{
+  if(bufferFills.empty())
+    return;
+  const unsigned int threads = std::min(std::max(std::thread::hardware_concurrency(), 1u), static_cast<unsigned int>(bufferFills.size()));
+
+  std::atomic<std::size_t> next = 0;
+  const auto work = [this, &next]
+  {
+    for(std::size_t i = next++; i < bufferFills.size(); i = next++)
+      bufferFills[i]();
+  };
+
+  // the calling thread takes part, so only threads - 1 workers are needed
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for(unsigned int i = 1; i < threads; ++i)
+    workers.emplace_back(work);
+  work();
+  for(std::thread& worker : workers)
+    worker.join();
+  bufferFills.clear();
+}
+
+void GraphicsContext::saveBuffers(std::string& data) const
+{
+  const auto append = [&data](const auto& value) {data.append(reinterpret_cast<const char*>(&value), sizeof(value));};
+  data.clear();
+  append(static_cast<std::uint32_t>(vertexBuffers.size()));
+  for(const VertexCategory& category : vertexBuffers)
+  {
+    append(static_cast<std::uint32_t>(category.buffers.size()));
+    for(const VertexBufferBase* buffer : category.buffers)
+    {
+      append(buffer->count);
+      append(static_cast<std::int32_t>(buffer->base));
+      append(buffer->offset);
+      data.append(static_cast<const char*>(buffer->data), buffer->size());
+    }
+  }
+  append(static_cast<std::uint64_t>(vertexBufferTotalSize));
+
+  std::unordered_map<const IndexBuffer*, std::uint32_t> indexBufferIndices;
+  append(static_cast<std::uint32_t>(indexBuffers.size()));
+  for(const IndexBuffer* buffer : indexBuffers)
+  {
+    indexBufferIndices.emplace(buffer, static_cast<std::uint32_t>(indexBufferIndices.size()));
+    append(buffer->count);
+    append(buffer->offset);
+    data.append(reinterpret_cast<const char*>(buffer->indices.data()), buffer->indices.size() * sizeof(std::uint32_t));
+  }
+  append(static_cast<std::uint64_t>(indexBufferTotalSize));
+
+  append(static_cast<std::uint32_t>(meshes.size()));
+  append(static_cast<std::uint32_t>(std::count_if(meshes.begin(), meshes.end(), [](const Mesh* mesh) {return !mesh->levelsOfDetail.empty();})));
+  for(std::size_t i = 0; i < meshes.size(); ++i)
+    if(const Mesh& mesh = *meshes[i]; !mesh.levelsOfDetail.empty())
+    {
+      append(static_cast<std::uint32_t>(i));
+      append(mesh.center.x());
+      append(mesh.center.y());
+      append(mesh.center.z());
+      append(mesh.radius);
+      append(static_cast<std::uint32_t>(mesh.levelsOfDetail.size()));
+      for(const Mesh::LevelOfDetail& levelOfDetail : mesh.levelsOfDetail)
+      {
+        append(indexBufferIndices[levelOfDetail.indexBuffer]);
+        append(levelOfDetail.maxProjectedRadius);
+      }
+    }
+}
+
+bool GraphicsContext::restoreBuffers(std::string_view data)
+{
+  std::size_t position = 0;
+  const auto read = [&data, &position](auto& value)
+  {
+    if(data.size() - position < sizeof(value))
+      return false;
+    std::memcpy(&value, data.data() + position, sizeof(value));
+    position += sizeof(value);
+    return true;
+  };
+  const auto skip = [&data, &position](std::size_t size, const char*& bytes)
+  {
+    if(data.size() - position < size)
+      return false;
+    bytes = data.data() + position;
+    position += size;
+    return true;
+  };
+
+  // Everything is checked before anything is changed.
+  struct RestoredVertexBuffer
+  {
+    VertexBufferBase* buffer;
+    std::uint32_t count;
+    std::int32_t base;
+    std::uint64_t offset;
+    const char* vertices;
+  };
+  std::vector<RestoredVertexBuffer> restoredVertexBuffers;
+  std::uint32_t count;
+  if(!read(count) || count != vertexBuffers.size())
+    return false;
+  for(const VertexCategory& category : vertexBuffers)
+  {
+    if(!read(count) || count != category.buffers.size())
+      return false;
+    for(VertexBufferBase* buffer : category.buffers)
+    {
+      RestoredVertexBuffer& restored = restoredVertexBuffers.emplace_back(RestoredVertexBuffer{buffer, 0, 0, 0, nullptr});
+      if(!read(restored.count) || !restored.count || !read(restored.base) || !read(restored.offset) ||
+         !skip(static_cast<std::size_t>(restored.count) * category.stride, restored.vertices))
+        return false;
+    }
+  }
+  std::uint64_t restoredVertexBufferTotalSize;
+  if(!read(restoredVertexBufferTotalSize))
+    return false;
+
+  struct RestoredIndexBuffer
+  {
+    IndexBuffer* buffer;
+    std::uint32_t count;
+    std::uint64_t offset;
+    const char* indices;
+  };
+  std::vector<RestoredIndexBuffer> restoredIndexBuffers;
+  if(!read(count) || count != indexBuffers.size())
+    return false;
+  for(IndexBuffer* buffer : indexBuffers)
+  {
+    RestoredIndexBuffer& restored = restoredIndexBuffers.emplace_back(RestoredIndexBuffer{buffer, 0, 0, nullptr});
+    if(!read(restored.count) || !read(restored.offset) || !skip(static_cast<std::size_t>(restored.count) * sizeof(std::uint32_t), restored.indices))
+      return false;
+  }
+  std::uint64_t restoredIndexBufferTotalSize;
+  if(!read(restoredIndexBufferTotalSize))
+    return false;
+
+  std::vector<std::pair<Mesh*, Mesh>> restoredMeshes;
+  std::uint32_t levelOfDetailMeshCount;
+  if(!read(count) || count != meshes.size() || !read(levelOfDetailMeshCount))
+    return false;
+  for(std::uint32_t i = 0; i < levelOfDetailMeshCount; ++i)
+  {
+    std::uint32_t meshIndex, levelCount;
+    Mesh restored;
+    if(!read(meshIndex) || meshIndex >= meshes.size() || !read(restored.center.x()) || !read(restored.center.y()) ||
+       !read(restored.center.z()) || !read(restored.radius) || !read(levelCount))
+      return false;
+    for(std::uint32_t j = 0; j < levelCount; ++j)
+    {
+      std::uint32_t indexBufferIndex;
+      float maxProjectedRadius;
+      if(!read(indexBufferIndex) || indexBufferIndex >= indexBuffers.size() || !read(maxProjectedRadius))
+        return false;
+      restored.levelsOfDetail.push_back({indexBuffers[indexBufferIndex], maxProjectedRadius});
+    }
+    restoredMeshes.emplace_back(meshes[meshIndex], std::move(restored));
+  }
+  if(position != data.size())
+    return false;
+
+  // The layout must be the one that compileLayout would determine for the restored sizes,
+  // so that no buffer exceeds the total sizes of the OpenGL buffers.
+  std::uint64_t offset = 0;
+  auto restoredVertexBuffer = restoredVertexBuffers.begin();
+  for(const VertexCategory& category : vertexBuffers)
+  {
+    offset = (offset + category.stride - 1) / category.stride * category.stride;
+    for(std::size_t i = 0; i < category.buffers.size(); ++i, ++restoredVertexBuffer)
+    {
+      if(restoredVertexBuffer->offset != offset || restoredVertexBuffer->base < 0 ||
+         static_cast<std::uint64_t>(restoredVertexBuffer->base) * category.stride != offset)
+        return false;
+      offset += static_cast<std::uint64_t>(restoredVertexBuffer->count) * category.stride;
+    }
+  }
+  if(offset != restoredVertexBufferTotalSize)
+    return false;
+  offset = 0;
+  for(const RestoredIndexBuffer& restored : restoredIndexBuffers)
+  {
+    if(restored.offset != offset)
+      return false;
+    offset += static_cast<std::uint64_t>(restored.count) * sizeof(std::uint32_t);
+  }
+  if(offset != restoredIndexBufferTotalSize)
+    return false;
+
+  // All indices of a mesh (including its levels of detail) must refer to vertices of its vertex buffer.
+  std::unordered_map<const VertexBufferBase*, std::uint32_t> vertexCounts;
+  for(const RestoredVertexBuffer& restored : restoredVertexBuffers)
+    vertexCounts.emplace(restored.buffer, restored.count);
+  std::unordered_map<const IndexBuffer*, const RestoredIndexBuffer*> restoredIndexBuffersByBuffer;
+  for(const RestoredIndexBuffer& restored : restoredIndexBuffers)
+    restoredIndexBuffersByBuffer.emplace(restored.buffer, &restored);
+  const auto checkIndices = [&vertexCounts, &restoredIndexBuffersByBuffer](const VertexBufferBase* vertexBuffer, const IndexBuffer* indexBuffer)
+  {
+    const auto vertexCount = vertexCounts.find(vertexBuffer);
+    const auto restored = restoredIndexBuffersByBuffer.find(indexBuffer);
+    if(vertexCount == vertexCounts.end() || restored == restoredIndexBuffersByBuffer.end())
+      return false;
+    for(std::uint32_t i = 0; i < restored->second->count; ++i)
+    {
+      std::uint32_t index;
+      std::memcpy(&index, restored->second->indices + i * sizeof(std::uint32_t), sizeof(index));
+      if(index >= vertexCount->second)
+        return false;
+    }
+    return true;
+  };
+  std::unordered_map<const Mesh*, const Mesh*> restoredMeshesByMesh;
+  for(const auto& [mesh, restored] : restoredMeshes)
+    restoredMeshesByMesh.emplace(mesh, &restored);
+  for(const Mesh* mesh : meshes)
+  {
+    if(!mesh->vertexBuffer)
+      continue;
+    if(mesh->indexBuffer && !checkIndices(mesh->vertexBuffer, mesh->indexBuffer))
+      return false;
+    if(const auto restored = restoredMeshesByMesh.find(mesh); restored != restoredMeshesByMesh.end())
+      for(const Mesh::LevelOfDetail& levelOfDetail : restored->second->levelsOfDetail)
+        if(!checkIndices(mesh->vertexBuffer, levelOfDetail.indexBuffer))
+          return false;
+  }
+
+  // The requested fills and levels of detail are replaced by the restored ones.
+  for(const RestoredVertexBuffer& restored : restoredVertexBuffers)
+  {
+    restored.buffer->assign(restored.vertices, restored.count);
+    restored.buffer->base = restored.base;
+    restored.buffer->offset = restored.offset;
+  }
+  vertexBufferTotalSize = static_cast<std::size_t>(restoredVertexBufferTotalSize);
+  for(const RestoredIndexBuffer& restored : restoredIndexBuffers)
+  {
+    restored.buffer->indices.resize(restored.count);
+    std::memcpy(restored.buffer->indices.data(), restored.indices, static_cast<std::size_t>(restored.count) * sizeof(std::uint32_t));
+    restored.buffer->count = restored.count;
+    restored.buffer->offset = restored.offset;
+    restored.buffer->type = GL_UNSIGNED_INT;
+  }
+  indexBufferTotalSize = static_cast<std::size_t>(restoredIndexBufferTotalSize);
+  for(Mesh* mesh : levelOfDetailMeshes)
+    mesh->levelsOfDetail.clear();
+  levelOfDetailMeshes.clear();
+  for(auto& [mesh, restored] : restoredMeshes)
+  {
+    mesh->levelsOfDetail.swap(restored.levelsOfDetail);
+    mesh->center = restored.center;
+    mesh->radius = restored.radius;
+  }
+  bufferFills.clear();
+  layoutRestored = true;
+  return true;
+}
+
 GraphicsContext::Texture* GraphicsContext::requestTexture(const std::string& file)
 {
   auto iter = textures.find(file);
@@ -502,6 +823,17 @@ GraphicsContext::Surface* GraphicsContext::requestSurface(const float* diffuseCo
   return surface;
 }
 
+void GraphicsContext::updateSurface(Surface* surface, const float* diffuseColor, const float* ambientColor, const float* specularColor, const float* emissionColor, float shininess)
+{
+  static const float defaultColor[4] = {0.f, 0.f, 0.f, 1.f};
+  std::memcpy(surface->diffuseColor, diffuseColor, sizeof(surface->diffuseColor));
+  std::memcpy(surface->ambientColor, ambientColor, sizeof(surface->ambientColor));
+  std::memcpy(surface->specularColor, specularColor ? specularColor : defaultColor, sizeof(surface->specularColor));
+  std::memcpy(surface->emissionColor, emissionColor ? emissionColor : defaultColor, sizeof(surface->emissionColor));
+  surface->shininess = shininess;
+  ++surfaceRevision;
+}
+
 void GraphicsContext::setGlobalAmbientLight(const float* color)
 {
   globalAmbientLight = "vec4(" + std::to_string(color[0]) + ", " + std::to_string(color[1]) + ", " + std::to_string(color[2]) + ", " + std::to_string(color[3]) + ")";
@@ -604,19 +936,41 @@ void GraphicsContext::updateModelMatrices(ModelMatrix::Usage usage, bool forceUp
   }
 }
 
-void GraphicsContext::startColorRendering(const Matrix4f& projection, const Matrix4f& view, int viewportX, int viewportY, int viewportWidth, int viewportHeight, bool clear, bool lighting, bool textures, bool smoothShading, bool fillPolygons)
+void GraphicsContext::releaseModelMatrices(const std::unordered_set<const Pose3f*>& variableParts)
+{
+  for(ModelMatrixSet& modelMatrixSet : modelMatrixSets)
+  {
+    std::vector<ModelMatrix*>& modelMatrices = modelMatrixSet.variableModelMatrices;
+    modelMatrices.erase(std::remove_if(modelMatrices.begin(), modelMatrices.end(), [&variableParts](const ModelMatrix* modelMatrix)
+    {
+      if(!variableParts.count(modelMatrix->variablePart))
+        return false;
+      delete modelMatrix;
+      return true;
+    }), modelMatrices.end());
+  }
+}
+
+void GraphicsContext::startColorRendering(const Matrix4f& projection, const Matrix4f& view, int viewportX, int viewportY, int viewportWidth, int viewportHeight, bool clear, bool lighting, bool textures, bool smoothShading, bool fillPolygons, bool levelsOfDetail)
 {
   const auto* context = QOpenGLContext::currentContext();
   ASSERT(!data);
   ASSERT(!shader);
   ASSERT(!f);
   data = &perContextData[context];
+  f = data->f;
+  updateSharedData();
   // Even if the caller wants textures to be active, we only use the corresponding shader if there are any textures
   // in the scene. Otherwise, at least the Apple implementation complains that a texture unit is used in a shader
   // without a bound texture.
   textures &= !data->textureIDs.empty();
   shader = &data->shaders[(lighting ? 4 : 0) + (textures ? 2 : 0) + (smoothShading ? 1 : 0)];
-  f = data->f;
+  if(data->surfaceRevision != surfaceRevision)
+  {
+    // Surfaces have been changed after compilation.
+    uploadSurfaces(*f, data->ubo);
+    data->surfaceRevision = surfaceRevision;
+  }
   if(clear)
     f->glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   if(viewportX >= 0)
@@ -625,11 +979,11 @@ void GraphicsContext::startColorRendering(const Matrix4f& projection, const Matr
   f->glUseProgram(shader->program);
   const Matrix4f pv = projection * view;
   f->glUniformMatrix4fv(shader->cameraPVLocation, 1, GL_FALSE, pv.data());
+  cameraPosition = -view.topLeftCorner<3, 3>().transpose() * view.topRightCorner<3, 1>();
   if(shader->cameraPosLocation >= 0)
-  {
-    const Vector3f pos = -view.topLeftCorner<3, 3>().transpose() * view.topRightCorner<3, 1>();
-    f->glUniform3fv(shader->cameraPosLocation, 1, pos.data());
-  }
+    f->glUniform3fv(shader->cameraPosLocation, 1, cameraPosition.data());
+  // Only perspective projections make objects appear smaller with distance.
+  levelOfDetailScale = levelsOfDetail && viewportHeight > 0 && projection(3, 2) != 0.f ? projection(1, 1) * static_cast<float>(viewportHeight) * 0.5f : 0.f;
   f->glBindBufferBase(GL_UNIFORM_BUFFER, 0, data->ubo);
 
   // Controller drawings might have changed these states in the meantime:
@@ -649,8 +1003,10 @@ void GraphicsContext::startDepthOnlyRendering(const Matrix4f& projection, const
   ASSERT(!shader);
   ASSERT(!f);
   data = &perContextData[context];
-  shader = &data->shaders[8];
   f = data->f;
+  updateSharedData();
+  shader = &data->shaders[8];
+  levelOfDetailScale = 0.f;
   if(clear)
     f->glClear(GL_DEPTH_BUFFER_BIT);
   if(viewportX >= 0)
@@ -687,8 +1043,24 @@ void GraphicsContext::draw(const Mesh* mesh, const ModelMatrix* modelMatrix, con
   f->glUniformMatrix4fv(shader->modelMatrixLocation, 1, GL_FALSE, modelMatrix->memory.data());
   if(!forcedSurface)
     setSurface(surface);
-  if(mesh->indexBuffer)
-    f->glDrawElementsBaseVertex(mesh->mode, mesh->indexBuffer->count, mesh->indexBuffer->type, reinterpret_cast<void*>(mesh->indexBuffer->offset), mesh->vertexBuffer->base);
+  const IndexBuffer* indexBuffer = mesh->indexBuffer;
+  if(levelOfDetailScale > 0.f && !mesh->levelsOfDetail.empty())
+  {
+    const Vector3f center = modelMatrix->memory.topLeftCorner<3, 3>() * mesh->center + modelMatrix->memory.topRightCorner<3, 1>();
+    const float distance = (center - cameraPosition).norm();
+    if(distance > mesh->radius)
+    {
+      const float projectedRadius = mesh->radius * levelOfDetailScale / distance;
+      for(const Mesh::LevelOfDetail& levelOfDetail : mesh->levelsOfDetail)
+      {
+        if(projectedRadius > levelOfDetail.maxProjectedRadius)
+          break;
+        indexBuffer = levelOfDetail.indexBuffer;
+      }
+    }
+  }
+  if(indexBuffer)
+    f->glDrawElementsBaseVertex(mesh->mode, indexBuffer->count, indexBuffer->type, reinterpret_cast<void*>(indexBuffer->offset), mesh->vertexBuffer->base);
   else
     f->glDrawArrays(mesh->mode, mesh->vertexBuffer->base, mesh->vertexBuffer->count);
 }
@@ -737,21 +1109,69 @@ bool GraphicsContext::makeCurrent(int width, int height, bool sampleBuffers)
     {
       delete buffer;
       buffer = nullptr;
+      currentOffscreenBuffer = nullptr;
       return false;
     }
 
+    currentOffscreenBuffer = buffer;
     return true;
   }
   else
+  {
+    currentOffscreenBuffer = it->second;
     return it->second && it->second->bind();
+  }
 }
 
-void GraphicsContext::finishImageRendering(void* image, int w, int h)
+void GraphicsContext::finishImageRendering(void* image, int w, int h, ImageFormat format)
 {
-  QOpenGLFunctions_3_3_Core* f = perContextData[QOpenGLContext::currentContext()].f;
-  const int lineSize = w * 3;
+  PerContextData& data = perContextData[QOpenGLContext::currentContext()];
+  QOpenGLFunctions_3_3_Core* f = data.f;
+
+  if(format == rgb)
+  {
+    const int lineSize = w * 3;
+    f->glPixelStorei(GL_PACK_ALIGNMENT, lineSize & (8 - 1) ? (lineSize & (4 - 1) ? 1 : 4) : 8);
+    f->glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, image);
+    return;
+  }
+
+  // The conversion pass samples the color attachment of the framebuffer that has just been rendered to.
+  ASSERT(currentOffscreenBuffer);
+  ASSERT(format != yuyv || !(w & 1));
+  const int targetWidth = format == yuyv ? w / 2 : w;
+  QOpenGLFramebufferObject*& target = conversionBuffers[static_cast<std::uint64_t>(format) << 32 | static_cast<std::uint64_t>(targetWidth) << 16 | static_cast<std::uint64_t>(h)];
+  if(!target)
+  {
+    QOpenGLFramebufferObjectFormat targetFormat;
+    targetFormat.setAttachment(QOpenGLFramebufferObject::NoAttachment);
+    targetFormat.setInternalTextureFormat(format == yuyv ? GL_RGBA8 : GL_R8);
+    target = new QOpenGLFramebufferObject(targetWidth, h, targetFormat);
+  }
+  if(!target->isValid() || !target->bind())
+  {
+    currentOffscreenBuffer->bind();
+    return;
+  }
+
+  f->glViewport(0, 0, targetWidth, h);
+  f->glDisable(GL_DEPTH_TEST);
+  f->glDisable(GL_BLEND);
+  f->glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+  f->glUseProgram(data.conversionPrograms[format]);
+  f->glBindTexture(GL_TEXTURE_2D, currentOffscreenBuffer->texture());
+  f->glBindVertexArray(data.conversionVAO);
+  f->glDrawArrays(GL_TRIANGLES, 0, 3);
+  f->glBindVertexArray(0);
+  f->glBindTexture(GL_TEXTURE_2D, 0);
+  f->glEnable(GL_DEPTH_TEST);
+
+  // The packed image is only 2/3 (YUYV) or 1/3 (Bayer, grey) of the size of the RGB image.
+  const int lineSize = targetWidth * (format == yuyv ? 4 : 1);
   f->glPixelStorei(GL_PACK_ALIGNMENT, lineSize & (8 - 1) ? (lineSize & (4 - 1) ? 1 : 4) : 8);
-  f->glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, image);
+  f->glReadPixels(0, 0, targetWidth, h, format == yuyv ? GL_RGBA : GL_RED, GL_UNSIGNED_BYTE, image);
+
+  currentOffscreenBuffer->bind();
 }
 
 void GraphicsContext::finishDepthRendering(void* image, int w, int h)
@@ -761,6 +1181,88 @@ void GraphicsContext::finishDepthRendering(void* image, int w, int h)
   f->glReadPixels(0, 0, w, h, GL_DEPTH_COMPONENT, GL_FLOAT, image);
 }
 
+void GraphicsContext::uploadSurfaces(QOpenGLFunctions_3_3_Core& f, GLuint ubo) const
+{
+  f.glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+  for(std::size_t i = 0; i < surfaces.size(); ++i)
+  {
+    static constexpr std::size_t verbatimPart = offsetof(Surface, shininess) - offsetof(Surface, diffuseColor) + sizeof(Surface::shininess);
+    unsigned char buf[Surface::memorySize];
+    std::memcpy(buf, &surfaces[i]->diffuseColor, verbatimPart);
+    *reinterpret_cast<unsigned int*>(buf + verbatimPart) = surfaces[i]->texture != nullptr;
+    f.glBufferSubData(GL_UNIFORM_BUFFER, i * Surface::memorySize, Surface::memorySize, buf);
+  }
+  f.glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void GraphicsContext::uploadBuffers(PerContextData& data)
+{
+  f->glBindBuffer(GL_ARRAY_BUFFER, data.vbo);
+  f->glBufferData(GL_ARRAY_BUFFER, vertexBufferTotalSize, nullptr, GL_STATIC_DRAW);
+  for(const auto& pair : vertexBuffers)
+    for(const auto* buffer : pair.buffers)
+      f->glBufferSubData(GL_ARRAY_BUFFER, buffer->offset, buffer->size(), buffer->data);
+
+  f->glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBufferTotalSize, nullptr, GL_STATIC_DRAW);
+  for(const auto* buffer : indexBuffers)
+    f->glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, buffer->offset, buffer->size(), buffer->indices.data());
+
+  f->glBindBuffer(GL_UNIFORM_BUFFER, data.ubo);
+  f->glBufferData(GL_UNIFORM_BUFFER, surfaces.size() * Surface::memorySize, nullptr, GL_STATIC_DRAW);
+  uploadSurfaces(*f, data.ubo);
+  data.surfaceRevision = surfaceRevision;
+}
+
+void GraphicsContext::uploadTexturesAndShaders(PerContextData& data)
+{
+  // Upload textures.
+  data.textureIDs.resize(textures.size());
+  f->glGenTextures(static_cast<GLsizei>(textures.size()), data.textureIDs.data());
+  for(const auto& pair : textures)
+  {
+    const Texture* texture = pair.second;
+    f->glBindTexture(GL_TEXTURE_2D, data.textureIDs[texture->index]);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    f->glTexImage2D(GL_TEXTURE_2D, 0, texture->hasAlpha ? GL_RGBA : GL_RGB, texture->width, texture->height, 0, texture->byteOrder, GL_UNSIGNED_BYTE, texture->data);
+    f->glGenerateMipmap(GL_TEXTURE_2D);
+  }
+
+  // Compile shaders (which depend on the number of surfaces).
+  for(unsigned int i = 0; i < 8; ++i)
+    data.shaders[i] = compileColorShader(i & 4, i & 2, i & 1);
+  data.shaders[8] = compileDepthOnlyShader();
+}
+
+void GraphicsContext::updateSharedData()
+{
+  if(data->layoutRevision == layoutRevision)
+    return;
+
+  // The buffer objects keep their names, so the VAOs of all contexts still refer to them.
+  f->glBindVertexArray(data->vao.front());
+  uploadBuffers(*data);
+  f->glBindBuffer(GL_ARRAY_BUFFER, 0);
+  f->glBindVertexArray(0);
+
+  // Texture indices and the number of surfaces might have changed.
+  f->glDeleteTextures(static_cast<GLsizei>(data->textureIDs.size()), data->textureIDs.data());
+  for(const auto& shader : data->shaders)
+    f->glDeleteProgram(shader.program);
+  uploadTexturesAndShaders(*data);
+  data->layoutRevision = layoutRevision;
+
+  // All contexts of the share group use the new objects from now on.
+  for(auto& [context, otherData] : perContextData)
+    if(&otherData != data && otherData.referenceCounterIndex == data->referenceCounterIndex)
+    {
+      otherData.textureIDs = data->textureIDs;
+      otherData.shaders = data->shaders;
+      otherData.surfaceRevision = data->surfaceRevision;
+      otherData.layoutRevision = layoutRevision;
+    }
+}
+
 void GraphicsContext::setSurface(const Surface* surface)
 {
   ASSERT(data);
@@ -896,6 +1398,97 @@ GraphicsContext::Shader GraphicsContext::compileDepthOnlyShader()
   return shader;
 }
 
+GLuint GraphicsContext::compileConversionProgram(ImageFormat format)
+{
+  ASSERT(format != rgb);
+  const char* versionSourceCode = "#version 330 core\n";
+  const char* defines = format == yuyv ? "#define YUYV\n" : (format == bayerRGGB ? "#define BAYER_RGGB\n" : "#define GREY\n");
+  return compileShader({versionSourceCode, conversionVertexShaderSourceCode}, {versionSourceCode, defines, conversionFragmentShaderSourceCode});
+}
+
+void GraphicsContext::createLevelsOfDetail(Mesh& mesh)
+{
+  const std::vector<std::uint32_t>& indices = mesh.indexBuffer->indices;
+  const VertexBufferBase& vertexBuffer = *mesh.vertexBuffer;
+  const std::size_t stride = vertexBuffer.size() / vertexBuffer.count / sizeof(float);
+  const float* vertexData = static_cast<const float*>(vertexBuffer.data);
+  // Both vertex types start with the position and the normal. Only VertexPNT has texture coordinates.
+  const bool withTextureCoordinates = stride > 6;
+
+  Vector3f min = Vector3f::Constant(std::numeric_limits<float>::max());
+  Vector3f max = Vector3f::Constant(std::numeric_limits<float>::lowest());
+  for(std::uint32_t index : indices)
+  {
+    const Vector3f position(vertexData + index * stride);
+    min = min.cwiseMin(position);
+    max = max.cwiseMax(position);
+  }
+  if(indices.empty())
+    min = max = Vector3f::Zero();
+  mesh.center = (min + max) * 0.5f;
+  mesh.radius = 0.f;
+  for(std::uint32_t index : indices)
+    mesh.radius = std::max(mesh.radius, (Vector3f(vertexData + index * stride) - mesh.center).norm());
+
+  std::size_t numOfIndices = indices.size();
+  std::unordered_map<std::uint64_t, std::uint32_t> clusters;
+  std::vector<std::uint32_t> representatives(vertexBuffer.count);
+  auto levelOfDetail = mesh.levelsOfDetail.begin();
+  for(; levelOfDetail != mesh.levelsOfDetail.end() && mesh.radius > 0.f; ++levelOfDetail)
+  {
+    // Vertices are merged into the first vertex of their cluster. A cluster is a grid cell, but vertices on different
+    // sides of sharp edges or texture seams are kept apart by also using the dominant normal direction and the texture coordinates.
+    const float gridResolution = levelOfDetail->maxProjectedRadius;
+    const float cellsPerMeter = gridResolution / (2.f * mesh.radius);
+    clusters.clear();
+    for(std::uint32_t index : indices)
+    {
+      const float* vertex = vertexData + index * stride;
+      const Vector3f cell = ((Vector3f(vertex) - min) * cellsPerMeter).array().floor();
+      std::uint64_t key = static_cast<std::uint64_t>(cell.x()) | static_cast<std::uint64_t>(cell.y()) << 8 | static_cast<std::uint64_t>(cell.z()) << 16;
+      Vector3f::Index axis;
+      const Vector3f normal(vertex + 3);
+      normal.cwiseAbs().maxCoeff(&axis);
+      key |= static_cast<std::uint64_t>(axis * 2 + (normal(axis) < 0.f ? 1 : 0)) << 24;
+      if(withTextureCoordinates)
+        key |= static_cast<std::uint64_t>(std::clamp(vertex[6] * gridResolution * 0.5f, 0.f, 255.f)) << 32 |
+               static_cast<std::uint64_t>(std::clamp(vertex[7] * gridResolution * 0.5f, 0.f, 255.f)) << 40;
+      representatives[index] = clusters.emplace(key, index).first->second;
+    }
+
+    std::vector<std::uint32_t>& simplifiedIndices = levelOfDetail->indexBuffer->indices;
+    for(std::size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+      const std::uint32_t a = representatives[indices[i]];
+      const std::uint32_t b = representatives[indices[i + 1]];
+      const std::uint32_t c = representatives[indices[i + 2]];
+      if(a != b && b != c && c != a)
+      {
+        simplifiedIndices.push_back(a);
+        simplifiedIndices.push_back(b);
+        simplifiedIndices.push_back(c);
+      }
+    }
+
+    // A level that is not much simpler than the previous one is not worth switching to.
+    // If it is empty, the mesh would disappear, and coarser levels would not be better.
+    if(simplifiedIndices.empty())
+      break;
+    if(simplifiedIndices.size() * 4 > numOfIndices * 3)
+    {
+      simplifiedIndices.clear();
+      continue;
+    }
+    numOfIndices = simplifiedIndices.size();
+  }
+  for(; levelOfDetail != mesh.levelsOfDetail.end(); ++levelOfDetail)
+    levelOfDetail->indexBuffer->indices.clear();
+  mesh.levelsOfDetail.erase(std::remove_if(mesh.levelsOfDetail.begin(), mesh.levelsOfDetail.end(), [](const Mesh::LevelOfDetail& levelOfDetail)
+  {
+    return levelOfDetail.indexBuffer->indices.empty();
+  }), mesh.levelsOfDetail.end());
+}
+
 QOpenGLFunctions_3_3_Core* GraphicsContext::getOpenGLFunctions() const
 {
   if(auto it = perContextData.find(QOpenGLContext::currentContext()); it != perContextData.end())
@@ -12,8 +12,13 @@
 #include "Platform/Assert.h"
 #include "Tools/Math/Eigen.h"
 #include "Tools/Math/Pose3f.h"
+#include <cstring>
+#include <functional>
 #include <stack>
+#include <string>
+#include <string_view>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class Light;
@@ -35,11 +40,35 @@ public:
     triangleList /**< Vertices are drawn as a list of triangles (must be multiple of 3). */
   };
 
+  /**
+   * Pixel formats in which rendered color images can be read back.
+   */
+  enum ImageFormat
+  {
+    rgb, /**< 3 bytes per pixel (R, G, B). */
+    yuyv, /**< 2 bytes per pixel, two horizontally adjacent pixels share their chroma (Y0, U, Y1, V). The width must be even. */
+    bayerRGGB, /**< 1 byte per pixel, a raw Bayer mosaic with the pattern RGGB. */
+    grey, /**< 1 byte per pixel (luminance). */
+    numOfImageFormats
+  };
+
+  /**
+   * Returns the number of bytes a pixel occupies in a given image format.
+   * @param format The image format.
+   * @return The (average) number of bytes per pixel.
+   */
+  static unsigned int getBytesPerPixel(ImageFormat format)
+  {
+    return format == rgb ? 3 : (format == yuyv ? 2 : 1);
+  }
+
   /**
    * A vertex with a 3D position and 3D normal.
    */
   struct VertexPN final
   {
+    VertexPN() = default;
+
     VertexPN(const Vector3f& position, const Vector3f& normal) :
       position(position), normal(normal)
     {}
@@ -58,12 +87,15 @@ public:
 
     friend class GraphicsContext;
   };
+  static_assert(sizeof(VertexPN) == 6 * sizeof(float), "VertexPN must be compatible with the vertices in mesh files");
 
   /**
    * A vertex with a 3D position, 3D normal and 2D texture coordinates.
    */
   struct VertexPNT final
   {
+    VertexPNT() = default;
+
     VertexPNT(const Vector3f& position, const Vector3f& normal, const Vector2f& textureCoordinates) :
       position(position), normal(normal), textureCoordinates(textureCoordinates)
     {}
@@ -83,6 +115,7 @@ public:
 
     friend class GraphicsContext;
   };
+  static_assert(sizeof(VertexPNT) == 8 * sizeof(float), "VertexPNT must be compatible with the vertices in mesh files");
 
   /**
    * Base class for vertex buffers.
@@ -102,6 +135,13 @@ public:
      */
     virtual std::size_t size() const = 0;
 
+    /**
+     * Replaces the vertices of this buffer by copies and calls \c finish.
+     * @param vertices The vertices in the binary layout of the vertex type (not necessarily aligned).
+     * @param vertexCount The number of vertices.
+     */
+    virtual void assign(const char* vertices, std::uint32_t vertexCount) = 0;
+
     void* data = nullptr; /**< Pointer to the vertex data. */
     std::uint32_t count = 0; /**< The number of vertices in this buffer. */
 
@@ -139,6 +179,13 @@ public:
     {
       return count * VertexType::size;
     }
+
+    void assign(const char* vertexData, std::uint32_t vertexCount) override
+    {
+      vertices.resize(vertexCount);
+      std::memcpy(vertices.data(), vertexData, static_cast<std::size_t>(vertexCount) * VertexType::size);
+      finish();
+    }
   };
 
   /**
@@ -180,9 +227,21 @@ public:
   struct Mesh final
   {
   private:
+    /**
+     * A simplified version of a mesh that shares its vertex buffer.
+     */
+    struct LevelOfDetail
+    {
+      IndexBuffer* indexBuffer; /**< The indices of the simplified triangles. */
+      float maxProjectedRadius; /**< The projected radius of the bounding sphere (in pixels) up to which this level is used. */
+    };
+
     GLenum mode = GL_TRIANGLES; /**< The primitive type of this mesh. */
     const VertexBufferBase* vertexBuffer = nullptr; /**< The vertex buffer of this mesh. */
     const IndexBuffer* indexBuffer = nullptr; /**< The (optional) index buffer of this mesh. */
+    std::vector<LevelOfDetail> levelsOfDetail; /**< The simplified versions of this mesh (from fine to coarse). */
+    Vector3f center = Vector3f::Zero(); /**< The center of the bounding sphere (only set if there are levels of detail). */
+    float radius = 0.f; /**< The radius of the bounding sphere (only set if there are levels of detail). */
 
     friend class GraphicsContext;
   };
@@ -268,9 +327,15 @@ public:
   /** Destructor. */
   ~GraphicsContext();
 
-  /** Determine buffer offsets of all declared buffers etc. */
+  /** Determine buffer offsets of all declared buffers etc. Requested buffer fills must have been run before. */
   void compile();
 
+  /**
+   * Compiles again after objects have been added to a compiled scene (e.g. when parts of a scene are reloaded).
+   * The buffers, textures and shaders are uploaded again when a context renders the next time.
+   */
+  void recompile();
+
   /** Create per context data for the current context (which may include uploading data to the GPU). */
   void createGraphics();
 
@@ -312,6 +377,40 @@ public:
    */
   Mesh* requestMesh(const VertexBufferBase* vertexBuffer, const IndexBuffer* indexBuffer, PrimitiveTopology primitiveTopology);
 
+  /**
+   * Requests that simplified versions of a mesh are generated when the context is compiled.
+   * They reuse the vertices of the mesh and are drawn instead of it when it appears small in a color render pass.
+   * Requests for meshes that are not indexed triangle lists are ignored.
+   * @param mesh The mesh.
+   */
+  void requestLevelsOfDetail(Mesh* mesh);
+
+  /**
+   * Requests that buffers are filled by a function that may run in parallel to other such functions.
+   * The function must only access the buffers that it fills and data that does not change until \c fillBuffers has returned.
+   * @param fill The function that fills the buffers (including calling \c finish for vertex buffers).
+   */
+  void requestBufferFill(std::function<void()> fill);
+
+  /** Runs all requested buffer fills on multiple threads and waits until they are done. */
+  void fillBuffers();
+
+  /**
+   * Serializes the contents and the layout of all buffers together with the levels of detail of all meshes.
+   * Must be called after \c compile.
+   * @param data Is filled with the serialized buffers.
+   */
+  void saveBuffers(std::string& data) const;
+
+  /**
+   * Restores the contents and the layout of all buffers and the levels of detail of all meshes from data saved by
+   * \c saveBuffers instead of running the requested buffer fills, so \c compile only has to assign indices.
+   * This fails without changing anything if the data does not match the registered buffers and meshes.
+   * @param data The serialized buffers.
+   * @return Whether the buffers were restored.
+   */
+  bool restoreBuffers(std::string_view data);
+
   /**
    * Requests a texture from a given file.
    * @param file The path to the texture file.
@@ -331,6 +430,18 @@ public:
    */
   Surface* requestSurface(const float* diffuseColor, const float* ambientColor, const float* specularColor = nullptr, const float* emissionColor = nullptr, float shininess = 1.f, const Texture* texture = nullptr);
 
+  /**
+   * Changes the properties of a surface (also after the graphics context has been compiled).
+   * The new properties are uploaded when the next frame is rendered in a context.
+   * @param surface The surface.
+   * @param diffuseColor The diffuse color (RGBA).
+   * @param ambientColor The ambient color (RGBA).
+   * @param specularColor The specular color (RGBA). May be \c nullptr.
+   * @param emissionColor The emission color (RGBA). May be \c nullptr.
+   * @param shininess The shininess of the surface (for the specular component).
+   */
+  void updateSurface(Surface* surface, const float* diffuseColor, const float* ambientColor, const float* specularColor = nullptr, const float* emissionColor = nullptr, float shininess = 1.f);
+
   /**
    * Sets the color of the global ambient light.
    * @param color Pointer to a four-element (RGBA) color.
@@ -384,6 +495,12 @@ public:
    */
   void updateModelMatrices(ModelMatrix::Usage usage, bool forceUpdate);
 
+  /**
+   * Deletes the model matrices of objects that have been removed from the scene.
+   * @param variableParts The poses that the variable parts of the model matrices to delete refer to.
+   */
+  void releaseModelMatrices(const std::unordered_set<const Pose3f*>& variableParts);
+
   /**
    * Starts a color render pass.
    * @param projection The projection matrix of the camera.
@@ -391,14 +508,15 @@ public:
    * @param viewportX Lower left corner of the viewport. If negative, the viewport is not set.
    * @param viewportY Lower left corner of the viewport.
    * @param viewportWidth Width of the viewport.
-   * @param viewportHeight Height of the viewport.
+   * @param viewportHeight Height of the viewport. The levels of detail of meshes are selected for an image of this height (also if the viewport is not set).
    * @param clear Whether to clear the color and depth buffers.
    * @param lighting Whether lighting should be active.
    * @param textures Whether textures should be active.
    * @param smoothShading Whether vertex normals are interpolated.
    * @param fillPolygons Whether polygons are filled (instead of wireframe rendering).
+   * @param levelsOfDetail Whether meshes that appear small are drawn simplified (otherwise, they are always drawn in full detail).
    */
-  void startColorRendering(const Matrix4f& projection, const Matrix4f& view, int viewportX, int viewportY, int viewportWidth, int viewportHeight, bool clear, bool lighting = true, bool textures = true, bool smoothShading = true, bool fillPolygons = true);
+  void startColorRendering(const Matrix4f& projection, const Matrix4f& view, int viewportX, int viewportY, int viewportWidth, int viewportHeight, bool clear, bool lighting = true, bool textures = true, bool smoothShading = true, bool fillPolygons = true, bool levelsOfDetail = true);
 
   /**
    * Starts a depth only render pass.
@@ -446,11 +564,13 @@ public:
 
   /**
    * Reads an image from current rendering context.
-   * @param image The buffer where is image will be saved to.
+   * Formats other than RGB are converted by an additional shader pass before they are read back.
+   * @param image The buffer where is image will be saved to (\c width * \c height * \c getBytesPerPixel(format) bytes).
    * @param width The image width.
    * @param height The image height.
+   * @param format The format in which the image should be delivered.
    */
-  void finishImageRendering(void* image, int width, int height);
+  void finishImageRendering(void* image, int width, int height, ImageFormat format = rgb);
 
   /**
    * Reads a depth image from current rendering context.
@@ -496,10 +616,14 @@ private:
     GLuint vbo; /**< The VBO (shared between contexts within a share group). */
     GLuint ebo; /**< The EBO (shared between contexts within a share group). */
     GLuint ubo; /**< The UBO (shared between contexts within a share group). */
+    unsigned int surfaceRevision = 0; /**< The revision of the surfaces that has been uploaded to the UBO from this context. */
+    unsigned int layoutRevision = 0; /**< The revision of the compiled scene that has been uploaded for this context. */
 
     std::vector<GLuint> textureIDs; /**< IDs for all textures (shared between contexts within a share group). */
 
     std::array<Shader, 9> shaders; /**< Shaders for different settings (shared between contexts within a share group). */
+    std::array<GLuint, numOfImageFormats> conversionPrograms; /**< Programs that convert an RGB image to the other image formats (shared between contexts within a share group). */
+    GLuint conversionVAO; /**< An empty VAO for drawing the full screen triangle of the conversion pass. This exists per context. */
 
     bool blendEnabled = false; /** The current blend state in this context. */
     GLuint boundTexture = 0; /** The currently bound texture in this context. */
@@ -552,6 +676,29 @@ private:
     unsigned lastUpdate = -1; /**< The simulation step of the last model matrix update. */
   };
 
+  /**
+   * Uploads the properties of all surfaces to a UBO.
+   * @param f The OpenGL functions of the current context.
+   * @param ubo The UBO (which must already have the size for all surfaces).
+   */
+  void uploadSurfaces(QOpenGLFunctions_3_3_Core& f, GLuint ubo) const;
+
+  /**
+   * Uploads the vertices, the indices and the surfaces to the buffers of a share group.
+   * The EBO is bound through a VAO, so one of the VAOs of the current context must be bound.
+   * @param data The per context data of the current context.
+   */
+  void uploadBuffers(PerContextData& data);
+
+  /**
+   * Uploads the textures and compiles the shaders of a share group.
+   * @param data The per context data of the current context.
+   */
+  void uploadTexturesAndShaders(PerContextData& data);
+
+  /** Uploads the compiled scene again for the share group of the current context if it was recompiled since. */
+  void updateSharedData();
+
   /**
    * Sets uniforms for a surface.
    * @param surface The surface to set.
@@ -581,6 +728,23 @@ private:
    */
   Shader compileDepthOnlyShader();
 
+  /**
+   * Compile a program that converts an RGB image to another image format.
+   * @param format The target image format (must not be \c rgb).
+   * @return A program ID.
+   */
+  GLuint compileConversionProgram(ImageFormat format);
+
+  /** Determines the offsets of all buffers within the VBO and the EBO. */
+  void compileLayout();
+
+  /**
+   * Fills the index buffers of the levels of detail of a mesh by clustering its vertices in grids of decreasing resolution.
+   * Levels that do not reduce the number of triangles noticeably are removed.
+   * @param mesh The mesh (its buffers must already be filled).
+   */
+  static void createLevelsOfDetail(Mesh& mesh);
+
   // Context handling:
   std::vector<unsigned> referenceCounters; /**< Reference counters of shared data per share group. */
   std::unordered_map<const QOpenGLContext*, PerContextData> perContextData; /**< Map of OpenGL context pointers to per context data. */
@@ -589,11 +753,16 @@ private:
   std::unordered_map<std::string, Texture*> textures; /**< Map of filenames to textures. */
   std::array<ModelMatrixSet, ModelMatrix::numOfUsages> modelMatrixSets; /**< List of all registered model matrices. */
   std::vector<Surface*> surfaces; /**< List of all registered surfaces. */
+  unsigned int surfaceRevision = 0; /**< Incremented whenever a surface has been changed after compilation. */
+  unsigned int layoutRevision = 0; /**< Incremented whenever the scene is compiled again after graphics have been created. */
   std::vector<VertexCategory> vertexBuffers; /**< List of the known vertex categories, pointing to all registered vertex buffers. */
   std::size_t vertexBufferTotalSize; /**< The total size of the vertex buffer object. */
   std::vector<IndexBuffer*> indexBuffers; /**< List of all registered index buffers. */
   std::size_t indexBufferTotalSize; /**< The total size of the element buffer object. */
+  bool layoutRestored = false; /**< Whether the layout of the buffers was restored by \c restoreBuffers. */
   std::vector<Mesh*> meshes; /**< List of all registered meshes. */
+  std::vector<Mesh*> levelOfDetailMeshes; /**< List of the meshes whose levels of detail have to be created during compilation. */
+  std::vector<std::function<void()>> bufferFills; /**< Functions that fill registered buffers and have not run yet. */
   std::vector<std::string> lightDeclarations; /**< GLSL declarations for light sources. */
   std::vector<std::string> lightCalculations; /**< GLSL code that adds a light source in the fragment shader. */
   float clearColor[4] = {0.f}; /**< The color to clear the framebuffer to. */
@@ -607,9 +776,13 @@ private:
   Shader* shader = nullptr; /**< The currently selected shader. */
   QOpenGLFunctions_3_3_Core* f = nullptr; /**< The OpenGL functions for the current OpenGL context. */
   const Surface* forcedSurface = nullptr; /**< The surface which overrides \c draw's argument. */
+  Vector3f cameraPosition = Vector3f::Zero(); /**< The position of the camera in world space. */
+  float levelOfDetailScale = 0.f; /**< Converts the ratio of a bounding sphere's radius and its distance to pixels (0 if levels of detail are not used). */
 
   // Offscreen rendering:
   QOpenGLContext* offscreenContext = nullptr; /**< The OpenGL context used for offscreen rendering. */
   QOffscreenSurface* offscreenSurface = nullptr; /**< The surface used for offscreen rendering. */
   std::unordered_map<unsigned int, QOpenGLFramebufferObject*> offscreenBuffers; /**< Map from encoded sizes to framebuffer objects. */
+  std::unordered_map<std::uint64_t, QOpenGLFramebufferObject*> conversionBuffers; /**< Map from encoded sizes and formats to framebuffer objects of the format conversion pass. */
+  QOpenGLFramebufferObject* currentOffscreenBuffer = nullptr; /**< The framebuffer object that was selected by the last call to \c makeCurrent. */
 };
@@ -11,3 +11,13 @@ ElementCore2::ElementCore2()
 {
   Simulation::simulation->elements.push_back(this);
 }
+
+void* ElementCore2::operator new(std::size_t size)
+{
+  return Simulation::simulation->elementArena.allocate(size);
+}
+
+void* ElementCore2::operator new(std::size_t size, std::align_val_t alignment)
+{
+  return Simulation::simulation->elementArena.allocate(size, static_cast<std::size_t>(alignment));
+}
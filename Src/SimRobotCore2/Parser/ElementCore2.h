@@ -7,6 +7,8 @@
 #pragma once
 
 #include "Parser/Element.h"
+#include <cstddef>
+#include <new>
 
 /**
  * @class Element
@@ -15,6 +17,55 @@
 class ElementCore2 : public Element
 {
 public:
+  /** The types of elements that are distinguished while the scene graph is built (instead of using \c dynamic_cast) */
+  enum Kind : unsigned char
+  {
+    otherKind,
+    bodyKind,
+    geometryKind,
+    massKind,
+    materialKind
+  };
+
+  Kind kind = otherKind; /**< The type of this element (set by the constructors of the respective classes) */
+
   /** Constructor */
   ElementCore2();
+
+  /**
+   * Allocates the memory for an element from the arena of the current simulation
+   * @param size The size of the element
+   * @return The memory
+   */
+  static void* operator new(std::size_t size);
+
+  /**
+   * Allocates the memory for an over-aligned element from the arena of the current simulation
+   * @param size The size of the element
+   * @param alignment The alignment of the element
+   * @return The memory
+   */
+  static void* operator new(std::size_t size, std::align_val_t alignment);
+
+  /** The memory of elements is released together with the arena of their simulation */
+  static void operator delete(void*) {}
+  static void operator delete(void*, std::align_val_t) {}
+
+  /**
+   * Checks whether the differences to a new version of this element (from a modified scene file) can be applied to
+   * this element while the simulation is running
+   * @param element The new version of this element (of the same type)
+   * @return Whether \c update can be called
+   */
+  virtual bool canUpdate(ElementCore2& element) const
+  {
+    static_cast<void>(element);
+    return false;
+  }
+
+  /**
+   * Applies the differences to a new version of this element (from a modified scene file) to this element
+   * @param element The new version of this element (of the same type)
+   */
+  virtual void update(ElementCore2& element) {static_cast<void>(element);}
 };
@@ -13,6 +13,7 @@
 #include "Simulation/Appearances/CapsuleAppearance.h"
 #include "Simulation/Appearances/ComplexAppearance.h"
 #include "Simulation/Appearances/CylinderAppearance.h"
+#include "Simulation/Appearances/MeshAppearance.h"
 #include "Simulation/Appearances/SphereAppearance.h"
 #include "Simulation/Axis.h"
 #include "Simulation/Body.h"
@@ -41,6 +42,7 @@
 #include "Simulation/Sensors/SingleDistanceSensor.h"
 #include "Simulation/Simulation.h"
 #include "Simulation/UserInput.h"
+#include "Tools/MeshFile.h"
 
 ParserCore2::ParserCore2()
 {
@@ -124,6 +126,8 @@ ParserCore2::ParserCore2()
       surfaceClass, translationClass | rotationClass, setClass | appearanceClass, {}},
     {"ComplexAppearance", appearanceClass, std::bind(&ParserCore2::complexAppearanceElement, this), nullptr, 0,
       surfaceClass | verticesClass | primitiveGroupClass, translationClass | rotationClass | normalsClass | texCoordsClass, setClass | primitiveGroupClass | appearanceClass, {}},
+    {"MeshAppearance", appearanceClass, std::bind(&ParserCore2::meshAppearanceElement, this), nullptr, 0,
+      surfaceClass, translationClass | rotationClass, setClass | appearanceClass, {"file"}},
 
     {"Vertices", verticesClass, std::bind(&ParserCore2::verticesElement, this), std::bind(&ParserCore2::verticesText, this, _1, _2), textFlag | constantFlag,
       0, 0, 0, {}},
@@ -193,11 +197,10 @@ bool ParserCore2::getColor(const char* key, bool required, float* colors)
 Element* ParserCore2::setElement()
 {
   ASSERT(element);
-  const std::string& name = getString("name", true);
+  // The name must be interned before the value is read, because both may be resolved into the same buffer.
+  const std::string& name = intern(getString("name", true));
   const std::string& value = getString("value", true);
-  auto& vars = elementData->parent->vars;
-  if(vars.find(name) == vars.end())
-    vars[name] = value;
+  elementData->parent->vars.emplace(&name, value);
   return nullptr;
 }
 
@@ -515,25 +518,12 @@ void ParserCore2::trianglesAndQuadsText(std::string& text, Location location)
 {
   ComplexAppearance::PrimitiveGroup* primitiveGroup = dynamic_cast<ComplexAppearance::PrimitiveGroup*>(element);
   ASSERT(primitiveGroup);
-  std::list<unsigned int>& vs = primitiveGroup->vertices;
-  const char* str = text.c_str();
-  char* nextStr;
-  unsigned int l;
-  skipWhitespace(str, location);
-  while(*str)
-  {
-    while(*str == '#') { while(*str && *str != '\n' && *str != '\r') { ++str; ++location.column; } skipWhitespace(str, location); if(!*str) return; }
-    l = static_cast<unsigned int>(std::strtol(str, &nextStr, 10));
-    if(str == nextStr)
-    {
-      handleError("Invalid index text (must be a space separated list of integers)", location);
-      return;
-    }
-    location.column += nextStr - str;
-    str = nextStr;
-    skipWhitespace(str, location);
-    vs.push_back(l);
-  }
+  // Whether normal indices are interleaved is not known yet, because the normals can follow the primitives.
+  // Therefore, only whole groups of corners can be checked here. ComplexAppearance ignores incomplete primitives.
+  const std::size_t corners = primitiveGroup->mode == ComplexAppearance::triangles ? 3 : 4;
+  getNumbers(text, location, primitiveGroup->vertices, corners, primitiveGroup->mode == ComplexAppearance::triangles ?
+             "Invalid index text (must be a space separated list of integers, three per triangle)" :
+             "Invalid index text (must be a space separated list of integers, four per quad)");
 }
 
 Element* ParserCore2::quadsElement()
@@ -552,31 +542,13 @@ void ParserCore2::verticesText(std::string& text, Location location)
 {
   ComplexAppearance::Vertices* vertices = dynamic_cast<ComplexAppearance::Vertices*>(element);
   ASSERT(vertices);
+  numbers.clear();
+  if(!getNumbers(text, location, numbers, 3, "Invalid vertex text (must be a space separated list of floats)"))
+    return;
   std::vector<Vector3f>& vs = vertices->vertices;
-  const char* str = text.c_str();
-  char* nextStr;
-  float components[3];
-  skipWhitespace(str, location);
-  while(*str)
-  {
-    for(int i = 0; i < 3; ++i)
-    {
-      while(*str == '#') { while(*str && *str != '\n' && *str != '\r') { ++str; ++location.column; } skipWhitespace(str, location); if(!*str) return; }
-      components[i] = std::strtof(str, &nextStr);
-      if(str == nextStr)
-      {
-        handleError("Invalid vertex text (must be a space separated list of floats)", location);
-        return;
-      }
-      location.column += nextStr - str;
-      str = nextStr;
-      skipWhitespace(str, location);
-    }
-    components[0] *= vertices->unit;
-    components[1] *= vertices->unit;
-    components[2] *= vertices->unit;
-    vs.emplace_back(components[0], components[1], components[2]);
-  }
+  vs.reserve(vs.size() + numbers.size() / 3);
+  for(std::size_t i = 0; i < numbers.size(); i += 3)
+    vs.emplace_back(numbers[i] * vertices->unit, numbers[i + 1] * vertices->unit, numbers[i + 2] * vertices->unit);
 }
 
 Element* ParserCore2::normalsElement()
@@ -588,28 +560,13 @@ void ParserCore2::normalsText(std::string& text, Location location)
 {
   ComplexAppearance::Normals* normals = dynamic_cast<ComplexAppearance::Normals*>(element);
   ASSERT(normals);
+  numbers.clear();
+  if(!getNumbers(text, location, numbers, 3, "Invalid normal text (must be a space separated list of floats)"))
+    return;
   std::vector<Vector3f>& ns = normals->normals;
-  const char* str = text.c_str();
-  char* nextStr;
-  float components[3];
-  skipWhitespace(str, location);
-  while(*str)
-  {
-    for(int i = 0; i < 3; ++i)
-    {
-      while(*str == '#') { while(*str && *str != '\n' && *str != '\r') { ++str; ++location.column; } skipWhitespace(str, location); if(!*str) return; }
-      components[i] = std::strtof(str, &nextStr);
-      if(str == nextStr)
-      {
-        handleError("Invalid normal text (must be a space separated list of floats)", location);
-        return;
-      }
-      location.column += nextStr - str;
-      str = nextStr;
-      skipWhitespace(str, location);
-    }
-    ns.emplace_back(components[0], components[1], components[2]);
-  }
+  ns.reserve(ns.size() + numbers.size() / 3);
+  for(std::size_t i = 0; i < numbers.size(); i += 3)
+    ns.emplace_back(numbers[i], numbers[i + 1], numbers[i + 2]);
 }
 
 Element* ParserCore2::texCoordsElement()
@@ -621,28 +578,39 @@ void ParserCore2::texCoordsText(std::string& text, Location location)
 {
   ComplexAppearance::TexCoords* texCoords = dynamic_cast<ComplexAppearance::TexCoords*>(element);
   ASSERT(texCoords);
+  numbers.clear();
+  if(!getNumbers(text, location, numbers, 2, "Invalid texture coordinate text (must be a space separated list of floats)"))
+    return;
   std::vector<Vector2f>& ts = texCoords->coords;
-  const char* str = text.c_str();
-  char* nextStr;
-  float components[2];
-  skipWhitespace(str, location);
-  while(*str)
+  ts.reserve(ts.size() + numbers.size() / 2);
+  for(std::size_t i = 0; i < numbers.size(); i += 2)
+    ts.emplace_back(numbers[i], numbers[i + 1]);
+}
+
+Element* ParserCore2::meshAppearanceElement()
+{
+  MeshAppearance* meshAppearance = new MeshAppearance();
+  meshAppearance->name = getString("name", false);
+  meshAppearance->file = getString("file", true);
+  meshAppearance->unit = getUnit("unit", false, 1);
+  if(meshAppearance->file.empty())
+    return meshAppearance;
+  addInputFile(meshAppearance->file);
+  std::shared_ptr<const MeshFile>& meshFile = meshFiles[meshAppearance->file];
+  if(!meshFile)
   {
-    for(int i = 0; i < 2; ++i)
+    auto loadedMeshFile = std::make_shared<MeshFile>();
+    std::string error;
+    if(!loadedMeshFile->load(meshAppearance->file, error))
     {
-      while(*str == '#') { while(*str && *str != '\n' && *str != '\r') { ++str; ++location.column; } skipWhitespace(str, location); if(!*str) return; }
-      components[i] = std::strtof(str, &nextStr);
-      if(str == nextStr)
-      {
-        handleError("Invalid texture coordinate text (must be a space separated list of floats)", location);
-        return;
-      }
-      location.column += nextStr - str;
-      str = nextStr;
-      skipWhitespace(str, location);
+      handleError("Could not load mesh \"" + meshAppearance->file + "\": " + error, findAttribute("file")->valueLocation);
+      meshFiles.erase(meshAppearance->file);
+      return meshAppearance;
     }
-    ts.emplace_back(components[0], components[1]);
+    meshFile = std::move(loadedMeshFile);
   }
+  meshAppearance->meshFile = meshFile;
+  return meshAppearance;
 }
 
 Element* ParserCore2::translationElement()
@@ -824,6 +792,27 @@ Element* ParserCore2::cameraElement()
   camera->imageHeight = getInteger("imageHeight", true, 0, true);
   camera->angleX = getAngle("angleX", true, 0.f, true);
   camera->angleY = getAngle("angleY", true, 0.f, true);
+
+  const std::string& format = getString("format", false);
+  if(format == "" || format == "rgb")
+    camera->format = GraphicsContext::rgb;
+  else if(format == "yuyv")
+  {
+    if(camera->imageWidth & 1)
+      handleError("The format \"yuyv\" requires an even imageWidth",
+                  findAttribute("format")->valueLocation);
+    else
+      camera->format = GraphicsContext::yuyv;
+  }
+  else if(format == "bayerRGGB")
+    camera->format = GraphicsContext::bayerRGGB;
+  else if(format == "grey")
+    camera->format = GraphicsContext::grey;
+  else
+    handleError("Unexpected image format \"" + format + "\" (expected one of \"rgb, yuyv, bayerRGGB, grey\")",
+                findAttribute("format")->valueLocation);
+  camera->fullDetail = getBool("fullDetail", false, false);
+
   return camera;
 }
 
@@ -842,6 +831,7 @@ Element* ParserCore2::objectSegmentedImageSensorElement()
   camera->imageHeight = getInteger("imageHeight", true, 0, true);
   camera->angleX = getAngle("angleX", true, 0.f, true);
   camera->angleY = getAngle("angleY", true, 0.f, true);
+  camera->fullDetail = getBool("fullDetail", false, false);
   return camera;
 }
 
@@ -883,13 +873,13 @@ Element* ParserCore2::depthImageSensorElement()
   {
     if(depthImageSensor->imageHeight > 1)
       handleError("Spherical projection is currently only supported for 1-D sensors (i.e. with imageHeight=\"1\")",
-                  attributes->find("projection")->second.valueLocation);
+                  findAttribute("projection")->valueLocation);
     else
       depthImageSensor->projection = DepthImageSensor::sphericalProjection;
   }
   else
     handleError("Unexpected projection type \"" + projection + "\" (expected one of \"perspective, spherical\")",
-                attributes->find("projection")->second.valueLocation);
+                findAttribute("projection")->valueLocation);
 
   return depthImageSensor;
 }
@@ -937,7 +927,7 @@ Element* ParserCore2::userInputElement()
   }
   else
     handleError("Unexpected user input type \"" + type + "\" (expected one of \"length, velocity, acceleration, angle, angularVelocity\")",
-                attributes->find("type")->second.valueLocation);
+                findAttribute("type")->valueLocation);
 
   return userInput;
 }
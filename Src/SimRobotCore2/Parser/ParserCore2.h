@@ -7,10 +7,13 @@
 #pragma once
 
 #include "Parser/Parser.h"
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 class Element;
+class MeshFile;
 
 /**
  * @class ParserCore2
@@ -90,6 +93,7 @@ private:
   void normalsText(std::string& text, Location location);
   Element* texCoordsElement();
   void texCoordsText(std::string& text, Location location);
+  Element* meshAppearanceElement();
   Element* hingeElement();
   Element* sliderElement();
   Element* axisElement();
@@ -113,4 +117,6 @@ private:
   Element* userInputElement();
 
   std::vector<ElementInfo> elements;
+  std::vector<float> numbers; /**< A buffer for the numbers in vertex, normal and texture coordinate texts */
+  std::unordered_map<std::string, std::shared_ptr<const MeshFile>> meshFiles; /**< The mesh files loaded so far (so that every file is loaded only once) */
 };
@@ -13,31 +13,215 @@
 #include <QLocale>
 #include <QMenu>
 #include <QMimeData>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions_3_3_Core>
+#include <algorithm>
+#include <array>
 #include <iomanip>
 #include <sstream>
 
 static inline float toDeg(float angleInRad)
 { return (angleInRad * 180.f / pi);}
 
+// The readings are mapped to colors by the fragment shader. The vertex shader generates
+// a single triangle that covers the whole viewport, so no vertex buffer is needed.
+static const char* vertexShaderSourceCode = R"glsl(#version 330 core
+out vec2 texCoords;
+
+void main()
+{
+  vec2 position = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+  texCoords = position;
+  gl_Position = vec4(position * 2.0 - 1.0, 0.0, 1.0);
+}
+)glsl";
+
+static const char* fragmentShaderSourceCode = R"glsl(#version 330 core
+uniform sampler2D sourceImage;
+uniform int mode;
+uniform float offset;
+uniform float scale;
+
+in vec2 texCoords;
+out vec4 FragColor;
+
+const vec3 colorRamp[7] = vec3[](vec3(1.0, 1.0, 1.0), vec3(0.0, 0.0, 1.0), vec3(0.0, 1.0, 1.0), vec3(0.0, 1.0, 0.0),
+                                 vec3(1.0, 1.0, 0.0), vec3(1.0, 0.0, 0.0), vec3(0.0, 0.0, 0.0));
+
+void main()
+{
+  if(mode == 1)
+  {
+    // YUYV: Each texel contains two pixels that share their chroma.
+    ivec2 size = textureSize(sourceImage, 0);
+    ivec2 pos = min(ivec2(texCoords * vec2(size.x * 2, size.y)), ivec2(size.x * 2 - 1, size.y - 1));
+    vec4 yuyv = texelFetch(sourceImage, ivec2(pos.x >> 1, pos.y), 0);
+    float y = (pos.x & 1) == 0 ? yuyv.r : yuyv.b;
+    float u = yuyv.g - 0.5;
+    float v = yuyv.a - 0.5;
+    FragColor = vec4(y + 1.402 * v, y - 0.344136 * u - 0.714136 * v, y + 1.772 * u, 1.0);
+  }
+  else if(mode == 2)
+    FragColor = vec4(texture(sourceImage, texCoords).rrr, 1.0);
+  else if(mode == 3)
+  {
+    float value = (texture(sourceImage, texCoords).r - offset) * scale;
+    if(value < 0.0 || value >= 6.0)
+      FragColor = vec4(0.0, 0.0, 0.0, 1.0);
+    else
+    {
+      int index = int(value);
+      FragColor = vec4(mix(colorRamp[index], colorRamp[index + 1], value - float(index)), 1.0);
+    }
+  }
+  else
+    FragColor = vec4(texture(sourceImage, texCoords).rgb, 1.0);
+}
+)glsl";
+
 SensorWidget::SensorWidget(SimRobotCore2::SensorPort* sensor) : pen(QColor::fromRgb(255, 0, 0)), sensor(sensor)
 {
+  QSurfaceFormat format = Simulation::simulation->graphicsContext.getOffscreenContext()->format();
+  format.setSwapBehavior(QSurfaceFormat::DoubleBuffer);
+  setFormat(format);
+
   setFocusPolicy(Qt::StrongFocus);
 
   sensorDimensions = sensor->getDimensions();
-  sensorType = sensor->getSensorType();;
+  sensorType = sensor->getSensorType();
+
+  float minValue, maxValue;
+  if(sensorType == SimRobotCore2::SensorPort::cameraSensor)
+  {
+    const int bytesPerPixel = sensorDimensions.size() > 2 ? sensorDimensions[2] : 3;
+    imageMode = bytesPerPixel == 3 ? rgbImage : bytesPerPixel == 2 ? yuyvImage : greyImage;
+  }
+  else if(sensorType == SimRobotCore2::SensorPort::floatArraySensor && sensor->getDescriptions().size() == 0 &&
+          sensorDimensions.size() == 2 && sensor->getMinAndMax(minValue, maxValue))
+    imageMode = depthImage;
+}
+
+SensorWidget::~SensorWidget()
+{
+  if(f)
+  {
+    makeCurrent();
+    f->glDeleteTextures(1, &texture);
+    f->glDeleteVertexArrays(1, &vertexArray);
+    f->glDeleteProgram(program);
+    doneCurrent();
+    delete f;
+  }
 }
 
-void SensorWidget::paintEvent(QPaintEvent*)
+void SensorWidget::initializeGL()
 {
+  if(imageMode == noImage)
+    return;
+
+  f = new QOpenGLFunctions_3_3_Core;
+  if(!f->initializeOpenGLFunctions())
+  {
+    delete f;
+    f = nullptr;
+    return;
+  }
+
+  const auto compileShader = [this](GLenum type, const char* source) -> GLuint
+  {
+    const GLuint shader = f->glCreateShader(type);
+    f->glShaderSource(shader, 1, &source, nullptr);
+    f->glCompileShader(shader);
+    GLint success = 0;
+    f->glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+    if(!success)
+    {
+      f->glDeleteShader(shader);
+      return 0;
+    }
+    return shader;
+  };
+  const GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexShaderSourceCode);
+  const GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentShaderSourceCode);
+  if(vertexShader && fragmentShader)
+  {
+    program = f->glCreateProgram();
+    f->glAttachShader(program, vertexShader);
+    f->glAttachShader(program, fragmentShader);
+    f->glLinkProgram(program);
+    GLint success = 0;
+    f->glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if(!success)
+    {
+      f->glDeleteProgram(program);
+      program = 0;
+    }
+  }
+  f->glDeleteShader(vertexShader);
+  f->glDeleteShader(fragmentShader);
+  if(!program)
+    return; // Images are converted by the CPU instead.
+
+  modeLocation = f->glGetUniformLocation(program, "mode");
+  offsetLocation = f->glGetUniformLocation(program, "offset");
+  scaleLocation = f->glGetUniformLocation(program, "scale");
+  f->glGenVertexArrays(1, &vertexArray);
+
+  // The size and format of the readings of a sensor never change, so the texture is allocated only once.
+  const int width = sensorDimensions[0], height = sensorDimensions[1];
+  f->glGenTextures(1, &texture);
+  f->glBindTexture(GL_TEXTURE_2D, texture);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  f->glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  switch(imageMode)
+  {
+    case rgbImage:
+      f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+      break;
+    case yuyvImage:
+      f->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width / 2, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+      break;
+    case greyImage:
+      f->glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, nullptr);
+      break;
+    case depthImage:
+      f->glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, nullptr);
+      break;
+    case noImage:
+      break;
+  }
+  f->glBindTexture(GL_TEXTURE_2D, 0);
+  valueChanged = true;
+}
+
+void SensorWidget::paintGL()
+{
+  // Reading the sensor might render with the offscreen context of the simulation.
+  const SimRobotCore2::SensorPort::Data data = sensor->getValue();
+  makeCurrent();
+
+  if(imageMode != noImage)
+  {
+    if(program)
+      paintImageWithShader(data);
+    else
+      paintImageWithPainter(data);
+    valueChanged = false;
+    return;
+  }
+
   float minValue, maxValue;
   bool hasMinAndMax = sensor->getMinAndMax(minValue, maxValue);
   const QList<int>& dimensions = sensorDimensions;
   painter.begin(this);
+  painter.fillRect(rect(), palette().window());
   switch(sensorType)
   {
     case SimRobotCore2::SensorPort::floatSensor:
     {
-      float sensorValue = sensor->getValue().floatValue;
+      float sensorValue = data.floatValue;
       char str_val[32];
       sprintf(str_val, "%.03f", sensorValue);
       if(hasMinAndMax)
@@ -66,8 +250,6 @@ void SensorWidget::paintEvent(QPaintEvent*)
       // Laser Range Finder
       else if(descriptions.size() == 0 && dimensions.size() == 1 && hasMinAndMax)
         paintFloatArrayWithLimitsAndWithoutDescriptions();
-      else if(descriptions.size() == 0 && dimensions.size() == 2 && hasMinAndMax)
-        paint2DFloatArrayWithLimitsAndWithoutDescriptions();
       // Other stuff
       else
         painter.drawText(0, 0, this->width(), this->height(), Qt::AlignCenter, "Not implemented yet!");
@@ -78,28 +260,145 @@ void SensorWidget::paintEvent(QPaintEvent*)
       paintBoolSensor();
       break;
     }
-    case SimRobotCore2::SensorPort::cameraSensor:
+    case SimRobotCore2::SensorPort::cameraSensor: // always drawn as an image
+    case SimRobotCore2::SensorPort::noSensor:
+      break; // do nothing
+  }
+  painter.end();
+}
+
+void SensorWidget::paintImageWithShader(const SimRobotCore2::SensorPort::Data& data)
+{
+  const int width = sensorDimensions[0], height = sensorDimensions[1];
+  f->glActiveTexture(GL_TEXTURE0);
+  f->glBindTexture(GL_TEXTURE_2D, texture);
+  if(valueChanged)
+  {
+    f->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    switch(imageMode)
     {
-      int xSize = dimensions[0], ySize = dimensions[1];
-      const unsigned char* vals = sensor->getValue().byteArray;
-      unsigned char* buffer = new unsigned char[xSize * ySize * 4];
-      unsigned char* pDest = buffer;
-      for(int y = ySize - 1; y >= 0; --y)
-        for(const unsigned char* pSrc = vals + xSize * 3 * y, * end = pSrc + xSize * 3; pSrc < end; pSrc += 3)
+      case rgbImage:
+        f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, data.byteArray);
+        break;
+      case yuyvImage:
+        f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width / 2, height, GL_RGBA, GL_UNSIGNED_BYTE, data.byteArray);
+        break;
+      case greyImage:
+        f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED, GL_UNSIGNED_BYTE, data.byteArray);
+        break;
+      case depthImage:
+        f->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RED, GL_FLOAT, data.floatArray);
+        break;
+      case noImage:
+        break;
+    }
+    f->glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  }
+
+  float minValue = 0.f, maxValue = 1.f;
+  if(imageMode == depthImage)
+    sensor->getMinAndMax(minValue, maxValue);
+
+  f->glDisable(GL_DEPTH_TEST);
+  f->glUseProgram(program);
+  f->glUniform1i(modeLocation, imageMode);
+  f->glUniform1f(offsetLocation, minValue);
+  f->glUniform1f(scaleLocation, 6.f / (maxValue - minValue));
+  f->glBindVertexArray(vertexArray);
+  f->glDrawArrays(GL_TRIANGLES, 0, 3);
+  f->glBindVertexArray(0);
+  f->glUseProgram(0);
+  f->glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void SensorWidget::paintImageWithPainter(const SimRobotCore2::SensorPort::Data& data)
+{
+  const int width = sensorDimensions[0], height = sensorDimensions[1];
+  if(image.isNull())
+  {
+    image = QImage(width, height, QImage::Format_RGB32);
+    valueChanged = true;
+  }
+
+  // The rows are converted by branchless loops over whole rows that the compiler can vectorize.
+  if(valueChanged)
+    for(int y = 0; y < height; ++y)
+    {
+      // The readings are stored bottom-up.
+      QRgb* dest = reinterpret_cast<QRgb*>(image.scanLine(height - 1 - y));
+      switch(imageMode)
+      {
+        case rgbImage:
         {
-          *pDest++ = pSrc[2];
-          *pDest++ = pSrc[1];
-          *pDest++ = pSrc[0];
-          *pDest++ = 0xff;
+          const unsigned char* src = data.byteArray + width * 3 * y;
+          for(int x = 0; x < width; ++x)
+            dest[x] = 0xff000000u | src[x * 3] << 16 | src[x * 3 + 1] << 8 | src[x * 3 + 2];
+          break;
         }
-      QImage img(buffer, xSize, ySize, QImage::Format_RGB32);
-      painter.drawImage(0, 0, img.scaled(this->width(), this->height()));
-      delete [] buffer;
-      break;
+        case yuyvImage:
+        {
+          // Two pixels share their chroma
+          const unsigned char* src = data.byteArray + width * 2 * y;
+          for(int x = 0; x < width; x += 2, src += 4)
+          {
+            const int u = src[1] - 128;
+            const int v = src[3] - 128;
+            const int r = (91881 * v) >> 16;
+            const int g = (-22554 * u - 46802 * v) >> 16;
+            const int b = (116130 * u) >> 16;
+            for(int i = 0; i < 2; ++i)
+            {
+              const int luma = src[i * 2];
+              dest[x + i] = qRgb(std::clamp(luma + r, 0, 255), std::clamp(luma + g, 0, 255), std::clamp(luma + b, 0, 255));
+            }
+          }
+          break;
+        }
+        case greyImage:
+        {
+          // Greyscale or raw Bayer images are shown as they are
+          const unsigned char* src = data.byteArray + width * y;
+          for(int x = 0; x < width; ++x)
+            dest[x] = 0xff000000u | src[x] * 0x010101u;
+          break;
+        }
+        case depthImage:
+        {
+          // The color ramp goes from white to blue, cyan, green, yellow, red and black in 256 steps each.
+          static const std::array<QRgb, 6 * 256 + 1> colorRamp = []
+          {
+            std::array<QRgb, 6 * 256 + 1> colorRamp;
+            for(int c = 0; c < 256; ++c)
+            {
+              colorRamp[c] = qRgb(255 - c, 255 - c, 255);
+              colorRamp[256 + c] = qRgb(0, c, 255);
+              colorRamp[512 + c] = qRgb(0, 255, 255 - c);
+              colorRamp[768 + c] = qRgb(c, 255, 0);
+              colorRamp[1024 + c] = qRgb(255, 255 - c, 0);
+              colorRamp[1280 + c] = qRgb(255 - c, 0, 0);
+            }
+            colorRamp[6 * 256] = qRgb(0, 0, 0);
+            return colorRamp;
+          }();
+          float minValue, maxValue;
+          sensor->getMinAndMax(minValue, maxValue);
+          const float scale = (6 << 8) / (maxValue - minValue);
+          const float* src = data.floatArray + width * y;
+          for(int x = 0; x < width; ++x)
+          {
+            const float value = (src[x] - minValue) * scale;
+            dest[x] = colorRamp[value >= 0.f && value < 6 * 256 ? static_cast<int>(value) : 6 * 256];
+          }
+          break;
+        }
+        case noImage:
+          break;
+      }
     }
-    case SimRobotCore2::SensorPort::noSensor:
-      break; // do nothing
-  }
+
+  // The image is scaled while it is drawn instead of creating a scaled copy first.
+  painter.begin(this);
+  painter.drawImage(rect(), image);
   painter.end();
 }
 
@@ -159,69 +458,6 @@ void SensorWidget::paintFloatArrayWithLimitsAndWithoutDescriptions()
   }
 }
 
-void SensorWidget::paint2DFloatArrayWithLimitsAndWithoutDescriptions()
-{
-  float minValue, maxValue;
-  if(!sensor->getMinAndMax(minValue, maxValue))
-  {
-    minValue = 0;
-    maxValue = 1;
-  }
-  double scale = (6 << 8) / (maxValue - minValue);
-  int xSize = sensorDimensions[0], ySize = sensorDimensions[1];
-  const float* vals = sensor->getValue().floatArray;
-  unsigned char* buffer = new unsigned char[xSize * ySize * 4];
-  unsigned char* pDest = buffer;
-  for(int y = ySize - 1; y >= 0; --y)
-    for(const float* pSrc = vals + xSize * y, * end = pSrc + xSize; pSrc < end; ++pSrc)
-    {
-      unsigned value = unsigned((*pSrc - minValue) * scale);
-      unsigned char c = static_cast<unsigned char>(value);
-      switch(value >> 8)
-      {
-        case 0:
-          *pDest++ = 255;
-          *pDest++ = 255 - c;
-          *pDest++ = 255 - c;
-          break;
-        case 1:
-          *pDest++ = 255;
-          *pDest++ = c;
-          *pDest++ = 0;
-          break;
-        case 2:
-          *pDest++ = 255 - c;
-          *pDest++ = 255;
-          *pDest++ = 0;
-          break;
-        case 3:
-          *pDest++ = 0;
-          *pDest++ = 255;
-          *pDest++ = c;
-          break;
-        case 4:
-          *pDest++ = 0;
-          *pDest++ = 255 - c;
-          *pDest++ = 255;
-          break;
-        case 5:
-          *pDest++ = 0;
-          *pDest++ = 0;
-          *pDest++ = 255 - c;
-          break;
-        default:
-          *pDest++ = 0;
-          *pDest++ = 0;
-          *pDest++ = 0;
-          break;
-      }
-      *pDest++ = 0xff;
-    }
-  QImage img(buffer, xSize, ySize, QImage::Format_RGB32);
-  painter.drawImage(0, 0, img.scaled(this->width(), this->height()));
-  delete [] buffer;
-}
-
 QSize SensorWidget::sizeHint() const
 {
   if(sensorType != SimRobotCore2::SensorPort::cameraSensor)
@@ -231,7 +467,8 @@ QSize SensorWidget::sizeHint() const
 
 void SensorWidget::update()
 {
-  QWidget::update();
+  valueChanged = true;
+  QOpenGLWidget::update();
 }
 
 QMenu* SensorWidget::createEditMenu() const
@@ -245,6 +482,42 @@ QMenu* SensorWidget::createEditMenu() const
   return menu;
 }
 
+QMenu* SensorWidget::createUserMenu() const
+{
+  if(sensorType != SimRobotCore2::SensorPort::cameraSensor)
+    return nullptr;
+
+  QMenu* menu = new QMenu(tr("&Sensor"));
+  QAction* action = menu->addAction(tr("&Record Video..."));
+  action->setStatusTip(tr("Record a video of the images of the camera that is captured every few simulation steps"));
+  connect(action, &QAction::triggered, this, &SensorWidget::recordVideo);
+  action = menu->addAction(tr("&Stop Recording"));
+  action->setEnabled(videoRecorder != nullptr);
+  connect(action, &QAction::triggered, this, &SensorWidget::stopRecording);
+  return menu;
+}
+
+void SensorWidget::recordVideo()
+{
+  QString fileName;
+  int stepsPerFrame;
+  if(!VideoRecorder::selectFile(this, fileName, stepsPerFrame))
+    return;
+
+  videoRecorder.reset();
+  videoRecorder = std::make_unique<VideoRecorder>(*sensor, stepsPerFrame, fileName);
+  CoreModule::current().application.setStatusMessage(tr("Recording to %1").arg(videoRecorder->getFileName()));
+}
+
+void SensorWidget::stopRecording()
+{
+  if(!videoRecorder)
+    return;
+  const QString fileName = videoRecorder->getFileName();
+  videoRecorder.reset();
+  CoreModule::current().application.setStatusMessage(tr("Recorded %1").arg(fileName));
+}
+
 void SensorWidget::copy()
 {
   auto* mimeData = new QMimeData;
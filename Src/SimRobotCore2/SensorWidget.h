@@ -7,19 +7,24 @@
 #pragma once
 
 #include "SimRobotCore2.h"
+#include "VideoRecorder.h"
+#include "Graphics/OpenGL.h"
+#include <QImage>
 #include <QList>
+#include <QOpenGLWidget>
 #include <QPainter>
 #include <QPen>
-#include <QWidget>
+#include <memory>
 
 class QMenu;
 class QMimeData;
+class QOpenGLFunctions_3_3_Core;
 
 /**
  * @class SensorWidget
  * A class that implements a view for visualizing sensor readings
  */
-class SensorWidget : public QWidget, public SimRobot::Widget
+class SensorWidget : public QOpenGLWidget, public SimRobot::Widget
 {
   Q_OBJECT
 
@@ -30,28 +35,72 @@ public:
    */
   SensorWidget(SimRobotCore2::SensorPort* sensor);
 
+  /** Destructor */
+  ~SensorWidget();
+
 private:
+  /** How the values of an image sensor are mapped to colors */
+  enum ImageMode
+  {
+    rgbImage, /**< 3 bytes per pixel (RGB) */
+    yuyvImage, /**< 2 bytes per pixel, two pixels share their chroma (YUYV) */
+    greyImage, /**< 1 byte per pixel (greyscale or raw Bayer) */
+    depthImage, /**< 1 float per pixel mapped to a color ramp between the limits of the sensor */
+    noImage /**< The sensor is not drawn as an image */
+  };
+
   QPainter painter;
   QPen pen;
   SimRobotCore2::SensorPort* sensor;
   SimRobotCore2::SensorPort::SensorType sensorType;
   QList<int> sensorDimensions;
+  ImageMode imageMode = noImage; /**< How the readings of the sensor are drawn if it is an image sensor */
+  bool valueChanged = true; /**< Whether the sensor was updated since its readings were last uploaded or converted */
+
+  QOpenGLFunctions_3_3_Core* f = nullptr; /**< The OpenGL functions of the context of this widget (\c nullptr if OpenGL 3.3 is not available) */
+  GLuint program = 0; /**< The shader that maps the texture to colors and scales it to the size of the widget */
+  GLint modeLocation = -1; /**< The location of the uniform selecting the \c ImageMode */
+  GLint offsetLocation = -1; /**< The location of the uniform with the minimum value of a depth image */
+  GLint scaleLocation = -1; /**< The location of the uniform that maps depth values to the color ramp */
+  GLuint vertexArray = 0; /**< An empty vertex array object (the vertices are generated in the shader) */
+  GLuint texture = 0; /**< The texture that holds the last readings of an image sensor */
+  int textureWidth = 0; /**< The number of texels per row allocated for \c texture */
+  int textureHeight = 0; /**< The number of rows allocated for \c texture */
+
+  QImage image; /**< The image into which the readings are converted if OpenGL 3.3 is not available (reused between repaints) */
+
+  std::unique_ptr<VideoRecorder> videoRecorder; /**< Records the images of a camera sensor while a recording is running */
 
   QWidget* getWidget() override {return this;}
   void update() override;
   QMenu* createEditMenu() const override;
+  QMenu* createUserMenu() const override;
 
   QSize sizeHint() const override;
-  void paintEvent(QPaintEvent* event) override;
+  void initializeGL() override;
+  void paintGL() override;
+
+  /**
+   * Draws the readings of an image sensor using a texture and a shader
+   * @param data The readings of the sensor
+   */
+  void paintImageWithShader(const SimRobotCore2::SensorPort::Data& data);
+
+  /**
+   * Draws the readings of an image sensor by converting them into \c image
+   * @param data The readings of the sensor
+   */
+  void paintImageWithPainter(const SimRobotCore2::SensorPort::Data& data);
 
   void paintBoolSensor();
   void paintFloatArrayWithDescriptionsSensor();
   void paintFloatArrayWithLimitsAndWithoutDescriptions();
-  void paint2DFloatArrayWithLimitsAndWithoutDescriptions();
 
   void setClipboardGraphics(QMimeData& mimeData);
   void setClipboardText(QMimeData& mimeData);
 
 private slots:
   void copy();
+  void recordVideo();
+  void stopRecording();
 };
@@ -17,6 +17,7 @@
 #include <ode/collision.h>
 #include <ode/objects.h>
 #include <QOpenGLFunctions_3_3_Core>
+#include <unordered_set>
 
 SimObjectRenderer::SimObjectRenderer(SimObject& simObject) :
   simObject(simObject),
@@ -114,7 +115,8 @@ void SimObjectRenderer::draw()
   const bool drawSensors = physicalObject && (renderFlags & showSensors);
   const bool drawDragPlane = dragging && dragSelection;
   const bool drawCoordinateSystem = renderFlags & showCoordinateSystem;
-  const bool drawControllerDrawings = (physicalObject || graphicalObject) && drawingsShadeMode != noShading && Simulation::simulation->scene->drawingManager;
+  const bool drawControllerDrawings = (physicalObject || graphicalObject) && drawingsShadeMode != noShading && Simulation::simulation->scene->drawingManager &&
+                                      !updateControllerDrawings(physicalObject, graphicalObject).empty();
 
   GraphicsContext& graphicsContext = Simulation::simulation->graphicsContext;
   if(drawAppearances || drawControllerDrawings)
@@ -166,7 +168,7 @@ void SimObjectRenderer::draw()
   // draw origin
   if(drawCoordinateSystem)
   {
-    graphicsContext.startColorRendering(projection, viewMatrix, -1, -1, -1, -1, clear, false, false, false, false);
+    graphicsContext.startColorRendering(projection, viewMatrix, -1, -1, width, height, clear, false, false, false, false);
     graphicsContext.draw(Simulation::simulation->xAxisMesh, Simulation::simulation->originModelMatrix, Simulation::simulation->xAxisSurface);
     graphicsContext.draw(Simulation::simulation->yAxisMesh, Simulation::simulation->originModelMatrix, Simulation::simulation->yAxisSurface);
     graphicsContext.draw(Simulation::simulation->zAxisMesh, Simulation::simulation->originModelMatrix, Simulation::simulation->zAxisSurface);
@@ -177,7 +179,7 @@ void SimObjectRenderer::draw()
   // draw object / scene appearance
   if(drawAppearances)
   {
-    graphicsContext.startColorRendering(projection, viewMatrix, -1, -1, -1, -1, clear, renderFlags & enableLights, renderFlags & enableTextures, surfaceShadeMode == smoothShading, surfaceShadeMode != wireframeShading);
+    graphicsContext.startColorRendering(projection, viewMatrix, -1, -1, width, height, clear, renderFlags & enableLights, renderFlags & enableTextures, surfaceShadeMode == smoothShading, surfaceShadeMode != wireframeShading);
     graphicalObject->drawAppearances(graphicsContext);
     graphicsContext.finishRendering();
     clear = false;
@@ -186,7 +188,7 @@ void SimObjectRenderer::draw()
   // draw object / scene physics
   if(drawPhysics || drawSensors)
   {
-    graphicsContext.startColorRendering(projection, viewMatrix, -1, -1, -1, -1, clear, renderFlags & enableLights, renderFlags & enableTextures, physicsShadeMode == smoothShading, physicsShadeMode != wireframeShading);
+    graphicsContext.startColorRendering(projection, viewMatrix, -1, -1, width, height, clear, renderFlags & enableLights, renderFlags & enableTextures, physicsShadeMode == smoothShading, physicsShadeMode != wireframeShading);
     physicalObject->drawPhysics(graphicsContext, (renderFlags | (physicsShadeMode != noShading ? showPhysics : 0)) & ~showControllerDrawings);
     graphicsContext.finishRendering();
     clear = false;
@@ -195,7 +197,7 @@ void SimObjectRenderer::draw()
   // draw drag plane
   if(drawDragPlane)
   {
-    graphicsContext.startColorRendering(projection, viewMatrix, -1, -1, -1, -1, clear, false, false, false, true);
+    graphicsContext.startColorRendering(projection, viewMatrix, -1, -1, width, height, clear, false, false, false, true);
     graphicsContext.draw(Simulation::simulation->dragPlaneMesh, Simulation::simulation->dragPlaneModelMatrix, Simulation::simulation->dragPlaneSurface);
     graphicsContext.finishRendering();
     clear = false;
@@ -219,21 +221,23 @@ void SimObjectRenderer::draw()
 
     Simulation::simulation->scene->drawingManager->beforeFrame();
 
-    if(physicalObject)
-      physicalObject->beforeControllerDrawings(projection.data(), viewMatrix.data());
-    if(graphicalObject)
-      graphicalObject->beforeControllerDrawings(projection.data(), viewMatrix.data());
+    for(const Scene::ControllerDrawing& controllerDrawing : controllerDrawings)
+    {
+      const GraphicsContext::ModelMatrix* modelMatrix = controllerDrawing.getModelMatrix();
+      ASSERT(modelMatrix);
+      controllerDrawing.drawing->beforeFrame(projection.data(), viewMatrix.data(), modelMatrix->getPointer());
+    }
 
     Simulation::simulation->scene->drawingManager->uploadData();
 
+    // Transparent occlusion needs two passes: Whether a fragment is blended depends on the result of its depth test, which
+    // only the shaders of the drawings could compare in a single pass, but these are provided by the controller.
+    // Therefore, the drawings are first drawn opaque where they are visible and then blended over the whole image.
     if(renderFlags & enableDrawingsTransparentOcclusion)
     {
       Simulation::simulation->scene->drawingManager->beforeDraw();
-
-      if(physicalObject)
-        physicalObject->drawControllerDrawings();
-      if(graphicalObject)
-        graphicalObject->drawControllerDrawings();
+      for(const Scene::ControllerDrawing& controllerDrawing : controllerDrawings)
+        controllerDrawing.drawing->draw();
     }
 
     if((renderFlags & enableDrawingsTransparentOcclusion) ||
@@ -244,16 +248,11 @@ void SimObjectRenderer::draw()
       f->glBlendColor(0.5f, 0.5f, 0.5f, 0.5f);
 
     Simulation::simulation->scene->drawingManager->beforeDraw();
+    for(const Scene::ControllerDrawing& controllerDrawing : controllerDrawings)
+      controllerDrawing.drawing->draw();
 
-    if(physicalObject)
-      physicalObject->drawControllerDrawings();
-    if(graphicalObject)
-      graphicalObject->drawControllerDrawings();
-
-    if(physicalObject)
-      physicalObject->afterControllerDrawings();
-    if(graphicalObject)
-      graphicalObject->afterControllerDrawings();
+    for(const Scene::ControllerDrawing& controllerDrawing : controllerDrawings)
+      controllerDrawing.drawing->afterFrame();
 
     Simulation::simulation->scene->drawingManager->afterFrame();
 
@@ -672,3 +671,37 @@ void SimObjectRenderer::getCamera(float* pos, float* target)
   target[1] = cameraTarget.y();
   target[2] = cameraTarget.z();
 }
+
+const std::vector<Scene::ControllerDrawing>& SimObjectRenderer::updateControllerDrawings(const PhysicalObject* physicalObject, const GraphicalObject* graphicalObject)
+{
+  const Scene* scene = Simulation::simulation->scene;
+  if(controllerDrawingsRevision == scene->controllerDrawingsRevision)
+    return controllerDrawings;
+  controllerDrawingsRevision = scene->controllerDrawingsRevision;
+  controllerDrawings.clear();
+  if(scene->controllerDrawings.empty())
+    return controllerDrawings;
+
+  // The objects shown in this view are only collected when drawings were registered or unregistered.
+  std::unordered_set<const PhysicalObject*> physicalObjects;
+  for(std::vector<const PhysicalObject*> stack = {physicalObject}; !stack.empty();)
+  {
+    const PhysicalObject* object = stack.back();
+    stack.pop_back();
+    if(object && physicalObjects.insert(object).second)
+      object->getPhysicalDrawingChildren(stack);
+  }
+  std::unordered_set<const GraphicalObject*> graphicalObjects;
+  for(std::vector<const GraphicalObject*> stack = {graphicalObject}; !stack.empty();)
+  {
+    const GraphicalObject* object = stack.back();
+    stack.pop_back();
+    if(object && graphicalObjects.insert(object).second)
+      object->getGraphicalDrawingChildren(stack);
+  }
+
+  for(const Scene::ControllerDrawing& controllerDrawing : scene->controllerDrawings)
+    if(controllerDrawing.physicalObject ? physicalObjects.count(controllerDrawing.physicalObject) != 0 : graphicalObjects.count(controllerDrawing.graphicalObject) != 0)
+      controllerDrawings.push_back(controllerDrawing);
+  return controllerDrawings;
+}
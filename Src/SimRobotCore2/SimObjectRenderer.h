@@ -7,10 +7,14 @@
 #pragma once
 
 #include "SimRobotCore2.h"
+#include "Simulation/Scene.h"
 #include "Tools/Math/Eigen.h"
+#include <vector>
 
 class SimObject;
 class Body;
+class GraphicalObject;
+class PhysicalObject;
 
 /**
  * @class SimObjectRenderer
@@ -28,6 +32,12 @@ public:
   /** Destructor. Ensures that \c destroy has been called.  */
   ~SimObjectRenderer();
 
+  /**
+   * Returns the object that is rendered
+   * @return The object
+   */
+  SimObject& getSimObject() const {return simObject;}
+
 private:
   SimObject& simObject;
   unsigned int width = 0;
@@ -59,8 +69,19 @@ private:
   unsigned int dragStartTime;
   static constexpr int degreeSteps = 15;
 
+  std::vector<Scene::ControllerDrawing> controllerDrawings; /**< The controller drawings of the rendered object and its children */
+  unsigned int controllerDrawingsRevision = ~0u; /**< The revision of the drawings of the scene \c controllerDrawings was collected from */
+
   void updateCameraTransformation();
 
+  /**
+   * Collects the controller drawings shown in this view if drawings were registered or unregistered since the last call
+   * @param physicalObject The rendered object as physical object (or \c nullptr)
+   * @param graphicalObject The rendered object as graphical object (or \c nullptr)
+   * @return The controller drawings to draw
+   */
+  const std::vector<Scene::ControllerDrawing>& updateControllerDrawings(const PhysicalObject* physicalObject, const GraphicalObject* graphicalObject);
+
   bool intersectRayAndPlane(const Vector3f& point, const Vector3f& v,
                             const Vector3f& plane, const Vector3f& n,
                             Vector3f& intersection) const;
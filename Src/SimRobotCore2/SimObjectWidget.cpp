@@ -34,7 +34,7 @@ SimObjectWidget::SimObjectWidget(SimObject& simObject) : QOpenGLWidget(),
   grabGesture(Qt::PinchGesture);
 
   // load layout settings
-  QSettings* settings = &CoreModule::application->getLayoutSettings();
+  QSettings* settings = &CoreModule::current().application.getLayoutSettings();
   settings->beginGroup(object.getFullName());
 
   objectRenderer.setSurfaceShadeMode(SimRobotCore2::Renderer::ShadeMode(settings->value("SurfaceShadeMode", int(objectRenderer.getSurfaceShadeMode())).toInt()));
@@ -63,7 +63,7 @@ SimObjectWidget::SimObjectWidget(SimObject& simObject) : QOpenGLWidget(),
 SimObjectWidget::~SimObjectWidget()
 {
   // save layout settings
-  QSettings* settings = &CoreModule::application->getLayoutSettings();
+  QSettings* settings = &CoreModule::current().application.getLayoutSettings();
   settings->beginGroup(object.getFullName());
 
   settings->setValue("SurfaceShadeMode", int(objectRenderer.getSurfaceShadeMode()));
@@ -164,7 +164,7 @@ void SimObjectWidget::mouseDoubleClickEvent(QMouseEvent* event)
   {
     SimRobotCore2::Object* selectedObject = objectRenderer.getDragSelection();
     if(selectedObject)
-      CoreModule::application->selectObject(*selectedObject);
+      CoreModule::current().application.selectObject(*selectedObject);
   }
 }
 
@@ -503,6 +503,34 @@ QMenu* SimObjectWidget::createUserMenu() const
     connect(action, &QAction::triggered, this, [this]{ const_cast<SimObjectWidget*>(this)->exportAsImage(1280, 1024); });
   }
 
+  {
+    QMenu* subMenu = menu->addMenu(tr("&Record Video..."));
+    subMenu->setStatusTip(tr("Record a video of the view that is captured every few simulation steps"));
+    auto* action = subMenu->addAction(tr("1920x1080"));
+    connect(action, &QAction::triggered, this, [this]{ const_cast<SimObjectWidget*>(this)->recordVideo(1920, 1080); });
+    action = subMenu->addAction(tr("1280x720"));
+    connect(action, &QAction::triggered, this, [this]{ const_cast<SimObjectWidget*>(this)->recordVideo(1280, 720); });
+    action = subMenu->addAction(tr("640x480"));
+    connect(action, &QAction::triggered, this, [this]{ const_cast<SimObjectWidget*>(this)->recordVideo(640, 480); });
+    action = menu->addAction(tr("&Stop Recording"));
+    action->setEnabled(videoRecorder != nullptr);
+    connect(action, &QAction::triggered, this, &SimObjectWidget::stopRecording);
+  }
+
+  {
+    QMenu* subMenu = menu->addMenu(tr("Ser&ve View"));
+    subMenu->setStatusTip(tr("Render the view independently of this widget and publish it to other processes"));
+    auto* action = subMenu->addAction(tr("1280x720"));
+    connect(action, &QAction::triggered, this, [this]{ const_cast<SimObjectWidget*>(this)->serveView(1280, 720); });
+    action = subMenu->addAction(tr("640x480"));
+    connect(action, &QAction::triggered, this, [this]{ const_cast<SimObjectWidget*>(this)->serveView(640, 480); });
+    action = subMenu->addAction(tr("320x240"));
+    connect(action, &QAction::triggered, this, [this]{ const_cast<SimObjectWidget*>(this)->serveView(320, 240); });
+    action = menu->addAction(tr("Stop Serving Views"));
+    action->setEnabled(!CoreModule::current().viewServer.empty());
+    connect(action, &QAction::triggered, this, &SimObjectWidget::stopServingViews);
+  }
+
   return menu;
 }
 
@@ -513,7 +541,7 @@ void SimObjectWidget::copy()
 
 void SimObjectWidget::exportAsImage(int width, int height)
 {
-  QSettings& settings = CoreModule::application->getSettings();
+  QSettings& settings = CoreModule::current().application.getSettings();
   QString fileName = QFileDialog::getSaveFileName(this,
                                                   tr("Export as Image"), settings.value("ExportDirectory", "").toString(), tr("Portable Network Graphic (*.png)")
 #ifdef LINUX
@@ -544,6 +572,39 @@ void SimObjectWidget::exportAsImage(int width, int height)
   image.save(fileName);
 }
 
+void SimObjectWidget::recordVideo(int width, int height)
+{
+  QString fileName;
+  int stepsPerFrame;
+  if(!VideoRecorder::selectFile(this, fileName, stepsPerFrame))
+    return;
+
+  videoRecorder.reset();
+  videoRecorder = std::make_unique<VideoRecorder>(objectRenderer, width, height, stepsPerFrame, fileName);
+  CoreModule::current().application.setStatusMessage(tr("Recording to %1").arg(videoRecorder->getFileName()));
+}
+
+void SimObjectWidget::stopRecording()
+{
+  if(!videoRecorder)
+    return;
+  const QString fileName = videoRecorder->getFileName();
+  videoRecorder.reset();
+  CoreModule::current().application.setStatusMessage(tr("Recorded %1").arg(fileName));
+}
+
+void SimObjectWidget::serveView(int width, int height)
+{
+  const QString key = CoreModule::current().viewServer.addView(objectRenderer, width, height);
+  CoreModule::current().application.setStatusMessage(tr("Serving view in shared memory segment %1").arg(key));
+}
+
+void SimObjectWidget::stopServingViews()
+{
+  CoreModule::current().viewServer.removeViews();
+  CoreModule::current().application.setStatusMessage(tr("Stopped serving views"));
+}
+
 void SimObjectWidget::setSurfaceShadeMode(int style)
 {
   objectRenderer.setSurfaceShadeMode(SimRobotCore2::Renderer::ShadeMode(style));
@@ -10,6 +10,8 @@
 
 #include "SimRobotCore2.h"
 #include "SimObjectRenderer.h"
+#include "VideoRecorder.h"
+#include <memory>
 
 class SimObject;
 class Simulation;
@@ -36,6 +38,7 @@ private:
   const SimRobot::Object& object; /**< The object that should be displayed */
   SimObjectRenderer objectRenderer; /**< For rendering the object */
   int fovY;
+  std::unique_ptr<VideoRecorder> videoRecorder; /**< Records the view while a recording is running */
 
   bool wKey, aKey, sKey, dKey;
 
@@ -72,4 +75,8 @@ private slots:
   void fitCamera();
   void toggleRenderFlag(int flag);
   void exportAsImage(int width, int height);
+  void recordVideo(int width, int height);
+  void stopRecording();
+  void serveView(int width, int height);
+  void stopServingViews();
 };
@@ -534,6 +534,39 @@ namespace SimRobotCore2
      * @return True if no manager was already registered
      */
     virtual bool registerDrawingManager(Controller3DDrawingManager& manager) = 0;
+
+    /**
+     * Casts rays against the collision geometries of the scene
+     * @param origins The start points of the rays (3 floats per ray)
+     * @param directions The normalized directions of the rays (3 floats per ray)
+     * @param maxDistances The maximum length of each ray
+     * @param count The number of rays
+     * @param distances Is filled with the distance to the closest hit of each ray (or its maximum length if nothing was hit)
+     * @param bodies Is filled with the body that was hit by each ray (\c nullptr if nothing or a static geometry was hit). Can be \c nullptr.
+     */
+    virtual void castRays(const float* origins, const float* directions, const float* maxDistances, unsigned int count, float* distances, Body** bodies) = 0;
+
+    /**
+     * Finds the root bodies near spheres. A body is found if the sphere that covers one of its collision geometries overlaps the query sphere.
+     * @param centers The centers of the query spheres (3 floats per sphere)
+     * @param radii The radii of the query spheres
+     * @param count The number of query spheres
+     * @param maxBodies The maximum number of bodies reported per query sphere
+     * @param bodies Is filled with up to \c maxBodies root bodies per query sphere (the bodies of sphere i start at index i * \c maxBodies)
+     * @param numOfBodies Is filled with the number of bodies found for each query sphere
+     */
+    virtual void findBodiesInSpheres(const float* centers, const float* radii, unsigned int count, unsigned int maxBodies, Body** bodies, unsigned int* numOfBodies) = 0;
+
+    /**
+     * Finds the root bodies closest to points. The distance to a body is the distance to the closest sphere that covers one of its collision geometries.
+     * @param points The points (3 floats per point)
+     * @param count The number of points
+     * @param k The maximum number of bodies reported per point
+     * @param bodies Is filled with up to \c k root bodies per point, sorted by their distance (the bodies of point i start at index i * \c k)
+     * @param distances Is filled with the distances of the bodies (same layout as \c bodies). Can be \c nullptr.
+     * @param numOfBodies Is filled with the number of bodies found for each point
+     */
+    virtual void findNearestBodies(const float* points, unsigned int count, unsigned int k, Body** bodies, float* distances, unsigned int* numOfBodies) = 0;
   };
 
   /**
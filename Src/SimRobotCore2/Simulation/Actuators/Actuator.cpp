@@ -28,12 +28,12 @@ void Actuator::addParent(Element& element)
 
 const QIcon* Actuator::Port::getIcon() const
 {
-  return &CoreModule::module->actuatorIcon;
+  return &CoreModule::current().actuatorIcon;
 }
 
 SimRobot::Widget* Actuator::Port::createWidget()
 {
-  CoreModule::module->application->openObject(CoreModule::module->actuatorsObject);
+  CoreModule::current().application.openObject(CoreModule::current().actuatorsObject);
   if(ActuatorsWidget::actuatorsWidget)
     ActuatorsWidget::actuatorsWidget->openActuator(fullName);
   return nullptr;
@@ -31,11 +31,11 @@ void Hinge::createPhysics(GraphicsContext& graphicsContext)
   Joint::createPhysics(graphicsContext);
 
   // find bodies to connect
-  Body* parentBody = dynamic_cast<Body*>(parent);
+  Body* parentBody = parent->kind == bodyKind ? static_cast<Body*>(parent) : nullptr;
   ASSERT(!parentBody || parentBody->body);
   ASSERT(!children.empty());
-  Body* childBody = dynamic_cast<Body*>(children.front());
-  ASSERT(childBody);
+  ASSERT(children.front()->kind == bodyKind);
+  Body* childBody = static_cast<Body*>(children.front());
   ASSERT(childBody->body);
 
   // create joint
@@ -80,5 +80,5 @@ void Hinge::createPhysics(GraphicsContext& graphicsContext)
 
 const QIcon* Hinge::getIcon() const
 {
-  return &CoreModule::module->hingeIcon;
+  return &CoreModule::current().hingeIcon;
 }
@@ -13,6 +13,8 @@
 #include "SimRobotCore2.h"
 #include "Simulation/Axis.h"
 #include "Simulation/Motors/Motor.h"
+#include "Simulation/Scene.h"
+#include "Simulation/Simulation.h"
 #include <ode/objects.h>
 #include <cmath>
 
@@ -37,6 +39,16 @@ void Joint::createPhysics(GraphicsContext& graphicsContext)
   surface = graphicsContext.requestSurface(color, color);
 }
 
+void Joint::destroyPhysics()
+{
+  if(axis->motor)
+    Simulation::simulation->scene->actuators.remove(axis->motor);
+  dJointDestroy(joint);
+  joint = nullptr;
+
+  Actuator::destroyPhysics();
+}
+
 void Joint::drawPhysics(GraphicsContext& graphicsContext, unsigned int flags) const
 {
   if(flags & SimRobotCore2::Renderer::showPhysics)
@@ -48,12 +60,12 @@ void Joint::drawPhysics(GraphicsContext& graphicsContext, unsigned int flags) co
   Actuator::drawPhysics(graphicsContext, flags);
 }
 
-void Joint::registerObjects()
+void Joint::registerObjects(CoreModule& module)
 {
   // add sensors and actuators
   if(axis->motor)
-    axis->motor->registerObjects();
+    axis->motor->registerObjects(module);
 
   // add children
-  ::PhysicalObject::registerObjects();
+  ::PhysicalObject::registerObjects(module);
 }
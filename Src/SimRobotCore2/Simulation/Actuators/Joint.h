@@ -35,6 +35,9 @@ protected:
    */
   void createPhysics(GraphicsContext& graphicsContext) override;
 
+  /** Destroys the ODE joint and stops the motor */
+  void destroyPhysics() override;
+
 private:
   /**
    * Submits draw calls for physical primitives of the object (including children) in the given graphics context
@@ -43,8 +46,11 @@ private:
    */
   void drawPhysics(GraphicsContext& graphicsContext, unsigned int flags) const override;
 
-  /** Registers this object with children, actuators and sensors at SimRobot's GUI */
-  void registerObjects() override;
+  /**
+   * Registers this object with children, actuators and sensors at SimRobot's GUI
+   * @param module The module that owns the simulation
+   */
+  void registerObjects(CoreModule& module) override;
 
   GraphicsContext::Mesh* axisLine = nullptr;
   GraphicsContext::Mesh* sphere = nullptr;
@@ -27,11 +27,11 @@ void Slider::createPhysics(GraphicsContext& graphicsContext)
   Joint::createPhysics(graphicsContext);
 
   // find bodies to connect
-  Body* parentBody = dynamic_cast<Body*>(parent);
+  Body* parentBody = parent->kind == bodyKind ? static_cast<Body*>(parent) : nullptr;
   ASSERT(!parentBody || parentBody->body);
   ASSERT(!children.empty());
-  Body* childBody = dynamic_cast<Body*>(children.front());
-  ASSERT(childBody);
+  ASSERT(children.front()->kind == bodyKind);
+  Body* childBody = static_cast<Body*>(children.front());
   ASSERT(childBody->body);
 
   // create joint
@@ -73,5 +73,5 @@ void Slider::createPhysics(GraphicsContext& graphicsContext)
 
 const QIcon* Slider::getIcon() const
 {
-  return &CoreModule::module->sliderIcon;
+  return &CoreModule::current().sliderIcon;
 }
@@ -8,6 +8,7 @@
 #include "CoreModule.h"
 #include "Platform/Assert.h"
 #include "Simulation/Scene.h"
+#include "Simulation/Simulation.h"
 #include "Tools/OpenGLTools.h"
 
 Appearance::Surface::Surface()
@@ -51,6 +52,24 @@ void Appearance::Surface::createGraphics(GraphicsContext& graphicsContext)
   surface = graphicsContext.requestSurface(diffuseColor, ambientColor, specularColor, emissionColor, shininess, texture);
 }
 
+bool Appearance::Surface::canUpdate(ElementCore2& element) const
+{
+  return static_cast<const Surface&>(element).diffuseTexture == diffuseTexture;
+}
+
+void Appearance::Surface::update(ElementCore2& element)
+{
+  const Surface& newSurface = static_cast<const Surface&>(element);
+  std::memcpy(diffuseColor, newSurface.diffuseColor, sizeof(diffuseColor));
+  hasAmbientColor = newSurface.hasAmbientColor;
+  std::memcpy(ambientColor, hasAmbientColor ? newSurface.ambientColor : newSurface.diffuseColor, sizeof(ambientColor));
+  std::memcpy(specularColor, newSurface.specularColor, sizeof(specularColor));
+  std::memcpy(emissionColor, newSurface.emissionColor, sizeof(emissionColor));
+  shininess = newSurface.shininess;
+  if(surface)
+    Simulation::simulation->graphicsContext.updateSurface(surface, diffuseColor, ambientColor, specularColor, emissionColor, shininess);
+}
+
 void Appearance::createGraphics(GraphicsContext& graphicsContext)
 {
   OpenGLTools::convertTransformation(rotation, translation, poseInParent);
@@ -60,6 +79,8 @@ void Appearance::createGraphics(GraphicsContext& graphicsContext)
   ASSERT(!mesh);
   mesh = createMesh(graphicsContext);
   ASSERT(!mesh == !surface);
+  if(mesh)
+    graphicsContext.requestLevelsOfDetail(mesh);
 
   graphicsContext.pushModelMatrix(poseInParent);
   ASSERT(!modelMatrix);
@@ -70,7 +91,7 @@ void Appearance::createGraphics(GraphicsContext& graphicsContext)
 
 const QIcon* Appearance::getIcon() const
 {
-  return &CoreModule::module->appearanceIcon;
+  return &CoreModule::current().appearanceIcon;
 }
 
 void Appearance::addParent(Element& element)
@@ -40,6 +40,19 @@ public:
      */
     void createGraphics(GraphicsContext& graphicsContext);
 
+    /**
+     * Checks whether the differences to a new version of this surface can be applied
+     * @param element The new version of this surface
+     * @return Whether it has the same texture
+     */
+    bool canUpdate(ElementCore2& element) const override;
+
+    /**
+     * Applies the colors and the shininess of a new version of this surface
+     * @param element The new version of this surface
+     */
+    void update(ElementCore2& element) override;
+
   private:
     /**
      * Registers an element as parent
@@ -80,16 +80,28 @@ GraphicsContext::Mesh* ComplexAppearance::createMesh(GraphicsContext& graphicsCo
 
 template<typename VertexType, bool withTextureCoordinates>
 GraphicsContext::Mesh* ComplexAppearance::createMeshImpl(GraphicsContext& graphicsContext)
+{
+  GraphicsContext::VertexBuffer<VertexType>* vertexBuffer = graphicsContext.requestVertexBuffer<VertexType>();
+  GraphicsContext::IndexBuffer* indexBuffer = graphicsContext.requestIndexBuffer();
+  graphicsContext.requestBufferFill([this, vertexBuffer, indexBuffer]
+  {
+    fillBuffers<VertexType, withTextureCoordinates>(*vertexBuffer, *indexBuffer);
+  });
+  return graphicsContext.requestMesh(vertexBuffer, indexBuffer, GraphicsContext::triangleList);
+}
+
+template<typename VertexType, bool withTextureCoordinates>
+void ComplexAppearance::fillBuffers(GraphicsContext::VertexBuffer<VertexType>& vertexBuffer, GraphicsContext::IndexBuffer& indexBuffer) const
 {
   const std::size_t verticesSize = vertices->vertices.size();
   ASSERT(!withTextureCoordinates || texCoords->coords.size() == verticesSize);
 
-  GraphicsContext::VertexBuffer<VertexType>* vertexBuffer = graphicsContext.requestVertexBuffer<VertexType>();
-  vertexBuffer->vertices.reserve(verticesSize);
+  vertexBuffer.vertices.reserve(verticesSize);
 
   std::unordered_map<std::uint64_t, unsigned int> indexMap;
+  indexMap.reserve(verticesSize);
 
-  auto getVertex = [this, vertexBuffer, &indexMap](std::list<unsigned int>::const_iterator& iter) -> unsigned int
+  auto getVertex = [this, &vertexBuffer, &indexMap](const unsigned int*& iter) -> unsigned int
   {
     const unsigned int vertexIndex = *(iter++);
     const unsigned int normalIndex = normals ? *(iter++) : vertexIndex;
@@ -106,22 +118,29 @@ GraphicsContext::Mesh* ComplexAppearance::createMeshImpl(GraphicsContext& graphi
     if constexpr(withTextureCoordinates)
     {
       const Vector2f& texCoord = texCoords->coords[vertexIndex];
-      vertexBuffer->vertices.emplace_back(vertex, normal, texCoord);
+      vertexBuffer.vertices.emplace_back(vertex, normal, texCoord);
     }
     else
-      vertexBuffer->vertices.emplace_back(vertex, normal);
+      vertexBuffer.vertices.emplace_back(vertex, normal);
     // Write the new index back to the map.
-    index = static_cast<unsigned int>(vertexBuffer->vertices.size());
+    index = static_cast<unsigned int>(vertexBuffer.vertices.size());
     return index - 1;
   };
 
-  GraphicsContext::IndexBuffer* indexBuffer = graphicsContext.requestIndexBuffer();
-  auto& indices = indexBuffer->indices;
+  auto& indices = indexBuffer.indices;
+  std::size_t indicesSize = indices.size();
+  for(const PrimitiveGroup* primitiveGroup : primitiveGroups)
+  {
+    const std::size_t corners = primitiveGroup->vertices.size() / (normals ? 2 : 1);
+    indicesSize += primitiveGroup->mode == quads ? corners / 4 * 6 : corners;
+  }
+  indices.reserve(indicesSize);
   for(const PrimitiveGroup* primitiveGroup : primitiveGroups)
   {
     ASSERT(primitiveGroup->mode == triangles || primitiveGroup->mode == quads);
-    ASSERT(primitiveGroup->vertices.size() % (normals ? (primitiveGroup->mode == triangles ? 6 : 8) : (primitiveGroup->mode == triangles ? 3 : 4)) == 0);
-    for(auto iter = primitiveGroup->vertices.begin(), end = primitiveGroup->vertices.end(); iter != end;)
+    // The parser cannot check whether normal indices are interleaved, so an incomplete primitive at the end is ignored.
+    const std::ptrdiff_t indicesPerPrimitive = (primitiveGroup->mode == triangles ? 3 : 4) * (normals ? 2 : 1);
+    for(const unsigned int* iter = primitiveGroup->vertices.data(), * end = iter + primitiveGroup->vertices.size(); end - iter >= indicesPerPrimitive;)
     {
       const auto i1 = getVertex(iter);
       const auto i2 = getVertex(iter);
@@ -134,17 +153,17 @@ GraphicsContext::Mesh* ComplexAppearance::createMeshImpl(GraphicsContext& graphi
       Vector3f n;
       if(!normals)
       {
-        const auto& p1 = vertexBuffer->vertices[i1].position;
-        const auto& p2 = vertexBuffer->vertices[i2].position;
-        const auto& p3 = vertexBuffer->vertices[i3].position;
+        const auto& p1 = vertexBuffer.vertices[i1].position;
+        const auto& p2 = vertexBuffer.vertices[i2].position;
+        const auto& p3 = vertexBuffer.vertices[i3].position;
 
         const Vector3f u = p2 - p1;
         const Vector3f v = p3 - p1;
         n = u.cross(v).normalized();
 
-        vertexBuffer->vertices[i1].normal += n;
-        vertexBuffer->vertices[i2].normal += n;
-        vertexBuffer->vertices[i3].normal += n;
+        vertexBuffer.vertices[i1].normal += n;
+        vertexBuffer.vertices[i2].normal += n;
+        vertexBuffer.vertices[i3].normal += n;
       }
 
       if(primitiveGroup->mode == quads)
@@ -154,16 +173,14 @@ GraphicsContext::Mesh* ComplexAppearance::createMeshImpl(GraphicsContext& graphi
         indices.push_back(i4);
         indices.push_back(i1);
         if(!normals)
-          vertexBuffer->vertices[i4].normal += n;
+          vertexBuffer.vertices[i4].normal += n;
       }
     }
   }
 
   if(!normals)
-    for(auto& vertex : vertexBuffer->vertices)
+    for(auto& vertex : vertexBuffer.vertices)
       vertex.normal.normalize();
-  vertexBuffer->vertices.shrink_to_fit();
-  vertexBuffer->finish();
-
-  return graphicsContext.requestMesh(vertexBuffer, indexBuffer, GraphicsContext::triangleList);
+  vertexBuffer.vertices.shrink_to_fit();
+  vertexBuffer.finish();
 }
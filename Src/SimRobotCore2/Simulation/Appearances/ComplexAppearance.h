@@ -86,7 +86,7 @@ public:
   {
   public:
     Mode mode; /**< The primitive group type (\c triangles, \c quads, ...) */
-    std::list<unsigned int> vertices; /**< The indices of the vertices used to draw the primitive */
+    std::vector<unsigned int> vertices; /**< The indices of the vertices used to draw the primitive (interleaved with normal indices if there are normals) */
 
     /**
      * Constructor
@@ -161,7 +161,7 @@ private:
   GraphicsContext::Mesh* createMesh(GraphicsContext& graphicsContext) override;
 
   /**
-   * Creates the mesh if it is not already cached
+   * Creates the mesh if it is not already cached (its buffers are filled later by \c fillBuffers)
    * @tparam VertexType The vertex type from the \c GraphicsContext that is used for this mesh
    * @tparam withTextureCoordinates Whether the vertex type has texture coordinates
    * @param graphicsContext The graphics context to create the mesh in
@@ -169,4 +169,14 @@ private:
    */
   template<typename VertexType, bool withTextureCoordinates>
   GraphicsContext::Mesh* createMeshImpl(GraphicsContext& graphicsContext);
+
+  /**
+   * Fills the buffers of the mesh from the primitive groups (may run in parallel to other appearances)
+   * @tparam VertexType The vertex type from the \c GraphicsContext that is used for this mesh
+   * @tparam withTextureCoordinates Whether the vertex type has texture coordinates
+   * @param vertexBuffer The vertex buffer to fill
+   * @param indexBuffer The index buffer to fill
+   */
+  template<typename VertexType, bool withTextureCoordinates>
+  void fillBuffers(GraphicsContext::VertexBuffer<VertexType>& vertexBuffer, GraphicsContext::IndexBuffer& indexBuffer) const;
 };
@@ -0,0 +1,94 @@
+/**
+ * @file Simulation/Appearances/MeshAppearance.cpp
+ * Implementation of class MeshAppearance
+ */
+
+#include "MeshAppearance.h"
+#include "Platform/Assert.h"
+#include "Simulation/Simulation.h"
+#include "Tools/MeshFile.h"
+#include <algorithm>
+#include <cstring>
+
+GraphicsContext::Mesh* MeshAppearance::createMesh(GraphicsContext& graphicsContext)
+{
+  // The cache is checked before the file is needed, because the file is released after the first mesh has been created.
+  if(meshFile)
+    hasTexCoords = meshFile->hasTexCoords();
+  const bool textured = hasTexCoords && surface->texture;
+  const auto key = std::make_tuple(file, unit, textured);
+  GraphicsContext::Mesh*& mesh = Simulation::simulation->meshAppearanceMeshCache[key];
+  if(!mesh)
+  {
+    if(!meshFile && !reloadMeshFile())
+      meshFile = std::make_shared<MeshFile>();
+    mesh = textured && meshFile->hasTexCoords() ? createMeshImpl<GraphicsContext::VertexPNT>(graphicsContext) : createMeshImpl<GraphicsContext::VertexPN>(graphicsContext);
+  }
+
+  // The file is not needed anymore (it is unmapped as soon as all appearances that use it have created their meshes and the buffers are filled).
+  meshFile.reset();
+  return mesh;
+}
+
+bool MeshAppearance::reloadMeshFile()
+{
+  auto loadedMeshFile = std::make_shared<MeshFile>();
+  std::string error;
+  if(!loadedMeshFile->load(file, error))
+    return false;
+  hasTexCoords = loadedMeshFile->hasTexCoords();
+  meshFile = std::move(loadedMeshFile);
+  return true;
+}
+
+template<typename VertexType>
+GraphicsContext::Mesh* MeshAppearance::createMeshImpl(GraphicsContext& graphicsContext)
+{
+  GraphicsContext::VertexBuffer<VertexType>* vertexBuffer = graphicsContext.requestVertexBuffer<VertexType>();
+  GraphicsContext::IndexBuffer* indexBuffer = graphicsContext.requestIndexBuffer();
+  // The fill keeps the file mapped until it has run.
+  graphicsContext.requestBufferFill([meshFile = meshFile, unit = unit, vertexBuffer, indexBuffer]
+  {
+    fillBuffers<VertexType>(*meshFile, unit, *vertexBuffer, *indexBuffer);
+  });
+  return graphicsContext.requestMesh(vertexBuffer, indexBuffer, GraphicsContext::triangleList);
+}
+
+template<typename VertexType>
+void MeshAppearance::fillBuffers(const MeshFile& meshFile, float unit, GraphicsContext::VertexBuffer<VertexType>& vertexBuffer, GraphicsContext::IndexBuffer& indexBuffer)
+{
+  constexpr std::size_t vertexSize = sizeof(VertexType) / sizeof(float);
+  const std::size_t vertexCount = meshFile.getVertexCount();
+  const std::size_t fileVertexSize = meshFile.getVertexSize();
+  const float* const fileVertices = meshFile.getVertices();
+
+  vertexBuffer.vertices.resize(vertexCount);
+  float* const vertices = reinterpret_cast<float*>(vertexBuffer.vertices.data());
+  if(fileVertexSize == vertexSize && unit == 1.f)
+    std::memcpy(vertices, fileVertices, vertexCount * vertexSize * sizeof(float));
+  else
+  {
+    // The texture coordinates are dropped if the surface has no texture.
+    for(std::size_t i = 0; i < vertexCount; ++i)
+    {
+      const float* const source = fileVertices + i * fileVertexSize;
+      float* const target = vertices + i * vertexSize;
+      target[0] = source[0] * unit;
+      target[1] = source[1] * unit;
+      target[2] = source[2] * unit;
+      std::copy(source + 3, source + vertexSize, target + 3);
+    }
+  }
+  vertexBuffer.finish();
+
+  // The index buffer only supports 32 bit indices, so 16 bit indices are widened.
+  const std::size_t indexCount = meshFile.getIndexCount();
+  indexBuffer.indices.resize(indexCount);
+  if(meshFile.hasIndices32())
+    std::memcpy(indexBuffer.indices.data(), meshFile.getIndices(), indexCount * sizeof(std::uint32_t));
+  else
+  {
+    const auto* const indices = static_cast<const std::uint16_t*>(meshFile.getIndices());
+    std::copy(indices, indices + indexCount, indexBuffer.indices.begin());
+  }
+}
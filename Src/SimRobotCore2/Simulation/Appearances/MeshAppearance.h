@@ -0,0 +1,60 @@
+/**
+ * @file Simulation/Appearances/MeshAppearance.h
+ * Declaration of class MeshAppearance
+ */
+
+#pragma once
+
+#include "Simulation/Appearances/Appearance.h"
+#include <memory>
+#include <string>
+
+class MeshFile;
+
+/**
+ * @class MeshAppearance
+ * The graphical representation of a triangle mesh that is stored in an external file
+ */
+class MeshAppearance : public Appearance
+{
+public:
+  std::string file; /**< The name of the mesh file (used to share meshes between appearances) */
+  float unit = 1.f; /**< The factor by which the positions in the file are scaled */
+  std::shared_ptr<const MeshFile> meshFile; /**< The loaded mesh (released after the mesh has been created) */
+
+private:
+  bool hasTexCoords = false; /**< Whether the mesh file has texture coordinates (remembered when the file is released) */
+
+  /**
+   * Creates a mesh for this appearance in the given graphics context
+   * @param graphicsContext The graphics context to create the mesh in
+   * @return The resulting mesh
+   */
+  GraphicsContext::Mesh* createMesh(GraphicsContext& graphicsContext) override;
+
+  /**
+   * Creates a mesh whose buffers are filled later by \c fillBuffers
+   * @tparam VertexType The vertex type from the \c GraphicsContext that is used for this mesh
+   * @param graphicsContext The graphics context to create the mesh in
+   * @return The resulting mesh
+   */
+  template<typename VertexType>
+  GraphicsContext::Mesh* createMeshImpl(GraphicsContext& graphicsContext);
+
+  /**
+   * Maps the mesh file again after it has been released, e.g. because the graphics are created again
+   * @return Whether the file could be loaded (otherwise, an empty mesh is used)
+   */
+  bool reloadMeshFile();
+
+  /**
+   * Copies the vertices and indices of a mesh file into buffers (may run in parallel to other appearances)
+   * @tparam VertexType The vertex type from the \c GraphicsContext that is used for this mesh
+   * @param meshFile The mesh file
+   * @param unit The factor by which the positions are scaled
+   * @param vertexBuffer The vertex buffer to fill
+   * @param indexBuffer The index buffer to fill
+   */
+  template<typename VertexType>
+  static void fillBuffers(const MeshFile& meshFile, float unit, GraphicsContext::VertexBuffer<VertexType>& vertexBuffer, GraphicsContext::IndexBuffer& indexBuffer);
+};
@@ -9,6 +9,7 @@
 #include "Simulation/Actuators/Joint.h"
 #include "Simulation/Motors/Motor.h"
 #include <cmath>
+#include <typeinfo>
 
 Axis::~Axis()
 {
@@ -31,6 +32,24 @@ void Axis::create()
   }
 }
 
+bool Axis::canUpdate(ElementCore2& element) const
+{
+  Axis& newAxis = static_cast<Axis&>(element);
+  newAxis.create();
+  if(newAxis.x != x || newAxis.y != y || newAxis.z != z || newAxis.cfm != cfm || !newAxis.deflection != !deflection ||
+     !newAxis.motor != !motor || (motor && (typeid(*newAxis.motor) != typeid(*motor) || !motor->canUpdate(*newAxis.motor))))
+    return false;
+  return !deflection || (newAxis.deflection->min == deflection->min && newAxis.deflection->max == deflection->max &&
+                         newAxis.deflection->stopCFM == deflection->stopCFM && newAxis.deflection->stopERP == deflection->stopERP &&
+                         newAxis.deflection->offset == deflection->offset);
+}
+
+void Axis::update(ElementCore2& element)
+{
+  if(motor)
+    motor->update(*static_cast<Axis&>(element).motor);
+}
+
 void Axis::addParent(Element& element)
 {
   joint = dynamic_cast<Joint*>(&element);
@@ -42,6 +42,19 @@ public:
   /** Normalizes the axis */
   void create();
 
+  /**
+   * Checks whether the differences to a new version of this axis can be applied
+   * @param element The new version of this axis
+   * @return Whether only the parameters of the motor differ
+   */
+  bool canUpdate(ElementCore2& element) const override;
+
+  /**
+   * Applies the parameters of the motor of a new version of this axis
+   * @param element The new version of this axis
+   */
+  void update(ElementCore2& element) override;
+
 private:
   /**
    * Registers an element as parent
@@ -17,6 +17,7 @@
 
 Body::Body()
 {
+  kind = bodyKind;
   dMassSetZero(&mass);
 }
 
@@ -54,17 +55,10 @@ void Body::createPhysics(GraphicsContext& graphicsContext)
   body = dBodyCreate(Simulation::simulation->physicalWorld);
   dBodySetData(body, this);
 
-  // add masses
-  for(SimObject* iter : children)
-  {
-    auto* mass = dynamic_cast<Mass*>(iter);
-    if(mass)
-      addMass(*mass);
-  }
-
-  // compute moment of inertia tensor at center of mass and center of mass position
-  centerOfMass += Vector3f(static_cast<float>(mass.c[0]), static_cast<float>(mass.c[1]), static_cast<float>(mass.c[2]));
-  dMassTranslate(&mass, -mass.c[0], -mass.c[1], -mass.c[2]);
+  // add masses (unless they were stored in the scene cache)
+  if(!Simulation::simulation->restoreBodyMass(mass, centerOfMass))
+    assembleMass(mass, centerOfMass);
+  Simulation::simulation->recordBodyMass(mass, centerOfMass);
 
   // set mass
   dBodySetMass(body, &mass);
@@ -79,12 +73,8 @@ void Body::createPhysics(GraphicsContext& graphicsContext)
 
   // add geometries
   const Pose3f geomOffset(-centerOfMass);
-  for(::PhysicalObject* iter : physicalDrawings)
-  {
-    auto* geometry = dynamic_cast<Geometry*>(iter);
-    if(geometry)
-      addGeometry(geomOffset, *geometry);
-  }
+  for(Geometry* geometry : geometries)
+    addGeometry(geomOffset, *geometry);
 
   poseInParent = poseInWorld;
 
@@ -109,6 +99,23 @@ void Body::createPhysics(GraphicsContext& graphicsContext)
   graphicsContext.popModelMatrixStack();
 }
 
+void Body::destroyPhysics()
+{
+  // Joints to child bodies must be destroyed before the bodies they connect.
+  ::PhysicalObject::destroyPhysics();
+
+  if(parentBody)
+    parentBody->bodyChildren.remove(this);
+  if(rootBody == this && bodySpace)
+  {
+    dSpaceDestroy(bodySpace);
+    bodySpace = nullptr;
+    Simulation::simulation->invalidateGeometryBVH();
+  }
+  dBodyDestroy(body);
+  body = nullptr;
+}
+
 void Body::addGeometry(const Pose3f& parentOffset, Geometry& geometry)
 {
   // compute geometry offset
@@ -137,34 +144,42 @@ void Body::addGeometry(const Pose3f& parentOffset, Geometry& geometry)
   }
 
   // handle nested geometries
-  for(::PhysicalObject* iter : geometry.physicalDrawings)
-  {
-    Geometry* geometry = dynamic_cast<Geometry*>(iter);
-    ASSERT(geometry);
-    addGeometry(offset, *geometry);
-  }
+  for(Geometry* childGeometry : geometry.geometries)
+    addGeometry(offset, *childGeometry);
 }
 
-void Body::addMass(Mass& mass)
+void Body::assembleMass(dMass& bodyMass, Vector3f& bodyCenterOfMass) const
 {
-  if(this->mass.mass == 0.f)
+  dMassSetZero(&bodyMass);
+  bodyCenterOfMass = Vector3f::Zero();
+  for(Mass* mass : masses)
+    addMass(bodyMass, bodyCenterOfMass, *mass);
+
+  // compute moment of inertia tensor at center of mass and center of mass position
+  bodyCenterOfMass += Vector3f(static_cast<float>(bodyMass.c[0]), static_cast<float>(bodyMass.c[1]), static_cast<float>(bodyMass.c[2]));
+  dMassTranslate(&bodyMass, -bodyMass.c[0], -bodyMass.c[1], -bodyMass.c[2]);
+}
+
+void Body::addMass(dMass& bodyMass, Vector3f& bodyCenterOfMass, Mass& mass)
+{
+  if(bodyMass.mass == 0.f)
   {
-    this->mass = mass.createMass();
+    bodyMass = mass.createMass();
     if(mass.rotation)
     {
       dMatrix3 matrix;
       ODETools::convertMatrix(*mass.rotation, matrix);
-      dMassRotate(&this->mass, matrix);
+      dMassRotate(&bodyMass, matrix);
     }
     if(mass.translation)
-      centerOfMass = *mass.translation;
+      bodyCenterOfMass = *mass.translation;
   }
   else
   {
-    if(centerOfMass != Vector3f::Zero())
+    if(bodyCenterOfMass != Vector3f::Zero())
     {
-      dMassTranslate(&this->mass, centerOfMass.x(), centerOfMass.y(), centerOfMass.z());
-      centerOfMass = Vector3f::Zero();
+      dMassTranslate(&bodyMass, bodyCenterOfMass.x(), bodyCenterOfMass.y(), bodyCenterOfMass.z());
+      bodyCenterOfMass = Vector3f::Zero();
     }
 
     const dMass& constAdditionalMass = mass.createMass();
@@ -179,13 +194,26 @@ void Body::addMass(Mass& mass)
       }
       if(mass.translation)
         dMassTranslate(&additionalMass, mass.translation->x(), mass.translation->y(), mass.translation->z());
-      dMassAdd(&this->mass, &additionalMass);
+      dMassAdd(&bodyMass, &additionalMass);
     }
     else
-      dMassAdd(&this->mass, &constAdditionalMass);
+      dMassAdd(&bodyMass, &constAdditionalMass);
   }
 }
 
+bool Body::canUpdateMass(const Body& newBody, dMass& newMass) const
+{
+  Vector3f newCenterOfMass;
+  newBody.assembleMass(newMass, newCenterOfMass);
+  return newCenterOfMass == centerOfMass;
+}
+
+void Body::updateMass(const dMass& newMass)
+{
+  mass = newMass;
+  dBodySetMass(body, &mass);
+}
+
 void Body::createGraphics(GraphicsContext& graphicsContext)
 {
   ASSERT(graphicsContext.emptyModelMatrixStack());
@@ -220,11 +248,10 @@ void Body::drawAppearances(GraphicsContext& graphicsContext) const
     child->drawAppearances(graphicsContext);
 }
 
-void Body::visitGraphicalControllerDrawings(const std::function<void(GraphicalObject&)>& accept)
+void Body::getGraphicalDrawingChildren(std::vector<const GraphicalObject*>& children) const
 {
-  GraphicalObject::visitGraphicalControllerDrawings(accept);
-  for(Body* child : bodyChildren)
-    accept(*child);
+  GraphicalObject::getGraphicalDrawingChildren(children);
+  children.insert(children.end(), bodyChildren.begin(), bodyChildren.end());
 }
 
 void Body::drawPhysics(GraphicsContext& graphicsContext, unsigned int flags) const
@@ -240,11 +267,10 @@ void Body::drawPhysics(GraphicsContext& graphicsContext, unsigned int flags) con
     child->drawPhysics(graphicsContext, flags);
 }
 
-void Body::visitPhysicalControllerDrawings(const std::function<void(::PhysicalObject&)>& accept)
+void Body::getPhysicalDrawingChildren(std::vector<const ::PhysicalObject*>& children) const
 {
-  ::PhysicalObject::visitPhysicalControllerDrawings(accept);
-  for(Body* child : bodyChildren)
-    accept(*child);
+  ::PhysicalObject::getPhysicalDrawingChildren(children);
+  children.insert(children.end(), bodyChildren.begin(), bodyChildren.end());
 }
 
 void Body::move(const Vector3f& offset)
@@ -13,6 +13,7 @@
 #include <ode/common.h>
 #include <ode/mass.h>
 #include <list>
+#include <vector>
 
 class Geometry;
 class Mass;
@@ -27,6 +28,7 @@ public:
   dBodyID body = nullptr;
   Body* rootBody = nullptr; /**< The first movable body in a chain of bodies (might point to itself) */
   dMass mass; /**< The mass of the body (at \c centerOfMass)*/
+  std::vector<Mass*> masses; /**< The mass descriptions that form the mass of the body */
 
   /** Default constructor */
   Body();
@@ -66,6 +68,21 @@ public:
    */
   void rotate(const RotationMatrix& rotation, const Vector3f& point);
 
+  /**
+   * Checks whether the masses of a new version of this body (from a modified scene file) can be applied
+   * while the simulation is running, i.e. whether they do not move the center of mass
+   * @param newBody The new version of this body
+   * @param newMass Is set to the mass of the new version of this body
+   * @return Whether \c updateMass can be called with \c newMass
+   */
+  bool canUpdateMass(const Body& newBody, dMass& newMass) const;
+
+  /**
+   * Replaces the mass of the body (without moving its center of mass)
+   * @param newMass The new mass (at \c centerOfMass)
+   */
+  void updateMass(const dMass& newMass);
+
 private:
   Vector3f centerOfMass = Vector3f::Zero(); /**< The position of the center of mass relative to the pose of the body */
 
@@ -84,6 +101,9 @@ private:
    */
   void createPhysics(GraphicsContext& graphicsContext) override;
 
+  /** Destroys the ODE body, its joints and, for a root body, the collision space with all geometries */
+  void destroyPhysics() override;
+
   /**
    * Creates a ODE geometry and attaches it to the body
    * @param parentOffset the base geometry offset from the center of mass of the body
@@ -92,10 +112,19 @@ private:
   void addGeometry(const Pose3f& parentOffset, Geometry& geometry);
 
   /**
-   * Adds a mass to the mass of the body
+   * Computes the mass of the body from its mass descriptions
+   * @param bodyMass Is set to the mass of the body (at \c bodyCenterOfMass)
+   * @param bodyCenterOfMass Is set to the position of the center of mass relative to the pose of the body
+   */
+  void assembleMass(dMass& bodyMass, Vector3f& bodyCenterOfMass) const;
+
+  /**
+   * Adds a mass to the mass of a body
+   * @param bodyMass The mass of the body
+   * @param bodyCenterOfMass The position of \c bodyMass relative to the pose of the body
    * @param mass A mass description of the mass to add
    */
-  void addMass(Mass& mass);
+  static void addMass(dMass& bodyMass, Vector3f& bodyCenterOfMass, Mass& mass);
 
   /**
    * Registers an element as parent
@@ -104,16 +133,16 @@ private:
   void addParent(Element& element) override;
 
   /**
-   * Visits controller drawings of physical children
-   * @param accept The functor to apply to every child
+   * Collects the physical children whose controller drawings are shown in a view of this body
+   * @param children The list the children are appended to
    */
-  void visitPhysicalControllerDrawings(const std::function<void(::PhysicalObject&)>& accept) override;
+  void getPhysicalDrawingChildren(std::vector<const ::PhysicalObject*>& children) const override;
 
   /**
-   * Visits controller drawings of graphical children
-   * @param accept The functor to apply to every child
+   * Collects the graphical children whose controller drawings are shown in a view of this body
+   * @param children The list the children are appended to
    */
-  void visitGraphicalControllerDrawings(const std::function<void(GraphicalObject&)>& accept) override;
+  void getGraphicalDrawingChildren(std::vector<const GraphicalObject*>& children) const override;
 
   friend class Accelerometer;
   friend class CollisionSensor;
@@ -21,12 +21,8 @@ void Compound::addParent(Element& element)
 void Compound::createPhysics(GraphicsContext& graphicsContext)
 {
   // create geometry
-  for(::PhysicalObject* iter : physicalDrawings)
-  {
-    Geometry* geometry = dynamic_cast<Geometry*>(iter);
-    if(geometry)
-      addGeometry(poseInWorld, *geometry, nullptr);
-  }
+  for(Geometry* geometry : geometries)
+    addGeometry(poseInWorld, *geometry, nullptr);
 
   OpenGLTools::convertTransformation(rotation, translation, poseInParent);
 
@@ -59,12 +55,8 @@ void Compound::addGeometry(const Pose3f& parentPose, Geometry& geometry, SimRobo
   }
 
   // handle nested geometries
-  for(::PhysicalObject* iter : geometry.physicalDrawings)
-  {
-    Geometry* geometry = dynamic_cast<Geometry*>(iter);
-    if(geometry)
-      addGeometry(geomPose, *geometry, callback);
-  }
+  for(Geometry* childGeometry : geometry.geometries)
+    addGeometry(geomPose, *childGeometry, callback);
 }
 
 void Compound::createGraphics(GraphicsContext& graphicsContext)
@@ -6,10 +6,12 @@
 
 #include "Geometry.h"
 #include "Platform/Assert.h"
+#include "Simulation/Simulation.h"
 #include "Tools/OpenGLTools.h"
 
 Geometry::Geometry()
 {
+  kind = geometryKind;
   color[0] = color[1] = color[2] = 0.8f;
   color[3] = 1.0f;
 }
@@ -22,10 +24,13 @@ Geometry::~Geometry()
 void Geometry::addParent(Element& element)
 {
   ::PhysicalObject::addParent(element);
+  parent->geometries.push_back(this);
 }
 
 dGeomID Geometry::createGeometry(dSpaceID)
 {
+  // The derived classes create a new ODE geometry after calling this.
+  Simulation::simulation->invalidateGeometryBVH();
   if(!created)
   {
     OpenGLTools::convertTransformation(rotation, translation, poseInParent);
@@ -145,3 +150,24 @@ bool Geometry::Material::getRollingFriction(const Material& other, float& rollin
   materialToRollingFriction[&other] = rollingFriction;
   return false;
 }
+
+bool Geometry::Material::canUpdate(ElementCore2& element) const
+{
+  return static_cast<Material&>(element).name == name;
+}
+
+void Geometry::Material::update(ElementCore2& element)
+{
+  const Material& material = static_cast<Material&>(element);
+  frictions = material.frictions;
+  rollingFrictions = material.rollingFrictions;
+
+  // The lookups of all materials might refer to the frictions of this one.
+  for(ElementCore2* otherElement : Simulation::simulation->elements)
+    if(otherElement->kind == materialKind)
+    {
+      const Material* other = static_cast<const Material*>(otherElement);
+      other->materialToFriction.clear();
+      other->materialToRollingFriction.clear();
+    }
+}
@@ -32,6 +32,9 @@ public:
     std::unordered_map<std::string, float> frictions; /**< The friction of the material on another material */
     std::unordered_map<std::string, float> rollingFrictions; /**< The rolling friction of the material on another material */
 
+    /** Default constructor */
+    Material() {kind = materialKind;}
+
     /**
      * Looks up the friction on another material
      * @param other The other material
@@ -48,6 +51,19 @@ public:
      */
     bool getRollingFriction(const Material& other, float& rollingFriction) const;
 
+    /**
+     * Checks whether the differences to a new version of this material can be applied
+     * @param element The new version of this material
+     * @return Whether the material has the same name
+     */
+    bool canUpdate(ElementCore2& element) const override;
+
+    /**
+     * Replaces the frictions by the frictions of a new version of this material
+     * @param element The new version of this material
+     */
+    void update(ElementCore2& element) override;
+
   private:
     mutable std::unordered_map<const Material*, float> materialToFriction; /**< A pointer map to speed up friction lookups */
     mutable std::unordered_map<const Material*, float> materialToRollingFriction; /**< A pointer map to speed up rolling friction lookups */
@@ -0,0 +1,143 @@
+/**
+ * @file Simulation/GeometryBVH.cpp
+ * Implementation of class GeometryBVH
+ */
+
+#include "GeometryBVH.h"
+#include "Simulation/Geometries/Geometry.h"
+#include "Simulation/Simulation.h"
+#include "Platform/Assert.h"
+#include "Tools/ODETools.h"
+#include <ode/collision.h>
+#include <ode/collision_space.h>
+#include <algorithm>
+#include <limits>
+
+void GeometryBVH::update()
+{
+  if(!collected)
+  {
+    entries.clear();
+    collect(Simulation::simulation->staticSpace);
+    collect(Simulation::simulation->movableSpace);
+    collected = true;
+    build();
+  }
+  else if(++updatesSinceBuild >= rebuildInterval)
+    build();
+  else
+    refit();
+}
+
+void GeometryBVH::collect(dSpaceID space)
+{
+  for(int i = 0, count = dSpaceGetNumGeoms(space); i < count; ++i)
+  {
+    dGeomID geom = dSpaceGetGeom(space, i);
+    if(dGeomIsSpace(geom))
+      collect(reinterpret_cast<dSpaceID>(geom));
+    else if(const Geometry* geometry = static_cast<const Geometry*>(dGeomGetData(geom)); geometry)
+      entries.push_back({geom, space, geometry, Vector3f::Zero()});
+  }
+}
+
+void GeometryBVH::build()
+{
+  for(Entry& entry : entries)
+    ODETools::convertVector(dGeomGetPosition(entry.geom), entry.center);
+  nodes.clear();
+  leaves.clear();
+  if(!entries.empty())
+    build(0, static_cast<int>(entries.size()));
+  updatesSinceBuild = 0;
+  refit();
+}
+
+void GeometryBVH::build(int begin, int end)
+{
+  const int index = static_cast<int>(nodes.size());
+  nodes.emplace_back();
+  if(end - begin <= leafSize)
+  {
+    nodes[index].leaf = static_cast<int>(leaves.size());
+    Leaf& leaf = leaves.emplace_back();
+    leaf.firstEntry = begin;
+    leaf.numOfEntries = end - begin;
+    for(int i = 0; i < leafSize; ++i)
+    {
+      leaf.geoms[i] = i < leaf.numOfEntries ? entries[begin + i].geom : nullptr;
+      leaf.geometries[i] = i < leaf.numOfEntries ? entries[begin + i].geometry : nullptr;
+    }
+  }
+  else
+  {
+    // split at the median along the axis with the largest extent of the centers
+    Vector3f min = entries[begin].center;
+    Vector3f max = min;
+    for(int i = begin + 1; i < end; ++i)
+    {
+      min = min.cwiseMin(entries[i].center);
+      max = max.cwiseMax(entries[i].center);
+    }
+    int axis;
+    (max - min).maxCoeff(&axis);
+    const int mid = begin + (end - begin) / 2;
+    std::nth_element(entries.begin() + begin, entries.begin() + mid, entries.begin() + end,
+                     [axis](const Entry& a, const Entry& b) {return a.center[axis] < b.center[axis];});
+    nodes[index].leaf = -1;
+    build(begin, mid);
+    build(mid, end);
+  }
+  nodes[index].skip = static_cast<int>(nodes.size());
+}
+
+void GeometryBVH::refit()
+{
+  for(Leaf& leaf : leaves)
+    for(int i = 0; i < leafSize; ++i)
+    {
+      const Entry* entry = i < leaf.numOfEntries ? &entries[leaf.firstEntry + i] : nullptr;
+      if(entry && dGeomIsEnabled(entry->geom) && dGeomIsEnabled(reinterpret_cast<dGeomID>(entry->space)))
+      {
+        const dReal* pos = dGeomGetPosition(entry->geom);
+        leaf.x[i] = static_cast<float>(pos[0]);
+        leaf.y[i] = static_cast<float>(pos[1]);
+        leaf.z[i] = static_cast<float>(pos[2]);
+        leaf.innerRadius[i] = entry->geometry->innerRadius;
+        leaf.innerRadiusSqr[i] = entry->geometry->innerRadiusSqr;
+        leaf.outerRadius[i] = entry->geometry->outerRadius;
+      }
+      else
+      {
+        leaf.x[i] = leaf.y[i] = leaf.z[i] = 0.f;
+        leaf.innerRadius[i] = leaf.innerRadiusSqr[i] = 0.f;
+        leaf.outerRadius[i] = -1.f;
+      }
+    }
+
+  // children follow their parents, so a reverse pass visits them first
+  for(int i = static_cast<int>(nodes.size()) - 1; i >= 0; --i)
+  {
+    Node& node = nodes[i];
+    if(node.leaf >= 0)
+    {
+      const Leaf& leaf = leaves[node.leaf];
+      const Eigen::Array4f radius = leaf.outerRadius;
+      const Eigen::Array4f inf = Eigen::Array4f::Constant(std::numeric_limits<float>::infinity());
+      const Eigen::Array<bool, 4, 1> valid = radius >= 0.f;
+      node.min = Vector3f(valid.select(leaf.x - radius, inf).minCoeff(),
+                          valid.select(leaf.y - radius, inf).minCoeff(),
+                          valid.select(leaf.z - radius, inf).minCoeff());
+      node.max = Vector3f(valid.select(leaf.x + radius, -inf).maxCoeff(),
+                          valid.select(leaf.y + radius, -inf).maxCoeff(),
+                          valid.select(leaf.z + radius, -inf).maxCoeff());
+    }
+    else
+    {
+      const Node& left = nodes[i + 1];
+      const Node& right = nodes[left.skip];
+      node.min = left.min.cwiseMin(right.min);
+      node.max = left.max.cwiseMax(right.max);
+    }
+  }
+}
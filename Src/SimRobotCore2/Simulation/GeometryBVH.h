@@ -0,0 +1,108 @@
+/**
+ * @file Simulation/GeometryBVH.h
+ * Declaration of class GeometryBVH
+ */
+
+#pragma once
+
+#include "Tools/Math/Eigen.h"
+#include <ode/common.h>
+#include <array>
+#include <vector>
+
+class Geometry;
+
+/**
+ * @class GeometryBVH
+ * A bounding volume hierarchy over the bounding spheres of all collision geometries in the static and movable spaces.
+ * The topology is built from the geometry positions of one simulation step and refitted to the new positions in
+ * later steps. It is rebuilt from scratch every \c rebuildInterval updates to prevent the boxes from degenerating.
+ * The geometries are collected again after the hierarchy was invalidated, i.e. after geometries were created or destroyed.
+ */
+class GeometryBVH
+{
+public:
+  static constexpr int leafSize = 4; /**< The maximum number of geometries per leaf (one SIMD lane each) */
+
+  /**
+   * A leaf of the hierarchy. The bounding spheres are stored as structure of arrays, so that queries can test all of them at once.
+   * Unused or disabled slots have an \c outerRadius of -1.
+   */
+  struct Leaf
+  {
+    Eigen::Array4f x; /**< The x coordinates of the sphere centers */
+    Eigen::Array4f y; /**< The y coordinates of the sphere centers */
+    Eigen::Array4f z; /**< The z coordinates of the sphere centers */
+    Eigen::Array4f innerRadius; /**< The radii of the spheres enclosed by the geometries */
+    Eigen::Array4f innerRadiusSqr; /**< The squares of \c innerRadius */
+    Eigen::Array4f outerRadius; /**< The radii of the spheres covering the geometries */
+    std::array<dGeomID, leafSize> geoms; /**< The ODE geometries */
+    std::array<const Geometry*, leafSize> geometries; /**< The scene graph geometries */
+    int firstEntry; /**< The index of the first entry stored in this leaf */
+    int numOfEntries; /**< The number of used slots */
+  };
+
+  /** A node of the hierarchy. The nodes are stored in depth-first order, i.e. the left child of an inner node directly follows it. */
+  struct Node
+  {
+    Vector3f min; /**< The minimum corner of the axis-aligned bounding box */
+    Vector3f max; /**< The maximum corner of the axis-aligned bounding box */
+    int skip; /**< The index of the first node behind the subtree of this node (the right child of the previous node for left children) */
+    int leaf; /**< The index of the leaf if this node is a leaf, -1 otherwise */
+  };
+
+  int rebuildInterval = 100; /**< The number of updates after which the topology is rebuilt */
+
+  /**
+   * Brings the hierarchy up to date with the current geometry positions.
+   * The geometries are collected on the first call and on the first call after \c invalidate.
+   */
+  void update();
+
+  /** Marks the set of geometries as outdated. Must be called whenever collision geometries are created or destroyed. */
+  void invalidate() {collected = false;}
+
+  /**
+   * Whether the hierarchy contains no geometry
+   * @return Whether it is empty
+   */
+  bool empty() const {return nodes.empty();}
+
+  const std::vector<Node>& getNodes() const {return nodes;}
+  const std::vector<Leaf>& getLeaves() const {return leaves;}
+
+private:
+  /** A geometry that is part of the hierarchy */
+  struct Entry
+  {
+    dGeomID geom; /**< The ODE geometry */
+    dSpaceID space; /**< The space containing the geometry (disabled spaces hide their geometries) */
+    const Geometry* geometry; /**< The scene graph geometry */
+    Vector3f center; /**< The position of the geometry at the time of the last build */
+  };
+
+  std::vector<Entry> entries; /**< All geometries (ordered as referenced by the leaves) */
+  std::vector<Node> nodes; /**< The nodes in depth-first order */
+  std::vector<Leaf> leaves; /**< The leaves */
+  bool collected = false; /**< Whether \c entries contains the current set of geometries */
+  int updatesSinceBuild = 0; /**< The number of refits since the last build */
+
+  /**
+   * Adds all geometries of a space (including subspaces) to \c entries
+   * @param space The space
+   */
+  void collect(dSpaceID space);
+
+  /** Rebuilds the topology from the current geometry positions */
+  void build();
+
+  /**
+   * Builds the subtree for a range of entries
+   * @param begin The first entry
+   * @param end The entry behind the last one
+   */
+  void build(int begin, int end);
+
+  /** Updates the spheres in the leaves and the boxes of all nodes */
+  void refit();
+};
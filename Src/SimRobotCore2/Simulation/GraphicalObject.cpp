@@ -6,7 +6,10 @@
 
 #include "GraphicalObject.h"
 #include "Platform/Assert.h"
+#include "Simulation/Scene.h"
+#include "Simulation/Simulation.h"
 #include "SimObjectRenderer.h"
+#include <algorithm>
 
 void GraphicalObject::createGraphics(GraphicsContext& graphicsContext)
 {
@@ -20,29 +23,7 @@ void GraphicalObject::drawAppearances(GraphicsContext& graphicsContext) const
     graphicalObject->drawAppearances(graphicsContext);
 }
 
-void GraphicalObject::drawControllerDrawings() const
-{
-  for(SimRobotCore2::Controller3DDrawing* drawing : controllerDrawings)
-    drawing->draw();
-  const_cast<GraphicalObject*>(this)->visitGraphicalControllerDrawings([](GraphicalObject& child){child.drawControllerDrawings();});
-}
-
-void GraphicalObject::beforeControllerDrawings(const float* projection, const float* view) const
-{
-  ASSERT(modelMatrix);
-  for(SimRobotCore2::Controller3DDrawing* drawing : controllerDrawings)
-    drawing->beforeFrame(projection, view, modelMatrix->getPointer());
-  const_cast<GraphicalObject*>(this)->visitGraphicalControllerDrawings([projection, view](GraphicalObject& child){child.beforeControllerDrawings(projection, view);});
-}
-
-void GraphicalObject::afterControllerDrawings() const
-{
-  for(SimRobotCore2::Controller3DDrawing* drawing : controllerDrawings)
-    drawing->afterFrame();
-  const_cast<GraphicalObject*>(this)->visitGraphicalControllerDrawings([](GraphicalObject& child){child.afterControllerDrawings();});
-}
-
-void GraphicalObject::visitGraphicalControllerDrawings(const std::function<void(GraphicalObject&)>&)
+void GraphicalObject::getGraphicalDrawingChildren(std::vector<const GraphicalObject*>&) const
 {
 }
 
@@ -53,17 +34,24 @@ void GraphicalObject::addParent(Element& element)
 
 bool GraphicalObject::registerDrawing(SimRobotCore2::Controller3DDrawing& drawing)
 {
-  controllerDrawings.push_back(&drawing);
+  Scene* scene = Simulation::simulation->scene;
+  ASSERT(scene);
+  scene->controllerDrawings.push_back({nullptr, this, &drawing});
+  ++scene->controllerDrawingsRevision;
   return true;
 }
 
 bool GraphicalObject::unregisterDrawing(SimRobotCore2::Controller3DDrawing& drawing)
 {
-  for(auto iter = controllerDrawings.begin(), end = controllerDrawings.end(); iter != end; ++iter)
-    if(*iter == &drawing)
-    {
-      controllerDrawings.erase(iter);
-      return true;
-    }
-  return false;
+  Scene* scene = Simulation::simulation->scene;
+  ASSERT(scene);
+  const auto iter = std::find_if(scene->controllerDrawings.begin(), scene->controllerDrawings.end(), [this, &drawing](const Scene::ControllerDrawing& controllerDrawing)
+  {
+    return controllerDrawing.graphicalObject == this && controllerDrawing.drawing == &drawing;
+  });
+  if(iter == scene->controllerDrawings.end())
+    return false;
+  scene->controllerDrawings.erase(iter);
+  ++scene->controllerDrawingsRevision;
+  return true;
 }
@@ -11,3 +11,13 @@ void BoxMass::assembleMass()
 {
   dMassSetBoxTotal(&mass, value, depth, width, height);
 }
+
+void BoxMass::update(ElementCore2& element)
+{
+  const BoxMass& newMass = static_cast<BoxMass&>(element);
+  value = newMass.value;
+  width = newMass.width;
+  height = newMass.height;
+  depth = newMass.depth;
+  Mass::update(element);
+}
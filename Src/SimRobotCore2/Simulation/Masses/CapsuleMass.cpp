@@ -11,3 +11,12 @@ void CapsuleMass::assembleMass()
 {
   dMassSetCapsuleTotal(&mass, value, 3, radius, height - radius - radius);
 }
+
+void CapsuleMass::update(ElementCore2& element)
+{
+  const CapsuleMass& newMass = static_cast<CapsuleMass&>(element);
+  value = newMass.value;
+  height = newMass.height;
+  radius = newMass.radius;
+  Mass::update(element);
+}
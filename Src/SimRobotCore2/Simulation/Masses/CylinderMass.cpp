@@ -11,3 +11,12 @@ void CylinderMass::assembleMass()
 {
   dMassSetCylinderTotal(&mass, value, 3, radius, height);
 }
+
+void CylinderMass::update(ElementCore2& element)
+{
+  const CylinderMass& newMass = static_cast<CylinderMass&>(element);
+  value = newMass.value;
+  height = newMass.height;
+  radius = newMass.radius;
+  Mass::update(element);
+}
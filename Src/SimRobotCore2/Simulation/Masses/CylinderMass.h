@@ -22,4 +22,10 @@ public:
 private:
   /** Creates the mass (not including children, \c translation or \c rotation) */
   void assembleMass() override;
+
+  /**
+   * Replaces the parameters and the mass by those of a new version of this element
+   * @param element The new version of this mass
+   */
+  void update(ElementCore2& element) override;
 };
@@ -11,3 +11,19 @@ void InertiaMatrixMass::assembleMass()
 {
   dMassSetParameters(&mass, value, x, y, z, ixx, iyy, izz, ixy, ixz, iyz);
 }
+
+void InertiaMatrixMass::update(ElementCore2& element)
+{
+  const InertiaMatrixMass& newMass = static_cast<InertiaMatrixMass&>(element);
+  value = newMass.value;
+  x = newMass.x;
+  y = newMass.y;
+  z = newMass.z;
+  ixx = newMass.ixx;
+  ixy = newMass.ixy;
+  ixz = newMass.ixz;
+  iyy = newMass.iyy;
+  iyz = newMass.iyz;
+  izz = newMass.izz;
+  Mass::update(element);
+}
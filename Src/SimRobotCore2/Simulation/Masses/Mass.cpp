@@ -6,6 +6,7 @@
 
 #include "Mass.h"
 #include "Platform/Assert.h"
+#include "Simulation/Body.h"
 #include "Tools/ODETools.h"
 #include <ode/mass.h>
 
@@ -14,10 +15,8 @@ const dMass& Mass::createMass()
   if(!created)
   {
     assembleMass();
-    for(auto* iter : children)
+    for(Mass* childMassDesc : masses)
     {
-      auto* childMassDesc = dynamic_cast<Mass*>(iter);
-      ASSERT(childMassDesc);
       const dMass& childMass = childMassDesc->createMass();
       if(childMassDesc->translation || childMassDesc->rotation)
       {
@@ -40,6 +39,36 @@ const dMass& Mass::createMass()
   return mass;
 }
 
+void Mass::addParent(Element& element)
+{
+  auto& parent = static_cast<ElementCore2&>(element);
+  if(parent.kind == bodyKind)
+    static_cast<Body&>(parent).masses.push_back(this);
+  else
+  {
+    ASSERT(parent.kind == massKind);
+    static_cast<Mass&>(parent).masses.push_back(this);
+  }
+  SimObject::addParent(element);
+}
+
+bool Mass::canUpdate(ElementCore2& element) const
+{
+  const Mass& newMass = static_cast<Mass&>(element);
+  return !translation == !newMass.translation && !rotation == !newMass.rotation;
+}
+
+void Mass::update(ElementCore2& element)
+{
+  Mass& newMass = static_cast<Mass&>(element);
+  if(translation)
+    *translation = *newMass.translation;
+  if(rotation)
+    *rotation = *newMass.rotation;
+  mass = newMass.createMass();
+  created = true;
+}
+
 void Mass::assembleMass()
 {
   dMassSetZero(&mass);
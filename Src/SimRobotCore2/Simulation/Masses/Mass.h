@@ -9,6 +9,7 @@
 #include "Simulation/SimObject.h"
 #include "Simulation/PhysicalObject.h"
 #include <ode/mass.h>
+#include <vector>
 
 /**
  * @class Mass
@@ -17,15 +18,40 @@
 class Mass : public SimObject, public SimRobotCore2::Mass
 {
 public:
+  /** Default constructor */
+  Mass() {kind = massKind;}
+
   /**
    * Creates the mass of a physical object (including children and not including \c translation and \c rotation)
    * @return The mass
    */
   const dMass& createMass();
 
+  /**
+   * Checks whether the differences to a new version of this mass can be applied
+   * (the bodies that use the mass check whether their center of mass would move)
+   * @param element The new version of this mass
+   * @return Whether both versions have a translation and a rotation or not
+   */
+  bool canUpdate(ElementCore2& element) const override;
+
+  /**
+   * Replaces the mass, the translation and the rotation by those of a new version of this element
+   * (derived classes also replace their parameters)
+   * @param element The new version of this mass
+   */
+  void update(ElementCore2& element) override;
+
 protected:
   dMass mass;
   bool created = false;
+  std::vector<Mass*> masses; /**< The subordinate mass descriptions */
+
+  /**
+   * Registers an element as parent
+   * @param element The element to register
+   */
+  void addParent(Element& element) override;
 
   /** Creates the mass (not including children, \c translation or \c rotation) */
   virtual void assembleMass();
@@ -11,3 +11,11 @@ void SphereMass::assembleMass()
 {
   dMassSetSphereTotal(&mass, value, radius);
 }
+
+void SphereMass::update(ElementCore2& element)
+{
+  const SphereMass& newMass = static_cast<SphereMass&>(element);
+  value = newMass.value;
+  radius = newMass.radius;
+  Mass::update(element);
+}
@@ -8,6 +8,7 @@
 
 #include "Simulation/Actuators/Actuator.h"
 
+class CoreModule;
 class Joint;
 
 /**
@@ -25,8 +26,28 @@ public:
    */
   virtual void create(Joint* joint) = 0;
 
-  /** Registers this object at SimRobot's GUI */
-  virtual void registerObjects() = 0;
+  /**
+   * Registers this object at SimRobot's GUI
+   * @param module The module that owns the simulation
+   */
+  virtual void registerObjects(CoreModule& module) = 0;
+
+  /**
+   * Checks whether the parameters of a new version of this motor (from a modified scene file) can be applied
+   * @param motor The new version of this motor (of the same type)
+   * @return Whether \c update can be called
+   */
+  virtual bool canUpdate(const Motor& motor) const
+  {
+    static_cast<void>(motor);
+    return false;
+  }
+
+  /**
+   * Applies the parameters of a new version of this motor (from a modified scene file)
+   * @param motor The new version of this motor (of the same type)
+   */
+  virtual void update(const Motor& motor) {static_cast<void>(motor);}
 
 protected:
   Joint* joint = nullptr; /**< The joint controlled by this motor */
@@ -92,12 +92,29 @@ bool PT2Motor::PositionSensor::getMinAndMax(float& min, float& max) const
   return false;
 }
 
-void PT2Motor::registerObjects()
+void PT2Motor::registerObjects(CoreModule& module)
 {
   positionSensor.unit = unit = QString::fromUtf8("°");
   positionSensor.fullName = joint->fullName + ".position";
   fullName = joint->fullName + ".position";
 
-  CoreModule::application->registerObject(*CoreModule::module, positionSensor, joint);
-  CoreModule::application->registerObject(*CoreModule::module, *this, joint);
+  module.application.registerObject(module, positionSensor, joint);
+  module.application.registerObject(module, *this, joint);
+}
+
+bool PT2Motor::canUpdate(const Motor&) const
+{
+  return true;
+}
+
+void PT2Motor::update(const Motor& motor)
+{
+  const PT2Motor& newMotor = static_cast<const PT2Motor&>(motor);
+  T = newMotor.T;
+  D = newMotor.D;
+  K = newMotor.K;
+  V = newMotor.V;
+  F = newMotor.F;
+  if(joint)
+    dJointSetHingeParam(joint->joint, dParamFMax, F);
 }
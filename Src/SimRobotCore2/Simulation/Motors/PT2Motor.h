@@ -55,8 +55,24 @@ private:
   /** Called before computing a simulation step to update the joint */
   void act() override;
 
-  /** Registers this object at SimRobot's GUI */
-  void registerObjects() override;
+  /**
+   * Registers this object at SimRobot's GUI
+   * @param module The module that owns the simulation
+   */
+  void registerObjects(CoreModule& module) override;
+
+  /**
+   * Checks whether the parameters of a new version of this motor can be applied
+   * @param motor The new version of this motor
+   * @return Always \c true
+   */
+  bool canUpdate(const Motor& motor) const override;
+
+  /**
+   * Applies the parameters of a new version of this motor
+   * @param motor The new version of this motor
+   */
+  void update(const Motor& motor) override;
 
   // actuator API
   void setValue(float value) override;
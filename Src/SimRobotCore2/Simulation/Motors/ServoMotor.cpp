@@ -126,7 +126,7 @@ bool ServoMotor::PositionSensor::getMinAndMax(float& min, float& max) const
   return false;
 }
 
-void ServoMotor::registerObjects()
+void ServoMotor::registerObjects(CoreModule& module)
 {
   if(dJointGetType(joint->joint) == dJointTypeHinge)
     positionSensor.unit = unit = QString::fromUtf8("°");
@@ -135,6 +135,28 @@ void ServoMotor::registerObjects()
   positionSensor.fullName = joint->fullName + ".position";
   fullName = joint->fullName + ".position";
 
-  CoreModule::application->registerObject(*CoreModule::module, positionSensor, joint);
-  CoreModule::application->registerObject(*CoreModule::module, *this, joint);
+  module.application.registerObject(module, positionSensor, joint);
+  module.application.registerObject(module, *this, joint);
+}
+
+bool ServoMotor::canUpdate(const Motor&) const
+{
+  return true;
+}
+
+void ServoMotor::update(const Motor& motor)
+{
+  const ServoMotor& newMotor = static_cast<const ServoMotor&>(motor);
+  maxVelocity = newMotor.maxVelocity;
+  maxForce = newMotor.maxForce;
+  controller.p = newMotor.controller.p;
+  controller.i = newMotor.controller.i;
+  controller.d = newMotor.controller.d;
+  if(joint)
+  {
+    if(dJointGetType(joint->joint) == dJointTypeHinge)
+      dJointSetHingeParam(joint->joint, dParamFMax, maxForce);
+    else
+      dJointSetSliderParam(joint->joint, dParamFMax, maxForce);
+  }
 }
@@ -100,7 +100,7 @@ bool VelocityMotor::VelocitySensor::getMinAndMax(float& min, float& max) const
   return true;
 }
 
-void VelocityMotor::registerObjects()
+void VelocityMotor::registerObjects(CoreModule& module)
 {
   if(dJointGetType(joint->joint) == dJointTypeHinge)
   {
@@ -114,11 +114,30 @@ void VelocityMotor::registerObjects()
   }
 
   positionSensor.fullName = joint->fullName + ".position";
-  CoreModule::application->registerObject(*CoreModule::module, positionSensor, joint);
+  module.application.registerObject(module, positionSensor, joint);
 
   velocitySensor.fullName = joint->fullName + ".velocity";
-  CoreModule::application->registerObject(*CoreModule::module, velocitySensor, joint);
+  module.application.registerObject(module, velocitySensor, joint);
 
   fullName = joint->fullName + ".velocity";
-  CoreModule::application->registerObject(*CoreModule::module, *this, joint);
+  module.application.registerObject(module, *this, joint);
+}
+
+bool VelocityMotor::canUpdate(const Motor&) const
+{
+  return true;
+}
+
+void VelocityMotor::update(const Motor& motor)
+{
+  const VelocityMotor& newMotor = static_cast<const VelocityMotor&>(motor);
+  maxVelocity = velocitySensor.maxVelocity = newMotor.maxVelocity;
+  maxForce = newMotor.maxForce;
+  if(joint)
+  {
+    if(dJointGetType(joint->joint) == dJointTypeHinge)
+      dJointSetHingeParam(joint->joint, dParamFMax, maxForce);
+    else
+      dJointSetSliderParam(joint->joint, dParamFMax, maxForce);
+  }
 }
@@ -7,7 +7,10 @@
 #include "PhysicalObject.h"
 #include "Platform/Assert.h"
 #include "Simulation/Body.h"
+#include "Simulation/Scene.h"
+#include "Simulation/Simulation.h"
 #include "SimObjectRenderer.h"
+#include <algorithm>
 
 void PhysicalObject::addParent(Element& element)
 {
@@ -22,9 +25,7 @@ void PhysicalObject::addParent(Element& element)
 void PhysicalObject::createPhysics(GraphicsContext& graphicsContext)
 {
   // find parent body for child objects
-  Body* body = dynamic_cast<Body*>(this);
-  if(!body)
-    body = parentBody;
+  Body* body = kind == bodyKind ? static_cast<Body*>(this) : parentBody;
 
   // initialize and call createPhysics() for each child object
   for(PhysicalObject* object : physicalChildren)
@@ -42,55 +43,45 @@ void PhysicalObject::createPhysics(GraphicsContext& graphicsContext)
   }
 }
 
-void PhysicalObject::drawPhysics(GraphicsContext& graphicsContext, unsigned int flags) const
-{
-  for(const PhysicalObject* drawing : physicalDrawings)
-    drawing->drawPhysics(graphicsContext, flags);
-}
-
-void PhysicalObject::drawControllerDrawings() const
+void PhysicalObject::destroyPhysics()
 {
-  for(SimRobotCore2::Controller3DDrawing* drawing : controllerDrawings)
-    drawing->draw();
-  const_cast<PhysicalObject*>(this)->visitPhysicalControllerDrawings([](PhysicalObject& child){child.drawControllerDrawings();});
-}
-
-void PhysicalObject::beforeControllerDrawings(const float* projection, const float* view) const
-{
-  ASSERT(modelMatrix);
-  for(SimRobotCore2::Controller3DDrawing* drawing : controllerDrawings)
-    drawing->beforeFrame(projection, view, modelMatrix->getPointer());
-  const_cast<PhysicalObject*>(this)->visitPhysicalControllerDrawings([projection, view](PhysicalObject& child){child.beforeControllerDrawings(projection, view);});
+  for(PhysicalObject* object : physicalChildren)
+    object->destroyPhysics();
 }
 
-void PhysicalObject::afterControllerDrawings() const
+void PhysicalObject::drawPhysics(GraphicsContext& graphicsContext, unsigned int flags) const
 {
-  for(SimRobotCore2::Controller3DDrawing* drawing : controllerDrawings)
-    drawing->afterFrame();
-  const_cast<PhysicalObject*>(this)->visitPhysicalControllerDrawings([](PhysicalObject& child){child.afterControllerDrawings();});
+  for(const PhysicalObject* drawing : physicalDrawings)
+    drawing->drawPhysics(graphicsContext, flags);
 }
 
-void PhysicalObject::visitPhysicalControllerDrawings(const std::function<void(PhysicalObject&)>& accept)
+void PhysicalObject::getPhysicalDrawingChildren(std::vector<const PhysicalObject*>& children) const
 {
-  for(PhysicalObject* drawing : physicalDrawings)
-    accept(*drawing);
+  children.insert(children.end(), physicalDrawings.begin(), physicalDrawings.end());
 }
 
 bool PhysicalObject::registerDrawing(SimRobotCore2::Controller3DDrawing& drawing)
 {
-  controllerDrawings.push_back(&drawing);
+  Scene* scene = Simulation::simulation->scene;
+  ASSERT(scene);
+  scene->controllerDrawings.push_back({this, nullptr, &drawing});
+  ++scene->controllerDrawingsRevision;
   return true;
 }
 
 bool PhysicalObject::unregisterDrawing(SimRobotCore2::Controller3DDrawing& drawing)
 {
-  for(auto iter = controllerDrawings.begin(), end = controllerDrawings.end(); iter != end; ++iter)
-    if(*iter == &drawing)
-    {
-      controllerDrawings.erase(iter);
-      return true;
-    }
-  return false;
+  Scene* scene = Simulation::simulation->scene;
+  ASSERT(scene);
+  const auto iter = std::find_if(scene->controllerDrawings.begin(), scene->controllerDrawings.end(), [this, &drawing](const Scene::ControllerDrawing& controllerDrawing)
+  {
+    return controllerDrawing.physicalObject == this && controllerDrawing.drawing == &drawing;
+  });
+  if(iter == scene->controllerDrawings.end())
+    return false;
+  scene->controllerDrawings.erase(iter);
+  ++scene->controllerDrawingsRevision;
+  return true;
 }
 
 SimRobotCore2::Body* PhysicalObject::getParentBody()
@@ -11,8 +11,10 @@
 #include "Simulation/SimObject.h"
 #include "Tools/Math/Pose3f.h"
 #include <list>
+#include <vector>
 
 class Body;
+class Geometry;
 class GraphicsContext;
 class SimObjectRenderer;
 
@@ -27,8 +29,9 @@ public:
   Body* parentBody = nullptr; /**< The superior body object (might be 0) */
 
   Pose3f poseInWorld; /**< The absolute pose of the object */
-  std::list<PhysicalObject*> physicalChildren; /**< List of subordinate physical scene graph objects */
-  std::list<PhysicalObject*> physicalDrawings; /**< List of subordinate physical objects that will be drawn relative to this one */
+  std::vector<PhysicalObject*> physicalChildren; /**< List of subordinate physical scene graph objects */
+  std::vector<PhysicalObject*> physicalDrawings; /**< List of subordinate physical objects that will be drawn relative to this one */
+  std::vector<Geometry*> geometries; /**< The subordinate geometries (which are also contained in \c physicalDrawings) */
 
   /**
    * Creates the physical objects used by the OpenDynamicsEngine (ODE).
@@ -38,6 +41,12 @@ public:
    */
   virtual void createPhysics(GraphicsContext& graphicsContext);
 
+  /**
+   * Destroys the physical objects that \c createPhysics created used by the OpenDynamicsEngine (ODE),
+   * so that the object (including its children) can be removed from a running simulation.
+   */
+  virtual void destroyPhysics();
+
   /**
    * Submits draw calls for physical primitives of the object (including children) in the given graphics context
    * @param graphicsContext The graphics context to draw the object to
@@ -45,37 +54,21 @@ public:
    */
   virtual void drawPhysics(GraphicsContext& graphicsContext, unsigned int flags) const;
 
-  /** Draws controller drawings of this physical object (and children) */
-  void drawControllerDrawings() const;
-
   /**
-   * Prepare controller drawings of this physical object (and children) for a frame
-   * @param projection Pointer to a column-major 4x4 projection matrix
-   * @param view Pointer to a column-major 4x4 view matrix
+   * Collects the physical children whose controller drawings are shown in a view of this object
+   * @param children The list the children are appended to
    */
-  void beforeControllerDrawings(const float* projection, const float* view) const;
-
-  /** Finish a frame of controller drawings for this physical object (and children) */
-  void afterControllerDrawings() const;
+  virtual void getPhysicalDrawingChildren(std::vector<const PhysicalObject*>& children) const;
 
   GraphicsContext::ModelMatrix* modelMatrix = nullptr; /**< The model matrix of this physical object */
 
 protected:
-  /**
-   * Visits controller drawings of physical children
-   * @param accept The functor to apply to every child
-   */
-  virtual void visitPhysicalControllerDrawings(const std::function<void(PhysicalObject&)>& accept);
-
   /**
    * Registers an element as parent
    * @param element The element to register
    */
   void addParent(Element& element) override;
 
-private:
-  std::list<SimRobotCore2::Controller3DDrawing*> controllerDrawings; /**< Drawings registered by another SimRobot module */
-
 protected:
   // API
   virtual bool registerDrawing(SimRobotCore2::Controller3DDrawing& drawing);
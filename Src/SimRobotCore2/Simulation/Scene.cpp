@@ -11,9 +11,12 @@
 #include "Simulation/Body.h"
 #include "Simulation/Simulation.h"
 #include "Tools/Math/Constants.h"
+#include <ode/objects.h>
+#include <algorithm>
 
 void Scene::updateTransformations()
 {
+  std::lock_guard<std::mutex> lock(transformationMutex);
   if(lastTransformationUpdateStep != Simulation::simulation->simulationStep)
   {
     for(Body* body : bodies)
@@ -62,23 +65,55 @@ void Scene::drawPhysics(GraphicsContext& graphicsContext, unsigned int flags) co
   ::PhysicalObject::drawPhysics(graphicsContext, flags);
 }
 
-void Scene::visitGraphicalControllerDrawings(const std::function<void(GraphicalObject&)>& accept)
+void Scene::getGraphicalDrawingChildren(std::vector<const GraphicalObject*>& children) const
 {
-  for(Body* body : bodies)
-    accept(*body);
-  GraphicalObject::visitGraphicalControllerDrawings(accept);
+  children.insert(children.end(), bodies.begin(), bodies.end());
+  GraphicalObject::getGraphicalDrawingChildren(children);
 }
 
-void Scene::visitPhysicalControllerDrawings(const std::function<void(::PhysicalObject&)>& accept)
+void Scene::getPhysicalDrawingChildren(std::vector<const ::PhysicalObject*>& children) const
 {
-  for(Body* body : bodies)
-    accept(*body);
-  ::PhysicalObject::visitPhysicalControllerDrawings(accept);
+  children.insert(children.end(), bodies.begin(), bodies.end());
+  ::PhysicalObject::getPhysicalDrawingChildren(children);
+}
+
+bool Scene::canUpdate(ElementCore2& element) const
+{
+  const Scene& scene = static_cast<Scene&>(element);
+  return scene.name == name && scene.controller == controller && scene.stepLength == stepLength &&
+         std::equal(color, color + 4, scene.color) &&
+         (scene.erp == -1.f) == (erp == -1.f) && (scene.cfm == -1.f) == (cfm == -1.f) &&
+         (scene.quickSolverIterations == -1) == (quickSolverIterations == -1);
+}
+
+void Scene::update(ElementCore2& element)
+{
+  const Scene& scene = static_cast<Scene&>(element);
+  gravity = scene.gravity;
+  erp = scene.erp;
+  cfm = scene.cfm;
+  contactMode = scene.contactMode;
+  contactSoftERP = scene.contactSoftERP;
+  contactSoftCFM = scene.contactSoftCFM;
+  useQuickSolver = scene.useQuickSolver;
+  quickSolverIterations = scene.quickSolverIterations;
+  if(useQuickSolver)
+    quickSolverSkip = scene.quickSolverSkip;
+  detectBodyCollisions = scene.detectBodyCollisions;
+
+  const dWorldID physicalWorld = Simulation::simulation->physicalWorld;
+  dWorldSetGravity(physicalWorld, REAL(0.), REAL(0.), static_cast<dReal>(gravity));
+  if(erp != -1.f)
+    dWorldSetERP(physicalWorld, erp);
+  if(cfm != -1.f)
+    dWorldSetCFM(physicalWorld, cfm);
+  if(quickSolverIterations != -1)
+    dWorldSetQuickStepNumIterations(physicalWorld, quickSolverIterations);
 }
 
 const QIcon* Scene::getIcon() const
 {
-  return &CoreModule::module->sceneIcon;
+  return &CoreModule::current().sceneIcon;
 }
 
 unsigned int Scene::getStep() const
@@ -103,3 +138,18 @@ bool Scene::registerDrawingManager(SimRobotCore2::Controller3DDrawingManager& ma
   drawingManager = &manager;
   return true;
 }
+
+void Scene::castRays(const float* origins, const float* directions, const float* maxDistances, unsigned int count, float* distances, SimRobotCore2::Body** bodies)
+{
+  Simulation::simulation->spatialQueries.castRays(origins, directions, maxDistances, count, distances, bodies);
+}
+
+void Scene::findBodiesInSpheres(const float* centers, const float* radii, unsigned int count, unsigned int maxBodies, SimRobotCore2::Body** bodies, unsigned int* numOfBodies)
+{
+  Simulation::simulation->spatialQueries.findBodiesInSpheres(centers, radii, count, maxBodies, bodies, numOfBodies);
+}
+
+void Scene::findNearestBodies(const float* points, unsigned int count, unsigned int k, SimRobotCore2::Body** bodies, float* distances, unsigned int* numOfBodies)
+{
+  Simulation::simulation->spatialQueries.findNearestBodies(points, count, k, bodies, distances, numOfBodies);
+}
@@ -13,6 +13,7 @@
 #include "Simulation/PhysicalObject.h"
 #include "Tools/Math/Constants.h"
 #include <list>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 
@@ -41,7 +42,23 @@ public:
   int quickSolverSkip; /**< Controls how often the normal solver will be used instead of the quick solver */
   bool detectBodyCollisions; /**< Whether to detect collision between different bodies */
 
+  /** A drawing that a controller registered at an object of the scene */
+  struct ControllerDrawing
+  {
+    const ::PhysicalObject* physicalObject; /**< The physical object the drawing was registered at (or \c nullptr) */
+    const GraphicalObject* graphicalObject; /**< The graphical object the drawing was registered at (or \c nullptr) */
+    SimRobotCore2::Controller3DDrawing* drawing; /**< The drawing */
+
+    /**
+     * Returns the model matrix of the object the drawing was registered at
+     * @return The model matrix
+     */
+    const GraphicsContext::ModelMatrix* getModelMatrix() const {return physicalObject ? physicalObject->modelMatrix : graphicalObject->modelMatrix;}
+  };
+
   SimRobotCore2::Controller3DDrawingManager* drawingManager = nullptr; /**< The manager for 3D controller drawings */
+  std::vector<ControllerDrawing> controllerDrawings; /**< All drawings registered at objects of the scene (in the order of their registration) */
+  unsigned int controllerDrawingsRevision = 0; /**< Changes whenever a drawing is registered or unregistered */
   std::list<Body*> bodies; /**< List of bodies without a parent body */
   std::list<Actuator::Port*> actuators; /**< List of actuators that need to do something in every simulation step */
   std::list<Light*> lights; /**< List of scene lights */
@@ -55,6 +72,7 @@ public:
   /** Updates the transformation of movable objects */
   void updateTransformations();
   unsigned int lastTransformationUpdateStep = 0;
+  std::mutex transformationMutex; /**< Protects the update of the transformations when sensors are read from multiple threads */
 
   /** Updates all actuators that need to do something for each simulation step */
   void updateActuators();
@@ -78,18 +96,30 @@ public:
    */
   void drawPhysics(GraphicsContext& graphicsContext, unsigned int flags) const override;
 
-private:
   /**
-   * Visits controller drawings of graphical children
-   * @param accept The functor to apply to every child
+   * Collects the graphical children whose controller drawings are shown in a view of the scene
+   * @param children The list the children are appended to
+   */
+  void getGraphicalDrawingChildren(std::vector<const GraphicalObject*>& children) const override;
+
+  /**
+   * Collects the physical children whose controller drawings are shown in a view of the scene
+   * @param children The list the children are appended to
+   */
+  void getPhysicalDrawingChildren(std::vector<const ::PhysicalObject*>& children) const override;
+
+  /**
+   * Checks whether the differences to a new version of the scene can be applied
+   * @param element The new version of the scene
+   * @return Whether only parameters of the physics engine differ
    */
-  void visitGraphicalControllerDrawings(const std::function<void(GraphicalObject&)>& accept) override;
+  bool canUpdate(ElementCore2& element) const override;
 
   /**
-   * Visits controller drawings of physical children
-   * @param accept The functor to apply to every child
+   * Applies the parameters of the physics engine of a new version of the scene
+   * @param element The new version of the scene
    */
-  void visitPhysicalControllerDrawings(const std::function<void(::PhysicalObject&)>& accept) override;
+  void update(ElementCore2& element) override;
 
 private:
   // API
@@ -105,4 +135,7 @@ private:
   double getTime() const override;
   unsigned int getFrameRate() const override;
   bool registerDrawingManager(SimRobotCore2::Controller3DDrawingManager& manager) override;
+  void castRays(const float* origins, const float* directions, const float* maxDistances, unsigned int count, float* distances, SimRobotCore2::Body** bodies) override;
+  void findBodiesInSpheres(const float* centers, const float* radii, unsigned int count, unsigned int maxBodies, SimRobotCore2::Body** bodies, unsigned int* numOfBodies) override;
+  void findNearestBodies(const float* points, unsigned int count, unsigned int k, SimRobotCore2::Body** bodies, float* distances, unsigned int* numOfBodies) override;
 };
@@ -43,12 +43,12 @@ void Accelerometer::addParent(Element& element)
   Sensor::addParent(element);
 }
 
-void Accelerometer::registerObjects()
+void Accelerometer::registerObjects(CoreModule& module)
 {
   sensor.fullName = fullName + ".acceleration";
-  CoreModule::application->registerObject(*CoreModule::module, sensor, this);
+  module.application.registerObject(module, sensor, this);
 
-  Sensor::registerObjects();
+  Sensor::registerObjects(module);
 }
 
 void Accelerometer::AccelerometerSensor::updateValue()
@@ -55,6 +55,9 @@ private:
    */
   void addParent(Element& element) override;
 
-  /** Registers this object with children, actuators and sensors at SimRobot's GUI */
-  void registerObjects() override;
+  /**
+   * Registers this object with children, actuators and sensors at SimRobot's GUI
+   * @param module The module that owns the simulation
+   */
+  void registerObjects(CoreModule& module) override;
 };
@@ -34,24 +34,15 @@ private:
   {
   public:
     ::PhysicalObject* physicalObject;
-    dGeomID geom;
     dGeomID scanRayGeom;
     float min;
     float max;
-    float maxSqrDist;
     Pose3f offset;
     float tanHalfAngleX;
     float tanHalfAngleY;
+    unsigned int query; /**< The index of the query in the simulation's distance queries */
 
   private:
-    float closestSqrDistance;
-    dGeomID closestGeom;
-    Pose3f pose; /**< The pose of the sensor relative to the origin of the scene */
-    Pose3f invertedPose;
-
-    static void staticCollisionCallback(DistanceSensor* sensor, dGeomID geom1, dGeomID geom2);
-    static void staticCollisionWithSpaceCallback(DistanceSensor* sensor, dGeomID geom1, dGeomID geom2);
-
     /** Update the sensor value. Is called when required. */
     void updateValue() override;
 
@@ -67,8 +58,14 @@ private:
    */
   void createPhysics(GraphicsContext& graphicsContext) override;
 
-  /** Registers this object with children, actuators and sensors at SimRobot's GUI */
-  void registerObjects() override;
+  /** Removes the query of the sensor and destroys its ray */
+  void destroyPhysics() override;
+
+  /**
+   * Registers this object with children, actuators and sensors at SimRobot's GUI
+   * @param module The module that owns the simulation
+   */
+  void registerObjects(CoreModule& module) override;
 
   /**
    * Registers an element as parent
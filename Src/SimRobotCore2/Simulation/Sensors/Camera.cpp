@@ -33,7 +33,7 @@ void Camera::createPhysics(GraphicsContext& graphicsContext)
 
   sensor.dimensions.append(imageWidth);
   sensor.dimensions.append(imageHeight);
-  sensor.dimensions.append(3);
+  sensor.dimensions.append(GraphicsContext::getBytesPerPixel(format));
 
   if(translation)
     sensor.offset.translation = *translation;
@@ -58,12 +58,12 @@ void Camera::addParent(Element& element)
   Sensor::addParent(element);
 }
 
-void Camera::registerObjects()
+void Camera::registerObjects(CoreModule& module)
 {
   sensor.fullName = fullName + ".image";
-  CoreModule::application->registerObject(*CoreModule::module, sensor, this);
+  module.application.registerObject(module, sensor, this);
 
-  Sensor::registerObjects();
+  Sensor::registerObjects(module);
 }
 
 void Camera::CameraSensor::updateValue()
@@ -71,7 +71,7 @@ void Camera::CameraSensor::updateValue()
   // allocate buffer
   const unsigned int imageWidth = camera->imageWidth;
   const unsigned int imageHeight = camera->imageHeight;
-  const unsigned int imageSize = imageWidth * imageHeight * 3;
+  const unsigned int imageSize = imageWidth * imageHeight * GraphicsContext::getBytesPerPixel(camera->format);
   if(imageBufferSize < imageSize)
   {
     if(imageBuffer)
@@ -95,7 +95,7 @@ void Camera::CameraSensor::updateValue()
   Matrix4f transformation;
   OpenGLTools::convertTransformation(pose.invert(), transformation);
 
-  graphicsContext.startColorRendering(projection, transformation, 0, 0, imageWidth, imageHeight, true);
+  graphicsContext.startColorRendering(projection, transformation, 0, 0, imageWidth, imageHeight, true, true, true, true, true, !camera->fullDetail);
 
   // draw all objects
   Simulation::simulation->scene->drawAppearances(graphicsContext);
@@ -103,7 +103,7 @@ void Camera::CameraSensor::updateValue()
   graphicsContext.finishRendering();
 
   // read frame buffer
-  graphicsContext.finishImageRendering(imageBuffer, imageWidth, imageHeight);
+  graphicsContext.finishImageRendering(imageBuffer, imageWidth, imageHeight, camera->format);
   data.byteArray = imageBuffer;
 }
 
@@ -115,13 +115,14 @@ bool Camera::CameraSensor::renderCameraImages(SimRobotCore2::SensorPort** camera
   // allocate buffer
   const unsigned int imageWidth = camera->imageWidth;
   const unsigned int imageHeight = camera->imageHeight;
-  const unsigned int imageSize = imageWidth * imageHeight * 3;
+  const GraphicsContext::ImageFormat format = camera->format;
+  const unsigned int imageSize = imageWidth * imageHeight * GraphicsContext::getBytesPerPixel(format);
   int imagesOfCurrentSize = 0;
   for(unsigned int i = 0; i < count; ++i)
   {
     CameraSensor* sensor = static_cast<CameraSensor*>(cameras[i]);
     if(sensor && sensor->lastSimulationStep != Simulation::simulation->simulationStep &&
-       sensor->camera->imageWidth == imageWidth && sensor->camera->imageHeight == imageHeight)
+       sensor->camera->imageWidth == imageWidth && sensor->camera->imageHeight == imageHeight && sensor->camera->format == format)
       ++imagesOfCurrentSize;
   }
   const unsigned int multiImageBufferSize = imageSize * imagesOfCurrentSize;
@@ -148,7 +149,7 @@ bool Camera::CameraSensor::renderCameraImages(SimRobotCore2::SensorPort** camera
   {
     CameraSensor* sensor = static_cast<CameraSensor*>(cameras[i]);
     if(sensor && sensor->lastSimulationStep != Simulation::simulation->simulationStep &&
-       sensor->camera->imageWidth == imageWidth && sensor->camera->imageHeight == imageHeight)
+       sensor->camera->imageWidth == imageWidth && sensor->camera->imageHeight == imageHeight && sensor->camera->format == format)
     {
       // setup camera position
       Pose3f pose = sensor->physicalObject->poseInWorld;
@@ -158,7 +159,7 @@ bool Camera::CameraSensor::renderCameraImages(SimRobotCore2::SensorPort** camera
       Matrix4f transformation;
       OpenGLTools::convertTransformation(pose.invert(), transformation);
 
-      graphicsContext.startColorRendering(sensor->projection, transformation, 0, currentHorizontalPos, imageWidth, imageHeight, !currentHorizontalPos);
+      graphicsContext.startColorRendering(sensor->projection, transformation, 0, currentHorizontalPos, imageWidth, imageHeight, !currentHorizontalPos, true, true, true, true, !sensor->camera->fullDetail);
 
       // draw all objects
       Simulation::simulation->scene->drawAppearances(graphicsContext);
@@ -174,7 +175,7 @@ bool Camera::CameraSensor::renderCameraImages(SimRobotCore2::SensorPort** camera
   }
 
   // read frame buffer
-  graphicsContext.finishImageRendering(imageBuffer, imageWidth, currentHorizontalPos);
+  graphicsContext.finishImageRendering(imageBuffer, imageWidth, currentHorizontalPos, format);
   return true;
 }
 
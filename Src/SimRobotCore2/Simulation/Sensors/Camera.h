@@ -20,6 +20,8 @@ public:
   unsigned int imageHeight; /**< The height of a camera image */
   float angleX;
   float angleY;
+  GraphicsContext::ImageFormat format = GraphicsContext::rgb; /**< The pixel format in which images are delivered */
+  bool fullDetail = false; /**< Whether all meshes are rendered in full detail (instead of simplified when they appear small) */
 
   /** Default constructor */
   Camera();
@@ -59,8 +61,11 @@ private:
    */
   void addParent(Element& element) override;
 
-  /** Registers this object with children, actuators and sensors at SimRobot's GUI */
-  void registerObjects() override;
+  /**
+   * Registers this object with children, actuators and sensors at SimRobot's GUI
+   * @param module The module that owns the simulation
+   */
+  void registerObjects(CoreModule& module) override;
 
   /**
    * Submits draw calls for physical primitives of the object (including children) in the given graphics context
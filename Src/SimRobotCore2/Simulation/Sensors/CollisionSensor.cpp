@@ -17,58 +17,45 @@ CollisionSensor::CollisionSensor()
 void CollisionSensor::createPhysics(GraphicsContext& graphicsContext)
 {
   // add geometries
-  for(auto iter = physicalDrawings.begin(), end = physicalDrawings.end(); iter != end; ++iter)
+  if(!geometries.empty())
   {
-    Geometry* geometry = dynamic_cast<Geometry*>(*iter);
-    if(geometry)
-    {
-      hasGeometries = true;
-      Pose3f geomOffset(-parentBody->centerOfMass);
-      if(translation)
-        geomOffset.translate(*translation);
-      if(rotation)
-        geomOffset.rotate(*rotation);
+    hasGeometries = true;
+    Pose3f geomOffset(-parentBody->centerOfMass);
+    if(translation)
+      geomOffset.translate(*translation);
+    if(rotation)
+      geomOffset.rotate(*rotation);
+    for(Geometry* geometry : geometries)
       parentBody->addGeometry(geomOffset, *geometry);
-      for(++iter; iter != end; ++iter) // avoid constructing geomOffset again
-      {
-        geometry = dynamic_cast<Geometry*>(*iter);
-        if(geometry)
-          parentBody->addGeometry(geomOffset, *geometry);
-      }
-      break;
-    }
   }
 
   // register collision callback function
   if(hasGeometries)
-    registerCollisionCallback(physicalDrawings, true);
+    registerCollisionCallback(geometries, true);
   else // in case the sensor has no geometries use the geometries of the body to which the sensor is attached
-    registerCollisionCallback(parentBody->physicalDrawings, false);
+    registerCollisionCallback(parentBody->geometries, false);
 
   Sensor::createPhysics(graphicsContext);
 }
 
-void CollisionSensor::registerCollisionCallback(std::list< ::PhysicalObject*>& geometries, bool setNotCollidable)
+void CollisionSensor::registerCollisionCallback(const std::vector<Geometry*>& geometries, bool setNotCollidable)
 {
-  for(::PhysicalObject* i : geometries)
-  {
-    Geometry* geometry = dynamic_cast<Geometry*>(i);
-    if(geometry && !geometry->immaterial)
+  for(Geometry* geometry : geometries)
+    if(!geometry->immaterial)
     {
       if(setNotCollidable)
         geometry->immaterial = true;
       geometry->registerCollisionCallback(sensor);
-      registerCollisionCallback(geometry->physicalDrawings, setNotCollidable);
+      registerCollisionCallback(geometry->geometries, setNotCollidable);
     }
-  }
 }
 
-void CollisionSensor::registerObjects()
+void CollisionSensor::registerObjects(CoreModule& module)
 {
   sensor.fullName = fullName + ".contact";
-  CoreModule::application->registerObject(*CoreModule::module, sensor, this);
+  module.application.registerObject(module, sensor, this);
 
-  Sensor::registerObjects();
+  Sensor::registerObjects(module);
 }
 
 void CollisionSensor::CollisionSensorPort::updateValue()
@@ -8,7 +8,9 @@
 
 #include "SimRobotCore2.h"
 #include "Simulation/Sensors/Sensor.h"
-#include <list>
+#include <vector>
+
+class Geometry;
 
 /**
  * @class CollisionSensor
@@ -59,10 +61,13 @@ private:
    * @param geometries The list of geometries
    * @param setNotCollidable Whether the geometries will be immaterialized
    */
-  void registerCollisionCallback(std::list<::PhysicalObject*>& geometries, bool setNotCollidable);
+  void registerCollisionCallback(const std::vector<Geometry*>& geometries, bool setNotCollidable);
 
-  /** Registers this object with children, actuators and sensors at SimRobot's GUI. */
-  void registerObjects() override;
+  /**
+   * Registers this object with children, actuators and sensors at SimRobot's GUI
+   * @param module The module that owns the simulation
+   */
+  void registerObjects(CoreModule& module) override;
 
   /**
    * Submits draw calls for physical primitives of the object (including children) in the given graphics context
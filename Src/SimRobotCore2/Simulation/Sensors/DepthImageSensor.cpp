@@ -194,12 +194,12 @@ void DepthImageSensor::addParent(Element& element)
   Sensor::addParent(element);
 }
 
-void DepthImageSensor::registerObjects()
+void DepthImageSensor::registerObjects(CoreModule& module)
 {
   sensor.fullName = fullName + ".image";
-  CoreModule::application->registerObject(*CoreModule::module, sensor, this);
+  module.application.registerObject(module, sensor, this);
 
-  Sensor::registerObjects();
+  Sensor::registerObjects(module);
 }
 
 void DepthImageSensor::DistanceSensor::updateValue()
@@ -78,8 +78,11 @@ private:
    */
   void addParent(Element& element) override;
 
-  /** Registers this object with children, actuators and sensors at SimRobot's GUI. */
-  void registerObjects() override;
+  /**
+   * Registers this object with children, actuators and sensors at SimRobot's GUI
+   * @param module The module that owns the simulation
+   */
+  void registerObjects(CoreModule& module) override;
 
   /**
    * Submits draw calls for physical primitives of the object (including children) in the given graphics context
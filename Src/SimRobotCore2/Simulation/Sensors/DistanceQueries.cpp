@@ -0,0 +1,230 @@
+/**
+ * @file Simulation/Sensors/DistanceQueries.cpp
+ * Implementation of class DistanceQueries
+ */
+
+#include "DistanceQueries.h"
+#include "Simulation/Body.h"
+#include "Simulation/Geometries/Geometry.h"
+#include "Simulation/Scene.h"
+#include "Simulation/Simulation.h"
+#include "Platform/Assert.h"
+#include <ode/collision.h>
+#include <cmath>
+
+unsigned int DistanceQueries::addApproxQuery(const PhysicalObject& physicalObject, const Pose3f& offset, float tanHalfAngleX, float tanHalfAngleY, float max, dGeomID scanRayGeom)
+{
+  Query& query = queries.emplace_back();
+  query.approx = true;
+  query.physicalObject = &physicalObject;
+  query.offset = offset;
+  query.tanHalfAngleX = tanHalfAngleX;
+  query.tanHalfAngleY = tanHalfAngleY;
+  query.max = max;
+  query.rayGeom = scanRayGeom;
+  return static_cast<unsigned int>(queries.size() - 1);
+}
+
+unsigned int DistanceQueries::addRayQuery(const PhysicalObject& physicalObject, const Pose3f& offset, float max, dGeomID rayGeom)
+{
+  Query& query = queries.emplace_back();
+  query.approx = false;
+  query.physicalObject = &physicalObject;
+  query.offset = offset;
+  query.tanHalfAngleX = query.tanHalfAngleY = 0.f;
+  query.max = max;
+  query.rayGeom = rayGeom;
+  return static_cast<unsigned int>(queries.size() - 1);
+}
+
+void DistanceQueries::removeQuery(unsigned int query)
+{
+  ASSERT(query < queries.size());
+  std::lock_guard<std::mutex> lock(mutex);
+  queries[query].physicalObject = nullptr;
+  queries[query].rayGeom = nullptr;
+}
+
+float DistanceQueries::getDistance(unsigned int query)
+{
+  ASSERT(query < queries.size());
+  std::lock_guard<std::mutex> lock(mutex);
+  if(lastUpdateStep != Simulation::simulation->simulationStep)
+    update();
+  return queries[query].distance;
+}
+
+void DistanceQueries::update()
+{
+  lastUpdateStep = Simulation::simulation->simulationStep;
+  Simulation::simulation->scene->updateTransformations();
+  bvh = &Simulation::simulation->getGeometryBVH();
+
+  if(activeQueries.empty())
+    activeQueries.resize(1);
+  std::vector<unsigned int>& rootQueries = activeQueries[0];
+  rootQueries.clear();
+  for(unsigned int i = 0; i < queries.size(); ++i)
+  {
+    Query& query = queries[i];
+    if(!query.physicalObject)
+      continue;
+    query.pose = query.physicalObject->poseInWorld;
+    query.pose.conc(query.offset);
+    query.invertedPose = query.pose.inverse();
+    query.closestSqrDistance = query.max * query.max;
+    query.distance = query.max;
+
+    const Vector3f& pos = query.pose.translation;
+    query.boundsMin = query.boundsMax = pos;
+    if(query.approx)
+    {
+      const float halfWidth = query.tanHalfAngleX * query.max;
+      const float halfHeight = query.tanHalfAngleY * query.max;
+      for(const Vector3f& corner : {Vector3f(query.max, halfWidth, halfHeight), Vector3f(query.max, -halfWidth, halfHeight),
+                                    Vector3f(query.max, halfWidth, -halfHeight), Vector3f(query.max, -halfWidth, -halfHeight)})
+      {
+        const Vector3f worldCorner = query.pose * corner;
+        query.boundsMin = query.boundsMin.cwiseMin(worldCorner);
+        query.boundsMax = query.boundsMax.cwiseMax(worldCorner);
+      }
+    }
+    else
+    {
+      const Vector3f dir = query.pose.rotation.col(0);
+      const Vector3f end = pos + dir * query.max;
+      query.boundsMin = query.boundsMin.cwiseMin(end);
+      query.boundsMax = query.boundsMax.cwiseMax(end);
+      dGeomRaySet(query.rayGeom, static_cast<dReal>(pos.x()), static_cast<dReal>(pos.y()), static_cast<dReal>(pos.z()),
+                  static_cast<dReal>(dir.x()), static_cast<dReal>(dir.y()), static_cast<dReal>(dir.z()));
+    }
+    rootQueries.push_back(i);
+  }
+
+  if(!bvh->empty() && !rootQueries.empty())
+    traverse(0, 0);
+}
+
+void DistanceQueries::traverse(int nodeIndex, unsigned int depth)
+{
+  if(activeQueries.size() <= depth + 1)
+    activeQueries.resize(depth + 2);
+  const std::vector<unsigned int>& parentQueries = activeQueries[depth];
+  std::vector<unsigned int>& nodeQueries = activeQueries[depth + 1];
+
+  const GeometryBVH::Node& node = bvh->getNodes()[nodeIndex];
+  nodeQueries.clear();
+  for(unsigned int i : parentQueries)
+  {
+    const Query& query = queries[i];
+    if((node.min.array() <= query.boundsMax.array()).all() && (node.max.array() >= query.boundsMin.array()).all())
+      nodeQueries.push_back(i);
+  }
+  if(nodeQueries.empty())
+    return;
+
+  if(node.leaf >= 0)
+  {
+    const GeometryBVH::Leaf& leaf = bvh->getLeaves()[node.leaf];
+    for(unsigned int i : nodeQueries)
+    {
+      Query& query = queries[i];
+      if(query.approx)
+        testApprox(query, leaf);
+      else
+        testRay(query, leaf);
+    }
+  }
+  else
+  {
+    traverse(nodeIndex + 1, depth + 1);
+    traverse(bvh->getNodes()[nodeIndex + 1].skip, depth + 1);
+  }
+}
+
+void DistanceQueries::testApprox(Query& query, const GeometryBVH::Leaf& leaf) const
+{
+  const Vector3f& pos = query.pose.translation;
+  const Eigen::Array4f dx = leaf.x - pos.x();
+  const Eigen::Array4f dy = leaf.y - pos.y();
+  const Eigen::Array4f dz = leaf.z - pos.z();
+  const Eigen::Array4f sqrDist = dx * dx + dy * dy + dz * dz;
+  const Eigen::Array4f approxSqrDist = sqrDist - leaf.innerRadiusSqr;
+
+  // the sphere centers relative to the sensor
+  const Matrix3f& rot = query.invertedPose.rotation;
+  const Vector3f& trans = query.invertedPose.translation;
+  const Eigen::Array4f relX = rot(0, 0) * leaf.x + rot(0, 1) * leaf.y + rot(0, 2) * leaf.z + trans.x();
+  const Eigen::Array4f absRelY = (rot(1, 0) * leaf.x + rot(1, 1) * leaf.y + rot(1, 2) * leaf.z + trans.y()).abs();
+  const Eigen::Array4f absRelZ = (rot(2, 0) * leaf.x + rot(2, 1) * leaf.y + rot(2, 2) * leaf.z + trans.z()).abs();
+  const Eigen::Array4f halfMaxY = query.tanHalfAngleX * relX;
+  const Eigen::Array4f halfMaxZ = query.tanHalfAngleY * relX;
+
+  // the center of the geometry must be in front of the sensor and the sphere that covers the geometry must collide with the pyramid
+  const Eigen::Array<bool, 4, 1> candidates = (leaf.outerRadius >= 0.f) && (approxSqrDist < query.closestSqrDistance) && (relX > 0.f) &&
+                                              ((absRelY - leaf.outerRadius).max(0.f) < halfMaxY) && ((absRelZ - leaf.outerRadius).max(0.f) < halfMaxZ);
+  if(!candidates.any())
+    return;
+
+  // a candidate whose enclosed sphere collides with the pyramid is a hit without further checks
+  const Eigen::Array<bool, 4, 1> innerHits = ((absRelY - leaf.innerRadius).max(0.f) < halfMaxY) && ((absRelZ - leaf.innerRadius).max(0.f) < halfMaxZ);
+
+  for(int i = 0; i < GeometryBVH::leafSize; ++i)
+  {
+    if(!candidates[i] || approxSqrDist[i] >= query.closestSqrDistance)
+      continue;
+    if(static_cast<const PhysicalObject*>(leaf.geometries[i]->parentBody) == query.physicalObject)
+      continue; // avoid detecting the body on which the sensor is mounted
+
+    if(!innerHits[i])
+    {
+      // the geometry might collide with the pyramid. let us perform a hit scan along one of the pyramid's sides to find out..
+      const Vector3f relPos = query.invertedPose * Vector3f(leaf.x[i], leaf.y[i], leaf.z[i]);
+      const Vector3f scanDir = query.pose.rotation * Vector3f(relPos.x(), std::max(std::min(relPos.y(), halfMaxY[i]), -halfMaxY[i]), std::max(std::min(relPos.z(), halfMaxZ[i]), -halfMaxZ[i]));
+      dGeomRaySet(query.rayGeom, pos.x(), pos.y(), pos.z(), scanDir.x(), scanDir.y(), scanDir.z());
+      dContactGeom contactGeom;
+      if(dCollide(query.rayGeom, leaf.geoms[i], CONTACTS_UNIMPORTANT | 1, &contactGeom, sizeof(dContactGeom)) <= 0)
+        continue;
+    }
+
+    query.closestSqrDistance = approxSqrDist[i];
+    query.distance = std::sqrt(sqrDist[i]) - leaf.innerRadius[i];
+  }
+}
+
+void DistanceQueries::testRay(Query& query, const GeometryBVH::Leaf& leaf) const
+{
+  const Vector3f& pos = query.pose.translation;
+  const Vector3f dir = query.pose.rotation.col(0);
+  const Eigen::Array4f dx = leaf.x - pos.x();
+  const Eigen::Array4f dy = leaf.y - pos.y();
+  const Eigen::Array4f dz = leaf.z - pos.z();
+
+  // closest point of the ray to each sphere center
+  const Eigen::Array4f t = (dx * dir.x() + dy * dir.y() + dz * dir.z()).max(0.f).min(query.max);
+  const Eigen::Array4f ex = dx - t * dir.x();
+  const Eigen::Array4f ey = dy - t * dir.y();
+  const Eigen::Array4f ez = dz - t * dir.z();
+  const Eigen::Array<bool, 4, 1> candidates = (leaf.outerRadius >= 0.f) && (ex * ex + ey * ey + ez * ez < leaf.outerRadius * leaf.outerRadius) &&
+                                              (t - leaf.outerRadius < std::sqrt(query.closestSqrDistance));
+  if(!candidates.any())
+    return;
+
+  for(int i = 0; i < GeometryBVH::leafSize; ++i)
+  {
+    if(!candidates[i])
+      continue;
+    dContactGeom contactGeoms[4];
+    const int contacts = dCollide(query.rayGeom, leaf.geoms[i], 4, contactGeoms, sizeof(dContactGeom));
+    for(int j = 0; j < contacts; ++j)
+    {
+      const dContactGeom& contactGeom = contactGeoms[j];
+      const float sqrDistance = (Vector3f(static_cast<float>(contactGeom.pos[0]), static_cast<float>(contactGeom.pos[1]), static_cast<float>(contactGeom.pos[2])) - pos).squaredNorm();
+      if(sqrDistance < query.closestSqrDistance)
+      {
+        query.closestSqrDistance = sqrDistance;
+        query.distance = std::sqrt(sqrDistance);
+      }
+    }
+  }
+}
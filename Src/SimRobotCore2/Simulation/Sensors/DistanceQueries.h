@@ -0,0 +1,109 @@
+/**
+ * @file Simulation/Sensors/DistanceQueries.h
+ * Declaration of class DistanceQueries
+ */
+
+#pragma once
+
+#include "Simulation/GeometryBVH.h"
+#include "Tools/Math/Pose3f.h"
+#include <ode/common.h>
+#include <mutex>
+#include <vector>
+
+class PhysicalObject;
+
+/**
+ * @class DistanceQueries
+ * Collects the queries of all distance sensors and answers them together once per simulation step.
+ * All queries of a step share a single traversal of a bounding volume hierarchy over the geometries.
+ */
+class DistanceQueries
+{
+public:
+  /**
+   * Registers the query of an approximate distance sensor (a pyramid that reports the distance to the inner sphere of
+   * the closest geometry whose center lies in front of the sensor).
+   * @param physicalObject The object the sensor is mounted on
+   * @param offset The pose of the sensor relative to \c physicalObject
+   * @param tanHalfAngleX The tangent of half the horizontal opening angle
+   * @param tanHalfAngleY The tangent of half the vertical opening angle
+   * @param max The maximum distance
+   * @param scanRayGeom A ray used to test geometries that only partially overlap the pyramid
+   * @return The index of the query
+   */
+  unsigned int addApproxQuery(const PhysicalObject& physicalObject, const Pose3f& offset, float tanHalfAngleX, float tanHalfAngleY, float max, dGeomID scanRayGeom);
+
+  /**
+   * Registers the query of a single ray distance sensor along the x axis of the sensor
+   * @param physicalObject The object the sensor is mounted on
+   * @param offset The pose of the sensor relative to \c physicalObject
+   * @param max The maximum distance
+   * @param rayGeom The ray used to test geometries
+   * @return The index of the query
+   */
+  unsigned int addRayQuery(const PhysicalObject& physicalObject, const Pose3f& offset, float max, dGeomID rayGeom);
+
+  /**
+   * Unregisters the query of a sensor that is removed from the scene. The indices of the other queries stay valid.
+   * @param query The index of the query
+   */
+  void removeQuery(unsigned int query);
+
+  /**
+   * Returns the result of a query for the current simulation step. All queries are answered by the first call in a step.
+   * @param query The index of the query
+   * @return The measured distance or the maximum distance if nothing was found
+   */
+  float getDistance(unsigned int query);
+
+private:
+  /** A registered query */
+  struct Query
+  {
+    bool approx; /**< Whether this is an approximate (pyramid) query or a ray query */
+    const PhysicalObject* physicalObject; /**< The object the sensor is mounted on (\c nullptr if the query was removed) */
+    Pose3f offset; /**< The pose of the sensor relative to \c physicalObject */
+    float tanHalfAngleX; /**< The tangent of half the horizontal opening angle */
+    float tanHalfAngleY; /**< The tangent of half the vertical opening angle */
+    float max; /**< The maximum distance */
+    dGeomID rayGeom; /**< The ray for hit scans */
+
+    Pose3f pose; /**< The pose of the sensor in the current step */
+    Pose3f invertedPose; /**< The inverse of \c pose */
+    Vector3f boundsMin; /**< The minimum corner of the bounding box of the query volume */
+    Vector3f boundsMax; /**< The maximum corner of the bounding box of the query volume */
+    float closestSqrDistance; /**< The (approximate) squared distance to the closest geometry found so far */
+    float distance; /**< The result */
+  };
+
+  std::vector<Query> queries; /**< All registered queries */
+  std::vector<std::vector<unsigned int>> activeQueries; /**< The queries overlapping the nodes along the current traversal path (one list per depth) */
+  const GeometryBVH* bvh = nullptr; /**< The hierarchy over all geometries (shared by all spatial queries of the simulation) */
+  unsigned int lastUpdateStep = 0xffffffff; /**< The simulation step in which the queries were answered last */
+  std::mutex mutex; /**< Protects the update when sensors are read from multiple threads */
+
+  /** Answers all queries for the current simulation step */
+  void update();
+
+  /**
+   * Traverses a subtree with all queries overlapping its parent
+   * @param nodeIndex The root of the subtree
+   * @param depth The depth of the node
+   */
+  void traverse(int nodeIndex, unsigned int depth);
+
+  /**
+   * Tests the geometries of a leaf against an approximate query
+   * @param query The query
+   * @param leaf The leaf
+   */
+  void testApprox(Query& query, const GeometryBVH::Leaf& leaf) const;
+
+  /**
+   * Tests the geometries of a leaf against a ray query
+   * @param query The query
+   * @param leaf The leaf
+   */
+  void testRay(Query& query, const GeometryBVH::Leaf& leaf) const;
+};
@@ -39,12 +39,12 @@ void Gyroscope::addParent(Element& element)
   Sensor::addParent(element);
 }
 
-void Gyroscope::registerObjects()
+void Gyroscope::registerObjects(CoreModule& module)
 {
   sensor.fullName = fullName + ".angularVelocities";
-  CoreModule::application->registerObject(*CoreModule::module, sensor, this);
+  module.application.registerObject(module, sensor, this);
 
-  Sensor::registerObjects();
+  Sensor::registerObjects(module);
 }
 
 void Gyroscope::GyroscopeSensor::updateValue()
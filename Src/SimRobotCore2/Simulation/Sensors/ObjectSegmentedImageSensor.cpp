@@ -89,12 +89,12 @@ void ObjectSegmentedImageSensor::addParent(Element& element)
   Sensor::addParent(element);
 }
 
-void ObjectSegmentedImageSensor::registerObjects()
+void ObjectSegmentedImageSensor::registerObjects(CoreModule& module)
 {
   sensor.fullName = fullName + ".image";
-  CoreModule::application->registerObject(*CoreModule::module, sensor, this);
+  module.application.registerObject(module, sensor, this);
 
-  Sensor::registerObjects();
+  Sensor::registerObjects(module);
 }
 
 void ObjectSegmentedImageSensor::ObjectSegmentedImageSensorPort::updateValue()
@@ -126,7 +126,7 @@ void ObjectSegmentedImageSensor::ObjectSegmentedImageSensorPort::updateValue()
   Matrix4f transformation;
   OpenGLTools::convertTransformation(pose.invert(), transformation);
 
-  graphicsContext.startColorRendering(projection, transformation, 0, 0, imageWidth, imageHeight, true, false, false, false);
+  graphicsContext.startColorRendering(projection, transformation, 0, 0, imageWidth, imageHeight, true, false, false, false, true, !camera->fullDetail);
 
   // draw all objects
   Simulation::simulation->scene->GraphicalObject::drawAppearances(graphicsContext);
@@ -197,7 +197,7 @@ bool ObjectSegmentedImageSensor::ObjectSegmentedImageSensorPort::renderCameraIma
       Matrix4f transformation;
       OpenGLTools::convertTransformation(pose.invert(), transformation);
 
-      graphicsContext.startColorRendering(sensor->projection, transformation, 0, currentHorizontalPos, imageWidth, imageHeight, !currentHorizontalPos, false, false, false);
+      graphicsContext.startColorRendering(sensor->projection, transformation, 0, currentHorizontalPos, imageWidth, imageHeight, !currentHorizontalPos, false, false, false, true, !sensor->camera->fullDetail);
 
       // draw all objects
       Simulation::simulation->scene->GraphicalObject::drawAppearances(graphicsContext);
@@ -24,7 +24,7 @@ void Sensor::createPhysics(GraphicsContext& graphicsContext)
 
 const QIcon* Sensor::Port::getIcon() const
 {
-  return &CoreModule::module->sensorIcon;
+  return &CoreModule::current().sensorIcon;
 }
 
 SimRobot::Widget* Sensor::Port::createWidget()
@@ -8,9 +8,10 @@
 #include "SingleDistanceSensor.h"
 #include "CoreModule.h"
 #include "Graphics/Primitives.h"
-#include "Simulation/Body.h"
+#include "Simulation/Simulation.h"
 #include "Platform/Assert.h"
 #include <ode/collision.h>
+#include <algorithm>
 
 SingleDistanceSensor::SingleDistanceSensor()
 {
@@ -25,11 +26,11 @@ void SingleDistanceSensor::createPhysics(GraphicsContext& graphicsContext)
   sensor.geom = dCreateRay(Simulation::simulation->rootSpace, max);
   sensor.min = min;
   sensor.max = max;
-  sensor.maxSqrDist = max * max;
   if(translation)
     sensor.offset.translation = *translation;
   if(rotation)
     sensor.offset.rotation = *rotation;
+  sensor.query = Simulation::simulation->distanceQueries.addRayQuery(*sensor.physicalObject, sensor.offset, max, sensor.geom);
 
   ASSERT(!ray);
   ray = Primitives::createLine(graphicsContext, Vector3f::Zero(), Vector3f(max, 0.f, 0.f));
@@ -39,12 +40,21 @@ void SingleDistanceSensor::createPhysics(GraphicsContext& graphicsContext)
   surface = graphicsContext.requestSurface(color, color);
 }
 
-void SingleDistanceSensor::registerObjects()
+void SingleDistanceSensor::destroyPhysics()
+{
+  Simulation::simulation->distanceQueries.removeQuery(sensor.query);
+  dGeomDestroy(sensor.geom);
+  sensor.geom = nullptr;
+
+  Sensor::destroyPhysics();
+}
+
+void SingleDistanceSensor::registerObjects(CoreModule& module)
 {
   sensor.fullName = fullName + ".distance";
-  CoreModule::application->registerObject(*CoreModule::module, sensor, this);
+  module.application.registerObject(module, sensor, this);
 
-  Sensor::registerObjects();
+  Sensor::registerObjects(module);
 }
 
 void SingleDistanceSensor::addParent(Element& element)
@@ -54,53 +64,9 @@ void SingleDistanceSensor::addParent(Element& element)
   Sensor::addParent(element);
 }
 
-void SingleDistanceSensor::DistanceSensor::staticCollisionCallback(SingleDistanceSensor::DistanceSensor* sensor, dGeomID geom1, dGeomID geom2)
-{
-  ASSERT(geom1 == sensor->geom);
-  ASSERT(!dGeomIsSpace(geom2));
-
-  dContactGeom contactGeoms[4];
-  int contacts = dCollide(geom1, geom2, 4, contactGeoms, sizeof(dContactGeom));
-
-  for(int i = 0; i < contacts; ++i)
-  {
-    const dContactGeom& contactGeom = contactGeoms[i];
-    const float sqrDistance = (Vector3f(static_cast<float>(contactGeom.pos[0]), static_cast<float>(contactGeom.pos[1]), static_cast<float>(contactGeom.pos[2])) - sensor->pose.translation).squaredNorm();
-    if(sqrDistance < sensor->closestSqrDistance)
-    {
-      sensor->closestSqrDistance = sqrDistance;
-      sensor->closestGeom = geom2;
-    }
-  }
-}
-
-void SingleDistanceSensor::DistanceSensor::staticCollisionWithSpaceCallback(SingleDistanceSensor::DistanceSensor* sensor, dGeomID geom1, dGeomID geom2)
-{
-  ASSERT(geom1 == sensor->geom);
-  ASSERT(dGeomIsSpace(geom2));
-  dSpaceCollide2(geom1, geom2, sensor, reinterpret_cast<dNearCallback*>(&staticCollisionCallback));
-}
-
 void SingleDistanceSensor::DistanceSensor::updateValue()
 {
-  pose = physicalObject->poseInWorld;
-  pose.conc(offset);
-  const Vector3f& pos = pose.translation;
-  const Vector3f dir = pose.rotation.col(0);
-  dGeomRaySet(geom, static_cast<dReal>(pos.x()), static_cast<dReal>(pos.y()), static_cast<dReal>(pos.z()),
-              static_cast<dReal>(dir.x()), static_cast<dReal>(dir.y()), static_cast<dReal>(dir.z()));
-  closestGeom = nullptr;
-  closestSqrDistance = maxSqrDist;
-  dSpaceCollide2(geom, reinterpret_cast<dGeomID>(Simulation::simulation->movableSpace), this, reinterpret_cast<dNearCallback*>(&staticCollisionWithSpaceCallback));
-  dSpaceCollide2(geom, reinterpret_cast<dGeomID>(Simulation::simulation->staticSpace), this, reinterpret_cast<dNearCallback*>(&staticCollisionCallback));
-  if(closestGeom)
-  {
-    data.floatValue = std::sqrt(closestSqrDistance);
-    if(data.floatValue < min)
-      data.floatValue = min;
-  }
-  else
-    data.floatValue = max;
+  data.floatValue = std::max(Simulation::simulation->distanceQueries.getDistance(query), min);
 }
 
 bool SingleDistanceSensor::DistanceSensor::getMinAndMax(float& min, float& max) const
@@ -27,28 +27,31 @@ void SimObject::addParent(Element& parent)
   dynamic_cast<SimObject*>(&parent)->children.push_back(this);
 }
 
-void SimObject::registerObjects()
+void SimObject::registerObjects(CoreModule& module)
 {
   for(SimObject* simObject : children)
+    registerChild(module, *simObject);
+}
+
+void SimObject::registerChild(CoreModule& module, SimObject& child)
+{
+  if(child.name.empty())
   {
-    if(simObject->name.empty())
-    {
-      const char* typeName = typeid(*simObject).name();
+    const char* typeName = typeid(child).name();
 #ifdef __GNUC__
-      while(std::isdigit(*typeName))
-        ++typeName;
+    while(std::isdigit(*typeName))
+      ++typeName;
 #else
-      const char* str = std::strchr(typeName, ' ');
-      if(str)
-        typeName = str + 1;
+    const char* str = std::strchr(typeName, ' ');
+    if(str)
+      typeName = str + 1;
 #endif
-      simObject->fullName = fullName + "." + typeName;
-    }
-    else
-      simObject->fullName = fullName + "." + simObject->name.c_str();
-    CoreModule::application->registerObject(*CoreModule::module, dynamic_cast<SimRobot::Object&>(*simObject), dynamic_cast<SimRobot::Object*>(this));
-    simObject->registerObjects();
+    child.fullName = fullName + "." + typeName;
   }
+  else
+    child.fullName = fullName + "." + child.name.c_str();
+  module.application.registerObject(module, dynamic_cast<SimRobot::Object&>(child), dynamic_cast<SimRobot::Object*>(this));
+  child.registerObjects(module);
 }
 
 SimRobot::Widget* SimObject::createWidget()
@@ -58,7 +61,7 @@ SimRobot::Widget* SimObject::createWidget()
 
 const QIcon* SimObject::getIcon() const
 {
-  return &CoreModule::module->objectIcon;
+  return &CoreModule::current().objectIcon;
 }
 
 SimRobotCore2::Renderer* SimObject::createRenderer()
@@ -12,8 +12,10 @@
 #include "Tools/Math/Pose3f.h"
 #include "Tools/Math/RotationMatrix.h"
 #include <QString>
-#include <list>
 #include <string>
+#include <vector>
+
+class CoreModule;
 
 /**
  * @class SimObject
@@ -24,7 +26,7 @@ class SimObject : public ElementCore2
 public:
   QString fullName; /**< The path name to the object in the scene graph */
   std::string name; /**< The name of the scene graph object (without path) */
-  std::list<SimObject*> children; /**< List of subordinate scene graph objects */
+  std::vector<SimObject*> children; /**< List of subordinate scene graph objects */
   Vector3f* translation = nullptr; /**< The initial translational offset relative to the origin of the parent object */
   RotationMatrix* rotation = nullptr; /**< The initial rotational offset relative to the origin of the parent object */
   Pose3f poseInParent; /**< The (updated) offset relative to the origin of the parent object */
@@ -32,8 +34,18 @@ public:
   /** Destructor */
   ~SimObject();
 
-  /** Registers this object with children, actuators and sensors at SimRobot's GUI */
-  virtual void registerObjects();
+  /**
+   * Registers this object with children, actuators and sensors at SimRobot's GUI
+   * @param module The module that owns the simulation
+   */
+  virtual void registerObjects(CoreModule& module);
+
+  /**
+   * Names a child object and registers it (including its children, actuators and sensors) at SimRobot's GUI
+   * @param module The module that owns the simulation
+   * @param child The child object
+   */
+  void registerChild(CoreModule& module, SimObject& child);
 
 protected:
   /**
@@ -5,13 +5,14 @@
  */
 
 #include "Simulation.h"
-#include "CoreModule.h"
 #include "Graphics/Primitives.h"
 #include "Parser/ElementCore2.h"
 #include "Parser/ParserCore2.h"
+#include "Parser/SceneCache.h"
 #include "Platform/Assert.h"
 #include "Platform/System.h"
 #include "Simulation/Body.h"
+#include "Simulation/GraphicalObject.h"
 #include "Simulation/Geometries/Geometry.h"
 #include "Simulation/Geometries/TorusGeometry.h"
 #include "Simulation/Scene.h"
@@ -21,22 +22,29 @@
 #include <ode/objects.h>
 #include <ode/odeinit.h>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstring>
+#include <mutex>
+#include <typeinfo>
+#include <unordered_set>
 #ifdef MULTI_THREADING
 #include <ode/threading_impl.h>
 #include <thread>
 #endif
 
-Simulation* Simulation::simulation = nullptr;
+thread_local Simulation* Simulation::simulation = nullptr;
 
-Simulation::Simulation()
-{
-  ASSERT(!simulation);
-  simulation = this;
-}
+/** The number of simulations that use ODE (ODE is initialized by the first and closed by the last one). */
+static unsigned int odeUsers = 0;
+static std::mutex odeUsersMutex;
 
 Simulation::~Simulation()
 {
+  // the elements might refer to the current simulation while they are deleted
+  Simulation* const previous = simulation == this ? nullptr : simulation;
+  simulation = this;
+
   for(ElementCore2* element : elements)
     delete element;
 
@@ -54,11 +62,14 @@ Simulation::~Simulation()
     dThreadingFreeImplementation(threading);
 #endif
     dWorldDestroy(physicalWorld);
-    dCloseODE();
+
+    std::lock_guard<std::mutex> lock(odeUsersMutex);
+    ASSERT(odeUsers > 0);
+    if(--odeUsers == 0)
+      dCloseODE();
   }
 
-  ASSERT(simulation == this);
-  simulation = nullptr;
+  simulation = previous;
 }
 
 bool Simulation::loadFile(const std::string& filename, std::list<std::string>& errors)
@@ -66,29 +77,65 @@ bool Simulation::loadFile(const std::string& filename, std::list<std::string>& e
   ASSERT(!scene);
   ASSERT(elements.empty());
 
-  ParserCore2 parser;
-  if(!parser.parse(filename, errors))
+  const Scope scope(*this);
+
+  loadPhases.clear();
+  auto phaseStart = std::chrono::steady_clock::now();
+  const auto endPhase = [this, &phaseStart](const char* name)
+  {
+    const auto now = std::chrono::steady_clock::now();
+    loadPhases.emplace_back(name, std::chrono::duration<double, std::milli>(now - phaseStart).count());
+    phaseStart = now;
+  };
+
+  const auto deleteElements = [this]
+  {
+    for(ElementCore2* element : elements)
+      delete element;
+    elements.clear();
+    elementArena.clear();
+    scene = nullptr;
+  };
+
+  bool parsed = ParserCore2().parse(filename, errors, &compiledScene);
+
+  // If the data derived from the scene does not match the compiled scene, the cache is not trusted at all.
+  if(parsed && compiledScene.cache && compiledScene.cache->isLoaded() && !checkCachedBodyMasses())
+  {
+    deleteElements();
+    parsed = ParserCore2().parse(filename, errors, &compiledScene, false);
+  }
+  endPhase("parse");
+  if(!parsed)
   {
     if(scene)
-    {
-      for(ElementCore2* element : elements)
-        delete element;
-      elements.clear();
-      scene = nullptr;
-    }
+      deleteElements();
     return false;
   }
 
   ASSERT(scene);
 
-  dInitODE();
+  // Data that was derived from the scene when the cache was recorded replaces computing it again.
+  SceneCache* const sceneCache = compiledScene.cache.get();
+  const bool loadedFromCache = sceneCache && sceneCache->isLoaded();
+  cachedBodyMasses = loadedFromCache ? sceneCache->getSection("body masses") : std::string_view();
+  recordedBodyMasses.clear();
+
+  {
+    std::lock_guard<std::mutex> lock(odeUsersMutex);
+    if(odeUsers++ == 0)
+    {
+      dInitODE2(0);
+      TorusGeometry::registerGeometryClass();
+    }
+  }
+  dAllocateODEDataForThread(dAllocateMaskAll);
   physicalWorld = dWorldCreate();
   rootSpace = dHashSpaceCreate(nullptr);
   staticSpace = dHashSpaceCreate(rootSpace);
   movableSpace = dHashSpaceCreate(rootSpace);
   contactGroup = dJointGroupCreate(0);
 
-  TorusGeometry::registerGeometryClass();
   dWorldSetGravity(physicalWorld, REAL(0.), REAL(0.), static_cast<dReal>(scene->gravity));
   if(scene->erp != -1.f)
     dWorldSetERP(physicalWorld, scene->erp);
@@ -103,9 +150,12 @@ bool Simulation::loadFile(const std::string& filename, std::list<std::string>& e
   dWorldSetStepThreadingImplementation(physicalWorld, dThreadingImplementationGetFunctions(threading), threading);
 #endif
 
+  endPhase("create world");
+
   graphicsContext.pushModelMatrixStack();
   scene->createPhysics(graphicsContext);
   graphicsContext.popModelMatrixStack();
+  endPhase("create physics");
 
   graphicsContext.pushModelMatrixStack();
   scene->createGraphics(graphicsContext);
@@ -137,15 +187,449 @@ bool Simulation::loadFile(const std::string& filename, std::list<std::string>& e
   graphicsContext.popModelMatrix();
   graphicsContext.popModelMatrixStack();
 
+  endPhase("create graphics");
+
+  // The meshes of the appearances are built in parallel now that all buffers are registered.
+  const bool buffersRestored = loadedFromCache && graphicsContext.restoreBuffers(sceneCache->getSection("graphics buffers"));
+  if(!buffersRestored)
+    graphicsContext.fillBuffers();
+  endPhase("build meshes");
+
   graphicsContext.compile();
+  endPhase("compile graphics");
+
+  // The cache is saved again if it lacked derived data, e.g. because the scene was reloaded in place before.
+  if(sceneCache && (!buffersRestored || cachedBodyMasses.size() != 0 || recordedBodyMasses.size() != sceneCache->getSection("body masses").size()))
+  {
+    std::string buffers;
+    graphicsContext.saveBuffers(buffers);
+    sceneCache->setSection("graphics buffers", std::move(buffers));
+    sceneCache->setSection("body masses", std::move(recordedBodyMasses));
+    sceneCache->save(compiledScene.cacheFileName);
+    endPhase("save scene cache");
+  }
+  cachedBodyMasses = std::string_view();
+  recordedBodyMasses.clear();
+  compiledScene.cache.reset();
 
   graphicsContext.initOffscreenRenderer();
+  endPhase("init offscreen renderer");
+
+  return true;
+}
+
+bool Simulation::checkCachedBodyMasses() const
+{
+  // A cache without masses (e.g. saved after the scene was reloaded in place) only lacks them.
+  const std::size_t size = compiledScene.cache->getSection("body masses").size();
+  const auto bodies = std::count_if(compiledScene.elements.begin(), compiledScene.elements.end(), [](const Element* element)
+  {
+    return dynamic_cast<const Body*>(element) != nullptr;
+  });
+  return size == 0 || size == static_cast<std::size_t>(bodies) * bodyMassRecordSize;
+}
+
+bool Simulation::restoreBodyMass(dMass& mass, Vector3f& centerOfMass)
+{
+  if(cachedBodyMasses.size() < bodyMassRecordSize)
+    return false;
+  std::memcpy(&mass, cachedBodyMasses.data(), sizeof(dMass));
+  std::memcpy(centerOfMass.data(), cachedBodyMasses.data() + sizeof(dMass), sizeof(Vector3f));
+  cachedBodyMasses.remove_prefix(bodyMassRecordSize);
+  return true;
+}
+
+void Simulation::recordBodyMass(const dMass& mass, const Vector3f& centerOfMass)
+{
+  recordedBodyMasses.append(reinterpret_cast<const char*>(&mass), sizeof(dMass));
+  recordedBodyMasses.append(reinterpret_cast<const char*>(centerOfMass.data()), sizeof(Vector3f));
+}
+
+namespace
+{
+  /**
+   * Finds out which elements of a modified version of a scene correspond to which elements of the loaded version.
+   * Corresponding elements have the same structure, but their attributes might differ, so they have to be updated.
+   * Bodies of the scene and of compounds do not need a counterpart. They are added, removed or instantiated again instead.
+   */
+  class SceneDiff
+  {
+  public:
+    static constexpr std::uint32_t none = 0xffffffff; /**< The index of a missing counterpart. */
+
+    std::vector<std::uint32_t> oldIndices; /**< The index of the corresponding old element of each new element (or \c none). */
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> updates; /**< The old and new indices of the elements that are updated. */
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> addedBodies; /**< The new indices of the bodies that are instantiated and the old indices of the bodies they replace (or \c none), in the order of instantiation. */
+    std::vector<std::uint32_t> removedBodies; /**< The old indices of the bodies that are removed without replacement. */
+    bool massChanged = false; /**< Whether a mass is updated. */
+
+    /**
+     * Constructor
+     * @param oldStructure The structure of the loaded version of the scene
+     * @param oldElements The elements of the loaded version of the scene
+     * @param newStructure The structure of the modified version of the scene
+     * @param newElements The elements of the modified version of the scene
+     */
+    SceneDiff(const SceneCache::Structure& oldStructure, const std::vector<Element*>& oldElements,
+              const SceneCache::Structure& newStructure, const std::vector<Element*>& newElements) :
+      oldIndices(newStructure.elements.size(), none), oldStructure(oldStructure), oldElements(oldElements),
+      newStructure(newStructure), newElements(newElements) {}
+
+    /**
+     * Compares both versions of the scene
+     * @return Whether the loaded version can be turned into the modified one
+     */
+    bool compare()
+    {
+      if(oldStructure.roots.size() != newStructure.roots.size())
+        return false;
+      for(std::size_t i = 0; i < newStructure.roots.size(); ++i)
+        if(!match(oldStructure.roots[i], newStructure.roots[i]))
+          return false;
+
+      // Elements that are kept must reuse the counterparts of the elements they reused before (bodies are never reused).
+      std::vector<std::uint32_t> oldReused, newReused;
+      for(std::uint32_t newIndex = 0; newIndex < oldIndices.size(); ++newIndex)
+        if(oldIndices[newIndex] != none)
+        {
+          getReused(oldStructure.elements[oldIndices[newIndex]], oldReused);
+          getReused(newStructure.elements[newIndex], newReused);
+          if(oldReused.size() != newReused.size())
+            return false;
+          for(std::size_t i = 0; i < newReused.size(); ++i)
+            if(oldIndices[newReused[i]] != oldReused[i])
+              return false;
+        }
+
+      std::sort(updates.begin(), updates.end());
+      updates.erase(std::unique(updates.begin(), updates.end()), updates.end());
+      for(const auto& [oldIndex, newIndex] : updates)
+        massChanged |= static_cast<ElementCore2*>(oldElements[oldIndex])->kind == ElementCore2::massKind;
+      std::sort(addedBodies.begin(), addedBodies.end());
+      return true;
+    }
+
+  private:
+    using Node = SceneCache::Structure::Element;
+    using Child = SceneCache::Structure::Child;
+
+    const SceneCache::Structure& oldStructure; /**< The structure of the loaded version of the scene. */
+    const std::vector<Element*>& oldElements; /**< The elements of the loaded version of the scene. */
+    const SceneCache::Structure& newStructure; /**< The structure of the modified version of the scene. */
+    const std::vector<Element*>& newElements; /**< The elements of the modified version of the scene. */
+    std::vector<std::uint32_t> mapped; /**< The new indices in \c oldIndices that were set (in that order), so that they can be reset again. */
+
+    /**
+     * Makes two elements counterparts of each other
+     * @param oldIndex The index of the old element
+     * @param newIndex The index of the new element
+     */
+    void map(std::uint32_t oldIndex, std::uint32_t newIndex)
+    {
+      oldIndices[newIndex] = oldIndex;
+      mapped.push_back(newIndex);
+    }
+
+    /**
+     * Matches an element and its children
+     * @param oldIndex The index of the old element
+     * @param newIndex The index of the new element
+     * @return Whether the old element can be turned into the new one
+     */
+    bool match(std::uint32_t oldIndex, std::uint32_t newIndex)
+    {
+      const Node& oldNode = oldStructure.elements[oldIndex];
+      const Node& newNode = newStructure.elements[newIndex];
+      if(oldNode.name != newNode.name)
+        return false;
+
+      // Unchanged elements correspond including all of their children.
+      if(oldNode.hash == newNode.hash && oldNode.end - oldIndex == newNode.end - newIndex)
+      {
+        for(std::uint32_t i = 0; i < newNode.end - newIndex; ++i)
+          map(oldIndex + i, newIndex + i);
+        return true;
+      }
+
+      map(oldIndex, newIndex);
+      if(oldNode.ownHash != newNode.ownHash && !addUpdate(oldIndex, newIndex))
+        return false;
+      if(newNode.name == "Scene" || newNode.name == "Compound")
+        return matchGroup(oldNode, newNode);
+      return matchChildren(oldNode.children, newNode.children);
+    }
+
+    /**
+     * Matches children that must correspond one by one
+     * @param oldChildren The children of the old element
+     * @param newChildren The children of the new element
+     * @return Whether the old children can be turned into the new ones
+     */
+    bool matchChildren(const std::vector<Child>& oldChildren, const std::vector<Child>& newChildren)
+    {
+      if(oldChildren.size() != newChildren.size())
+        return false;
+      for(std::size_t i = 0; i < newChildren.size(); ++i)
+        if(oldChildren[i].reused != newChildren[i].reused ||
+           (!newChildren[i].reused && !match(oldChildren[i].index, newChildren[i].index)))
+          return false;
+      return true;
+    }
+
+    /**
+     * Matches the children of the scene or of a compound, whose bodies can be added, removed or instantiated again
+     * @param oldNode The old element
+     * @param newNode The new element
+     * @return Whether the old children can be turned into the new ones
+     */
+    bool matchGroup(const Node& oldNode, const Node& newNode)
+    {
+      std::vector<std::uint32_t> oldBodies;
+      std::vector<Child> oldOthers, newOthers;
+      for(const Child& child : oldNode.children)
+        if(!child.reused && oldStructure.elements[child.index].name == "Body")
+          oldBodies.push_back(child.index);
+        else
+          oldOthers.push_back(child);
+
+      // Bodies correspond if they have the same name (in their order if several have the same name).
+      for(const Child& child : newNode.children)
+      {
+        const Node& newBody = newStructure.elements[child.index];
+        if(child.reused || newBody.name != "Body")
+        {
+          newOthers.push_back(child);
+          continue;
+        }
+        const auto oldBody = std::find_if(oldBodies.begin(), oldBodies.end(), [&](std::uint32_t oldIndex)
+        {
+          return oldIndex != none && oldStructure.elements[oldIndex].nameAttribute == newBody.nameAttribute;
+        });
+        if(oldBody == oldBodies.end())
+        {
+          addedBodies.emplace_back(child.index, none);
+          continue;
+        }
+
+        // A body that cannot be turned into the new one is instantiated again.
+        const std::size_t mappedCount = mapped.size();
+        const std::size_t updateCount = updates.size();
+        if(!match(*oldBody, child.index))
+        {
+          for(std::size_t i = mappedCount; i < mapped.size(); ++i)
+            oldIndices[mapped[i]] = none;
+          mapped.resize(mappedCount);
+          updates.resize(updateCount);
+          addedBodies.emplace_back(child.index, *oldBody);
+        }
+        *oldBody = none;
+      }
+      for(std::uint32_t oldIndex : oldBodies)
+        if(oldIndex != none)
+          removedBodies.push_back(oldIndex);
+
+      return matchChildren(oldOthers, newOthers);
+    }
+
+    /**
+     * Adds an update of an element whose attributes or text changed
+     * @param oldIndex The index of the old element
+     * @param newIndex The index of the new element
+     * @return Whether the element can be updated
+     */
+    bool addUpdate(std::uint32_t oldIndex, std::uint32_t newIndex)
+    {
+      // Changes of elements that only modify their parent (e.g. <Translation>) are changes of that parent.
+      while(!oldElements[oldIndex] || !newElements[newIndex])
+      {
+        oldIndex = oldStructure.elements[oldIndex].parent;
+        newIndex = newStructure.elements[newIndex].parent;
+        if(oldIndex == SceneCache::noParent || newIndex == SceneCache::noParent)
+          return false;
+      }
+
+      auto* element = dynamic_cast<ElementCore2*>(oldElements[oldIndex]);
+      auto* newElement = dynamic_cast<ElementCore2*>(newElements[newIndex]);
+      if(!element || !newElement || typeid(*element) != typeid(*newElement) || !element->canUpdate(*newElement))
+        return false;
+      updates.emplace_back(oldIndex, newIndex);
+
+      // A mass is part of the masses that contain it.
+      const std::uint32_t oldParent = oldStructure.elements[oldIndex].parent;
+      if(element->kind == ElementCore2::massKind && oldParent != SceneCache::noParent && oldElements[oldParent] &&
+         static_cast<ElementCore2*>(oldElements[oldParent])->kind == ElementCore2::massKind)
+        return addUpdate(oldParent, newStructure.elements[newIndex].parent);
+      return true;
+    }
+
+    /**
+     * Collects the indices of the elements that an element reuses
+     * @param node The element
+     * @param reused Is filled with the indices
+     */
+    static void getReused(const Node& node, std::vector<std::uint32_t>& reused)
+    {
+      reused.clear();
+      for(const Child& child : node.children)
+        if(child.reused)
+          reused.push_back(child.index);
+    }
+  };
+}
+
+bool Simulation::reloadFile(const std::string& filename, std::list<std::string>& errors)
+{
+  ASSERT(scene);
+
+  Simulation newSimulation;
+  Parser::CompiledScene newCompiledScene;
+  {
+    const Scope scope(newSimulation);
+    ParserCore2 parser;
+    if(!parser.parse(filename, errors, &newCompiledScene))
+      return false;
+  }
+
+  // Files that elements loaded (e.g. meshes) are not part of the compiled scene, so a change of one requires a full reload.
+  if(newCompiledScene.dataFiles != compiledScene.dataFiles)
+    return false;
+
+  SceneCache::Structure structure, newStructure;
+  if(!SceneCache::analyze(compiledScene.events, structure) || !SceneCache::analyze(newCompiledScene.events, newStructure) ||
+     structure.elements.size() != compiledScene.elements.size() || newStructure.elements.size() != newCompiledScene.elements.size())
+    return false;
+
+  SceneDiff diff(structure, compiledScene.elements, newStructure, newCompiledScene.elements);
+  if(!diff.compare())
+    return false;
 
+  // A changed mass changes the mass of all bodies that are kept and use it, which must keep their centers of mass.
+  std::vector<std::pair<Body*, dMass>> massUpdates;
+  if(diff.massChanged)
+    for(std::size_t i = 0; i < newStructure.elements.size(); ++i)
+    {
+      auto* element = diff.oldIndices[i] != SceneDiff::none ? static_cast<ElementCore2*>(compiledScene.elements[diff.oldIndices[i]]) : nullptr;
+      if(element && element->kind == ElementCore2::bodyKind)
+      {
+        auto* body = static_cast<Body*>(element);
+        massUpdates.emplace_back(body, dMass());
+        if(!body->canUpdateMass(*static_cast<Body*>(newCompiledScene.elements[i]), massUpdates.back().second))
+          return false;
+      }
+    }
+
+  const Scope scope(*this);
+  for(const auto& [index, newIndex] : diff.updates)
+    static_cast<ElementCore2*>(compiledScene.elements[index])->update(*static_cast<ElementCore2*>(newCompiledScene.elements[newIndex]));
+  for(const auto& [body, mass] : massUpdates)
+    body->updateMass(mass);
+
+  // Bodies that are removed or replaced are taken out of the simulation. Their elements are only deleted with the simulation.
+  std::unordered_set<const Pose3f*> removedPoses;
+  const auto removeBody = [&](std::uint32_t index, bool replaced)
+  {
+    auto* body = static_cast<Body*>(compiledScene.elements[index]);
+    removingObject(*body);
+    if(!replaced)
+    {
+      ::PhysicalObject* parent = body->parent;
+      parent->children.erase(std::find(parent->children.begin(), parent->children.end(), body));
+      parent->physicalChildren.erase(std::find(parent->physicalChildren.begin(), parent->physicalChildren.end(), body));
+      scene->bodies.remove(body);
+    }
+    static_cast<::PhysicalObject*>(body)->destroyPhysics();
+
+    std::unordered_set<const ::PhysicalObject*> physicalObjects;
+    std::unordered_set<const GraphicalObject*> graphicalObjects;
+    for(std::uint32_t i = index; i < structure.elements[index].end; ++i)
+      if(compiledScene.elements[i])
+      {
+        physicalObjects.insert(dynamic_cast<::PhysicalObject*>(compiledScene.elements[i]));
+        graphicalObjects.insert(dynamic_cast<GraphicalObject*>(compiledScene.elements[i]));
+        if(static_cast<ElementCore2*>(compiledScene.elements[i])->kind == ElementCore2::bodyKind)
+          removedPoses.insert(&static_cast<Body*>(compiledScene.elements[i])->poseInParent);
+      }
+    const std::size_t drawingCount = scene->controllerDrawings.size();
+    std::erase_if(scene->controllerDrawings, [&](const Scene::ControllerDrawing& drawing)
+    {
+      return physicalObjects.contains(drawing.physicalObject) || graphicalObjects.contains(drawing.graphicalObject);
+    });
+    if(scene->controllerDrawings.size() != drawingCount)
+      ++scene->controllerDrawingsRevision;
+  };
+  for(std::uint32_t index : diff.removedBodies)
+    removeBody(index, false);
+  for(const auto& [newIndex, index] : diff.addedBodies)
+    if(index != SceneDiff::none)
+      removeBody(index, true);
+
+  // The new bodies are instantiated from the compiled scene as children of the elements that are kept.
+  std::vector<Element*> liveElements(newStructure.elements.size());
+  for(std::size_t i = 0; i < liveElements.size(); ++i)
+    if(diff.oldIndices[i] != SceneDiff::none)
+      liveElements[i] = compiledScene.elements[diff.oldIndices[i]];
+  std::vector<std::pair<::PhysicalObject*, Body*>> addedBodies;
+  for(const auto& [newIndex, index] : diff.addedBodies)
+  {
+    auto* parent = dynamic_cast<::PhysicalObject*>(liveElements[newStructure.elements[newIndex].parent]);
+    ASSERT(parent);
+    // The events were parsed successfully before, so instantiating them cannot fail.
+    ParserCore2 parser;
+    VERIFY(parser.instantiate(filename, newCompiledScene.events, newStructure, newIndex, *parent, liveElements, errors));
+    auto* body = static_cast<Body*>(liveElements[newIndex]);
+
+    body->poseInWorld = parent->poseInWorld;
+    if(body->translation)
+      body->poseInWorld.translate(*body->translation);
+    if(body->rotation)
+      body->poseInWorld.rotate(*body->rotation);
+    body->parentBody = nullptr;
+    graphicsContext.pushModelMatrixStack();
+    static_cast<::PhysicalObject*>(body)->createPhysics(graphicsContext);
+    graphicsContext.popModelMatrixStack();
+
+    // A body that replaces another one takes its place.
+    if(index != SceneDiff::none)
+    {
+      auto* oldBody = static_cast<Body*>(compiledScene.elements[index]);
+      ASSERT(parent->children.back() == body && parent->physicalChildren.back() == body && scene->bodies.back() == body);
+      parent->children.pop_back();
+      std::replace(parent->children.begin(), parent->children.end(), static_cast<SimObject*>(oldBody), static_cast<SimObject*>(body));
+      parent->physicalChildren.pop_back();
+      std::replace(parent->physicalChildren.begin(), parent->physicalChildren.end(), static_cast<::PhysicalObject*>(oldBody), static_cast<::PhysicalObject*>(body));
+      scene->bodies.pop_back();
+      std::replace(scene->bodies.begin(), scene->bodies.end(), oldBody, body);
+    }
+
+    graphicsContext.pushModelMatrixStack();
+    body->createGraphics(graphicsContext);
+    graphicsContext.popModelMatrixStack();
+    addedBodies.emplace_back(parent, body);
+  }
+
+  if(!diff.removedBodies.empty() || !diff.addedBodies.empty())
+  {
+    // The geometries and meshes of removed bodies stay in the buffers until the scene is loaded again.
+    graphicsContext.releaseModelMatrices(removedPoses);
+    graphicsContext.recompile();
+    for(const auto& [parent, body] : addedBodies)
+      addedObject(*parent, *body);
+    scene->lastTransformationUpdateStep = simulationStep - 1; // enforce transformation update
+  }
+  recordedBodyMasses.clear();
+
+  compiledScene.elements.swap(liveElements);
+  compiledScene.events.swap(newCompiledScene.events);
+
+  // Only the events were recorded, so the next time the scene is loaded, the data derived from it is added to the cache.
+  if(newCompiledScene.cache && !newCompiledScene.cache->isLoaded())
+    newCompiledScene.cache->save(newCompiledScene.cacheFileName);
   return true;
 }
 
 void Simulation::doSimulationStep()
 {
+  ASSERT(simulation == this);
   ++simulationStep;
   simulatedTime += scene->stepLength;
 
@@ -302,9 +786,20 @@ void Simulation::updateFrameRate()
   }
 }
 
-void Simulation::registerObjects()
+const GeometryBVH& Simulation::getGeometryBVH()
+{
+  std::lock_guard<std::mutex> lock(geometryBVHMutex);
+  if(lastGeometryBVHUpdateStep != simulationStep)
+  {
+    lastGeometryBVHUpdateStep = simulationStep;
+    geometryBVH.update();
+  }
+  return geometryBVH;
+}
+
+void Simulation::invalidateGeometryBVH()
 {
-  scene->fullName = scene->name.c_str();
-  CoreModule::application->registerObject(*CoreModule::module, *scene, 0);
-  scene->registerObjects();
+  std::lock_guard<std::mutex> lock(geometryBVHMutex);
+  geometryBVH.invalidate();
+  lastGeometryBVHUpdateStep = 0xffffffff;
 }
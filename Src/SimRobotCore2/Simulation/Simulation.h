@@ -7,17 +7,30 @@
 #pragma once
 
 #include "Graphics/GraphicsContext.h"
+#include "Parser/Parser.h"
 #include "Simulation/Appearances/ComplexAppearance.h"
+#include "Simulation/GeometryBVH.h"
+#include "Simulation/Sensors/DistanceQueries.h"
+#include "Simulation/SpatialQueries.h"
+#include "Tools/Arena.h"
 #include <string>
+#include <string_view>
 #include <list>
+#include <map>
+#include <mutex>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 #include <ode/common.h>
+#include <ode/mass.h>
 #ifdef MULTI_THREADING
 #include <ode/threading.h>
 #endif
 
 class Scene;
 class ElementCore2;
+class SimObject;
 
 /**
  * @class Simulation
@@ -26,10 +39,25 @@ class ElementCore2;
 class Simulation
 {
 public:
-  static Simulation* simulation;
+  static thread_local Simulation* simulation; /**< The simulation that is currently processed by the calling thread */
+
+  /**
+   * @class Scope
+   * Makes a simulation the current one of the calling thread for the lifetime of this object
+   */
+  class Scope
+  {
+  public:
+    explicit Scope(Simulation& simulation) : previous(Simulation::simulation) {Simulation::simulation = &simulation;}
+    ~Scope() {Simulation::simulation = previous;}
+
+  private:
+    Simulation* previous; /**< The simulation that was current before */
+  };
 
   Scene* scene = nullptr; /**< The root of the scene graph */
-  std::list<ElementCore2*> elements; /**< All scene graph elements */
+  std::vector<ElementCore2*> elements; /**< All scene graph elements */
+  Arena elementArena; /**< The memory of the scene graph elements */
 
   dWorldID physicalWorld = nullptr; /**< The physical world */
   dSpaceID rootSpace = nullptr; /**< The root collision space */
@@ -57,34 +85,100 @@ public:
   Pose3f dragPlanePose; /**< Pose of the drag plane (assuming it is not possible to drag simultaneously in multiple renderers). */
   std::vector<GraphicsContext::Surface*> bodySurfaces; /**< The special surfaces for each body, used by \c ObjectSegmentedImageSensor. */
   std::unordered_map<ComplexAppearance::Descriptor, GraphicsContext::Mesh*, ComplexAppearance::Hasher> complexAppearanceMeshCache; /**< The cache for meshes generated by complex appearances. */
+  std::map<std::tuple<std::string, float, bool>, GraphicsContext::Mesh*> meshAppearanceMeshCache; /**< The cache for meshes generated by mesh appearances (file, unit, textured). */
+  DistanceQueries distanceQueries; /**< The queries of all distance sensors, answered together once per step. */
+  SpatialQueries spatialQueries; /**< The spatial queries of controllers. */
 
   unsigned int currentFrameRate = 0; /**< The current frame rate of the simulation */
+  std::vector<std::pair<const char*, double>> loadPhases; /**< The durations (in ms) of the phases of the last call to \c loadFile */
 
   /** Default Constructor. */
-  Simulation();
+  Simulation() = default;
 
   /** Destructor. */
   virtual ~Simulation();
 
   /**
-   * Loads a file and initializes the simulation
+   * Loads a file and initializes the simulation.
+   * This must be called on the GUI thread, since it creates the offscreen renderer.
    * @param filename The name of the file
    * @param errors The errors that occured during parsing.
    */
   bool loadFile(const std::string& filename, std::list<std::string>& errors);
 
-  /** Executes one simulation step */
+  /**
+   * Applies the changes of a modified version of the loaded file to the running simulation.
+   * Elements that changed are updated if they support it (see \c ElementCore2::canUpdate). Bodies of the scene or of
+   * compounds that were added or removed or that changed otherwise are added, removed or instantiated again, while all
+   * other bodies keep their state. If anything else changed (e.g. a compound), nothing is changed and the simulation
+   * has to be reloaded completely.
+   * @param filename The name of the file
+   * @param errors The errors that occured during parsing.
+   * @return Whether the changes were applied.
+   */
+  bool reloadFile(const std::string& filename, std::list<std::string>& errors);
+
+  /** Executes one simulation step. This simulation must be the current one of the calling thread. */
   void doSimulationStep();
   unsigned int simulationStep = 0;
   double simulatedTime = 0;
   unsigned int collisions = 0;
   unsigned int contactPoints = 0;
 
-  /** Registers all objects of the simulation (including children, actuators and sensors) at SimRobot's GUI */
-  void registerObjects();
+  /** Makes the next call to \c getGeometryBVH collect the geometries again. Called whenever collision geometries are created or destroyed. */
+  void invalidateGeometryBVH();
+
+  /**
+   * Provides the mass of the next body that is created if the scene was loaded from its scene cache.
+   * @param mass Is filled with the mass of the body (at its center of mass).
+   * @param centerOfMass Is filled with the center of mass relative to the body.
+   * @return Whether the mass was cached (otherwise, the body has to compute it).
+   */
+  bool restoreBodyMass(dMass& mass, Vector3f& centerOfMass);
+
+  /**
+   * Records the mass of a body that was created, so it can be stored in the scene cache.
+   * @param mass The mass of the body (at its center of mass).
+   * @param centerOfMass The center of mass relative to the body.
+   */
+  void recordBodyMass(const dMass& mass, const Vector3f& centerOfMass);
+
+protected:
+  /**
+   * Called by \c reloadFile before an object (including its children) is removed from the scene graph.
+   * @param object The object
+   */
+  virtual void removingObject(SimObject& object) {static_cast<void>(object);}
+
+  /**
+   * Called by \c reloadFile after an object (including its children) was added to the scene graph.
+   * @param parent The object the new object was added to
+   * @param object The new object
+   */
+  virtual void addedObject(SimObject& parent, SimObject& object) {static_cast<void>(parent); static_cast<void>(object);}
 
 private:
+  static constexpr std::size_t bodyMassRecordSize = sizeof(dMass) + sizeof(Vector3f); /**< The size of the mass of a body in the scene cache */
+
+  Parser::CompiledScene compiledScene; /**< The compiled version of the loaded file, used to find out what changed when it is reloaded. */
+  std::string_view cachedBodyMasses; /**< The masses from the scene cache that have not been restored yet (while loading). */
+  std::string recordedBodyMasses; /**< The masses of all bodies in the order they were created (while loading). */
   dJointGroupID contactGroup = nullptr; /**< The joint group for temporary contact joints used for collision handling */
+  GeometryBVH geometryBVH; /**< The hierarchy over all collision geometries, shared by sensors and controller queries */
+  unsigned int lastGeometryBVHUpdateStep = 0xffffffff; /**< The simulation step in which \c geometryBVH was updated last */
+  std::mutex geometryBVHMutex; /**< Protects the update of \c geometryBVH when it is used from multiple threads */
+
+  /**
+   * Returns the bounding volume hierarchy over all collision geometries, brought up to date with the current simulation step
+   * @return The hierarchy
+   */
+  const GeometryBVH& getGeometryBVH();
+
+  /**
+   * Checks whether the scene cache of the loaded scene contains a mass for each body of the scene (or none at all)
+   * @return Whether the masses can be restored
+   */
+  bool checkCachedBodyMasses() const;
 
   /** Computes the frame rate of simulation */
   void updateFrameRate();
@@ -114,4 +208,7 @@ private:
    * @param geom2 The second geometry object for collision testing
    */
   static void staticCollisionSpaceWithSpaceCallback(Simulation *simulation, dGeomID geom1, dGeomID geom2);
+
+  friend class DistanceQueries;
+  friend class SpatialQueries;
 };
@@ -0,0 +1,195 @@
+/**
+ * @file Simulation/SpatialQueries.cpp
+ * Implementation of class SpatialQueries
+ */
+
+#include "SpatialQueries.h"
+#include "Simulation/Body.h"
+#include "Simulation/Geometries/Geometry.h"
+#include "Simulation/Simulation.h"
+#include "Platform/Assert.h"
+#include <ode/collision.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void SpatialQueries::castRays(const float* origins, const float* directions, const float* maxDistances, unsigned int count, float* distances, SimRobotCore2::Body** bodies)
+{
+  const GeometryBVH& bvh = Simulation::simulation->getGeometryBVH();
+  std::lock_guard<std::mutex> lock(mutex);
+  if(!rayGeom)
+    rayGeom = dCreateRay(Simulation::simulation->rootSpace, 1.f);
+
+  for(unsigned int i = 0; i < count; ++i)
+  {
+    Body* body;
+    distances[i] = castRay(bvh, Vector3f(origins[i * 3], origins[i * 3 + 1], origins[i * 3 + 2]),
+                           Vector3f(directions[i * 3], directions[i * 3 + 1], directions[i * 3 + 2]), maxDistances[i], body);
+    if(bodies)
+      bodies[i] = body;
+  }
+}
+
+float SpatialQueries::castRay(const GeometryBVH& bvh, const Vector3f& origin, const Vector3f& direction, float maxDistance, Body*& body)
+{
+  body = nullptr;
+  float distance = maxDistance;
+  const Vector3f invDirection = direction.cwiseInverse();
+  const std::vector<GeometryBVH::Node>& nodes = bvh.getNodes();
+  for(int i = 0; i < static_cast<int>(nodes.size());)
+  {
+    // the nodes are stored in depth-first order, so a subtree that is missed can be skipped without a stack
+    const GeometryBVH::Node& node = nodes[i];
+    const Vector3f t1 = (node.min - origin).cwiseProduct(invDirection);
+    const Vector3f t2 = (node.max - origin).cwiseProduct(invDirection);
+    if((node.min.array() > node.max.array()).any() ||
+       std::max(t1.cwiseMin(t2).maxCoeff(), 0.f) > std::min(t1.cwiseMax(t2).minCoeff(), distance))
+    {
+      i = node.skip;
+      continue;
+    }
+    ++i;
+    if(node.leaf < 0)
+      continue;
+
+    // closest point of the ray to each sphere center
+    const GeometryBVH::Leaf& leaf = bvh.getLeaves()[node.leaf];
+    const Eigen::Array4f dx = leaf.x - origin.x();
+    const Eigen::Array4f dy = leaf.y - origin.y();
+    const Eigen::Array4f dz = leaf.z - origin.z();
+    const Eigen::Array4f t = (dx * direction.x() + dy * direction.y() + dz * direction.z()).max(0.f).min(distance);
+    const Eigen::Array4f ex = dx - t * direction.x();
+    const Eigen::Array4f ey = dy - t * direction.y();
+    const Eigen::Array4f ez = dz - t * direction.z();
+    const Eigen::Array<bool, 4, 1> candidates = (leaf.outerRadius >= 0.f) && (ex * ex + ey * ey + ez * ez < leaf.outerRadius * leaf.outerRadius) &&
+                                                (t - leaf.outerRadius < distance);
+    if(!candidates.any())
+      continue;
+
+    for(int j = 0; j < GeometryBVH::leafSize; ++j)
+    {
+      if(!candidates[j])
+        continue;
+      dGeomRaySet(rayGeom, origin.x(), origin.y(), origin.z(), direction.x(), direction.y(), direction.z());
+      dGeomRaySetLength(rayGeom, distance);
+      dContactGeom contactGeoms[4];
+      const int contacts = dCollide(rayGeom, leaf.geoms[j], 4, contactGeoms, sizeof(dContactGeom));
+      for(int k = 0; k < contacts; ++k)
+        if(static_cast<float>(contactGeoms[k].depth) < distance)
+        {
+          distance = static_cast<float>(contactGeoms[k].depth);
+          body = leaf.geometries[j]->parentBody;
+        }
+    }
+  }
+  return distance;
+}
+
+void SpatialQueries::findBodiesInSpheres(const float* centers, const float* radii, unsigned int count, unsigned int maxBodies, SimRobotCore2::Body** bodies, unsigned int* numOfBodies)
+{
+  const GeometryBVH& bvh = Simulation::simulation->getGeometryBVH();
+  const std::vector<GeometryBVH::Node>& nodes = bvh.getNodes();
+  for(unsigned int i = 0; i < count; ++i)
+  {
+    const Vector3f center(centers[i * 3], centers[i * 3 + 1], centers[i * 3 + 2]);
+    const float radius = radii[i];
+    SimRobotCore2::Body** const found = bodies + i * maxBodies;
+    unsigned int& numOfFound = numOfBodies[i];
+    numOfFound = 0;
+    for(int j = 0; j < static_cast<int>(nodes.size()) && numOfFound < maxBodies;)
+    {
+      const GeometryBVH::Node& node = nodes[j];
+      if(squaredDistance(node, center) > radius * radius)
+      {
+        j = node.skip;
+        continue;
+      }
+      ++j;
+      if(node.leaf < 0)
+        continue;
+
+      const GeometryBVH::Leaf& leaf = bvh.getLeaves()[node.leaf];
+      const Eigen::Array4f dx = leaf.x - center.x();
+      const Eigen::Array4f dy = leaf.y - center.y();
+      const Eigen::Array4f dz = leaf.z - center.z();
+      const Eigen::Array4f maxDistance = leaf.outerRadius + radius;
+      const Eigen::Array<bool, 4, 1> hits = (leaf.outerRadius >= 0.f) && (dx * dx + dy * dy + dz * dz <= maxDistance * maxDistance);
+      for(int k = 0; k < GeometryBVH::leafSize && numOfFound < maxBodies; ++k)
+        if(hits[k] && leaf.geometries[k]->parentBody)
+        {
+          SimRobotCore2::Body* const body = leaf.geometries[k]->parentBody->rootBody;
+          if(std::find(found, found + numOfFound, body) == found + numOfFound)
+            found[numOfFound++] = body;
+        }
+    }
+  }
+}
+
+void SpatialQueries::findNearestBodies(const float* points, unsigned int count, unsigned int k, SimRobotCore2::Body** bodies, float* distances, unsigned int* numOfBodies)
+{
+  const GeometryBVH& bvh = Simulation::simulation->getGeometryBVH();
+  const std::vector<GeometryBVH::Node>& nodes = bvh.getNodes();
+  std::lock_guard<std::mutex> lock(mutex);
+  for(unsigned int i = 0; i < count; ++i)
+  {
+    const Vector3f point(points[i * 3], points[i * 3 + 1], points[i * 3 + 2]);
+    neighbors.clear();
+    for(int j = 0; j < static_cast<int>(nodes.size()) && k > 0;)
+    {
+      // nothing in a node can replace a neighbor if its box is farther away than the k-th closest body
+      const GeometryBVH::Node& node = nodes[j];
+      const float maxDistance = neighbors.size() < k ? std::numeric_limits<float>::infinity() : neighbors.back().distance;
+      if(squaredDistance(node, point) >= maxDistance * maxDistance)
+      {
+        j = node.skip;
+        continue;
+      }
+      ++j;
+      if(node.leaf < 0)
+        continue;
+
+      const GeometryBVH::Leaf& leaf = bvh.getLeaves()[node.leaf];
+      const Eigen::Array4f dx = leaf.x - point.x();
+      const Eigen::Array4f dy = leaf.y - point.y();
+      const Eigen::Array4f dz = leaf.z - point.z();
+      const Eigen::Array4f leafDistances = ((dx * dx + dy * dy + dz * dz).sqrt() - leaf.outerRadius).max(0.f);
+      for(int l = 0; l < GeometryBVH::leafSize; ++l)
+      {
+        if(leaf.outerRadius[l] < 0.f || !leaf.geometries[l]->parentBody)
+          continue;
+        Body* const body = leaf.geometries[l]->parentBody->rootBody;
+        const float distance = leafDistances[l];
+
+        // a body can have many geometries, but it is only listed with the closest one
+        auto neighbor = std::find_if(neighbors.begin(), neighbors.end(), [body](const Neighbor& neighbor) {return neighbor.body == body;});
+        if(neighbor != neighbors.end())
+        {
+          if(distance >= neighbor->distance)
+            continue;
+          neighbors.erase(neighbor);
+        }
+        else if(neighbors.size() == k)
+        {
+          if(distance >= neighbors.back().distance)
+            continue;
+          neighbors.pop_back();
+        }
+        neighbors.insert(std::upper_bound(neighbors.begin(), neighbors.end(), distance, [](float distance, const Neighbor& neighbor) {return distance < neighbor.distance;}),
+                         Neighbor{distance, body});
+      }
+    }
+
+    numOfBodies[i] = static_cast<unsigned int>(neighbors.size());
+    for(std::size_t j = 0; j < neighbors.size(); ++j)
+    {
+      bodies[i * k + j] = neighbors[j].body;
+      if(distances)
+        distances[i * k + j] = neighbors[j].distance;
+    }
+  }
+}
+
+float SpatialQueries::squaredDistance(const GeometryBVH::Node& node, const Vector3f& point)
+{
+  return (point.cwiseMax(node.min).cwiseMin(node.max) - point).squaredNorm();
+}
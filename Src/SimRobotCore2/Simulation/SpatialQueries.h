@@ -0,0 +1,88 @@
+/**
+ * @file Simulation/SpatialQueries.h
+ * Declaration of class SpatialQueries
+ */
+
+#pragma once
+
+#include "SimRobotCore2.h"
+#include "Simulation/GeometryBVH.h"
+#include <ode/common.h>
+#include <mutex>
+#include <vector>
+
+class Body;
+
+/**
+ * @class SpatialQueries
+ * Answers the ray, sphere and nearest neighbor queries of controllers using the bounding volume hierarchy over all
+ * collision geometries of the simulation. Each query of a batch traverses the hierarchy separately, but they share
+ * one update of the hierarchy per simulation step.
+ */
+class SpatialQueries
+{
+public:
+  /**
+   * Casts rays against the collision geometries
+   * @param origins The start points of the rays (3 floats per ray)
+   * @param directions The normalized directions of the rays (3 floats per ray)
+   * @param maxDistances The maximum length of each ray
+   * @param count The number of rays
+   * @param distances Is filled with the distance to the closest hit of each ray (or its maximum length)
+   * @param bodies Is filled with the body that was hit by each ray (\c nullptr if there is none). Can be \c nullptr.
+   */
+  void castRays(const float* origins, const float* directions, const float* maxDistances, unsigned int count, float* distances, SimRobotCore2::Body** bodies);
+
+  /**
+   * Finds the root bodies whose collision geometries are covered by spheres that overlap query spheres
+   * @param centers The centers of the query spheres (3 floats per sphere)
+   * @param radii The radii of the query spheres
+   * @param count The number of query spheres
+   * @param maxBodies The maximum number of bodies per query sphere
+   * @param bodies Is filled with up to \c maxBodies bodies per query sphere
+   * @param numOfBodies Is filled with the number of bodies found for each query sphere
+   */
+  void findBodiesInSpheres(const float* centers, const float* radii, unsigned int count, unsigned int maxBodies, SimRobotCore2::Body** bodies, unsigned int* numOfBodies);
+
+  /**
+   * Finds the root bodies closest to points
+   * @param points The points (3 floats per point)
+   * @param count The number of points
+   * @param k The maximum number of bodies per point
+   * @param bodies Is filled with up to \c k bodies per point, sorted by their distance
+   * @param distances Is filled with the distances of the bodies. Can be \c nullptr.
+   * @param numOfBodies Is filled with the number of bodies found for each point
+   */
+  void findNearestBodies(const float* points, unsigned int count, unsigned int k, SimRobotCore2::Body** bodies, float* distances, unsigned int* numOfBodies);
+
+private:
+  /** A body found by a nearest neighbor query */
+  struct Neighbor
+  {
+    float distance; /**< The distance to the closest covering sphere of a geometry of the body */
+    Body* body; /**< The root body */
+  };
+
+  dGeomID rayGeom = nullptr; /**< The ray used to test geometries (created on first use) */
+  std::vector<Neighbor> neighbors; /**< The closest bodies found so far by the current nearest neighbor query */
+  std::mutex mutex; /**< Protects the ray and the buffers when queries are issued from multiple threads */
+
+  /**
+   * Casts a single ray
+   * @param bvh The hierarchy over all geometries
+   * @param origin The start point of the ray
+   * @param direction The normalized direction of the ray
+   * @param maxDistance The maximum length of the ray
+   * @param body Is set to the body that was hit (\c nullptr if there is none)
+   * @return The distance to the closest hit (or \c maxDistance)
+   */
+  float castRay(const GeometryBVH& bvh, const Vector3f& origin, const Vector3f& direction, float maxDistance, Body*& body);
+
+  /**
+   * Returns the squared distance of a point to the box of a node
+   * @param node The node
+   * @param point The point
+   * @return The squared distance (0 if the point is inside)
+   */
+  static float squaredDistance(const GeometryBVH::Node& node, const Vector3f& point);
+};
@@ -11,12 +11,12 @@
 
 const QIcon* UserInput::InputPort::getIcon() const
 {
-  return &CoreModule::module->actuatorIcon;
+  return &CoreModule::current().actuatorIcon;
 }
 
 SimRobot::Widget* UserInput::InputPort::createWidget()
 {
-  CoreModule::module->application->openObject(CoreModule::module->actuatorsObject);
+  CoreModule::current().application.openObject(CoreModule::current().actuatorsObject);
   if(ActuatorsWidget::actuatorsWidget)
     ActuatorsWidget::actuatorsWidget->openActuator(fullName);
   return nullptr;
@@ -34,7 +34,7 @@ void UserInput::InputPort::setValue(float value)
 
 const QIcon* UserInput::OutputPort::getIcon() const
 {
-  return &CoreModule::module->sensorIcon;
+  return &CoreModule::current().sensorIcon;
 }
 
 SimRobot::Widget* UserInput::OutputPort::createWidget()
@@ -42,16 +42,16 @@ SimRobot::Widget* UserInput::OutputPort::createWidget()
   return new SensorWidget(this);
 }
 
-void UserInput::registerObjects()
+void UserInput::registerObjects(CoreModule& module)
 {
   inputPort.data.floatValue = inputPort.defaultValue;
   inputPort.fullName = fullName + ".value";
   outputPort.input = &inputPort;
-  CoreModule::application->registerObject(*CoreModule::module, inputPort, this);
-  CoreModule::application->registerObject(*CoreModule::module, outputPort, this);
+  module.application.registerObject(module, inputPort, this);
+  module.application.registerObject(module, outputPort, this);
 }
 
 const QIcon* UserInput::getIcon() const
 {
-  return &CoreModule::module->sliderIcon;
+  return &CoreModule::current().sliderIcon;
 }
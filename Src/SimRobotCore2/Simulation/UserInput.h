@@ -53,8 +53,11 @@ private:
     bool getMinAndMax(float& min, float& max) const override {return input->getMinAndMax(min, max);}
   } outputPort;
 
-  /** Registers this object with children, actuators and sensors at SimRobot's GUI */
-  void registerObjects() override;
+  /**
+   * Registers this object with children, actuators and sensors at SimRobot's GUI
+   * @param module The module that owns the simulation
+   */
+  void registerObjects(CoreModule& module) override;
 
   // API
   const QString& getFullName() const override {return SimObject::getFullName();}
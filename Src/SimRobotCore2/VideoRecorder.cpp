@@ -0,0 +1,366 @@
+/**
+ * @file VideoRecorder.cpp
+ * Implementation of class VideoRecorder
+ */
+
+#include "VideoRecorder.h"
+#include "CoreModule.h"
+#include "SimObjectRenderer.h"
+#include "Platform/Assert.h"
+#include "Simulation/Scene.h"
+#include <QDir>
+#include <QFile>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QImage>
+#include <QImageWriter>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QProcess>
+#include <QSettings>
+#include <QStandardPaths>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+/**
+ * Converts a frame into the planes of a YUV4MPEG2 frame (4:4:4 for RGB, 4:2:2 for YUYV, monochrome for grey).
+ * The rows of the frame are stored bottom-up, the rows of the planes top-down.
+ */
+static void convertToPlanes(const std::vector<unsigned char>& frame, int width, int height, int bytesPerPixel, std::vector<unsigned char>& planes)
+{
+  const std::size_t pixels = static_cast<std::size_t>(width) * height;
+  if(bytesPerPixel == 3)
+  {
+    planes.resize(pixels * 3);
+    unsigned char* y = planes.data(), * u = y + pixels, * v = u + pixels;
+    for(int row = height - 1; row >= 0; --row)
+      for(const unsigned char* src = frame.data() + static_cast<std::size_t>(row) * width * 3, * end = src + width * 3; src < end; src += 3)
+      {
+        const int r = src[0], g = src[1], b = src[2];
+        *y++ = static_cast<unsigned char>((19595 * r + 38470 * g + 7471 * b + 32768) >> 16);
+        *u++ = static_cast<unsigned char>(std::min(((-11059 * r - 21709 * g + 32768 * b + 32768) >> 16) + 128, 255));
+        *v++ = static_cast<unsigned char>(std::min(((32768 * r - 27439 * g - 5329 * b + 32768) >> 16) + 128, 255));
+      }
+  }
+  else if(bytesPerPixel == 2)
+  {
+    planes.resize(pixels * 2);
+    unsigned char* y = planes.data(), * u = y + pixels, * v = u + pixels / 2;
+    for(int row = height - 1; row >= 0; --row)
+      for(const unsigned char* src = frame.data() + static_cast<std::size_t>(row) * width * 2, * end = src + width * 2; src < end; src += 4)
+      {
+        *y++ = src[0];
+        *u++ = src[1];
+        *y++ = src[2];
+        *v++ = src[3];
+      }
+  }
+  else
+  {
+    planes.resize(pixels);
+    for(int row = 0; row < height; ++row)
+      std::memcpy(planes.data() + static_cast<std::size_t>(row) * width, frame.data() + static_cast<std::size_t>(height - 1 - row) * width, width);
+  }
+}
+
+/**
+ * Converts a frame into an image with the rows stored top-down.
+ */
+static QImage convertToImage(const std::vector<unsigned char>& frame, int width, int height, int bytesPerPixel)
+{
+  if(bytesPerPixel == 3)
+    return QImage(frame.data(), width, height, width * 3, QImage::Format_RGB888).mirrored();
+  else if(bytesPerPixel == 1)
+    return QImage(frame.data(), width, height, width, QImage::Format_Grayscale8).mirrored();
+
+  // Two pixels share their chroma
+  QImage image(width, height, QImage::Format_RGB32);
+  for(int row = 0; row < height; ++row)
+  {
+    QRgb* dest = reinterpret_cast<QRgb*>(image.scanLine(height - 1 - row));
+    const unsigned char* src = frame.data() + static_cast<std::size_t>(row) * width * 2;
+    for(int x = 0; x < width; x += 2, src += 4)
+    {
+      const int u = src[1] - 128;
+      const int v = src[3] - 128;
+      const int r = (91881 * v) >> 16;
+      const int g = (-22554 * u - 46802 * v) >> 16;
+      const int b = (116130 * u) >> 16;
+      for(int i = 0; i < 2; ++i)
+      {
+        const int luma = src[i * 2];
+        dest[x + i] = qRgb(std::clamp(luma + r, 0, 255), std::clamp(luma + g, 0, 255), std::clamp(luma + b, 0, 255));
+      }
+    }
+  }
+  return image;
+}
+
+VideoRecorder::VideoRecorder(SimObjectRenderer& view, int width, int height, int stepsPerFrame, const QString& fileName) :
+  renderer(std::make_unique<SimObjectRenderer>(view.getSimObject())), view(&view), width(width), height(height), stepsPerFrame(stepsPerFrame), fileName(fileName)
+{
+  GraphicsContext& graphicsContext = Simulation::simulation->graphicsContext;
+  graphicsContext.makeCurrent(width, height);
+  renderer->init();
+
+  QOpenGLFunctions_3_3_Core* f = graphicsContext.getOpenGLFunctions();
+  f->glGenBuffers(numOfPixelBuffers, pixelBuffers.data());
+  for(const GLuint pixelBuffer : pixelBuffers)
+  {
+    f->glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+    f->glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(getFrameSize()), nullptr, GL_STREAM_READ);
+  }
+  f->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  start();
+}
+
+VideoRecorder::VideoRecorder(SimRobotCore2::SensorPort& sensor, int stepsPerFrame, const QString& fileName) :
+  sensor(&sensor), stepsPerFrame(stepsPerFrame), fileName(fileName)
+{
+  const QList<int> dimensions = sensor.getDimensions();
+  ASSERT(sensor.getSensorType() == SimRobotCore2::SensorPort::cameraSensor && dimensions.size() >= 2);
+  width = dimensions[0];
+  height = dimensions[1];
+  const int bytesPerPixel = dimensions.size() > 2 ? dimensions[2] : 3;
+  pixelFormat = bytesPerPixel == 3 ? rgb : bytesPerPixel == 2 ? yuyv : grey;
+
+  start();
+}
+
+VideoRecorder::~VideoRecorder()
+{
+  std::vector<VideoRecorder*>& videoRecorders = CoreModule::current().videoRecorders;
+  videoRecorders.erase(std::find(videoRecorders.begin(), videoRecorders.end(), this));
+
+  if(renderer)
+  {
+    GraphicsContext& graphicsContext = Simulation::simulation->graphicsContext;
+    graphicsContext.makeCurrent(width, height);
+    while(numOfPendingPixelBuffers > 0)
+      readPixelBuffer();
+    graphicsContext.getOpenGLFunctions()->glDeleteBuffers(numOfPixelBuffers, pixelBuffers.data());
+    renderer->destroy();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  frameAvailable.notify_one();
+  encoder.join();
+}
+
+int VideoRecorder::getDefaultStepsPerFrame()
+{
+  return std::max(1, static_cast<int>(std::lround(1.0 / (25.0 * Simulation::simulation->scene->stepLength))));
+}
+
+void VideoRecorder::start()
+{
+  const QFileInfo fileInfo(fileName);
+  const QString suffix = fileInfo.suffix().toLower();
+  if(suffix == "y4m")
+    output = y4mFile;
+  else if(QImageWriter::supportedImageFormats().contains(suffix.toLatin1()))
+    output = imageSequence;
+  else
+  {
+    ffmpegPath = QStandardPaths::findExecutable("ffmpeg");
+    if(!ffmpegPath.isEmpty())
+      output = ffmpegPipe;
+    else
+    {
+      output = y4mFile;
+      fileName = fileInfo.path() + "/" + fileInfo.completeBaseName() + ".y4m";
+    }
+  }
+
+  // The frame rate refers to simulated time.
+  const long long frameDuration = std::max(1LL, std::llround(stepsPerFrame * Simulation::simulation->scene->stepLength * 1000000.0));
+  const long long divisor = std::gcd(1000000LL, frameDuration);
+  streamHeader = QString::asprintf("YUV4MPEG2 W%d H%d F%lld:%lld Ip A1:1 %s XCOLORRANGE=FULL\n", width, height,
+                                   1000000LL / divisor, frameDuration / divisor,
+                                   pixelFormat == rgb ? "C444" : pixelFormat == yuyv ? "C422" : "Cmono").toLatin1();
+
+  CoreModule::current().videoRecorders.push_back(this);
+  encoder = std::thread(&VideoRecorder::encode, this);
+}
+
+void VideoRecorder::step()
+{
+  if(stepsUntilFrame > 0)
+  {
+    --stepsUntilFrame;
+    return;
+  }
+  stepsUntilFrame = stepsPerFrame - 1;
+
+  if(renderer)
+    captureView();
+  else
+    captureSensor();
+}
+
+void VideoRecorder::captureView()
+{
+  GraphicsContext& graphicsContext = Simulation::simulation->graphicsContext;
+  if(!graphicsContext.makeCurrent(width, height))
+    return;
+
+  float pos[3], target[3];
+  view->getCamera(pos, target);
+  renderer->setCamera(pos, target);
+  renderer->setSurfaceShadeMode(view->getSurfaceShadeMode());
+  renderer->setPhysicsShadeMode(view->getPhysicsShadeMode());
+  renderer->setDrawingsShadeMode(view->getDrawingsShadeMode());
+  renderer->setRenderFlags(view->getRenderFlags());
+  renderer->resize(static_cast<float>(view->getFovY()), width, height);
+  renderer->draw();
+
+  // The pixel buffer that is reused now was read into numOfPixelBuffers frames ago, so mapping it does not stall.
+  if(numOfPendingPixelBuffers == numOfPixelBuffers)
+    readPixelBuffer();
+
+  QOpenGLFunctions_3_3_Core* f = graphicsContext.getOpenGLFunctions();
+  f->glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[nextPixelBuffer]);
+  f->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  f->glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+  f->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  nextPixelBuffer = (nextPixelBuffer + 1) % numOfPixelBuffers;
+  ++numOfPendingPixelBuffers;
+}
+
+void VideoRecorder::captureSensor()
+{
+  const SimRobotCore2::SensorPort::Data data = sensor->getValue();
+  std::vector<unsigned char> frame = allocateFrame();
+  std::memcpy(frame.data(), data.byteArray, frame.size());
+  queueFrame(std::move(frame));
+}
+
+void VideoRecorder::readPixelBuffer()
+{
+  ASSERT(numOfPendingPixelBuffers > 0);
+  const int index = (nextPixelBuffer + numOfPixelBuffers - numOfPendingPixelBuffers) % numOfPixelBuffers;
+  --numOfPendingPixelBuffers;
+
+  QOpenGLFunctions_3_3_Core* f = Simulation::simulation->graphicsContext.getOpenGLFunctions();
+  std::vector<unsigned char> frame = allocateFrame();
+  f->glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffers[index]);
+  if(const void* pixels = f->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(frame.size()), GL_MAP_READ_BIT))
+  {
+    std::memcpy(frame.data(), pixels, frame.size());
+    f->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    queueFrame(std::move(frame));
+  }
+  f->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+bool VideoRecorder::selectFile(QWidget* parent, QString& fileName, int& stepsPerFrame)
+{
+  QSettings& settings = CoreModule::current().application.getSettings();
+  fileName = QFileDialog::getSaveFileName(parent,
+                                          QObject::tr("Record Video"), settings.value("VideoDirectory", "").toString(), QObject::tr("Video (*.mp4 *.mkv *.avi);;YUV4MPEG2 (*.y4m);;Image Sequence (*.png *.jpg)")
+#ifdef LINUX
+                                          , nullptr, QFileDialog::DontUseNativeDialog
+#endif
+                                          );
+  if(fileName.isEmpty())
+    return false;
+  settings.setValue("VideoDirectory", QFileInfo(fileName).dir().path());
+  stepsPerFrame = settings.value("VideoStepsPerFrame", getDefaultStepsPerFrame()).toInt();
+  return true;
+}
+
+std::vector<unsigned char> VideoRecorder::allocateFrame()
+{
+  std::vector<unsigned char> frame;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if(!unusedFrames.empty())
+    {
+      frame = std::move(unusedFrames.back());
+      unusedFrames.pop_back();
+    }
+  }
+  frame.resize(getFrameSize());
+  return frame;
+}
+
+void VideoRecorder::queueFrame(std::vector<unsigned char>&& frame)
+{
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // If the encoder falls behind, the simulation waits for it, so that no frame is lost and the memory does not grow without bounds.
+    frameTaken.wait(lock, [this] {return frames.size() < maxNumOfQueuedFrames;});
+    frames.emplace_back(std::move(frame));
+  }
+  frameAvailable.notify_one();
+}
+
+std::size_t VideoRecorder::getFrameSize() const
+{
+  return static_cast<std::size_t>(width) * height * (pixelFormat == rgb ? 3 : pixelFormat == yuyv ? 2 : 1);
+}
+
+void VideoRecorder::encode()
+{
+  // The devices are created here, because a QProcess can only be used in the thread that created it.
+  QFile file;
+  QProcess process;
+  QIODevice* device = nullptr;
+  if(output == y4mFile)
+  {
+    file.setFileName(fileName);
+    if(file.open(QIODevice::WriteOnly))
+      device = &file;
+  }
+  else if(output == ffmpegPipe)
+  {
+    process.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    process.start(ffmpegPath, {"-y", "-loglevel", "error", "-f", "yuv4mpegpipe", "-i", "-", "-pix_fmt", "yuv420p", fileName});
+    if(process.waitForStarted(-1))
+      device = &process;
+  }
+  if(device)
+    device->write(streamHeader);
+
+  const int bytesPerPixel = pixelFormat == rgb ? 3 : pixelFormat == yuyv ? 2 : 1;
+  const QFileInfo fileInfo(fileName);
+  std::vector<unsigned char> frame;
+  std::vector<unsigned char> planes;
+  for(int index = 0;; ++index)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      if(!frame.empty())
+        unusedFrames.emplace_back(std::move(frame));
+      frameAvailable.wait(lock, [this] {return stopping || !frames.empty();});
+      if(frames.empty())
+        break;
+      frame = std::move(frames.front());
+      frames.pop_front();
+    }
+    frameTaken.notify_one();
+
+    if(output == imageSequence)
+      convertToImage(frame, width, height, bytesPerPixel).save(fileInfo.path() + "/" + fileInfo.completeBaseName() + QString("_%1.").arg(index, 6, 10, QChar('0')) + fileInfo.suffix());
+    else if(device)
+    {
+      convertToPlanes(frame, width, height, bytesPerPixel, planes);
+      device->write("FRAME\n");
+      device->write(reinterpret_cast<const char*>(planes.data()), static_cast<qint64>(planes.size()));
+      if(device == &process)
+        process.waitForBytesWritten(-1);
+    }
+  }
+
+  if(device == &process)
+  {
+    process.closeWriteChannel();
+    process.waitForFinished(-1);
+  }
+}
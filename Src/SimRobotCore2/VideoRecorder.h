@@ -0,0 +1,161 @@
+/**
+ * @file VideoRecorder.h
+ * Declaration of class VideoRecorder
+ */
+
+#pragma once
+
+#include "SimRobotCore2.h"
+#include "Graphics/OpenGL.h"
+#include <QByteArray>
+#include <QString>
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class QWidget;
+class SimObjectRenderer;
+
+/**
+ * @class VideoRecorder
+ * Records a video of a 3-D view of an object or of the images of a camera sensor.
+ * A frame is captured every \c stepsPerFrame simulation steps, so the video plays at the speed of
+ * simulated time no matter how fast the simulation actually ran. Views are read back through pixel
+ * buffer objects that are only mapped a few frames later, and all conversion and encoding is done by
+ * a background thread.
+ *
+ * The output is selected by the extension of the file name: "y4m" writes a raw YUV4MPEG2 stream,
+ * image formats such as "png" write a numbered image sequence, and everything else (e.g. "mp4") is
+ * encoded by piping a YUV4MPEG2 stream into ffmpeg. If ffmpeg is not installed, a ".y4m" file is
+ * written instead.
+ */
+class VideoRecorder
+{
+public:
+  /**
+   * Constructor for recording a view of an object
+   * @param view The renderer of the view. The camera and shading of each frame are adopted from it.
+   * @param width The width of the video in pixels
+   * @param height The height of the video in pixels
+   * @param stepsPerFrame The number of simulation steps between two frames
+   * @param fileName The name of the file to write
+   */
+  VideoRecorder(SimObjectRenderer& view, int width, int height, int stepsPerFrame, const QString& fileName);
+
+  /**
+   * Constructor for recording the images of a camera sensor (at its resolution)
+   * @param sensor The camera sensor
+   * @param stepsPerFrame The number of simulation steps between two frames
+   * @param fileName The name of the file to write
+   */
+  VideoRecorder(SimRobotCore2::SensorPort& sensor, int stepsPerFrame, const QString& fileName);
+
+  /** Destructor. Writes all pending frames and closes the output. */
+  ~VideoRecorder();
+
+  /** Called after each simulation step. Captures a frame every \c stepsPerFrame steps. */
+  void step();
+
+  /**
+   * Returns the name of the file that is actually written (the images of a sequence get the frame number appended to it)
+   * @return The file name
+   */
+  const QString& getFileName() const {return fileName;}
+
+  /**
+   * Returns the number of simulation steps between two frames that results in about 25 frames per simulated second
+   * @return The number of steps
+   */
+  static int getDefaultStepsPerFrame();
+
+  /**
+   * Asks the user for the file to record to and remembers its directory for the next time
+   * @param parent The parent widget of the file dialog
+   * @param fileName Is set to the selected file name
+   * @param stepsPerFrame Is set to the number of simulation steps between two frames from the settings
+   * @return Whether a file was selected
+   */
+  static bool selectFile(QWidget* parent, QString& fileName, int& stepsPerFrame);
+
+private:
+  /** The format of the pixels of a captured frame (rows are stored bottom-up) */
+  enum PixelFormat
+  {
+    rgb, /**< 3 bytes per pixel */
+    yuyv, /**< 2 bytes per pixel, two pixels share their chroma */
+    grey /**< 1 byte per pixel */
+  };
+
+  /** Where the frames are written to */
+  enum Output
+  {
+    y4mFile, /**< A YUV4MPEG2 file */
+    imageSequence, /**< One image file per frame */
+    ffmpegPipe /**< A YUV4MPEG2 stream piped into ffmpeg */
+  };
+
+  static constexpr int numOfPixelBuffers = 3; /**< The number of frames of a view that are read back asynchronously at the same time */
+  static constexpr std::size_t maxNumOfQueuedFrames = 2 * numOfPixelBuffers; /**< The number of frames that can wait for the encoder before capturing waits for the encoder */
+
+  std::unique_ptr<SimObjectRenderer> renderer; /**< The renderer for the frames of a view (\c nullptr when recording a sensor) */
+  SimObjectRenderer* view = nullptr; /**< The view whose camera and shading are adopted */
+  SimRobotCore2::SensorPort* sensor = nullptr; /**< The recorded camera sensor (\c nullptr when recording a view) */
+  int width; /**< The width of the frames */
+  int height; /**< The height of the frames */
+  PixelFormat pixelFormat = rgb; /**< The format of the captured frames */
+  int stepsPerFrame; /**< The number of simulation steps between two frames */
+  int stepsUntilFrame = 0; /**< The number of simulation steps until the next frame is captured */
+  Output output; /**< Where the frames are written to */
+  QString fileName; /**< The name of the file that is written */
+  QString ffmpegPath; /**< The path of the ffmpeg executable (if \c output is \c ffmpegPipe) */
+  QByteArray streamHeader; /**< The header of the YUV4MPEG2 stream (contains the frame rate in simulated time) */
+
+  std::array<GLuint, numOfPixelBuffers> pixelBuffers{}; /**< The pixel buffer objects into which the frames of a view are read */
+  int nextPixelBuffer = 0; /**< The index of the pixel buffer that is used for the next frame */
+  int numOfPendingPixelBuffers = 0; /**< The number of pixel buffers that were read into but not mapped yet */
+
+  std::thread encoder; /**< The thread that converts and writes the frames */
+  std::mutex mutex; /**< Guards the members below */
+  std::condition_variable frameAvailable; /**< Signals the encoder that a frame was queued or the recording stopped */
+  std::condition_variable frameTaken; /**< Signals the capturing thread that the encoder took a frame from the queue */
+  std::deque<std::vector<unsigned char>> frames; /**< The frames that have not been written yet */
+  std::vector<std::vector<unsigned char>> unusedFrames; /**< Frame buffers that were written and can be reused */
+  bool stopping = false; /**< Whether the encoder should terminate after it wrote all frames */
+
+  /** Selects the output and starts the encoder thread */
+  void start();
+
+  /** Renders the view and reads it back into the next pixel buffer */
+  void captureView();
+
+  /** Copies the current image of the camera sensor */
+  void captureSensor();
+
+  /** Maps the oldest pending pixel buffer and queues its frame */
+  void readPixelBuffer();
+
+  /**
+   * Returns an unused frame buffer
+   * @return The buffer with a size of \c getFrameSize bytes
+   */
+  std::vector<unsigned char> allocateFrame();
+
+  /**
+   * Queues a frame for the encoder
+   * @param frame The frame
+   */
+  void queueFrame(std::vector<unsigned char>&& frame);
+
+  /**
+   * Returns the size of a frame in the captured pixel format
+   * @return The size in bytes
+   */
+  std::size_t getFrameSize() const;
+
+  /** The main function of the encoder thread */
+  void encode();
+};
@@ -0,0 +1,236 @@
+/**
+ * @file ViewServer.cpp
+ * Implementation of class ViewServer
+ */
+
+#include "ViewServer.h"
+#include "CoreModule.h"
+#include "SimObjectRenderer.h"
+#include "Platform/Assert.h"
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QImage>
+#include <QOpenGLFunctions_3_3_Core>
+#include <QSettings>
+#include <QSharedMemory>
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+ViewServer::ViewServer() = default;
+
+ViewServer::~ViewServer()
+{
+  removeViews();
+
+  if(publisher.joinable())
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopping = true;
+    }
+    frameAvailable.notify_one();
+    publisher.join();
+  }
+}
+
+QString ViewServer::addView(SimObjectRenderer& view, int width, int height)
+{
+  GraphicsContext& graphicsContext = Simulation::simulation->graphicsContext;
+  graphicsContext.makeCurrent(width, height);
+
+  View& newView = *views.emplace_back(std::make_unique<View>());
+  newView.renderer = std::make_unique<SimObjectRenderer>(view.getSimObject());
+  newView.width = width;
+  newView.height = height;
+  newView.key = QString("SimRobot-%1-View%2").arg(QCoreApplication::applicationPid()).arg(nextViewId++);
+
+  // The camera and shading are fixed when the view is added, so the widget it was taken from can be closed.
+  float pos[3], target[3];
+  view.getCamera(pos, target);
+  newView.renderer->init();
+  newView.renderer->setCamera(pos, target);
+  newView.renderer->setSurfaceShadeMode(view.getSurfaceShadeMode());
+  newView.renderer->setPhysicsShadeMode(view.getPhysicsShadeMode());
+  newView.renderer->setDrawingsShadeMode(view.getDrawingsShadeMode());
+  newView.renderer->setRenderFlags(view.getRenderFlags());
+  newView.renderer->resize(static_cast<float>(view.getFovY()), width, height);
+
+  QOpenGLFunctions_3_3_Core* f = graphicsContext.getOpenGLFunctions();
+  f->glGenBuffers(numOfPixelBuffers, newView.pixelBuffers.data());
+  for(const GLuint pixelBuffer : newView.pixelBuffers)
+  {
+    f->glBindBuffer(GL_PIXEL_PACK_BUFFER, pixelBuffer);
+    f->glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(width) * height * 3, nullptr, GL_STREAM_READ);
+  }
+  f->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  if(views.size() == 1)
+  {
+    const int framesPerSecond = std::max(1, CoreModule::current().application.getSettings().value("ViewServerFramesPerSecond", 10).toInt());
+    frameDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond));
+    nextFrameTime = std::chrono::steady_clock::now();
+  }
+  if(!publisher.joinable())
+    publisher = std::thread(&ViewServer::publish, this);
+
+  return newView.key;
+}
+
+void ViewServer::removeViews()
+{
+  for(const std::unique_ptr<View>& view : views)
+    removeView(*view);
+  views.clear();
+}
+
+void ViewServer::removeViews(const std::unordered_set<const SimObject*>& objects)
+{
+  std::erase_if(views, [this, &objects](const std::unique_ptr<View>& view)
+  {
+    if(!objects.contains(&view->renderer->getSimObject()))
+      return false;
+    removeView(*view);
+    return true;
+  });
+}
+
+void ViewServer::removeView(View& view)
+{
+  GraphicsContext& graphicsContext = Simulation::simulation->graphicsContext;
+  graphicsContext.makeCurrent(view.width, view.height);
+  graphicsContext.getOpenGLFunctions()->glDeleteBuffers(numOfPixelBuffers, view.pixelBuffers.data());
+  view.renderer->destroy();
+  queueFrame({view.key, view.width, view.height, {}});
+}
+
+void ViewServer::step()
+{
+  if(views.empty())
+    return;
+
+  const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  if(now < nextFrameTime)
+    return;
+
+  // Frames that could not be rendered in time are skipped instead of being caught up on.
+  nextFrameTime += frameDuration;
+  if(nextFrameTime <= now)
+    nextFrameTime = now + frameDuration;
+
+  // All views are rendered in the same step, so they share the model matrices that are updated once per step.
+  for(const std::unique_ptr<View>& view : views)
+    capture(*view);
+}
+
+void ViewServer::capture(View& view)
+{
+  GraphicsContext& graphicsContext = Simulation::simulation->graphicsContext;
+  if(!graphicsContext.makeCurrent(view.width, view.height))
+    return;
+
+  view.renderer->draw();
+
+  // The pixel buffer that is reused now was read into a frame ago, so mapping it does not stall.
+  if(view.numOfPendingPixelBuffers == numOfPixelBuffers)
+    readPixelBuffer(view);
+
+  QOpenGLFunctions_3_3_Core* f = graphicsContext.getOpenGLFunctions();
+  f->glBindBuffer(GL_PIXEL_PACK_BUFFER, view.pixelBuffers[view.nextPixelBuffer]);
+  f->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+  f->glReadPixels(0, 0, view.width, view.height, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+  f->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  view.nextPixelBuffer = (view.nextPixelBuffer + 1) % numOfPixelBuffers;
+  ++view.numOfPendingPixelBuffers;
+}
+
+void ViewServer::readPixelBuffer(View& view)
+{
+  ASSERT(view.numOfPendingPixelBuffers > 0);
+  const int index = (view.nextPixelBuffer + numOfPixelBuffers - view.numOfPendingPixelBuffers) % numOfPixelBuffers;
+  --view.numOfPendingPixelBuffers;
+
+  QOpenGLFunctions_3_3_Core* f = Simulation::simulation->graphicsContext.getOpenGLFunctions();
+  Frame frame{view.key, view.width, view.height, std::vector<unsigned char>(static_cast<std::size_t>(view.width) * view.height * 3)};
+  f->glBindBuffer(GL_PIXEL_PACK_BUFFER, view.pixelBuffers[index]);
+  if(const void* pixels = f->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(frame.pixels.size()), GL_MAP_READ_BIT))
+  {
+    std::memcpy(frame.pixels.data(), pixels, frame.pixels.size());
+    f->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    queueFrame(std::move(frame));
+  }
+  f->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void ViewServer::queueFrame(Frame&& frame)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // If the publisher falls behind, the oldest frames are dropped, since clients are only interested in the latest ones.
+    while(!frame.pixels.empty() && frames.size() >= 2 * views.size() && !frames.front().pixels.empty())
+      frames.pop_front();
+    frames.emplace_back(std::move(frame));
+  }
+  frameAvailable.notify_one();
+}
+
+void ViewServer::publish()
+{
+  /** The shared memory segment of a view */
+  struct Segment
+  {
+    std::unique_ptr<QSharedMemory> memory; /**< The segment (\c nullptr if it could not be created) */
+    std::uint32_t frame = 0; /**< The number of the last published frame */
+  };
+
+  // The segments are created here, because they are only used by this thread.
+  std::map<QString, Segment> segments;
+  QByteArray jpeg;
+  for(;;)
+  {
+    Frame frame;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      frameAvailable.wait(lock, [this] {return stopping || !frames.empty();});
+      if(frames.empty())
+        break;
+      frame = std::move(frames.front());
+      frames.pop_front();
+    }
+
+    if(frame.pixels.empty())
+    {
+      segments.erase(frame.key);
+      continue;
+    }
+
+    jpeg.clear();
+    QBuffer buffer(&jpeg);
+    buffer.open(QIODevice::WriteOnly);
+    if(!QImage(frame.pixels.data(), frame.width, frame.height, frame.width * 3, QImage::Format_RGB888).mirrored().save(&buffer, "JPG", 85))
+      continue;
+
+    // The segment has the size of an uncompressed frame, which the JPEG data practically never exceed.
+    Segment& segment = segments[frame.key];
+    if(!segment.memory)
+    {
+      segment.memory = std::make_unique<QSharedMemory>(frame.key);
+      if(!segment.memory->create(static_cast<qsizetype>(sizeof(FrameHeader) + frame.pixels.size())) &&
+         !(segment.memory->error() == QSharedMemory::AlreadyExists && segment.memory->attach()))
+      {
+        segment.memory.reset();
+        continue;
+      }
+    }
+    if(static_cast<qsizetype>(sizeof(FrameHeader)) + jpeg.size() > segment.memory->size())
+      continue;
+
+    const FrameHeader header{++segment.frame, static_cast<std::uint32_t>(frame.width), static_cast<std::uint32_t>(frame.height), static_cast<std::uint32_t>(jpeg.size())};
+    segment.memory->lock();
+    auto* const data = static_cast<char*>(segment.memory->data());
+    std::memcpy(data, &header, sizeof(FrameHeader));
+    std::memcpy(data + sizeof(FrameHeader), jpeg.constData(), static_cast<std::size_t>(jpeg.size()));
+    segment.memory->unlock();
+  }
+}
@@ -0,0 +1,137 @@
+/**
+ * @file ViewServer.h
+ * Declaration of class ViewServer
+ */
+
+#pragma once
+
+#include "Graphics/OpenGL.h"
+#include <QString>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+class SimObject;
+class SimObjectRenderer;
+
+/**
+ * @class ViewServer
+ * Renders fixed viewpoints of the scene at a fixed (real time) rate without a widget, e.g. for remote dashboards.
+ * The views are rendered through the off-screen renderer after simulation steps and read back through pixel buffer
+ * objects that are only mapped a frame later. A background thread compresses the frames to JPEG and publishes each
+ * view in a shared memory segment (see \c FrameHeader) that local clients can attach to with \c QSharedMemory.
+ */
+class ViewServer
+{
+public:
+  /** The header at the beginning of the shared memory segment of a view. The JPEG data follows directly behind it. */
+  struct FrameHeader
+  {
+    std::uint32_t frame; /**< The number of the frame (starts with 1 and is incremented for each published frame) */
+    std::uint32_t width; /**< The width of the frame in pixels */
+    std::uint32_t height; /**< The height of the frame in pixels */
+    std::uint32_t size; /**< The size of the JPEG data in bytes */
+  };
+
+  /** Constructor */
+  ViewServer();
+
+  /** Destructor. Removes all views. */
+  ~ViewServer();
+
+  /**
+   * Adds a view. It shows the object of a renderer with the camera and shading that the renderer currently uses.
+   * @param view The renderer whose settings are adopted (it can be destroyed afterwards)
+   * @param width The width of the frames in pixels
+   * @param height The height of the frames in pixels
+   * @return The key of the shared memory segment in which the frames are published
+   */
+  QString addView(SimObjectRenderer& view, int width, int height);
+
+  /** Removes all views and their shared memory segments */
+  void removeViews();
+
+  /**
+   * Removes the views that show certain objects, e.g. because the objects are removed from the scene
+   * @param objects The objects
+   */
+  void removeViews(const std::unordered_set<const SimObject*>& objects);
+
+  /**
+   * Whether views are served
+   * @return Whether there is at least one view
+   */
+  bool empty() const {return views.empty();}
+
+  /** Called after each simulation step. Renders all views if a frame is due. */
+  void step();
+
+private:
+  static constexpr int numOfPixelBuffers = 2; /**< The number of frames of a view that are read back asynchronously at the same time */
+
+  /** A served view */
+  struct View
+  {
+    std::unique_ptr<SimObjectRenderer> renderer; /**< The renderer of the view */
+    int width; /**< The width of the frames */
+    int height; /**< The height of the frames */
+    QString key; /**< The key of the shared memory segment */
+    std::array<GLuint, numOfPixelBuffers> pixelBuffers{}; /**< The pixel buffer objects into which the frames are read */
+    int nextPixelBuffer = 0; /**< The index of the pixel buffer that is used for the next frame */
+    int numOfPendingPixelBuffers = 0; /**< The number of pixel buffers that were read into but not mapped yet */
+  };
+
+  /** A frame that waits for being published */
+  struct Frame
+  {
+    QString key; /**< The key of the shared memory segment of the view */
+    int width; /**< The width of the frame */
+    int height; /**< The height of the frame */
+    std::vector<unsigned char> pixels; /**< The RGB pixels with the rows stored bottom-up (empty to release the segment) */
+  };
+
+  std::vector<std::unique_ptr<View>> views; /**< All served views */
+  unsigned int nextViewId = 0; /**< The number used in the key of the next view */
+  std::chrono::steady_clock::duration frameDuration; /**< The (real) time between two frames */
+  std::chrono::steady_clock::time_point nextFrameTime; /**< The (real) time when the next frame is due */
+
+  std::thread publisher; /**< The thread that compresses and publishes the frames */
+  std::mutex mutex; /**< Guards the members below */
+  std::condition_variable frameAvailable; /**< Signals the publisher that a frame was queued or the server stopped */
+  std::deque<Frame> frames; /**< The frames that have not been published yet */
+  bool stopping = false; /**< Whether the publisher should terminate after it published all frames */
+
+  /**
+   * Releases the resources of a view and its shared memory segment (but does not remove it from \c views)
+   * @param view The view
+   */
+  void removeView(View& view);
+
+  /**
+   * Renders a view and reads it back into its next pixel buffer
+   * @param view The view
+   */
+  void capture(View& view);
+
+  /**
+   * Maps the oldest pending pixel buffer of a view and queues its frame
+   * @param view The view
+   */
+  void readPixelBuffer(View& view);
+
+  /**
+   * Queues a frame for the publisher
+   * @param frame The frame
+   */
+  void queueFrame(Frame&& frame);
+
+  /** The main function of the publisher thread */
+  void publish();
+};
@@ -23,6 +23,8 @@
 #include "Simulation/Masses/PointMass.h"
 #include "Simulation/Masses/RectMass.h"
 #include "Simulation/Scene.h"
+#include "Simulation/Sensors/FieldOfViewSensor.h"
+#include "Simulation/Sensors/RangeSensor.h"
 #include "Simulation/Simulation.h"
 #include "Tools/Math/Constants.h"
 #include <box2d/b2_math.h>
@@ -41,11 +43,11 @@ ParserCore2D::ParserCore2D()
 
     {"Set", setClass, std::bind(&ParserCore2D::setElement, this), nullptr, 0, 0, 0, 0, {}},
 
-    {"Scene", sceneClass, std::bind(&ParserCore2D::sceneElement, this), nullptr, 0, 0, 0, setClass | bodyClass | compoundClass, {"background"}},
+    {"Scene", sceneClass, std::bind(&ParserCore2D::sceneElement, this), nullptr, 0, 0, 0, setClass | bodyClass | compoundClass | sensorClass, {"background"}},
 
-    {"Body", bodyClass, std::bind(&ParserCore2D::bodyElement, this), nullptr, 0, massClass, translationClass | rotationClass, setClass | massClass | geometryClass, {}},
+    {"Body", bodyClass, std::bind(&ParserCore2D::bodyElement, this), nullptr, 0, massClass, translationClass | rotationClass, setClass | massClass | geometryClass | sensorClass, {}},
 
-    {"Compound", compoundClass, std::bind(&ParserCore2D::compoundElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass | bodyClass | compoundClass | geometryClass, {}},
+    {"Compound", compoundClass, std::bind(&ParserCore2D::compoundElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass | bodyClass | compoundClass | geometryClass | sensorClass, {}},
 
     {"Translation", translationClass, std::bind(&ParserCore2D::translationElement, this), nullptr, 0, 0, 0, 0, {}},
 
@@ -61,7 +63,10 @@ ParserCore2D::ParserCore2D()
     {"ConvexGeometry", geometryClass, std::bind(&ParserCore2D::convexGeometryElement, this), std::bind(&ParserCore2D::verticesText, this, _1, _2), textFlag, 0, translationClass | rotationClass, setClass | geometryClass, {}},
     {"DiskGeometry", geometryClass, std::bind(&ParserCore2D::diskGeometryElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass | geometryClass, {}},
     {"EdgeGeometry", geometryClass, std::bind(&ParserCore2D::edgeGeometryElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass | geometryClass, {}},
-    {"RectGeometry", geometryClass, std::bind(&ParserCore2D::rectGeometryElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass | geometryClass, {}}
+    {"RectGeometry", geometryClass, std::bind(&ParserCore2D::rectGeometryElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass | geometryClass, {}},
+
+    {"RangeSensor", sensorClass, std::bind(&ParserCore2D::rangeSensorElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass, {}},
+    {"FieldOfViewSensor", sensorClass, std::bind(&ParserCore2D::fieldOfViewSensorElement, this), nullptr, 0, 0, translationClass | rotationClass, setClass, {}}
   };
 
   for(const ElementInfo& element : elements)
@@ -83,11 +88,10 @@ bool ParserCore2D::getColor(const char* key, bool required, QColor& color)
 Element* ParserCore2D::setElement()
 {
   ASSERT(element);
-  const std::string& name = getString("name", true);
+  // The name must be interned before the value is read, because both may be resolved into the same buffer.
+  const std::string& name = intern(getString("name", true));
   const std::string& value = getString("value", true);
-  auto& vars = elementData->parent->vars;
-  if(vars.find(name) == vars.end())
-    vars[name] = value;
+  elementData->parent->vars.emplace(&name, value);
   return nullptr;
 }
 
@@ -242,6 +246,30 @@ Element* ParserCore2D::rectGeometryElement()
   return rectGeometry;
 }
 
+Element* ParserCore2D::rangeSensorElement()
+{
+  auto* const rangeSensor = new RangeSensor;
+  rangeSensor->name = getString("name", false);
+  rangeSensor->mask = getUInt16("mask", false, 0xffff);
+  rangeSensor->angle = getAngle("angle", false, 0.f, false);
+  rangeSensor->rays = getInteger("rays", false, 1, true);
+  rangeSensor->min = getLength("min", false, 0.f, false);
+  rangeSensor->max = getLength("max", true, 0.f, true);
+  if(rangeSensor->max <= rangeSensor->min)
+    handleError("The maximum distance must be greater than the minimum distance", findAttribute("max")->valueLocation);
+  return rangeSensor;
+}
+
+Element* ParserCore2D::fieldOfViewSensorElement()
+{
+  auto* const fieldOfViewSensor = new FieldOfViewSensor;
+  fieldOfViewSensor->name = getString("name", false);
+  fieldOfViewSensor->mask = getUInt16("mask", false, 0xffff);
+  fieldOfViewSensor->angle = getAngle("angle", false, 2.f * pi, true);
+  fieldOfViewSensor->range = getLength("range", true, 0.f, true);
+  return fieldOfViewSensor;
+}
+
 void ParserCore2D::verticesText(std::string& text, Reader::Location location)
 {
   std::vector<b2Vec2>* vertices;
@@ -36,8 +36,20 @@ void SimObjectPainter::draw(QPaintDevice* device)
   {
     Simulation::simulation->scene->updateTransformations();
 
-    painter.setTransform(physicalObject->transformation.inverted(nullptr), true);
-    physicalObject->drawPhysics(painter);
+    if(physicalObject == Simulation::simulation->scene)
+    {
+      // Only the bodies can move, so everything else is drawn from a layer that is only redrawn when the view changes.
+      updateStaticLayer(*device);
+      painter.resetTransform();
+      painter.drawPixmap(0, 0, staticLayer);
+      painter.setTransform(transform);
+      Simulation::simulation->scene->drawDynamicPhysics(painter);
+    }
+    else
+    {
+      painter.setTransform(physicalObject->transformation.inverted(nullptr), true);
+      physicalObject->drawPhysics(painter);
+    }
   }
 
   painter.end();
@@ -289,4 +301,22 @@ void SimObjectPainter::updateTransform()
   transform.rotateRadians(rotation);
   transform.translate(offset.x, offset.y);
   transformInv = transform.inverted(nullptr);
+  staticLayerValid = false;
+}
+
+void SimObjectPainter::updateStaticLayer(const QPaintDevice& device)
+{
+  const qreal devicePixelRatio = device.devicePixelRatioF();
+  if(staticLayerValid && staticLayer.devicePixelRatio() == devicePixelRatio)
+    return;
+
+  // The layer has the resolution of the device so that it is drawn without scaling.
+  staticLayer = QPixmap((QSizeF(size) * devicePixelRatio).toSize());
+  staticLayer.setDevicePixelRatio(devicePixelRatio);
+  staticLayer.fill(Qt::transparent);
+  QPainter layerPainter(&staticLayer);
+  layerPainter.setRenderHints(painter.renderHints());
+  layerPainter.setTransform(transform);
+  Simulation::simulation->scene->drawStaticPhysics(layerPainter);
+  staticLayerValid = true;
 }
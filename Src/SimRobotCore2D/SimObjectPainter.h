@@ -11,6 +11,7 @@
 #include "SimRobotCore2D.h"
 #include <box2d/b2_math.h>
 #include <QPainter>
+#include <QPixmap>
 #include <QPointF>
 
 class Body;
@@ -133,6 +134,12 @@ private:
   /** Updates the transformation matrices derived from \c size, \c offset, \c zoomFactor and \c rotation. */
   void updateTransform();
 
+  /**
+   * Redraws the static parts of the scene into \c staticLayer if the view has changed.
+   * @param device The device to which the layer will be drawn.
+   */
+  void updateStaticLayer(const QPaintDevice& device);
+
   SimObject& simObject; /**< The object to paint. */
   QPainter painter; /**< The Qt painter. */
 
@@ -150,4 +157,7 @@ private:
 
   QTransform transform; /**< Transforms world coordinates into window coordinates. */
   QTransform transformInv; /**< Transforms window coordinates into world coordinates. */
+
+  QPixmap staticLayer; /**< The background and the compounds of the scene as they are seen with the current view. */
+  bool staticLayerValid = false; /**< Whether \c staticLayer matches the current view. */
 };
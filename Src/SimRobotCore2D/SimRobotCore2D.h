@@ -15,6 +15,7 @@ class QPaintDevice;
 namespace SimRobotCore2D
 {
   class Body;
+  class BodySet;
   class Painter;
   class CollisionCallback;
 
@@ -24,7 +25,9 @@ namespace SimRobotCore2D
     body, /**< An object of the type SimRobotCore2D::Body. */
     compound, /**< An object of the type SimRobotCore2D::Compound. */
     mass, /**< An object of the type SimRobotCore2D::Mass. */
-    geometry /**< An object of the type SimRobotCore2D::Geometry. */
+    geometry, /**< An object of the type SimRobotCore2D::Geometry. */
+    sensor, /**< An object of the type SimRobotCore2D::Sensor. */
+    sensorPort /**< An object of the type SimRobotCore2D::SensorPort. */
   };
 
   class Object : public SimRobot::Object
@@ -82,6 +85,15 @@ namespace SimRobotCore2D
      * @return The frame rate in frames per second.
      */
     [[nodiscard]] virtual unsigned int getFrameRate() const = 0;
+
+    /**
+     * Creates a set of bodies whose states can be read and commanded in bulk.
+     * The set must be deleted before the scene is destroyed.
+     * @param bodies The bodies (the order is kept in all arrays that are exchanged with the set).
+     * @param count The number of bodies.
+     * @return The new body set (or \c nullptr if one of the bodies is not a body of this simulation).
+     */
+    virtual BodySet* createBodySet(Body* const* bodies, unsigned int count) = 0;
   };
 
   class Body : public PhysicalObject
@@ -216,6 +228,60 @@ namespace SimRobotCore2D
     virtual bool unregisterCollisionCallback(CollisionCallback& callback) = 0;
   };
 
+  class Sensor : public PhysicalObject
+  {
+  public:
+    /**
+     * Returns an object type identifier.
+     * @return The identifier.
+     */
+    [[nodiscard]] int getKind() const override
+    {
+      return sensor;
+    }
+  };
+
+  class SensorPort : public SimRobot::Object
+  {
+  public:
+    /**
+     * Returns an object type identifier.
+     * @return The identifier.
+     */
+    [[nodiscard]] int getKind() const override
+    {
+      return sensorPort;
+    }
+
+    /**
+     * Returns the number of values that form a single reading (e.g. 1 for a distance, 3 for an object).
+     * @return The number of floats per reading.
+     */
+    [[nodiscard]] virtual unsigned int getReadingSize() const = 0;
+
+    /**
+     * Returns the readings of the sensor in the current simulation step.
+     * All sensors of the scene are evaluated together when the first of them is read after a step.
+     * @param count The number of readings.
+     * @return The readings (\c count * \c getReadingSize floats stored contiguously).
+     */
+    virtual const float* getReadings(unsigned int& count) = 0;
+
+    /**
+     * Returns the bodies to which the readings of the most recent call to \c getReadings refer.
+     * @return One body per reading or \c nullptr if the readings do not refer to bodies.
+     */
+    [[nodiscard]] virtual Body* const* getBodies() const = 0;
+
+    /**
+     * Returns the range of the sensor readings.
+     * @param min The minimum value.
+     * @param max The maximum value.
+     * @return Whether the readings have a range.
+     */
+    virtual bool getMinAndMax(float& min, float& max) const = 0;
+  };
+
   class Painter
   {
   public:
@@ -320,6 +386,46 @@ namespace SimRobotCore2D
     virtual void resetView() = 0;
   };
 
+  class BodySet
+  {
+  public:
+    /** Virtual destructor for polymorphism. */
+    virtual ~BodySet() = default;
+
+    /**
+     * Returns the number of bodies in the set.
+     * @return The number of bodies.
+     */
+    [[nodiscard]] virtual unsigned int getSize() const = 0;
+
+    /**
+     * Fills arrays with the states of all bodies in world coordinates (one element per body, any array may be \c nullptr).
+     * @param x The x-coordinates of the positions.
+     * @param y The y-coordinates of the positions.
+     * @param rotation The rotations (normalized to [-pi, pi]).
+     * @param vx The x-components of the linear velocities.
+     * @param vy The y-components of the linear velocities.
+     * @param angularVelocity The angular velocities.
+     */
+    virtual void getStates(float* x, float* y, float* rotation, float* vx, float* vy, float* angularVelocity) const = 0;
+
+    /**
+     * Sets the velocities of all bodies (one element per body).
+     * @param vx The x-components of the new linear velocities (or \c nullptr to keep them).
+     * @param vy The y-components of the new linear velocities (or \c nullptr to keep them).
+     * @param angularVelocity The new angular velocities (or \c nullptr to keep them).
+     */
+    virtual void setVelocities(const float* vx, const float* vy, const float* angularVelocity) = 0;
+
+    /**
+     * Applies forces to the centers of mass of all bodies for the next simulation step (one element per body).
+     * @param fx The x-components of the forces.
+     * @param fy The y-components of the forces.
+     * @param torque The torques (or \c nullptr to apply none).
+     */
+    virtual void applyForces(const float* fx, const float* fy, const float* torque) = 0;
+  };
+
   class CollisionCallback
   {
   public:
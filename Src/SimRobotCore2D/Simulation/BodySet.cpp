@@ -0,0 +1,94 @@
+/**
+ * @file BodySet.cpp
+ *
+ * This file implements a class for reading and commanding the states of many bodies at once.
+ */
+
+#include "BodySet.h"
+#include "Platform/Assert.h"
+#include "Simulation/Body.h"
+#include "Tools/Math.h"
+#include <box2d/b2_body.h>
+
+BodySet::BodySet(SimRobotCore2D::Body* const* bodies, unsigned int count)
+{
+  // Resolve the Box2D bodies once so that the bulk accessors do not need any virtual calls.
+  this->bodies.reserve(count);
+  for(unsigned int i = 0; i < count; ++i)
+  {
+    auto* const body = dynamic_cast<Body*>(bodies[i]);
+    ASSERT(isBody(body));
+    this->bodies.push_back(body->body);
+  }
+}
+
+bool BodySet::isBody(const SimRobotCore2D::Body* body)
+{
+  const auto* const simulationBody = dynamic_cast<const Body*>(body);
+  return simulationBody && simulationBody->body;
+}
+
+unsigned int BodySet::getSize() const
+{
+  return static_cast<unsigned int>(bodies.size());
+}
+
+void BodySet::getStates(float* x, float* y, float* rotation, float* vx, float* vy, float* angularVelocity) const
+{
+  const std::size_t count = bodies.size();
+  if(x || y)
+    for(std::size_t i = 0; i < count; ++i)
+    {
+      const b2Vec2& position = bodies[i]->GetPosition();
+      if(x)
+        x[i] = position.x;
+      if(y)
+        y[i] = position.y;
+    }
+  if(rotation)
+    for(std::size_t i = 0; i < count; ++i)
+      rotation[i] = normalize(bodies[i]->GetAngle());
+  if(vx || vy)
+    for(std::size_t i = 0; i < count; ++i)
+    {
+      const b2Vec2& velocity = bodies[i]->GetLinearVelocity();
+      if(vx)
+        vx[i] = velocity.x;
+      if(vy)
+        vy[i] = velocity.y;
+    }
+  if(angularVelocity)
+    for(std::size_t i = 0; i < count; ++i)
+      angularVelocity[i] = bodies[i]->GetAngularVelocity();
+}
+
+void BodySet::setVelocities(const float* vx, const float* vy, const float* angularVelocity)
+{
+  const std::size_t count = bodies.size();
+  if(vx && vy)
+    for(std::size_t i = 0; i < count; ++i)
+      bodies[i]->SetLinearVelocity(b2Vec2(vx[i], vy[i]));
+  else if(vx || vy)
+    for(std::size_t i = 0; i < count; ++i)
+    {
+      b2Vec2 velocity = bodies[i]->GetLinearVelocity();
+      if(vx)
+        velocity.x = vx[i];
+      else
+        velocity.y = vy[i];
+      bodies[i]->SetLinearVelocity(velocity);
+    }
+  if(angularVelocity)
+    for(std::size_t i = 0; i < count; ++i)
+      bodies[i]->SetAngularVelocity(angularVelocity[i]);
+}
+
+void BodySet::applyForces(const float* fx, const float* fy, const float* torque)
+{
+  const std::size_t count = bodies.size();
+  for(std::size_t i = 0; i < count; ++i)
+    bodies[i]->ApplyForceToCenter(b2Vec2(fx[i], fy[i]), true);
+  if(torque)
+    for(std::size_t i = 0; i < count; ++i)
+      bodies[i]->ApplyTorque(torque[i], true);
+}
@@ -0,0 +1,66 @@
+/**
+ * @file BodySet.h
+ *
+ * This file declares a class for reading and commanding the states of many bodies at once.
+ */
+
+#pragma once
+
+#include "SimRobotCore2D.h"
+#include <vector>
+
+class b2Body;
+
+class BodySet : public SimRobotCore2D::BodySet
+{
+public:
+  /**
+   * Constructor.
+   * @param bodies The bodies.
+   * @param count The number of bodies.
+   */
+  BodySet(SimRobotCore2D::Body* const* bodies, unsigned int count);
+
+  /**
+   * Checks whether a body can be part of a body set.
+   * @param body The body.
+   * @return Whether the body is a body of this simulation that has a Box2D body.
+   */
+  static bool isBody(const SimRobotCore2D::Body* body);
+
+private:
+  /**
+   * Returns the number of bodies in the set.
+   * @return The number of bodies.
+   */
+  [[nodiscard]] unsigned int getSize() const override;
+
+  /**
+   * Fills arrays with the states of all bodies in world coordinates.
+   * @param x The x-coordinates of the positions.
+   * @param y The y-coordinates of the positions.
+   * @param rotation The rotations.
+   * @param vx The x-components of the linear velocities.
+   * @param vy The y-components of the linear velocities.
+   * @param angularVelocity The angular velocities.
+   */
+  void getStates(float* x, float* y, float* rotation, float* vx, float* vy, float* angularVelocity) const override;
+
+  /**
+   * Sets the velocities of all bodies.
+   * @param vx The x-components of the new linear velocities (or \c nullptr to keep them).
+   * @param vy The y-components of the new linear velocities (or \c nullptr to keep them).
+   * @param angularVelocity The new angular velocities (or \c nullptr to keep them).
+   */
+  void setVelocities(const float* vx, const float* vy, const float* angularVelocity) override;
+
+  /**
+   * Applies forces to the centers of mass of all bodies.
+   * @param fx The x-components of the forces.
+   * @param fy The y-components of the forces.
+   * @param torque The torques.
+   */
+  void applyForces(const float* fx, const float* fy, const float* torque) override;
+
+  std::vector<b2Body*> bodies; /**< The Box2D bodies in the order in which they were passed. */
+};
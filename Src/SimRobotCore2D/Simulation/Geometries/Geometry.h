@@ -10,7 +10,7 @@
 
 #include "Simulation/PhysicalObject.h"
 #include "SimRobotCore2D.h"
-#include <list>
+#include <vector>
 
 class b2Body;
 class b2Fixture;
@@ -27,7 +27,7 @@ public:
    */
   void createGeometry(b2Body* body, const b2Transform& geometryPose);
 
-  std::list<SimRobotCore2D::CollisionCallback*> callbacks; /**< The list of collision callbacks registered for this geometry. */
+  std::vector<SimRobotCore2D::CollisionCallback*> callbacks; /**< The list of collision callbacks registered for this geometry. */
   std::uint16_t category = 0; /**< The category for collision filtering (0-15). */
   std::uint16_t mask = 0xffff; /**< The mask of categories with which this geometry wants to collide. */
 
@@ -8,6 +8,7 @@
 
 #include "Scene.h"
 #include "Simulation/Body.h"
+#include "Simulation/BodySet.h"
 #include "Simulation/Simulation.h"
 #include "CoreModule.h"
 #include <QPainter>
@@ -20,6 +21,12 @@ void Scene::createPhysics()
 }
 
 void Scene::drawPhysics(QPainter& painter) const
+{
+  drawStaticPhysics(painter);
+  drawDynamicPhysics(painter);
+}
+
+void Scene::drawStaticPhysics(QPainter& painter) const
 {
   if(!background.empty())
   {
@@ -31,9 +38,13 @@ void Scene::drawPhysics(QPainter& painter) const
     backgroundRenderer.render(&painter);
     painter.restore();
   }
+  ::PhysicalObject::drawPhysics(painter);
+}
+
+void Scene::drawDynamicPhysics(QPainter& painter) const
+{
   for(const Body* body : bodies)
     body->drawPhysics(painter);
-  ::PhysicalObject::drawPhysics(painter);
 }
 
 void Scene::updateTransformations()
@@ -86,3 +97,11 @@ unsigned int Scene::getFrameRate() const
 {
   return Simulation::simulation->currentFrameRate;
 }
+
+SimRobotCore2D::BodySet* Scene::createBodySet(SimRobotCore2D::Body* const* bodies, unsigned int count)
+{
+  for(unsigned int i = 0; i < count; ++i)
+    if(!BodySet::isBody(bodies[i]))
+      return nullptr;
+  return new BodySet(bodies, count);
+}
@@ -28,6 +28,18 @@ public:
    */
   void drawPhysics(QPainter& painter) const override;
 
+  /**
+   * Draws the parts of the scene that never move (i.e. the background and the compounds).
+   * @param painter The drawing helper.
+   */
+  void drawStaticPhysics(QPainter& painter) const;
+
+  /**
+   * Draws the bodies of the scene.
+   * @param painter The drawing helper.
+   */
+  void drawDynamicPhysics(QPainter& painter) const;
+
   /** Updates the transformations of all bodies. */
   void updateTransformations();
 
@@ -49,6 +61,7 @@ protected:
   [[nodiscard]] unsigned int getStep() const override;
   [[nodiscard]] double getTime() const override;
   [[nodiscard]] unsigned int getFrameRate() const override;
+  SimRobotCore2D::BodySet* createBodySet(SimRobotCore2D::Body* const* bodies, unsigned int count) override;
 
 private:
   mutable QSvgRenderer backgroundRenderer; /**< The renderer for the background image. */
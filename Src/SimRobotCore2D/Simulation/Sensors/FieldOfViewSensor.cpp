@@ -0,0 +1,90 @@
+/**
+ * @file FieldOfViewSensor.cpp
+ *
+ * This file implements a class for sensors that report the poses of the bodies within their field of view.
+ */
+
+#include "FieldOfViewSensor.h"
+#include "CoreModule.h"
+#include "Simulation/Body.h"
+#include "Simulation/Geometries/Geometry.h"
+#include "Tools/Math/Constants.h"
+#include <box2d/b2_body.h>
+#include <box2d/b2_collision.h>
+#include <box2d/b2_fixture.h>
+#include <box2d/b2_world.h>
+#include <box2d/b2_world_callbacks.h>
+#include <algorithm>
+#include <cmath>
+
+void FieldOfViewSensor::createPhysics()
+{
+  Sensor::createPhysics();
+
+  port.readingSize = 3;
+  port.refersToBodies = true;
+}
+
+void FieldOfViewSensor::registerObjects()
+{
+  port.fullName = fullName + ".objects";
+  CoreModule::application->registerObject(*CoreModule::module, port, this);
+
+  Sensor::registerObjects();
+}
+
+void FieldOfViewSensor::updateReadings(const b2World& world)
+{
+  class CandidateCallback : public b2QueryCallback
+  {
+  public:
+    CandidateCallback(const FieldOfViewSensor& sensor, std::vector<Body*>& candidates) : sensor(sensor), candidates(candidates) {}
+
+    bool ReportFixture(b2Fixture* fixture) override
+    {
+      // Fixtures of compounds do not belong to a body.
+      if(sensor.detects(fixture))
+        if(const Body* const body = reinterpret_cast<const Geometry*>(fixture->GetUserData().pointer)->parentBody; body)
+          candidates.push_back(body->rootBody);
+      return true;
+    }
+
+    const FieldOfViewSensor& sensor;
+    std::vector<Body*>& candidates;
+  };
+
+  const b2Transform pose = getPose();
+  candidates.clear();
+  CandidateCallback callback(*this, candidates);
+  b2AABB aabb;
+  aabb.lowerBound = pose.p - b2Vec2(range, range);
+  aabb.upperBound = pose.p + b2Vec2(range, range);
+  world.QueryAABB(&callback, aabb);
+
+  // A body is usually reported once per fixture.
+  std::sort(candidates.begin(), candidates.end());
+  candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+  objects.clear();
+  const float squaredRange = range * range;
+  const float halfAngle = angle * 0.5f;
+  for(Body* body : candidates)
+  {
+    const b2Transform relativePose = b2MulT(pose, body->body->GetTransform());
+    const float squaredDistance = relativePose.p.LengthSquared();
+    if(squaredDistance > squaredRange || (halfAngle < pi && std::abs(std::atan2(relativePose.p.y, relativePose.p.x)) > halfAngle))
+      continue;
+    objects.push_back({body, relativePose, squaredDistance});
+  }
+  std::sort(objects.begin(), objects.end(), [](const Object& a, const Object& b) {return a.squaredDistance < b.squaredDistance;});
+
+  port.readings.resize(objects.size() * 3);
+  port.bodies.resize(objects.size());
+  for(std::size_t i = 0; i < objects.size(); ++i)
+  {
+    port.readings[i * 3] = objects[i].pose.p.x;
+    port.readings[i * 3 + 1] = objects[i].pose.p.y;
+    port.readings[i * 3 + 2] = objects[i].pose.q.GetAngle();
+    port.bodies[i] = objects[i].body;
+  }
+}
@@ -0,0 +1,41 @@
+/**
+ * @file FieldOfViewSensor.h
+ *
+ * This file declares a class for sensors that report the poses of the bodies within their field of view.
+ */
+
+#pragma once
+
+#include "Simulation/Sensors/Sensor.h"
+
+class FieldOfViewSensor : public Sensor
+{
+public:
+  float angle = 0.f; /**< The opening angle of the field of view (in rad). */
+  float range = 0.f; /**< The maximum distance of a body to the sensor. */
+
+private:
+  /** Initializes the physical properties of the sensor. */
+  void createPhysics() override;
+
+  /** Registers this object with children, actuators and sensors at SimRobot's GUI. */
+  void registerObjects() override;
+
+  /**
+   * Collects the bodies within the field of view and stores their poses relative to the sensor, sorted by distance.
+   * @param world The Box2D world.
+   */
+  void updateReadings(const b2World& world) override;
+
+  /** A body within the field of view. */
+  struct Object
+  {
+    Body* body; /**< The (root) body. */
+    b2Transform pose; /**< The pose of the body relative to the sensor. */
+    float squaredDistance; /**< The squared distance of the body to the sensor. */
+  };
+
+  Port port; /**< The port which provides the poses of the bodies (x, y, rotation). */
+  std::vector<Body*> candidates; /**< The bodies with a fixture near the sensor (buffer to avoid reallocations). */
+  std::vector<Object> objects; /**< The bodies within the field of view (buffer to avoid reallocations). */
+};
@@ -0,0 +1,65 @@
+/**
+ * @file RangeSensor.cpp
+ *
+ * This file implements a class for sensors that measure distances along a fan of rays.
+ */
+
+#include "RangeSensor.h"
+#include "CoreModule.h"
+#include <box2d/b2_fixture.h>
+#include <box2d/b2_world.h>
+#include <box2d/b2_world_callbacks.h>
+
+void RangeSensor::createPhysics()
+{
+  Sensor::createPhysics();
+
+  // The rays are evenly distributed across the opening angle, centered around the x-axis of the sensor.
+  directions.resize(rays);
+  for(unsigned int i = 0; i < rays; ++i)
+  {
+    const b2Rot direction(rays > 1 ? angle * (static_cast<float>(i) / static_cast<float>(rays - 1) - 0.5f) : 0.f);
+    directions[i] = direction.GetXAxis();
+  }
+  port.readings.resize(rays, max);
+  port.min = min;
+  port.max = max;
+}
+
+void RangeSensor::registerObjects()
+{
+  port.fullName = fullName + ".distances";
+  CoreModule::application->registerObject(*CoreModule::module, port, this);
+
+  Sensor::registerObjects();
+}
+
+void RangeSensor::updateReadings(const b2World& world)
+{
+  class ClosestHitCallback : public b2RayCastCallback
+  {
+  public:
+    explicit ClosestHitCallback(const RangeSensor& sensor) : sensor(sensor) {}
+
+    float ReportFixture(b2Fixture* fixture, const b2Vec2&, const b2Vec2&, float fraction) override
+    {
+      // Returning -1 ignores the fixture, returning the fraction clips the ray to the hit.
+      if(!sensor.detects(fixture))
+        return -1.f;
+      closestFraction = fraction;
+      return fraction;
+    }
+
+    const RangeSensor& sensor;
+    float closestFraction = 1.f;
+  };
+
+  const b2Transform pose = getPose();
+  for(unsigned int i = 0; i < rays; ++i)
+  {
+    const b2Vec2 direction = b2Mul(pose.q, directions[i]);
+    ClosestHitCallback callback(*this);
+    world.RayCast(&callback, pose.p + min * direction, pose.p + max * direction);
+    port.readings[i] = min + (max - min) * callback.closestFraction;
+  }
+}
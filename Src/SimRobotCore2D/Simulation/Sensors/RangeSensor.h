@@ -0,0 +1,34 @@
+/**
+ * @file RangeSensor.h
+ *
+ * This file declares a class for sensors that measure distances along a fan of rays.
+ */
+
+#pragma once
+
+#include "Simulation/Sensors/Sensor.h"
+
+class RangeSensor : public Sensor
+{
+public:
+  float angle = 0.f; /**< The opening angle of the fan of rays (in rad). */
+  unsigned int rays = 1; /**< The number of rays. */
+  float min = 0.f; /**< The minimum distance that can be measured. */
+  float max = 0.f; /**< The maximum distance that can be measured. */
+
+private:
+  /** Initializes the physical properties of the sensor. */
+  void createPhysics() override;
+
+  /** Registers this object with children, actuators and sensors at SimRobot's GUI. */
+  void registerObjects() override;
+
+  /**
+   * Casts all rays into the world and stores the distances to the closest hits.
+   * @param world The Box2D world.
+   */
+  void updateReadings(const b2World& world) override;
+
+  Port port; /**< The port which provides the distances. */
+  std::vector<b2Vec2> directions; /**< The directions of the rays relative to the sensor. */
+};
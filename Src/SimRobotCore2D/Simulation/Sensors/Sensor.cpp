@@ -0,0 +1,94 @@
+/**
+ * @file Sensor.cpp
+ *
+ * This file implements a base class for sensors.
+ */
+
+#include "Sensor.h"
+#include "CoreModule.h"
+#include "Simulation/Body.h"
+#include "Simulation/Geometries/Geometry.h"
+#include "Simulation/Simulation.h"
+#include <box2d/b2_body.h>
+#include <box2d/b2_fixture.h>
+
+void Sensor::createPhysics()
+{
+  // Bodies move, so only the pose relative to the parent body is constant.
+  offset = parentBody ? b2MulT(parentBody->pose, pose) : pose;
+  Simulation::simulation->sensors.push_back(this);
+
+  ::PhysicalObject::createPhysics();
+}
+
+b2Transform Sensor::getPose() const
+{
+  return parentBody ? b2Mul(parentBody->body->GetTransform(), offset) : offset;
+}
+
+bool Sensor::detects(b2Fixture* fixture) const
+{
+  if(!(fixture->GetFilterData().categoryBits & mask))
+    return false;
+  const auto* const geometry = reinterpret_cast<const Geometry*>(fixture->GetUserData().pointer);
+  return !parentBody || !geometry->parentBody || geometry->parentBody->rootBody != parentBody->rootBody;
+}
+
+const QString& Sensor::getFullName() const
+{
+  return SimObject::getFullName();
+}
+
+const QIcon* Sensor::getIcon() const
+{
+  return SimObject::getIcon();
+}
+
+SimRobot::Widget* Sensor::createWidget()
+{
+  return SimObject::createWidget();
+}
+
+SimRobotCore2D::Painter* Sensor::createPainter()
+{
+  return SimObject::createPainter();
+}
+
+SimRobotCore2D::Body* Sensor::getParentBody() const
+{
+  return parentBody;
+}
+
+const QString& Sensor::Port::getFullName() const
+{
+  return fullName;
+}
+
+const QIcon* Sensor::Port::getIcon() const
+{
+  return &CoreModule::module->objectIcon;
+}
+
+unsigned int Sensor::Port::getReadingSize() const
+{
+  return readingSize;
+}
+
+const float* Sensor::Port::getReadings(unsigned int& count)
+{
+  Simulation::simulation->updateSensors();
+  count = static_cast<unsigned int>(readings.size() / readingSize);
+  return readings.data();
+}
+
+SimRobotCore2D::Body* const* Sensor::Port::getBodies() const
+{
+  return refersToBodies ? bodies.data() : nullptr;
+}
+
+bool Sensor::Port::getMinAndMax(float& min, float& max) const
+{
+  min = this->min;
+  max = this->max;
+  return this->min < this->max;
+}
@@ -0,0 +1,131 @@
+/**
+ * @file Sensor.h
+ *
+ * This file declares a base class for sensors.
+ */
+
+#pragma once
+
+#include "Simulation/PhysicalObject.h"
+#include "SimRobotCore2D.h"
+#include <box2d/b2_math.h>
+#include <cstdint>
+#include <vector>
+
+class b2Fixture;
+class b2World;
+
+class Sensor : public PhysicalObject, public SimRobotCore2D::Sensor
+{
+public:
+  class Port : public SimRobotCore2D::SensorPort
+  {
+  public:
+    QString fullName; /**< The path name to the object in the scene graph. */
+    unsigned int readingSize = 1; /**< The number of floats per reading. */
+    std::vector<float> readings; /**< The readings of the most recent evaluation. */
+    std::vector<SimRobotCore2D::Body*> bodies; /**< The bodies to which the readings refer (if \c refersToBodies). */
+    bool refersToBodies = false; /**< Whether each reading refers to a body. */
+    float min = 0.f; /**< The minimum value of a reading (if \c min < \c max). */
+    float max = 0.f; /**< The maximum value of a reading (if \c min < \c max). */
+
+  private:
+    /**
+     * Returns the full path to the object in the scene graph.
+     * @return The full path ...
+     */
+    [[nodiscard]] const QString& getFullName() const override;
+
+    /**
+     * Returns an icon to visualize the object in the scene graph.
+     * @return An icon ...
+     */
+    [[nodiscard]] const QIcon* getIcon() const override;
+
+    /**
+     * Returns the number of values that form a single reading.
+     * @return The number of floats per reading.
+     */
+    [[nodiscard]] unsigned int getReadingSize() const override;
+
+    /**
+     * Returns the readings of the sensor in the current simulation step.
+     * @param count The number of readings.
+     * @return The readings.
+     */
+    const float* getReadings(unsigned int& count) override;
+
+    /**
+     * Returns the bodies to which the readings refer.
+     * @return One body per reading or \c nullptr.
+     */
+    [[nodiscard]] SimRobotCore2D::Body* const* getBodies() const override;
+
+    /**
+     * Returns the range of the sensor readings.
+     * @param min The minimum value.
+     * @param max The maximum value.
+     * @return Whether the readings have a range.
+     */
+    bool getMinAndMax(float& min, float& max) const override;
+  };
+
+  /**
+   * Computes the readings of the sensor for the current state of the world.
+   * This is called for multiple sensors in parallel, so it must only modify the sensor itself.
+   * @param world The Box2D world.
+   */
+  virtual void updateReadings(const b2World& world) = 0;
+
+  std::uint16_t mask = 0xffff; /**< The mask of categories of geometries that this sensor detects. */
+
+protected:
+  /** Initializes the physical properties of the sensor. */
+  void createPhysics() override;
+
+  /**
+   * Returns the current pose of the sensor in world coordinates.
+   * @return The pose.
+   */
+  [[nodiscard]] b2Transform getPose() const;
+
+  /**
+   * Checks whether a fixture can be detected by this sensor, i.e. whether its category is in the mask and it does not belong to the robot that carries the sensor.
+   * @param fixture The fixture.
+   * @return Whether the fixture can be detected.
+   */
+  [[nodiscard]] bool detects(b2Fixture* fixture) const;
+
+  /**
+   * Returns the full path to the object in the scene graph.
+   * @return The full path ...
+   */
+  [[nodiscard]] const QString& getFullName() const override;
+
+  /**
+   * Returns an icon to visualize the object in the scene graph.
+   * @return An icon ...
+   */
+  [[nodiscard]] const QIcon* getIcon() const override;
+
+  /**
+   * Creates a widget for this object.
+   * @return The new widget instance.
+   */
+  SimRobot::Widget* createWidget() override;
+
+  /**
+   * Creates a painter for this object.
+   * @return The new painter instance.
+   */
+  SimRobotCore2D::Painter* createPainter() override;
+
+  /**
+   * Returns the parent body of the physical object.
+   * @return The parent body.
+   */
+  [[nodiscard]] SimRobotCore2D::Body* getParentBody() const override;
+
+private:
+  b2Transform offset; /**< The pose of the sensor relative to its parent body (or to the world if it is not attached to a body). */
+};
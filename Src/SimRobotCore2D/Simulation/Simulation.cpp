@@ -14,9 +14,13 @@
 #include "Parser/ParserCore2D.h"
 #include "Simulation/Geometries/Geometry.h"
 #include "Simulation/Scene.h"
+#include "Simulation/Sensors/Sensor.h"
 #include <box2d/b2_body.h>
 #include <box2d/b2_world.h>
 #include <box2d/b2_contact.h>
+#include <algorithm>
+#include <atomic>
+#include <latch>
 
 Simulation* Simulation::simulation = nullptr;
 
@@ -94,30 +98,80 @@ void Simulation::doSimulationStep()
   // Execute the Box2D step.
   world->Step(scene->stepLength, scene->velocityIterations, scene->positionIterations);
 
-  // Report collisions that persist over multiple steps.
+  // Report collisions that persist over multiple steps. The contact list of the world is not used for this,
+  // because it also contains all contacts of overlapping bounding boxes, which are many more than the touching ones.
   for(auto& contact : contacts)
   {
-    if(contact.second)
-      reportCollisions(contact.first);
-    else
+    if(!contact.second)
       contact.second = true;
+    else if(hasCollisionCallbacks(contact.first))
+      reportCollisions(contact.first);
   }
 
   updateFrameRate();
 }
 
+void Simulation::updateSensors()
+{
+  if(lastSensorUpdateStep == simulationStep)
+    return;
+  lastSensorUpdateStep = simulationStep;
+
+  // Sensors only read the world, so they can be evaluated in parallel if there are enough of them to pay off.
+  constexpr std::size_t minSensorsPerThread = 16;
+  const std::size_t numOfThreads = std::min(static_cast<std::size_t>(std::max(sensorPool.maxThreadCount(), 1)),
+                                            sensors.size() / minSensorsPerThread);
+  if(numOfThreads < 2)
+  {
+    for(Sensor* sensor : sensors)
+      sensor->updateReadings(*world);
+    return;
+  }
+
+  std::atomic<std::size_t> nextSensor = 0;
+  const auto updateReadings = [&]
+  {
+    for(std::size_t i = nextSensor++; i < sensors.size(); i = nextSensor++)
+      sensors[i]->updateReadings(*world);
+  };
+  // The calling thread takes part, so only numOfThreads - 1 helpers are needed.
+  std::latch done(static_cast<std::ptrdiff_t>(numOfThreads - 1));
+  for(std::size_t i = 1; i < numOfThreads; ++i)
+    sensorPool.start([&updateReadings, &done]
+    {
+      updateReadings();
+      done.count_down();
+    });
+  updateReadings();
+  done.wait();
+}
+
 void Simulation::BeginContact(b2Contact* contact)
 {
   ++collisions;
-  contacts[contact] = false;
+  contactIndices[contact] = contacts.size();
+  contacts.emplace_back(contact, false);
 
   // Report already here because the contact might already end before the end of the time step.
-  reportCollisions(contact);
+  if(hasCollisionCallbacks(contact))
+    reportCollisions(contact);
 }
 
 void Simulation::EndContact(b2Contact* contact)
 {
-  contacts.erase(contact);
+  // The ended contact is replaced by the last one, so that the active contacts stay dense.
+  const auto i = contactIndices.find(contact);
+  if(i != contactIndices.end())
+  {
+    const std::size_t index = i->second;
+    contactIndices.erase(i);
+    if(index != contacts.size() - 1)
+    {
+      contacts[index] = contacts.back();
+      contactIndices[contacts[index].first] = index;
+    }
+    contacts.pop_back();
+  }
   --collisions;
 }
 
@@ -134,6 +188,12 @@ void Simulation::updateFrameRate()
   }
 }
 
+bool Simulation::hasCollisionCallbacks(b2Contact* contact)
+{
+  return !reinterpret_cast<const Geometry*>(contact->GetFixtureA()->GetUserData().pointer)->callbacks.empty() ||
+         !reinterpret_cast<const Geometry*>(contact->GetFixtureB()->GetUserData().pointer)->callbacks.empty();
+}
+
 void Simulation::reportCollisions(b2Contact* contact)
 {
   auto* const geom1 = reinterpret_cast<Geometry*>(contact->GetFixtureA()->GetUserData().pointer);
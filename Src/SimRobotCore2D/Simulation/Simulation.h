@@ -9,14 +9,18 @@
 #pragma once
 
 #include <box2d/b2_world_callbacks.h>
+#include <QThreadPool>
 #include <list>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 class b2Body;
 class b2World;
 class ElementCore2D;
 class Scene;
+class Sensor;
 
 class Simulation : public b2ContactListener
 {
@@ -41,6 +45,9 @@ public:
   /** Executes one time step (frame) of the simulation. */
   void doSimulationStep();
 
+  /** Computes the readings of all sensors (if this has not been done in the current step yet). */
+  void updateSensors();
+
   static Simulation* simulation; /**< The only instance of this class. */
   std::list<ElementCore2D*> elements; /**< All elements in the simulation. */
   Scene* scene = nullptr; /**< The scene that is being simulated. */
@@ -51,6 +58,7 @@ public:
 
   b2World* world = nullptr; /**< The Box2D world in which the physics happen. */
   b2Body* staticBody = nullptr; /**< The Box2D body to which compound fixtures are attached. */
+  std::vector<Sensor*> sensors; /**< All sensors in the scene. */
 
 protected:
   /**
@@ -69,6 +77,13 @@ private:
   /** Updates the frame rate (if required). */
   void updateFrameRate();
 
+  /**
+   * Checks whether a collision callback is registered for one of the geometries of a contact.
+   * @param contact The contact.
+   * @return Whether there is a callback to call.
+   */
+  static bool hasCollisionCallbacks(b2Contact* contact);
+
   /**
    * Call collision callbacks for a contact.
    * @param contact The contact.
@@ -77,5 +92,8 @@ private:
 
   unsigned int lastFrameRateComputationTime = 0; /**< The (real) time when the frame rate was calculated. */
   unsigned int lastFrameRateComputationStep = 0; /**< The step number when the frame rate was calculated. */
-  std::unordered_map<b2Contact*, bool> contacts; /**< The active contacts + whether they should be additionally reported in \c doSimulationStep. */
+  unsigned int lastSensorUpdateStep = ~0u; /**< The step in which the sensor readings were computed. */
+  QThreadPool sensorPool; /**< The threads that help computing the sensor readings. */
+  std::vector<std::pair<b2Contact*, bool>> contacts; /**< The active contacts + whether they should be additionally reported in \c doSimulationStep. */
+  std::unordered_map<b2Contact*, std::size_t> contactIndices; /**< The index of each active contact in \c contacts (Box2D contacts have no user data). */
 };
@@ -15,6 +15,7 @@
 #include <QSet>
 #include <QSettings>
 #include <QTextStream>
+#include <QTimer>
 #include <QVBoxLayout>
 
 #include "EditorModule.h"
@@ -239,9 +240,15 @@ QMenu* EditorWidget::createFileMenu() const
   action->setShortcut(QKeySequence(QKeySequence::Save));
   action->setStatusTip(tr("Save the document to disk"));
   action->setEnabled(document()->isModified());
-  connect(action, &QAction::triggered, this, &EditorWidget::save);
+  connect(action, &QAction::triggered, this, &EditorWidget::saveAndReload);
   connect(document(), &QTextDocument::modificationChanged, action, &QAction::setEnabled);
 
+  action = menu->addAction(tr("&Reload Scene on Save"));
+  action->setStatusTip(tr("Apply the changes to the simulation when a file of the scene is saved"));
+  action->setCheckable(true);
+  action->setChecked(EditorModule::application->getSettings().value("ReloadSceneOnSave", false).toBool());
+  connect(action, &QAction::toggled, this, [](bool checked){EditorModule::application->getSettings().setValue("ReloadSceneOnSave", checked);});
+
   return menu;
 }
 
@@ -513,17 +520,43 @@ void EditorWidget::undoAvailable(bool available)
   canUndo = available;
 }
 
-void EditorWidget::save()
+bool EditorWidget::save()
 {
   QFile file(editorObject->filePath);
   if(!file.open(QFile::WriteOnly | QFile::Text))
   {
     EditorModule::application->showWarning(QObject::tr("SimRobotEditor"), QObject::tr("Cannot write file %1:\n%2.").arg(editorObject->filePath).arg(file.errorString()));
-    return;
+    return false;
   }
   QTextStream out(&file);
   out << toPlainText();
+  out.flush();
+  file.close();
   document()->setModified(false);
+  return true;
+}
+
+void EditorWidget::saveAndReload()
+{
+  if(!save() || !EditorModule::application->getSettings().value("ReloadSceneOnSave", false).toBool())
+    return;
+
+  // The changes are applied to the simulation if the file is the scene file or a file included by it.
+  // This is done after returning to the event loop, since reloading can replace the dock widgets.
+  for(const EditorObject* object = editorObject; object; object = object->parent)
+  {
+    const auto* fileEditorObject = dynamic_cast<const FileEditorObject*>(object);
+    if(fileEditorObject && fileEditorObject->filePath == EditorModule::application->getFilePath())
+    {
+      const QString filePath = fileEditorObject->filePath;
+      QTimer::singleShot(0, this, [filePath]
+      {
+        if(EditorModule::application->getFilePath() == filePath)
+          EditorModule::application->simReload();
+      });
+      break;
+    }
+  }
 }
 
 void EditorWidget::cut()
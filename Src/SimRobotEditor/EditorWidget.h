@@ -140,7 +140,8 @@ private slots:
   void copyAvailable(bool available);
   void redoAvailable(bool available);
   void undoAvailable(bool available);
-  void save();
+  bool save();
+  void saveAndReload();
   void cut();
   void copy();
   void deleteText();